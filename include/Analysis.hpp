@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Resonix {
+    class ThreadPool;
+
+    /**
+     * @struct SignalStats
+     * @brief Quality-control statistics of a sample buffer
+     *
+     * NaN and infinite samples (e.g. from TANGENT and COTANGENT asymptotes)
+     * are counted and otherwise ignored, so peak, RMS and DC offset describe
+     * the finite samples only.
+     */
+    struct SignalStats {
+        long long length = 0;          ///< Number of samples analyzed
+        float peak = 0.0f;             ///< Largest absolute finite sample
+        float rms = 0.0f;              ///< Root mean square of the finite samples
+        float dc_offset = 0.0f;        ///< Mean of the finite samples
+        long long zero_crossings = 0;  ///< Sign changes between adjacent finite samples
+        long long nan_count = 0;       ///< Number of NaN samples
+        long long inf_count = 0;       ///< Number of infinite samples
+    };
+
+    /**
+     * @class StatsAccumulator
+     * @brief Running single-pass computation of SignalStats
+     *
+     * Consecutive add() calls behave like one call over the concatenated
+     * samples, which lets filters and streams collect statistics block by
+     * block while the data is still in cache.
+     *
+     * Classification uses the IEEE 754 bit patterns rather than float
+     * comparisons, so NaN counts stay correct under -ffast-math.
+     */
+    class StatsAccumulator {
+    public:
+        /** @brief Adds the next count samples of the stream */
+        void add(const float* samples, int count);
+
+        /** @brief Appends the statistics of the samples that directly follow this stream */
+        void merge(const StatsAccumulator& next);
+
+        /** @brief Statistics of everything added so far */
+        SignalStats result() const;
+
+        /** @brief Forgets all samples */
+        void reset() { *this = StatsAccumulator(); }
+
+    private:
+        double sum_ = 0.0;
+        double sum_squares_ = 0.0;
+        uint32_t peak_bits_ = 0;
+        long long length_ = 0;
+        long long finite_ = 0;
+        long long zero_crossings_ = 0;
+        long long nan_count_ = 0;
+        long long inf_count_ = 0;
+        uint32_t first_bits_ = 0;
+        uint32_t last_bits_ = 0;
+    };
+
+    /**
+     * @brief Computes peak, RMS, DC offset, zero crossings and NaN/Inf counts in one pass
+     *
+     * Long buffers are split into chunks analyzed concurrently and merged.
+     *
+     * @param samples Pointer to the samples to analyze
+     * @param length Number of samples
+     * @param pool Pool for the chunks; nullptr uses ThreadPool::global()
+     * @return SignalStats Statistics; all zero if samples is null or length <= 0
+     *
+     * @example
+     * auto tan = Resonix::generateSamples(Resonix::TANGENT, 1, 440.0f);
+     * Resonix::SignalStats stats = Resonix::analyze(tan.get(), Resonix::SAMPLE_RATE);
+     * if (stats.nan_count > 0) { ... }
+     */
+    SignalStats analyze(const float* samples, long long length, ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Envelope follower mode: peak and RMS of every block
+     *
+     * @param samples Pointer to the samples to analyze
+     * @param length Number of samples
+     * @param block_size Samples per block; the last block may be shorter
+     * @param peak Receives ceil(length / block_size) block peaks
+     * @param rms Receives ceil(length / block_size) block RMS values
+     * @return long long Number of blocks written, or -1 on invalid input
+     */
+    long long analyzeBlocks(const float* samples, long long length, int block_size, float* peak, float* rms);
+}
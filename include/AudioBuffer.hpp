@@ -0,0 +1,133 @@
+#pragma once
+
+#include "BufferPool.hpp"
+
+namespace Resonix {
+    /**
+     * @class Span
+     * @brief Non-owning view of contiguous samples
+     *
+     * Two words, passed by value; it stays valid as long as the storage it
+     * points into.
+     */
+    template <typename T>
+    class Span {
+    public:
+        Span() : data_(nullptr), size_(0) {}
+        Span(T* data, long long size) : data_(data), size_(size) {}
+
+        T* data() const { return data_; }
+        long long size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        T& operator[](long long index) const { return data_[index]; }
+        T* begin() const { return data_; }
+        T* end() const { return data_ + size_; }
+
+        /** @brief View of count samples starting at offset, clipped to this span */
+        Span subspan(long long offset, long long count) const {
+            if (offset >= size_)
+                return Span();
+            return Span(data_ + offset, count < size_ - offset ? count : size_ - offset);
+        }
+
+        operator Span<const T>() const { return Span<const T>(data_, size_); }
+
+    private:
+        T* data_;
+        long long size_;
+    };
+
+    using SampleSpan = Span<float>;
+    using ConstSampleSpan = Span<const float>;
+
+    /**
+     * @class AudioBuffer
+     * @brief Planar multichannel sample storage
+     *
+     * All channels live in one pooled allocation. Every channel starts on a
+     * BUFFER_ALIGNMENT boundary, stride() samples after the previous one, so
+     * per-channel kernels get aligned loads and the whole buffer maps to a 2D
+     * (channels x frames) array without copying. Move-only.
+     *
+     * @example
+     * Resonix::AudioBuffer stereo(2, Resonix::SAMPLE_RATE);
+     * Resonix::generateSamples(stereo, Resonix::NOISE_PINK, 0.0f);
+     * Resonix::lowpass_filter(stereo, 2000.0f);
+     * std::vector<float> pcm(stereo.channels() * stereo.frames());
+     * Resonix::interleave(stereo, pcm.data());
+     */
+    class AudioBuffer {
+    public:
+        AudioBuffer() : channels_(0), frames_(0), stride_(0) {}
+
+        /**
+         * @brief Allocates uninitialized storage for channels x frames samples
+         *
+         * On invalid sizes or allocation failure the buffer is left empty().
+         */
+        AudioBuffer(int channels, long long frames);
+
+        AudioBuffer(AudioBuffer&& other) noexcept;
+        AudioBuffer& operator=(AudioBuffer&& other) noexcept;
+
+        AudioBuffer(const AudioBuffer&) = delete;
+        AudioBuffer& operator=(const AudioBuffer&) = delete;
+
+        bool empty() const { return !storage_; }
+        int channels() const { return channels_; }
+        long long frames() const { return frames_; }
+
+        /** @brief Distance in samples between the starts of consecutive channels */
+        long long stride() const { return stride_; }
+
+        float* channel(int index) { return storage_.get() + index * stride_; }
+        const float* channel(int index) const { return storage_.get() + index * stride_; }
+
+        SampleSpan operator[](int index) { return SampleSpan(channel(index), frames_); }
+        ConstSampleSpan operator[](int index) const { return ConstSampleSpan(channel(index), frames_); }
+
+        /** @brief Start of channel 0; channel c starts at data() + c * stride() */
+        float* data() { return storage_.get(); }
+        const float* data() const { return storage_.get(); }
+
+        /** @brief Sets every sample to zero */
+        void clear();
+
+        /**
+         * @brief Hands the storage over, e.g. to a NumPy array, leaving this buffer empty
+         *
+         * Read the layout (channels, frames, stride) before calling.
+         */
+        SampleBuffer release();
+
+    private:
+        SampleBuffer storage_;
+        int channels_;
+        long long frames_;
+        long long stride_;
+    };
+
+    /**
+     * @brief Writes the buffer as interleaved frames (L R L R ... for stereo)
+     *
+     * @param input Planar source buffer
+     * @param output Destination of channels() * frames() samples
+     */
+    void interleave(const AudioBuffer& input, float* output);
+
+    /**
+     * @brief Interleaves frames [offset, offset + frames) of a buffer
+     *
+     * @param output Destination of frames * channels() samples
+     */
+    void interleave(const AudioBuffer& input, long long offset, long long frames, float* output);
+
+    /**
+     * @brief Splits interleaved frames into the channels of a buffer
+     *
+     * @param input Interleaved source of output.channels() * output.frames() samples
+     * @param output Planar destination; its size determines how much is read
+     */
+    void deinterleave(const float* input, AudioBuffer& output);
+}
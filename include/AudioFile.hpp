@@ -0,0 +1,242 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AudioBuffer.hpp"
+#include "Pcm.hpp"
+#include "Resonix.hpp"
+
+namespace Resonix {
+    /**
+     * @enum FileFormat
+     * @brief Container of a rendered audio file
+     */
+    enum FileFormat {
+        WAV, ///< RIFF WAVE, promoted to RF64 on close when larger than 4 GiB
+        RAW  ///< Headerless interleaved little-endian samples
+    };
+
+    /**
+     * @enum Access
+     * @brief Expected access pattern of a mapped file, passed on to madvise()
+     */
+    enum Access {
+        ACCESS_NORMAL,     ///< Default readahead
+        ACCESS_SEQUENTIAL, ///< Aggressive readahead, pages dropped soon after use
+        ACCESS_RANDOM      ///< No readahead
+    };
+
+    /**
+     * @class AudioFileReader
+     * @brief Memory-mapped reader for WAV/RF64 and raw files
+     *
+     * The file is mapped read-only, so opening costs no I/O and pages are read
+     * from the page cache on first touch. float32 data is exposed directly as
+     * a span over the mapping; int16, int24 and float16 data is converted to
+     * float on demand, one caller-sized block at a time, so no full-length
+     * copy exists for any encoding. Where mmap is unavailable the file is read into
+     * memory instead.
+     *
+     * @example
+     * Resonix::AudioFileReader reader;
+     * reader.open("take.wav");
+     * Filter::BiquadFilter lowpass = Filter::make_lowpass_filter(1000.0f, 0.707f);
+     * std::vector<float> block(4096);
+     * for (long long start = 0; start < reader.frames(); start += 4096) {
+     *     long long count = reader.readChannel(0, start, 4096, block.data());
+     *     lowpass.process(block.data(), block.data(), static_cast<int>(count));
+     * }
+     */
+    class AudioFileReader {
+    public:
+        AudioFileReader();
+        ~AudioFileReader();
+
+        AudioFileReader(const AudioFileReader&) = delete;
+        AudioFileReader& operator=(const AudioFileReader&) = delete;
+
+        /**
+         * @brief Maps a WAV (RIFF, RF64, PCM/float/extensible) file of any SampleFormat
+         *
+         * @return bool false if the file cannot be mapped or is not a supported WAV file
+         */
+        bool open(const std::string& path);
+
+        /**
+         * @brief Maps a headerless file of interleaved little-endian samples
+         *
+         * @return bool false if the file cannot be mapped or a parameter is invalid
+         */
+        bool openRaw(const std::string& path, int channels, SampleFormat format = FLOAT32, int sample_rate = SAMPLE_RATE);
+
+        /** @brief Unmaps the file; spans from samples() become invalid */
+        void close();
+
+        bool isOpen() const { return data_ != nullptr; }
+        int channels() const { return channels_; }
+        int sampleRate() const { return sample_rate_; }
+        SampleFormat format() const { return format_; }
+        long long frames() const { return frames_; }
+
+        /**
+         * @brief Zero-copy view of all interleaved samples
+         *
+         * @return ConstSampleSpan The mapped data for aligned float32 files, otherwise empty
+         */
+        ConstSampleSpan samples() const;
+
+        /**
+         * @brief Converts interleaved frames [offset, offset + frames) to float
+         *
+         * @param output Destination of frames * channels() samples
+         * @return long long Frames converted, fewer near the end of the file; -1 on invalid input
+         */
+        long long read(long long offset, long long frames, float* output) const;
+
+        /** @brief Like read(), for a single channel */
+        long long readChannel(int channel, long long offset, long long frames, float* output) const;
+
+        /** @brief Sets the readahead policy of the whole mapping */
+        void advise(Access access) const;
+
+        /** @brief Lets the kernel drop the pages of frames that will not be read again */
+        void release(long long offset, long long frames) const;
+
+    private:
+        bool map(const std::string& path);
+        bool parseWav();
+
+        const unsigned char* file_data_;
+        size_t file_size_;
+        bool mapped_;
+        const unsigned char* data_;
+        int channels_;
+        int sample_rate_;
+        SampleFormat format_;
+        long long frames_;
+    };
+
+    /**
+     * @class AudioFileWriter
+     * @brief Streaming writer for WAV/RF64 and raw files
+     *
+     * Samples are encoded (float32, int16, int24 or float16, with optional
+     * TPDF dither, see encodeSamples()) straight into fixed-size chunks that a background thread
+     * writes while the caller computes the next block. Only a few chunks
+     * exist at a time, so memory use is constant however long the render is.
+     * Every write is a whole chunk (a multiple of 4 KiB) at a 4 KiB-aligned
+     * file offset: the WAV header is padded to 4 KiB with a JUNK chunk.
+     *
+     * Errors are sticky: after a failed write every call returns false.
+     *
+     * open(), write() and close() take a mutex, so one writer can be shared
+     * between threads (e.g. a SinkThread and the caller); a write that comes
+     * after another thread's close() returns false.
+     *
+     * @example
+     * Resonix::AudioFileWriter writer;
+     * writer.open("drone.wav", 1);
+     * graph.render(3600LL * Resonix::SAMPLE_RATE, [&](const float* block, int count) {
+     *     writer.write(block, count);
+     * });
+     * writer.close();
+     */
+    class AudioFileWriter {
+    public:
+        /** @brief Samples per chunk handed to the writer thread */
+        static constexpr int CHUNK_SAMPLES = 1 << 18;
+        /** @brief Chunks in flight; the producer waits when all are queued */
+        static constexpr int CHUNK_COUNT = 3;
+        /** @brief Size of the WAV header, so sample data starts page-aligned */
+        static constexpr int WAV_HEADER_BYTES = 4096;
+
+        AudioFileWriter();
+        ~AudioFileWriter();
+
+        AudioFileWriter(const AudioFileWriter&) = delete;
+        AudioFileWriter& operator=(const AudioFileWriter&) = delete;
+
+        /**
+         * @brief Creates or truncates a file and starts the writer thread
+         *
+         * @param path File to write
+         * @param channels Interleaved channels per frame
+         * @param sample_rate Sample rate stored in the WAV header
+         * @param format WAV or RAW
+         * @param sample_format Encoding of the stored samples
+         * @param dither Whether INT16 and INT24 output is TPDF-dithered
+         * @param dither_seed Dither stream of the file (see Dither); files written with equal seeds share their noise
+         * @return bool false if a file is already open, a parameter is invalid or the file cannot be created
+         */
+        bool open(const std::string& path, int channels, int sample_rate = SAMPLE_RATE, FileFormat format = WAV,
+                  SampleFormat sample_format = FLOAT32, bool dither = true, unsigned long long dither_seed = 0);
+
+        /**
+         * @brief Appends interleaved frames
+         *
+         * @param samples frames * channels() interleaved samples
+         * @param frames Number of frames
+         * @return bool false if no file is open or writing failed
+         */
+        bool write(const float* samples, long long frames);
+
+        /** @brief Appends every frame of a planar buffer with matching channel count */
+        bool write(const AudioBuffer& buffer);
+
+        /**
+         * @brief Writes the remaining samples, finalizes the header and closes the file
+         *
+         * @return bool true if every sample reached the file
+         */
+        bool close();
+
+        bool isOpen() const;
+        int channels() const;
+        SampleFormat sampleFormat() const;
+        long long framesWritten() const;
+
+    private:
+        struct Chunk {
+            unsigned char* bytes;
+            size_t size;
+        };
+
+        bool append(const float* samples, long long frames);
+        bool closeLocked();
+        void writerLoop();
+        bool submitCurrent();
+        bool writeHeader(bool final);
+
+        std::FILE* file_;
+        FileFormat format_;
+        SampleFormat sample_format_;
+        Dither dither_;
+        bool dithered_;
+        int channels_;
+        int sample_rate_;
+        long long samples_written_;
+
+        std::vector<unsigned char*> storage_;
+        Chunk current_;
+        size_t chunk_bytes_;
+
+        // Serializes the public calls; mutex_ only guards the chunk queues
+        mutable std::mutex call_mutex_;
+
+        std::thread thread_;
+        std::mutex mutex_;
+        std::condition_variable ready_cv_;
+        std::condition_variable free_cv_;
+        std::deque<Chunk> queued_;
+        std::vector<unsigned char*> free_;
+        std::vector<float> scratch_;
+        bool stopping_;
+        std::atomic<bool> failed_;
+    };
+}
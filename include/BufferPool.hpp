@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Resonix {
+    /** @brief Alignment of every pooled buffer, one cache line and a full AVX-512 register */
+    constexpr size_t BUFFER_ALIGNMENT = 64;
+
+    /**
+     * @struct Allocator
+     * @brief Hook for the memory behind a BufferPool
+     *
+     * allocate must return BUFFER_ALIGNMENT-aligned memory or nullptr, and
+     * deallocate receives the same size back. user is passed through untouched.
+     */
+    struct Allocator {
+        void* (*allocate)(size_t bytes, void* user);
+        void (*deallocate)(void* memory, size_t bytes, void* user);
+        void* user;
+    };
+
+    /**
+     * @struct MemoryUsage
+     * @brief Allocations charged to one API function
+     */
+    struct MemoryUsage {
+        std::string name;                   // API that was running, "other" for untagged requests
+        unsigned long long allocations = 0; // Blocks handed out since the last reset
+        size_t bytes = 0;                   // Bytes requested since the last reset
+        size_t live_bytes = 0;              // Requested bytes still in use
+        size_t peak_bytes = 0;              // Highest live_bytes since the last reset
+    };
+
+    /**
+     * @struct MemoryStats
+     * @brief Snapshot of what a BufferPool has handed out and what it holds
+     *
+     * live_bytes and peak_bytes count the bytes callers asked for; reserved_bytes
+     * is what the pool holds from its allocator, including size-class rounding,
+     * block headers and the free lists, i.e. its actual footprint.
+     */
+    struct MemoryStats {
+        size_t live_bytes = 0;
+        size_t peak_bytes = 0;
+        size_t reserved_bytes = 0;
+        size_t peak_reserved_bytes = 0;
+        size_t cached_bytes = 0;
+        unsigned long long allocations = 0;
+        std::vector<MemoryUsage> apis;      // Sorted by peak_bytes, largest first
+    };
+
+    /**
+     * @class MemoryTag
+     * @brief Charges the pool allocations of the current thread to an API name
+     *
+     * Tags nest; the outermost one wins, so the memory a public function uses
+     * internally is charged to that function. name must outlive the program,
+     * e.g. a string literal; tags with the same text share one entry.
+     *
+     * @example
+     * Resonix::MemoryTag tag("Resonix::resample");
+     */
+    class MemoryTag {
+    public:
+        explicit MemoryTag(const char* name);
+        ~MemoryTag();
+
+        MemoryTag(const MemoryTag&) = delete;
+        MemoryTag& operator=(const MemoryTag&) = delete;
+
+    private:
+        bool outermost_;
+    };
+
+    /**
+     * @class BufferPool
+     * @brief Recycling allocator for large sample buffers
+     *
+     * Requests are rounded up to size classes (four per power of two) and
+     * released buffers are kept on per-class free lists, so repeated calls of
+     * the same size reuse memory that is already mapped instead of page-faulting
+     * fresh pages. Buffers are 64-byte aligned and not initialized.
+     *
+     * Each buffer records its pool and allocator, so it can be released from
+     * any thread and after the allocator hook has changed. A pool must outlive
+     * its buffers; the global() pool is never destroyed.
+     *
+     * @example
+     * Resonix::SampleBuffer block = Resonix::allocateSamples(48000);
+     * // ... block.get() is returned to the pool when block goes out of scope
+     */
+    class BufferPool {
+    public:
+        /** @brief Default upper bound of memory held on the free lists */
+        static constexpr size_t DEFAULT_CACHE_LIMIT = size_t(256) << 20;
+
+        BufferPool();
+        ~BufferPool();
+
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        /**
+         * @brief Hands out an uninitialized, 64-byte aligned block
+         *
+         * @param bytes Usable size of the block
+         * @return void* The block, or nullptr if bytes is 0 or allocation failed
+         */
+        void* allocate(size_t bytes);
+
+        /** @brief Returns a block from any pool's allocate() to its pool; nullptr is ignored */
+        static void release(void* memory);
+
+        /**
+         * @brief Replaces the memory source; nullptr restores aligned operator new
+         *
+         * Cached blocks of the previous allocator are freed right away.
+         */
+        void setAllocator(const Allocator* allocator);
+
+        /** @brief Caps the memory kept on the free lists; excess is freed on release */
+        void setCacheLimit(size_t bytes);
+
+        /** @brief Frees every cached block */
+        void trim();
+
+        /** @brief Bytes currently held on the free lists */
+        size_t cachedBytes() const;
+
+        /** @brief Live, peak and per-API usage of the blocks handed out */
+        MemoryStats memoryStats() const;
+
+        /**
+         * @brief Starts a new measurement
+         *
+         * Zeroes the allocation counts and lowers every peak to the current
+         * live bytes; memory still in use keeps being counted as live.
+         */
+        void resetMemoryStats();
+
+        /** @brief Process-wide pool used by all sample-returning APIs */
+        static BufferPool& global();
+
+    private:
+        struct Header;
+
+        void recycle(Header* header);
+        static void freeBlock(Header* header);
+
+        struct Usage;
+
+        void recordAllocation(Header* header);
+
+        mutable std::mutex mutex_;
+        std::vector<std::vector<Header*>> free_lists_;
+        Allocator allocator_;
+        size_t cached_bytes_;
+        size_t cache_limit_;
+        size_t reserved_bytes_;
+        size_t peak_reserved_bytes_;
+        std::vector<Usage> usage_;  // [0] totals, then one entry per tag
+    };
+
+    /** @brief Deleter returning a sample buffer to its BufferPool */
+    struct BufferDeleter {
+        void operator()(float* samples) const { BufferPool::release(samples); }
+    };
+
+    /** @brief Owning handle of a pooled sample buffer */
+    using SampleBuffer = std::unique_ptr<float[], BufferDeleter>;
+
+    /**
+     * @brief Allocates count uninitialized samples from BufferPool::global()
+     *
+     * @return SampleBuffer The buffer, or nullptr if count is 0 or allocation failed
+     */
+    SampleBuffer allocateSamples(size_t count);
+
+    /** @brief memoryStats() of BufferPool::global(), which backs every Resonix allocation */
+    MemoryStats memoryStats();
+
+    /** @brief resetMemoryStats() of BufferPool::global() */
+    void resetMemoryStats();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @def RESONIX_CLONES
+ * @brief Compiles a hot kernel once per ISA level and selects one at load time
+ *
+ * On x86-64 ELF targets the compiler emits an AVX-512 (x86-64-v4), an
+ * AVX2/FMA (x86-64-v3) and a baseline SSE2 version of every marked function.
+ * The dynamic loader binds the best one for the running CPU through CPUID,
+ * once, via an ifunc resolver. A single portable binary therefore runs at
+ * native speed on new hosts and still runs on old ones. Elsewhere the macro
+ * is empty: the baseline of AArch64 already includes NEON.
+ *
+ * The AVX2 and AVX-512 versions may fuse multiply-adds, so their output can
+ * differ from the SSE2 version in the last bits.
+ *
+ * Define RESONIX_NO_DISPATCH (the RESONIX_NATIVE CMake option does) when
+ * building with -march=native, where the clones would be redundant.
+ */
+#if !defined(RESONIX_NO_DISPATCH) && defined(__x86_64__) && defined(__ELF__) && defined(__GLIBC__) \
+    && (defined(__clang__) ? __clang_major__ >= 14 : defined(__GNUC__) && __GNUC__ >= 12)
+#define RESONIX_DISPATCH 1
+#define RESONIX_CLONES __attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3", "default")))
+#else
+#define RESONIX_CLONES
+#endif
+
+namespace Resonix {
+    /**
+     * @brief Instruction set the hot kernels run with on this machine
+     *
+     * @return const char* "avx512", "avx2" or "sse2" on x86-64, "neon" on
+     * ARM, otherwise "generic"
+     */
+    const char* simdLevel();
+}
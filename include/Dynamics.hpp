@@ -0,0 +1,186 @@
+#pragma once
+
+#include <vector>
+#include "AudioBuffer.hpp"
+#include "Resonix.hpp"
+
+namespace Filter {
+    /**
+     * @enum DynamicsMode
+     * @brief Gain law of a Dynamics processor
+     */
+    enum DynamicsMode {
+        DYNAMICS_COMPRESSOR,  ///< Above threshold_db, the level rises by 1 dB per ratio dB of input
+        DYNAMICS_LIMITER,     ///< Nothing leaves above threshold_db (the ceiling); attack is set by the lookahead
+        DYNAMICS_GATE         ///< Below threshold_db, the level falls by ratio dB per dB of input, down to range_db
+    };
+
+    /**
+     * @struct DynamicsSettings
+     * @brief Parameters of a Dynamics processor
+     */
+    struct DynamicsSettings {
+        DynamicsMode mode = DYNAMICS_COMPRESSOR;
+        float threshold_db = -12.0f;    // Of the sample peak; the ceiling of a limiter
+        float ratio = 4.0f;             // >= 1; ignored by the limiter
+        float attack_ms = 5.0f;         // Gain reduction (gate: opening) time constant; ignored by the limiter
+        float release_ms = 100.0f;      // Recovery (gate: closing) time constant
+        float lookahead_ms = 5.0f;      // Delay of the audio behind the detector
+        float makeup_db = 0.0f;         // Gain applied after the gain law; ignored by the limiter
+        float range_db = -80.0f;        // Deepest attenuation of the gate
+    };
+
+    /**
+     * @class Dynamics
+     * @brief Streaming lookahead compressor, brickwall limiter and gate
+     *
+     * The audio runs through a delay line of latency() samples while the
+     * detector looks at the undelayed input: a sliding-window maximum over
+     * the lookahead holds each peak for as long as it is in the delay line, so
+     * gain reduction is in place before the peak leaves it. The window maximum
+     * combines running maxima from the start and the end of window-long
+     * segments (van Herk/Gil-Werman), three max operations per sample without
+     * data-dependent branches. The gain law is evaluated in the log domain for
+     * a whole block at a time with vectorized log2/exp2; only the running
+     * maxima and the attack/release smoothing are serial.
+     *
+     * The limiter smooths with a moving average over the lookahead instead of
+     * an attack time constant, which makes it a true brickwall: no output
+     * sample exceeds the ceiling by more than float rounding.
+     *
+     * All channels share one detector (the maximum of their magnitudes) and
+     * thus one gain, so stereo images do not shift. State carries over between
+     * process() calls like FilterChain.
+     *
+     * @example
+     * Filter::DynamicsSettings settings;
+     * settings.mode = Filter::DYNAMICS_LIMITER;
+     * settings.threshold_db = -1.0f;
+     * Filter::Dynamics limiter(settings, 2);
+     * float* channels[2] = {left, right};
+     * limiter.process(channels, channels, 512);
+     */
+    class Dynamics {
+    public:
+        static constexpr int MAX_CHANNELS = 16;
+        /** @brief Frames of gain computed per vectorized pass */
+        static constexpr int BLOCK_FRAMES = 256;
+        static constexpr float MAX_LOOKAHEAD_MS = 500.0f;
+
+        /**
+         * @param settings Parameters; out-of-range values are clamped
+         * @param channels Channels processed together, clamped to [1, MAX_CHANNELS]
+         */
+        explicit Dynamics(const DynamicsSettings& settings = DynamicsSettings(), int channels = 1);
+
+        /**
+         * @brief Processes count frames of every channel, delayed by latency()
+         *
+         * @param input channels() pointers to count samples each
+         * @param output channels() pointers; output[c] == input[c] is allowed
+         */
+        void process(const float* const* input, float* const* output, int count);
+
+        /** @brief Single-channel process() */
+        void process(const float* input, float* output, int count);
+
+        /** @brief Empties the delay line and releases all gain reduction */
+        void reset();
+
+        /** @brief Samples the output lags the input */
+        int latency() const { return lookahead_; }
+        int channels() const { return channels_; }
+        const DynamicsSettings& settings() const { return settings_; }
+
+        /** @brief Gain applied to the last output sample in dB, makeup excluded */
+        float gainDb() const;
+
+    private:
+        void detect(const float* const* input, int count);
+        void smooth(int count);
+
+        DynamicsSettings settings_;
+        int channels_;
+        int lookahead_;
+        int delay_mask_;            // Delay ring length - 1, a power of two minus one
+        int average_mask_;
+        long long position_;        // Frames consumed so far
+        Resonix::SampleBuffer delay_;   // channels_ rings of delay_mask_ + 1 samples
+        Resonix::SampleBuffer scratch_; // Detector levels, then gains, of one block
+        Resonix::SampleBuffer average_; // Limiter: the last lookahead_ + 1 held gains
+        std::vector<float> segment_;    // Detector levels of the current window-long segment
+        std::vector<float> suffix_;     // Maxima from each frame to the end of the previous segment, then a floor
+        int segment_offset_;
+        float prefix_;                  // Maximum since the start of the current segment
+        double average_sum_;
+        float attack_coefficient_;
+        float release_coefficient_;
+        float makeup_;
+        float gain_;                // Smoother state: the gain of the last sample before the limiter average
+        float applied_;             // Gain of the last output sample, makeup excluded
+    };
+
+    /**
+     * @brief Runs count frames through a fresh Dynamics and compensates its latency
+     *
+     * output[c][i] lines up with input[c][i]; output[c] == input[c] is allowed.
+     */
+    void apply_dynamics(const float* const* input, float* const* output, int channels, int count, const DynamicsSettings& settings);
+}
+
+namespace Resonix {
+    /**
+     * @brief Compresses audio samples with a lookahead peak compressor
+     *
+     * @param samples Pointer to input audio samples
+     * @param sample_length Number of samples
+     * @param threshold_db Peak level above which the gain is reduced
+     * @param ratio Input dB per output dB above the threshold (>= 1)
+     * @param attack_ms Time constant of the gain reduction
+     * @param release_ms Time constant of the recovery
+     * @param lookahead_ms How far ahead peaks are seen; the output is aligned with the input
+     * @param stats Optional; receives analyze() statistics of the output
+     * @return SampleBuffer Compressed samples, or nullptr if an argument is invalid
+     *
+     * @example
+     * Resonix::SampleBuffer even = Resonix::compressor(samples, 44100, -18.0f, 3.0f);
+     */
+    SampleBuffer compressor(const float* samples, int sample_length, float threshold_db, float ratio = 4.0f, float attack_ms = 5.0f,
+                            float release_ms = 100.0f, float lookahead_ms = 5.0f, SignalStats* stats = nullptr);
+
+    /**
+     * @brief Brickwall-limits audio samples to a ceiling, see Filter::Dynamics
+     *
+     * @param ceiling_db Highest sample peak of the output
+     * @param release_ms Time constant of the recovery
+     * @param lookahead_ms Length of the fade into each gain reduction
+     * @return SampleBuffer Limited samples, or nullptr if an argument is invalid
+     *
+     * @example
+     * // Peak-safe master before 16-bit export
+     * Resonix::SampleBuffer master = Resonix::limiter(mix, frames, -1.0f);
+     */
+    SampleBuffer limiter(const float* samples, int sample_length, float ceiling_db = -1.0f, float release_ms = 50.0f,
+                         float lookahead_ms = 5.0f, SignalStats* stats = nullptr);
+
+    /**
+     * @brief Gates audio samples below a threshold, see Filter::Dynamics
+     *
+     * The gain falls by 20 dB per dB below threshold_db, so the gate closes
+     * over a few dB; use Filter::DynamicsSettings for a gentler expander.
+     *
+     * @param range_db Attenuation of a closed gate
+     * @param attack_ms Time constant of the opening
+     * @param release_ms Time constant of the closing
+     * @return SampleBuffer Gated samples, or nullptr if an argument is invalid
+     */
+    SampleBuffer gate(const float* samples, int sample_length, float threshold_db, float range_db = -80.0f, float attack_ms = 1.0f,
+                      float release_ms = 100.0f, float lookahead_ms = 5.0f, SignalStats* stats = nullptr);
+
+    /**
+     * @brief Applies dynamics to every channel of a buffer in place, with one linked gain
+     *
+     * @return bool false if the buffer is empty or has more than Filter::Dynamics::MAX_CHANNELS channels
+     */
+    bool dynamics(AudioBuffer& buffer, const Filter::DynamicsSettings& settings);
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Modulation.hpp"
+#include "Resonix.hpp"
+
+namespace Resonix {
+    /**
+     * @class ModulatedOscillator
+     * @brief Phase-accumulating oscillator driven at audio rate
+     *
+     * Unlike Oscillator, whose phase follows from the sample index, this one
+     * carries a running phase, so its frequency can change on every sample:
+     * vibrato, glides and frequency modulation come from a buffer of
+     * frequencies, phase modulation from a buffer of phase offsets. The phase
+     * is kept in cycles in [0, 1) and wraps by subtraction; only the frequency
+     * path integrates sample by sample, everything else is vectorized.
+     *
+     * @example
+     * Resonix::ModulatedOscillator carrier(Resonix::SINE, 440.0f);
+     * Resonix::ModulatedOscillator vibrato(Resonix::SINE, 5.0f);
+     * float frequency[512], block[512];
+     * vibrato.render(frequency, 512);
+     * for (float& f : frequency) f = 440.0f + 6.0f * f;
+     * carrier.renderFM(block, 512, frequency);
+     */
+    class ModulatedOscillator {
+    public:
+        /**
+         * @param shape SINE, COSINE, SQUARE, TRIANGLE or SAWTOOTH; other shapes render silence
+         * @param frequency Frequency in Hz used by render() and renderPM()
+         * @param phase Starting phase in cycles
+         */
+        explicit ModulatedOscillator(Shape shape = SINE, float frequency = 0.0f, float phase = 0.0f);
+
+        /** @brief Renders count samples at the constant frequency */
+        void render(float* output, int count);
+
+        /**
+         * @brief Renders count samples with a per-sample frequency
+         *
+         * @param frequency count frequencies in Hz; negative values run the phase
+         *                  backwards. May be the same buffer as output
+         */
+        void renderFM(float* output, int count, const float* frequency);
+
+        /**
+         * @brief Renders count samples at the constant frequency with phase modulation
+         *
+         * @param modulation count modulator samples
+         * @param depth Phase offset in radians per unit of modulation, the modulation index
+         */
+        void renderPM(float* output, int count, const float* modulation, float depth = 1.0f);
+
+        /**
+         * @brief render(), renderFM() and renderPM() multiplied by an Envelope or LFO
+         *
+         * The gain is applied inside the waveform loop, so it costs one
+         * multiply-add per sample and no pass of its own. The source advances
+         * by count samples.
+         */
+        template <typename Source>
+        void render(float* output, int count, Source& gain);
+
+        template <typename Source>
+        void renderFM(float* output, int count, const float* frequency, Source& gain);
+
+        template <typename Source>
+        void renderPM(float* output, int count, const float* modulation, float depth, Source& gain);
+
+        void setFrequency(float frequency) { frequency_ = frequency; }
+        void setPhase(float phase);
+
+        Shape shape() const { return shape_; }
+        float frequency() const { return frequency_; }
+        float phase() const { return static_cast<float>(phase_); }
+
+    private:
+        void renderPhase(float* output, int count, const float* modulation, float depth_cycles, float gain, float gain_step);
+        void integrate(float* output, int count, const float* frequency);
+        void shape(float* cycles, int count, float gain, float gain_step) const;
+
+        Shape shape_;
+        float frequency_;
+        double phase_;      // Cycles in [0, 1); double so long streams do not drift
+    };
+
+    /** @brief Most operators an FMVoice can have */
+    constexpr int MAX_OPERATORS = 6;
+
+    /**
+     * @struct FMOperator
+     * @brief Settings of one FMVoice operator
+     */
+    struct FMOperator {
+        Shape shape = SINE;
+        float ratio = 1.0f;         // Frequency as a multiple of the voice frequency
+        float frequency = 0.0f;     // Fixed frequency in Hz; overrides ratio when positive
+        float feedback = 0.0f;      // Self-modulation index in radians
+        float output = 0.0f;        // Gain into the voice output; 0 for pure modulators
+    };
+
+    /**
+     * @class FMVoice
+     * @brief Phase-modulation synthesizer of 2 to 6 operators, in the style of classic FM
+     *
+     * Operator i may be modulated by any operator j > i, each with its own
+     * index in radians, so every classic stack, branch and parallel algorithm
+     * can be built; the voice output is the sum of the operators weighted by
+     * their output gain. Operators are computed from the last to the first,
+     * a whole block at a time: each one reads the finished blocks of its
+     * modulators, so every operator is a single vectorized pass. Only
+     * operators with feedback run sample by sample.
+     *
+     * @example
+     * Resonix::FMVoice bell(2, 220.0f);
+     * Resonix::FMOperator carrier, modulator;
+     * carrier.output = 0.5f;
+     * modulator.ratio = 3.5f;
+     * bell.setOperator(0, carrier);
+     * bell.setOperator(1, modulator);
+     * bell.setModulation(0, 1, 4.0f);
+     * float block[512];
+     * bell.render(block, 512);
+     */
+    class FMVoice {
+    public:
+        /** @brief Frames per operator block */
+        static constexpr int BLOCK_FRAMES = 256;
+
+        /**
+         * @param operators Number of operators, clamped to [1, MAX_OPERATORS]; all start as
+         *                  silent sine operators at ratio 1
+         * @param frequency Voice frequency in Hz
+         */
+        explicit FMVoice(int operators = 2, float frequency = 0.0f);
+
+        /** @return bool false if index is out of range or the shape is not tonal */
+        bool setOperator(int index, const FMOperator& settings);
+
+        /**
+         * @brief Sets how strongly source modulates target
+         *
+         * @param index Peak phase deviation in radians per unit of source output
+         * @return bool false unless 0 <= target < source < operators(); use
+         * FMOperator::feedback for self-modulation
+         */
+        bool setModulation(int target, int source, float index);
+
+        void setFrequency(float frequency) { frequency_ = frequency; }
+
+        /** @brief Renders the next count samples of the voice output */
+        void render(float* output, int count);
+
+        /** @brief Restarts every operator at phase 0 and clears the feedback memory */
+        void reset();
+
+        int operators() const { return operator_count_; }
+        float frequency() const { return frequency_; }
+        const FMOperator& getOperator(int index) const { return operators_[index]; }
+
+    private:
+        void renderBlock(float* output, int count);
+
+        int operator_count_;
+        float frequency_;
+        FMOperator operators_[MAX_OPERATORS];
+        float modulation_[MAX_OPERATORS][MAX_OPERATORS];    // [target][source] in cycles
+        double phases_[MAX_OPERATORS];
+        float feedback_[MAX_OPERATORS][2];                  // Last two outputs of each operator
+        SampleBuffer blocks_;                               // One block per operator, then the modulation sum
+    };
+}
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <type_traits>
+#include <vector>
 #include "Math.hpp"
+#include "Analysis.hpp"
 #include "Resonix.hpp"
 
 namespace Filter {
@@ -9,20 +13,32 @@ namespace Filter {
         float b0, b1, b2, a1, a2;
         float x1, x2, y1, y2;
 
+        /**
+         * @brief Coefficients and state of process<double>
+         *
+         * The design functions compute the coefficients again in double
+         * precision, and the state carries over between calls unrounded, so
+         * double buffers are filtered natively rather than through the float
+         * filter above. setCoefficients() sets them to the float values.
+         */
+        struct Precise {
+            double b0, b1, b2, a1, a2;
+            double x1, x2, y1, y2;
+        } precise;
+
         BiquadFilter() {
             reset();
         }
 
         void reset() {
-            b0 = 1.0f;
-            b1 = 0.0f;
-            b2 = 0.0f;
-            a1 = 0.0f;
-            a2 = 0.0f;
-            x1 = 0.0f;
-            x2 = 0.0f;
-            y1 = 0.0f;
-            y2 = 0.0f;
+            setCoefficients(1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+            clear();
+        }
+
+        /** @brief Zeroes the state of both precisions, keeping the coefficients */
+        void clear() {
+            x1 = x2 = y1 = y2 = 0.0f;
+            precise.x1 = precise.x2 = precise.y1 = precise.y2 = 0.0;
         }
 
         void setCoefficients(float b0_, float b1_, float b2_, float a1_, float a2_) {
@@ -31,6 +47,16 @@ namespace Filter {
             b2 = b2_;
             a1 = a1_;
             a2 = a2_;
+            setPreciseCoefficients(b0_, b1_, b2_, a1_, a2_);
+        }
+
+        /** @brief Sets the coefficients of process<double> only */
+        void setPreciseCoefficients(double b0_, double b1_, double b2_, double a1_, double a2_) {
+            precise.b0 = b0_;
+            precise.b1 = b1_;
+            precise.b2 = b2_;
+            precise.a1 = a1_;
+            precise.a2 = a2_;
         }
 
         float process(float input) {
@@ -43,13 +69,173 @@ namespace Filter {
 
             return output;
         }
+
+        /** @brief Filters a contiguous block, with a kernel picked per CPU (see RESONIX_CLONES) */
+        void process(const float* input, float* output, int count);
+
+        /**
+         * @brief Filters count samples read and written with element strides
+         *
+         * Runs in the precision of T: float uses the members above, double
+         * the double-precision coefficients and state in precise. Safe for
+         * input == output with equal strides.
+         */
+        template <typename T>
+        void process(const T* input, std::ptrdiff_t input_stride, T* output, std::ptrdiff_t output_stride, int count) {
+            if constexpr (std::is_same_v<T, double>)
+                run(precise, input, input_stride, output, output_stride, count);
+            else
+                run(*this, input, input_stride, output, output_stride, count);
+        }
+
+    private:
+        template <typename Terms, typename T>
+        static void run(Terms& terms, const T* input, std::ptrdiff_t input_stride, T* output, std::ptrdiff_t output_stride, int count) {
+            const T c0 = terms.b0, c1 = terms.b1, c2 = terms.b2, d1 = terms.a1, d2 = terms.a2;
+            T sx1 = terms.x1, sx2 = terms.x2, sy1 = terms.y1, sy2 = terms.y2;
+            T in, out;
+
+            // Coefficients and state kept in registers for the whole block
+            for (int i = 0; i < count; i++) {
+                in = input[i * input_stride];
+                out = c0 * in + c1 * sx1 + c2 * sx2 - d1 * sy1 - d2 * sy2;
+
+                sx2 = sx1;
+                sx1 = in;
+                sy2 = sy1;
+                sy1 = out;
+
+                output[i * output_stride] = out;
+            }
+
+            terms.x1 = sx1;
+            terms.x2 = sx2;
+            terms.y1 = sy1;
+            terms.y2 = sy2;
+        }
+    };
+
+    struct FormantFilter {
+        static constexpr int NUM_FORMANTS = 4;
+
+        BiquadFilter bands[NUM_FORMANTS];
+        float weights[NUM_FORMANTS];
+        float mix;
+
+        FormantFilter() : weights{1.0f, 0.85f, 0.7f, 0.55f}, mix(0.0f) {}
+
+        void setup(float peak, float mix_, float spread);
+
+        void reset() {
+            for (BiquadFilter& band : bands) {
+                band.clear();
+            }
+        }
+
+        void process(const float* input, float* output, int count);
+
+        /** @brief Strided form of process(), computed in the precision of T */
+        template <typename T>
+        void process(const T* input, std::ptrdiff_t input_stride, T* output, std::ptrdiff_t output_stride, int count) {
+            constexpr int CHUNK = 256;
+            T accumulator[CHUNK], band_output[CHUNK];
+            const T normalization = 0.5f;
+            int start, length, f, i;
+
+            // Bands are summed per cache-resident chunk, so input == output is allowed
+            for (start = 0; start < count; start += CHUNK) {
+                length = count - start < CHUNK ? count - start : CHUNK;
+
+                for (i = 0; i < length; i++) {
+                    accumulator[i] = 0.0f;
+                }
+
+                for (f = 0; f < NUM_FORMANTS; f++) {
+                    bands[f].process(input + start * input_stride, input_stride, band_output, 1, length);
+                    for (i = 0; i < length; i++) {
+                        accumulator[i] += band_output[i] * static_cast<T>(weights[f]);
+                    }
+                }
+
+                for (i = 0; i < length; i++) {
+                    output[(start + i) * output_stride] = input[(start + i) * input_stride] * static_cast<T>(1.0f - mix)
+                                                        + accumulator[i] * normalization * static_cast<T>(mix);
+                }
+            }
+        }
     };
 
-	std::unique_ptr<float[]> apply_bandpass_filter(const float* samples, int sample_length, float center_hz, float bandwidth_hz, float resonance);
+    /**
+     * @class FilterChain
+     * @brief Serial chain of biquad and formant stages with persistent state
+     *
+     * Each process() call continues where the previous one stopped, so a long
+     * stream can be filtered block by block with the same result as one call
+     * over the whole buffer. The first stage reads the input and the others run
+     * in place on the output, so no intermediate buffers are needed.
+     */
+    class FilterChain {
+    public:
+        void addBiquad(const BiquadFilter& filter);
+        void addFormant(const FormantFilter& filter);
+
+        /** @brief Filters count samples; input == output is allowed */
+        void process(const float* input, float* output, int count);
+
+        /** @brief Clears the state of every stage, keeping the coefficients */
+        void reset();
+
+        int size() const { return static_cast<int>(stages_.size()); }
+
+    private:
+        struct Stage {
+            bool is_formant;
+            BiquadFilter biquad;
+            FormantFilter formant;
+        };
+
+        std::vector<Stage> stages_;
+    };
+
+    BiquadFilter make_bandpass_filter(float center_hz, float bandwidth_hz, float resonance);
+
+    BiquadFilter make_lowpass_filter(float cutoff_hz, float resonance);
+
+    BiquadFilter make_highpass_filter(float cutoff_hz, float resonance);
+
+    /** @brief Block length of filter calls that also collect statistics */
+    constexpr int STATS_BLOCK_LENGTH = 4096;
+
+    /**
+     * @brief Runs a filter over a buffer, optionally collecting output statistics
+     *
+     * With stats set, the buffer is filtered in STATS_BLOCK_LENGTH blocks and
+     * each block is analyzed right after it is written, while still in cache.
+     */
+    template <typename Processor>
+    void process_with_stats(Processor& filter, const float* input, float* output, int count, Resonix::SignalStats* stats) {
+        Resonix::StatsAccumulator accumulator;
+        int start, length;
+
+        if (!stats) {
+            filter.process(input, output, count);
+            return;
+        }
+
+        for (start = 0; start < count; start += length) {
+            length = count - start < STATS_BLOCK_LENGTH ? count - start : STATS_BLOCK_LENGTH;
+            filter.process(input + start, output + start, length);
+            accumulator.add(output + start, length);
+        }
+
+        *stats = accumulator.result();
+    }
+
+	Resonix::SampleBuffer apply_bandpass_filter(const float* samples, int sample_length, float center_hz, float bandwidth_hz, float resonance, Resonix::SignalStats* stats = nullptr);
 
-    std::unique_ptr<float[]> apply_lowpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance);
+    Resonix::SampleBuffer apply_lowpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance, Resonix::SignalStats* stats = nullptr);
 
-    std::unique_ptr<float[]> apply_highpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance);
+    Resonix::SampleBuffer apply_highpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance, Resonix::SignalStats* stats = nullptr);
 
-    std::unique_ptr<float[]> apply_formant_filter(const float* samples, int sample_length, float peak, float mix, float spread);
+    Resonix::SampleBuffer apply_formant_filter(const float* samples, int sample_length, float peak, float mix, float spread, Resonix::SignalStats* stats = nullptr);
 }
\ No newline at end of file
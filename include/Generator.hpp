@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include "BufferPool.hpp"
 
 /**
  * @namespace Generator
@@ -11,9 +12,29 @@
  * various waveform types used in synthesis and signal processing.
  *
  * All generators use phase accumulation for accurate frequency generation
- * and return dynamically allocated buffers that must be freed by the caller.
+ * and return 64-byte aligned buffers from Resonix::BufferPool, returned to the
+ * pool when the SampleBuffer handle is destroyed.
+ *
+ * Every waveform also has a block overload that writes `count` samples starting
+ * at absolute sample index `offset` into a caller-provided buffer. The phase is
+ * derived from the absolute index, so a signal rendered block by block matches
+ * a single call up to float rounding; streaming and graph processing build on it.
  */
 namespace Generator {
+    /** @brief Block length used when whole-buffer generators fill their output */
+    constexpr int BLOCK_LENGTH = 4096;
+
+    /**
+     * @brief Returns the waveform position at an absolute sample index
+     *
+     * @param offset Absolute sample index
+     * @param frequency Frequency of the waveform in Hz
+     * @return float Fractional cycle position in range [0.0, 1.0)
+     *
+     * @note Computed in double precision so long streams keep an accurate phase
+     */
+    float cycleAt(long long offset, float frequency);
+
     /**
      * @brief Generates a sine wave
      *
@@ -23,14 +44,25 @@ namespace Generator {
      * @param sample_length Number of samples to generate
      * @param frequency Frequency of the waveform in Hz
      * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @warning Returns nullptr if allocation fails
      *
      * @see Cosine(), Square(), Triangle()
      */
-    std::unique_ptr<float[]> Sine(int sample_length, float frequency, const float phaseIncrement);
+    Resonix::SampleBuffer Sine(int sample_length, float frequency, const float phaseIncrement);
+
+    /**
+     * @brief Renders a block of the Sine() waveform
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param frequency Frequency of the waveform in Hz
+     * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
+     */
+    void Sine(float* output, long long offset, int count, float frequency, const float phaseIncrement);
 
     /**
      * @brief Generates a square wave
@@ -41,14 +73,25 @@ namespace Generator {
      * @param sample_length Number of samples to generate
      * @param frequency Frequency of the waveform in Hz
      * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of samples (values: -1.0 or 1.0)
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples (values: -1.0 or 1.0)
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @warning Returns nullptr if allocation fails
      *
      * @see Triangle(), Sawtooth()
      */
-    std::unique_ptr<float[]> Square(int sample_length, float frequency, const float phaseIncrement);
+    Resonix::SampleBuffer Square(int sample_length, float frequency, const float phaseIncrement);
+
+    /**
+     * @brief Renders a block of the Square() waveform
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param frequency Frequency of the waveform in Hz
+     * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
+     */
+    void Square(float* output, long long offset, int count, float frequency, const float phaseIncrement);
 
     /**
      * @brief Generates a triangle wave
@@ -59,14 +102,25 @@ namespace Generator {
      * @param sample_length Number of samples to generate
      * @param frequency Frequency of the waveform in Hz
      * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @warning Returns nullptr if allocation fails
      *
      * @see Square(), Sawtooth()
      */
-    std::unique_ptr<float[]> Triangle(int sample_length, float frequency, const float phaseIncrement);
+    Resonix::SampleBuffer Triangle(int sample_length, float frequency, const float phaseIncrement);
+
+    /**
+     * @brief Renders a block of the Triangle() waveform
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param frequency Frequency of the waveform in Hz
+     * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
+     */
+    void Triangle(float* output, long long offset, int count, float frequency, const float phaseIncrement);
 
     /**
      * @brief Generates a sawtooth wave
@@ -77,14 +131,25 @@ namespace Generator {
      * @param sample_length Number of samples to generate
      * @param frequency Frequency of the waveform in Hz
      * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @warning Returns nullptr if allocation fails
      *
      * @see Triangle(), Square()
      */
-    std::unique_ptr<float[]> Sawtooth(int sample_length, float frequency, const float phaseIncrement);
+    Resonix::SampleBuffer Sawtooth(int sample_length, float frequency, const float phaseIncrement);
+
+    /**
+     * @brief Renders a block of the Sawtooth() waveform
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param frequency Frequency of the waveform in Hz
+     * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
+     */
+    void Sawtooth(float* output, long long offset, int count, float frequency, const float phaseIncrement);
 
     /**
      * @brief Generates a cosine wave
@@ -95,14 +160,25 @@ namespace Generator {
      * @param sample_length Number of samples to generate
      * @param frequency Frequency of the waveform in Hz
      * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @warning Returns nullptr if allocation fails
      *
      * @see Sine(), Tangent()
      */
-    std::unique_ptr<float[]> Cosine(int sample_length, float frequency, const float phaseIncrement);
+    Resonix::SampleBuffer Cosine(int sample_length, float frequency, const float phaseIncrement);
+
+    /**
+     * @brief Renders a block of the Cosine() waveform
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param frequency Frequency of the waveform in Hz
+     * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
+     */
+    void Cosine(float* output, long long offset, int count, float frequency, const float phaseIncrement);
 
     /**
      * @brief Generates a tangent wave
@@ -113,15 +189,26 @@ namespace Generator {
      * @param sample_length Number of samples to generate
      * @param frequency Frequency of the waveform in Hz
      * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of samples
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @warning Contains discontinuities; output is not band-limited
      * @warning Returns nullptr if allocation fails
      *
      * @see Cotangent(), Sine()
      */
-    std::unique_ptr<float[]> Tangent(int sample_length, float frequency, const float phaseIncrement);
+    Resonix::SampleBuffer Tangent(int sample_length, float frequency, const float phaseIncrement);
+
+    /**
+     * @brief Renders a block of the Tangent() waveform
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param frequency Frequency of the waveform in Hz
+     * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
+     */
+    void Tangent(float* output, long long offset, int count, float frequency, const float phaseIncrement);
 
     /**
      * @brief Generates a cotangent wave
@@ -132,15 +219,26 @@ namespace Generator {
      * @param sample_length Number of samples to generate
      * @param frequency Frequency of the waveform in Hz
      * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of samples
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @warning Contains discontinuities; output is not band-limited
      * @warning Returns nullptr if allocation fails
      *
      * @see Tangent(), Cosine()
      */
-    std::unique_ptr<float[]> Cotangent(int sample_length, float frequency, const float phaseIncrement);
+    Resonix::SampleBuffer Cotangent(int sample_length, float frequency, const float phaseIncrement);
+
+    /**
+     * @brief Renders a block of the Cotangent() waveform
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param frequency Frequency of the waveform in Hz
+     * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
+     */
+    void Cotangent(float* output, long long offset, int count, float frequency, const float phaseIncrement);
 
     /**
      * @brief Generates a Hann window function
@@ -152,15 +250,27 @@ namespace Generator {
      * @param sample_length Number of samples to generate
      * @param frequency Frequency of the window cycle in Hz
      * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of samples in range [0.0, 1.0]
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples in range [0.0, 1.0]
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @note Output range is [0.0, 1.0] unlike other generators
      * @warning Returns nullptr if allocation fails
      *
      * @see Phased_Hann()
      */
-    std::unique_ptr<float[]> Hann(int sample_length, float frequency, const float phaseIncrement);
+    Resonix::SampleBuffer Hann(int sample_length, float frequency, const float phaseIncrement);
+
+    /**
+     * @brief Renders a block of the Hann() waveform
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param frequency Frequency of the waveform in Hz
+     * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
+     * @param window_length Total length of the Hann window in samples
+     */
+    void Hann(float* output, long long offset, int count, float frequency, const float phaseIncrement, long long window_length);
 
     /**
      * @brief Generates a phase-shifted Hann window function
@@ -172,13 +282,116 @@ namespace Generator {
      * @param sample_length Number of samples to generate
      * @param frequency Frequency of the window cycle in Hz
      * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of samples in range [0.0, 1.0]
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples in range [0.0, 1.0]
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @note Output range is [0.0, 1.0] unlike other generators
      * @warning Returns nullptr if allocation fails
      *
      * @see Hann()
      */
-    std::unique_ptr<float[]> Phased_Hann(int sample_length, float frequency, const float phaseIncrement);
-}
\ No newline at end of file
+    Resonix::SampleBuffer Phased_Hann(int sample_length, float frequency, const float phaseIncrement);
+
+    /**
+     * @brief Renders a block of the Phased_Hann() waveform
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param frequency Frequency of the waveform in Hz
+     * @param phaseIncrement Phase increment per sample (2π * frequency / sample_rate)
+     * @param window_length Total length of the Hann window in samples
+     */
+    void Phased_Hann(float* output, long long offset, int count, float frequency, const float phaseIncrement, long long window_length);
+
+    /**
+     * @brief Running state that lets consecutive BrownNoise() blocks skip their warm-up
+     */
+    struct BrownNoiseState {
+        long long position = -1;  ///< Sample index the state continues at, -1 if unset
+        float current = 0.0f;     ///< Integrator of the current cell
+        float next = 0.0f;        ///< Integrator started at the current cell boundary
+    };
+
+    /**
+     * @brief Generates uniform white noise
+     *
+     * Samples come from a counter-based Philox4x32-10 generator keyed by the
+     * seed and indexed by the absolute sample position, so any block of the
+     * stream can be produced independently: chunked and multi-threaded
+     * generation give bit-identical results.
+     *
+     * @param sample_length Number of samples to generate
+     * @param seed Stream selector; equal seeds give equal noise
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples in range [-1.0, 1.0)
+     *
+     * @see PinkNoise(), BrownNoise()
+     */
+    Resonix::SampleBuffer WhiteNoise(int sample_length, unsigned long long seed);
+
+    /**
+     * @brief Renders a block of the WhiteNoise() stream
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param seed Stream selector
+     */
+    void WhiteNoise(float* output, long long offset, int count, unsigned long long seed);
+
+    /**
+     * @brief Generates pink (1/f) noise
+     *
+     * Voss-McCartney algorithm with 16 rows: row k holds a random value that
+     * changes every 2^k samples. Each row value is drawn from the counter-based
+     * generator by its own index, so the stream stays stateless and blocks
+     * can be rendered in any order.
+     *
+     * @param sample_length Number of samples to generate
+     * @param seed Stream selector
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples in range [-1.0, 1.0)
+     *
+     * @note The rows are averaged, so the RMS level is about 0.15
+     */
+    Resonix::SampleBuffer PinkNoise(int sample_length, unsigned long long seed);
+
+    /**
+     * @brief Renders a block of the PinkNoise() stream
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param seed Stream selector
+     */
+    void PinkNoise(float* output, long long offset, int count, unsigned long long seed);
+
+    /**
+     * @brief Generates brown (1/f^2) noise
+     *
+     * Leaky integration of WhiteNoise() with a 20 Hz corner. To stay
+     * reproducible under chunking, the stream is split into cells many time
+     * constants long and every sample integrates from the start of the
+     * previous cell; the dropped history is far below float resolution.
+     *
+     * @param sample_length Number of samples to generate
+     * @param seed Stream selector
+     * @return Resonix::SampleBuffer Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
+     *
+     * @note Scaled to an RMS level of 0.25 and clipped to [-1.0, 1.0]
+     */
+    Resonix::SampleBuffer BrownNoise(int sample_length, unsigned long long seed);
+
+    /**
+     * @brief Renders a block of the BrownNoise() stream
+     *
+     * Without a state, or when offset is not where the state stopped, the
+     * integrators are rebuilt from the previous cell boundary first.
+     *
+     * @param output Destination buffer of at least count samples
+     * @param offset Absolute index of the first sample to render
+     * @param count Number of samples to render
+     * @param seed Stream selector
+     * @param state Optional running state for contiguous streaming
+     */
+    void BrownNoise(float* output, long long offset, int count, unsigned long long seed, BrownNoiseState* state = nullptr);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @def RESONIX_PROFILE
+ * @brief Times the rest of the enclosing block as one call of a named stage
+ *
+ * name must be a string literal or another string that lives as long as the
+ * program: stages are told apart by its address.
+ * frames is the number of frames the call processes. Nested scopes all
+ * count, so a stage's time includes the stages it calls.
+ *
+ * Both macros expand to nothing unless the library is built with
+ * RESONIX_INSTRUMENT defined (the RESONIX_INSTRUMENT CMake option, or the
+ * environment variable of the same name for setup.py); the arguments are then
+ * not even evaluated.
+ */
+/**
+ * @def RESONIX_PROFILE_BYTES
+ * @brief Charges an allocation of the given size to the innermost open stage
+ */
+#ifdef RESONIX_INSTRUMENT
+#define RESONIX_PROFILE_JOIN2(a, b) a##b
+#define RESONIX_PROFILE_JOIN(a, b) RESONIX_PROFILE_JOIN2(a, b)
+#define RESONIX_PROFILE(name, frames) \
+    ::Resonix::Instrument::Scope RESONIX_PROFILE_JOIN(resonix_profile_, __LINE__)(name, static_cast<long long>(frames))
+#define RESONIX_PROFILE_BYTES(bytes) ::Resonix::Instrument::Scope::addBytes(bytes)
+#else
+#define RESONIX_PROFILE(name, frames) static_cast<void>(0)
+#define RESONIX_PROFILE_BYTES(bytes) static_cast<void>(0)
+#endif
+
+namespace Resonix {
+    /**
+     * @struct StageStats
+     * @brief Accumulated counters of one API function or graph stage
+     */
+    struct StageStats {
+        std::string name;
+        unsigned long long calls = 0;
+        unsigned long long frames = 0;
+        unsigned long long bytes = 0;   // Requested from the buffer pool while the stage ran
+        double total_ms = 0.0;          // Wall time of all calls
+        double max_ms = 0.0;            // Longest single call
+    };
+
+    /**
+     * @struct Stats
+     * @brief Snapshot of every stage that ran since the last resetStats()
+     */
+    struct Stats {
+        bool enabled = false;           // false when built without RESONIX_INSTRUMENT
+        std::vector<StageStats> stages; // Sorted by total time, longest first
+    };
+
+    /**
+     * @brief Collects the counters of all threads
+     *
+     * Counters are recorded without locks into per-thread tables, so the
+     * snapshot may miss calls still in flight on other threads.
+     *
+     * @return Stats Empty and disabled when instrumentation is compiled out
+     */
+    Stats stats();
+
+    /** @brief Zeroes all counters and drops the recorded trace; call while no stage is running */
+    void resetStats();
+
+    /**
+     * @brief Starts or stops recording every call for writeTrace
+     *
+     * Off by default. Each thread keeps the first TRACE_CAPACITY calls and
+     * drops the rest until resetStats().
+     */
+    void setTracing(bool enabled);
+
+    /**
+     * @brief Writes the recorded calls as Chrome trace JSON
+     *
+     * The file opens in chrome://tracing or Perfetto, with one track per thread.
+     *
+     * @param path Output file
+     * @return bool false when the file cannot be written or instrumentation is compiled out
+     */
+    bool writeTrace(const std::string& path);
+
+    namespace Instrument {
+        /** @brief Calls each thread can record for writeTrace */
+        constexpr size_t TRACE_CAPACITY = size_t(1) << 16;
+
+#ifdef RESONIX_INSTRUMENT
+        /** @brief Use through RESONIX_PROFILE */
+        class Scope {
+        public:
+            Scope(const char* name, long long frames);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            static void addBytes(size_t bytes);
+
+        private:
+            const char* name_;
+            long long frames_;
+            unsigned long long start_;
+            unsigned long long bytes_;
+            Scope* parent_;
+        };
+#endif
+    }
+}
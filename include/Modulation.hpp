@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include "Filter.hpp"
+#include "Resonix.hpp"
+
+namespace Resonix {
+    /** @brief Samples between two evaluations of a curved modulation source */
+    constexpr int CONTROL_PERIOD = 32;
+
+    /**
+     * @struct Ramp
+     * @brief A stretch of a modulation source: sample i is start + i * delta
+     */
+    struct Ramp {
+        float start = 0.0f;
+        float delta = 0.0f;
+        int frames = 0;
+    };
+
+    /** @brief Multiplies count samples by start + i * delta; input == output is allowed */
+    void multiplyRamp(const float* input, float* output, float start, float delta, int count);
+
+    /**
+     * @enum EnvelopeCurve
+     * @brief Shape of the decay and release segments of an Envelope
+     */
+    enum EnvelopeCurve {
+        ENVELOPE_LINEAR,      ///< Straight lines, reaching their target in exactly the set time
+        ENVELOPE_EXPONENTIAL  ///< Exponentials falling 60 dB in the set time; the attack stays linear
+    };
+
+    /**
+     * @enum EnvelopeStage
+     * @brief Segment an Envelope is in
+     */
+    enum EnvelopeStage {
+        ENVELOPE_IDLE,
+        ENVELOPE_ATTACK,
+        ENVELOPE_DECAY,
+        ENVELOPE_SUSTAIN,
+        ENVELOPE_RELEASE
+    };
+
+    /**
+     * @class Envelope
+     * @brief Streaming ADSR envelope evaluated at block rate
+     *
+     * next() hands out the envelope as linear ramps: linear segments as one
+     * exact ramp up to the next stage change, exponential ones as a ramp per
+     * CONTROL_PERIOD between exactly computed points. Consumers multiply by
+     * start + i * delta inside their own sample loop, so the envelope costs one
+     * multiply-add per sample and no buffer. Oscillator::render() and the
+     * ModulatedOscillator renders take an Envelope as their gain; apply() does
+     * the same for a block that is already rendered.
+     *
+     * @example
+     * Resonix::Oscillator osc(Resonix::SAWTOOTH, 110.0f);
+     * Resonix::Envelope envelope(0.01f, 0.2f, 0.6f, 0.5f);
+     * float block[512];
+     * envelope.noteOn();
+     * osc.render(block, 512, envelope);
+     */
+    class Envelope {
+    public:
+        /**
+         * @param attack Seconds from 0 to 1
+         * @param decay Seconds from 1 to sustain
+         * @param sustain Level held until noteOff(), in [0, 1]
+         * @param release Seconds from the level at noteOff() to 0
+         * @param curve Shape of the decay and release
+         */
+        explicit Envelope(float attack = 0.01f, float decay = 0.1f, float sustain = 0.7f, float release = 0.2f,
+                          EnvelopeCurve curve = ENVELOPE_LINEAR);
+
+        /** @brief Starts the attack from the current level */
+        void noteOn();
+
+        /** @brief Starts the release from the current level; ignored while idle */
+        void noteOff();
+
+        /** @brief Drops to idle at level 0 */
+        void reset();
+
+        /**
+         * @brief Advances by up to frames samples
+         *
+         * @return Ramp The next stretch, at least one sample long; it ends at a
+         * stage change or after CONTROL_PERIOD samples of a curved segment
+         */
+        Ramp next(int frames);
+
+        /** @brief Writes the next count envelope values */
+        void render(float* output, int count);
+
+        /** @brief Multiplies count samples by the envelope; input == output is allowed */
+        void apply(const float* input, float* output, int count);
+
+        EnvelopeStage stage() const { return stage_; }
+        bool active() const { return stage_ != ENVELOPE_IDLE; }
+        float value() const { return value_; }
+
+    private:
+        EnvelopeCurve curve_;
+        float sustain_;
+        float attack_step_;     // Level change per sample; 0 jumps straight to the target
+        float decay_step_;
+        long long release_frames_;
+        float release_step_;    // Set from the level at noteOff()
+        float decay_factor_;    // Per-sample factor of the exponential segments
+        float release_factor_;
+        EnvelopeStage stage_;
+        float value_;
+    };
+
+    /**
+     * @class LFO
+     * @brief Streaming low-frequency oscillator evaluated at block rate
+     *
+     * The waveform is evaluated every CONTROL_PERIOD samples and linearly
+     * interpolated between, which also rounds off the edges of SQUARE and
+     * SAWTOOTH. Its output is offset + depth * waveform.
+     *
+     * @example
+     * Resonix::LFO tremolo(Resonix::SINE, 5.0f, 0.3f, 0.7f);
+     * osc.render(block, 512, tremolo);
+     */
+    class LFO {
+    public:
+        /**
+         * @param shape SINE, COSINE, SQUARE, TRIANGLE or SAWTOOTH; other shapes output offset
+         * @param frequency Rate in Hz
+         * @param depth Amplitude of the waveform
+         * @param offset Value the waveform swings around
+         * @param phase Starting phase in cycles
+         */
+        explicit LFO(Shape shape = SINE, float frequency = 1.0f, float depth = 1.0f, float offset = 0.0f, float phase = 0.0f);
+
+        /** @brief Advances by up to frames samples, at most CONTROL_PERIOD */
+        Ramp next(int frames);
+
+        /** @brief Writes the next count values */
+        void render(float* output, int count);
+
+        /** @brief Multiplies count samples by the LFO (tremolo); input == output is allowed */
+        void apply(const float* input, float* output, int count);
+
+        void setPhase(float phase);
+
+        Shape shape() const { return shape_; }
+        float frequency() const { return frequency_; }
+        float phase() const { return static_cast<float>(phase_); }
+
+    private:
+        float at(double phase) const;
+
+        Shape shape_;
+        float frequency_;
+        float depth_;
+        float offset_;
+        double phase_;          // Cycles in [0, 1)
+        float value_;           // Output at phase_
+    };
+
+    /** @brief Highest cutoff a modulated filter is designed for, as a fraction of SAMPLE_RATE */
+    constexpr float MAX_SWEEP_CUTOFF = 0.45f;
+
+    /**
+     * @brief Filters count samples with a cutoff that follows a modulation source
+     *
+     * The cutoff of each ramp is cutoff_hz * 2^(octaves * value) at its start,
+     * clamped to [10 Hz, MAX_SWEEP_CUTOFF * SAMPLE_RATE]; the coefficients are
+     * redesigned once per ramp and the filter state carries over, so sweeps
+     * stream block by block like FilterChain.
+     *
+     * @param filter State of the filter; only its x/y history is used
+     * @param source Envelope or LFO driving the cutoff
+     * @param design Filter::make_lowpass_filter or Filter::make_highpass_filter
+     * @param cutoff_hz Cutoff at a source value of 0
+     * @param octaves Cutoff shift per unit of the source
+     */
+    template <typename Source>
+    void sweepFilter(Filter::BiquadFilter& filter, Source& source, Filter::BiquadFilter (*design)(float, float),
+                     const float* input, float* output, int count, float cutoff_hz, float octaves, float resonance = 0.707f) {
+        const float highest = MAX_SWEEP_CUTOFF * SAMPLE_RATE;
+        Filter::BiquadFilter shape;
+        Ramp ramp;
+
+        for (int start = 0; start < count; start += ramp.frames) {
+            ramp = source.next(std::min(count - start, CONTROL_PERIOD));
+            shape = design(std::min(std::max(cutoff_hz * std::exp2(octaves * ramp.start), 10.0f), highest), resonance);
+            filter.setCoefficients(shape.b0, shape.b1, shape.b2, shape.a1, shape.a2);
+            filter.process(input + start, output + start, ramp.frames);
+        }
+    }
+}
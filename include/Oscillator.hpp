@@ -0,0 +1,133 @@
+#pragma once
+
+#include <memory>
+#include "Modulation.hpp"
+#include "Resonix.hpp"
+
+namespace Resonix {
+    /** @brief Longest period, in samples, that is rendered once and tiled */
+    constexpr int MAX_CYCLE_LENGTH = 1 << 16;
+
+    /** @brief Default memory limit of the cycle cache */
+    constexpr size_t DEFAULT_CYCLE_CACHE_LIMIT = size_t(16) << 20;
+
+    /**
+     * @struct Cycle
+     * @brief Whole periods of a steady tone, rendered once and then copied
+     *
+     * A tone whose frequency times period is a whole number of cycles repeats
+     * every period samples, so sample n equals sample n % period. Short periods
+     * are stored repeated, so every copy is at least a few kilobytes long. A
+     * period that is only nearly whole drifts a little with every repetition,
+     * so it is used for the first horizon samples only.
+     */
+    struct Cycle {
+        SampleBuffer samples;
+        int period;     // Samples per repetition
+        int length;     // Samples stored, a multiple of period
+        long long horizon;  // Samples tiled before the phase drifts by 1e-5 cycles; LLONG_MAX when exact
+
+        /**
+         * @brief Writes samples offset .. offset + count - 1 of the endless tone
+         */
+        void tile(long long offset, float* output, long long count) const;
+
+        /** @brief tile() multiplied by gain + i * gain_step while copying */
+        void tile(long long offset, float* output, long long count, float gain, float gain_step) const;
+    };
+
+    /**
+     * @brief Looks up or renders the repeating cycle of a steady tone
+     *
+     * Only the periodic shapes (SINE, SQUARE, TRIANGLE, SAWTOOTH, COSINE,
+     * TANGENT and COTANGENT) qualify. The period is the smallest whole number
+     * of samples holding a whole number of cycles closely enough that the
+     * phase drifts by less than 1e-5 cycles over length samples, found from
+     * the continued fraction of frequency / SAMPLE_RATE. Tiled output so
+     * matches the direct render however long it runs or the cache is set.
+     * Cycles are kept in an LRU cache keyed by shape, frequency and sample rate.
+     *
+     * @param length Samples about to be rendered; periods longer than half of
+     *               it are not worth rendering separately, and the cycle's
+     *               horizon is at least this long
+     * @return std::shared_ptr<const Cycle> The cycle, or nullptr when the tone
+     * does not repeat soon enough or the cache is disabled
+     */
+    std::shared_ptr<const Cycle> findCycle(Shape shape, float frequency, long long length);
+
+    /**
+     * @brief Caps the memory of cached cycles; 0 disables tiling altogether
+     *
+     * @param bytes Limit, DEFAULT_CYCLE_CACHE_LIMIT initially
+     */
+    void setCycleCacheLimit(size_t bytes);
+
+    /**
+     * @class Oscillator
+     * @brief Stateful block renderer for a waveform Shape
+     *
+     * Wraps the Generator block kernels behind a running sample position, so a
+     * waveform can be produced in cache-sized pieces instead of one full-length
+     * buffer. Consecutive render() calls continue exactly where the previous
+     * one stopped. Steady tones are copied from a cached Cycle (see
+     * findCycle()) instead of being evaluated sample by sample; past the
+     * cycle's horizon they are evaluated again.
+     *
+     * @example
+     * Resonix::Oscillator osc(Resonix::SAWTOOTH, 110.0f);
+     * float block[512];
+     * osc.render(block, 512);   // samples 0..511
+     * osc.render(block, 512);   // samples 512..1023
+     */
+    class Oscillator {
+    public:
+        /**
+         * @param shape Waveform shape to render
+         * @param frequency Frequency of the waveform in Hz
+         * @param length Total stream length in samples; only HANN and PHASED_HANN
+         *               use it, as the span of their window
+         * @param seed Stream selector of the NOISE_* shapes
+         */
+        Oscillator(Shape shape, float frequency, long long length = SAMPLE_RATE, unsigned long long seed = 0);
+
+        /**
+         * @brief Renders the next count samples and advances the position
+         *
+         * @param output Destination buffer of at least count samples
+         * @param count Number of samples to render
+         */
+        void render(float* output, int count);
+
+        /**
+         * @brief Renders the next count samples multiplied by an Envelope or LFO
+         *
+         * Tiled tones are scaled while they are copied, the others block by
+         * block right after the kernel wrote them, so the gain takes no pass of
+         * its own over the output. The source advances by count samples.
+         *
+         * @param gain Envelope or LFO
+         */
+        template <typename Source>
+        void render(float* output, int count, Source& gain);
+
+        /** @brief Moves the stream to an absolute sample index */
+        void seek(long long position) { position_ = position; }
+
+        long long position() const { return position_; }
+        long long length() const { return length_; }
+        Shape shape() const { return shape_; }
+        float frequency() const { return frequency_; }
+
+    private:
+        void renderBlock(float* output, int count);
+
+        Shape shape_;
+        float frequency_;
+        float phase_increment_;
+        long long length_;
+        long long position_;
+        unsigned long long seed_;
+        Generator::BrownNoiseState brown_;
+        std::shared_ptr<const Cycle> cycle_;
+    };
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+namespace Resonix {
+    /**
+     * @enum SampleFormat
+     * @brief Encoding of delivered or stored samples
+     */
+    enum SampleFormat {
+        FLOAT32, ///< IEEE 754 single precision
+        INT16,   ///< 16-bit signed PCM
+        INT24,   ///< 24-bit signed PCM, packed little-endian in 3 bytes
+        FLOAT16  ///< IEEE 754 half precision
+    };
+
+    /** @brief Bytes per sample of a SampleFormat */
+    inline int bytesPerSample(SampleFormat format) {
+        return format == INT16 || format == FLOAT16 ? 2 : format == INT24 ? 3 : 4;
+    }
+
+    /**
+     * @struct Dither
+     * @brief Position in a TPDF dither stream
+     *
+     * The dither is counter-based: the value added to sample n depends only on
+     * the seed and position + n, so a buffer encoded in blocks, or split
+     * across threads, gets the same bits as one encodeSamples() call.
+     */
+    struct Dither {
+        unsigned long long seed = 0;     ///< Stream selector; equal seeds give equal dither
+        unsigned long long position = 0; ///< Index of the next sample, advanced by encodeSamples()
+    };
+
+    /**
+     * @brief Quantizes float samples in [-1.0, 1.0] to a SampleFormat
+     *
+     * Dithering, rounding and clipping are fused into the store, so the output
+     * is written in a single pass. INT16 and INT24 add triangular (TPDF) dither
+     * of ±1 LSB when dither is given, then clip to full scale; FLOAT16 clips to
+     * its largest finite value and ignores dither. NaN samples encode as 0
+     * (integers) or saturate (FLOAT16).
+     *
+     * @param input Samples to encode
+     * @param count Number of samples
+     * @param format Encoding of output
+     * @param output Destination of count * bytesPerSample(format) bytes, little-endian
+     * @param dither Dither stream, advanced by count; nullptr rounds without dither
+     *
+     * @example
+     * Resonix::Dither dither;
+     * std::vector<int16_t> pcm(4096);
+     * for (...) {
+     *     chain.process(block, block, 4096);
+     *     Resonix::encodeSamples(block, 4096, Resonix::INT16, pcm.data(), &dither);
+     * }
+     */
+    void encodeSamples(const float* input, long long count, SampleFormat format, void* output, Dither* dither = nullptr);
+
+    /**
+     * @brief Converts encoded samples to float
+     *
+     * Integers are scaled by 1 / 2^(bits - 1), the inverse of encodeSamples().
+     *
+     * @param input First encoded sample
+     * @param count Number of samples to convert
+     * @param stride Distance between consecutive samples, in samples (channels() for one channel of interleaved frames)
+     * @param format Encoding of input
+     * @param output Destination of count floats
+     */
+    void decodeSamples(const void* input, long long count, long long stride, SampleFormat format, float* output);
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include "AudioFile.hpp"
+#include "RingBuffer.hpp"
+
+namespace Resonix {
+    /**
+     * @struct RealtimeStats
+     * @brief Counters of a RenderThread since start() or resetStats()
+     */
+    struct RealtimeStats {
+        long long frames_rendered = 0;
+        long long frames_read = 0;
+        long long underruns = 0;            // read() calls that found too few frames
+        long long underrun_frames = 0;      // Frames replaced by silence
+        long long buffered_frames = 0;      // Frames queued right now, i.e. the output latency
+        long long min_buffered_frames = 0;  // Lowest queue level seen by read(), the worst headroom
+        double max_render_ms = 0.0;         // Longest time the source took for one block
+    };
+
+    /**
+     * @class RenderThread
+     * @brief Renders a source ahead of a real-time consumer through a RingBuffer
+     *
+     * A dedicated thread calls the source one block at a time whenever the ring
+     * has room for a block, and the consumer, typically an audio device callback,
+     * takes frames out with read(). read() never blocks, locks or allocates;
+     * when the render thread falls behind it pads with silence and counts an
+     * underrun. The ring is filled before start() returns, so playback starts
+     * with the full buffer as headroom.
+     *
+     * The source runs on the render thread and should not allocate or block
+     * either; an Oscillator feeding a FilterChain qualifies.
+     *
+     * @example
+     * Resonix::Oscillator osc(Resonix::SAWTOOTH, 110.0f);
+     * Filter::FilterChain chain;
+     * chain.addBiquad(Filter::make_lowpass_filter(1200.0f, 0.707f));
+     * Resonix::RenderThread renderer([osc, chain](float* block, int frames) mutable {
+     *     osc.render(block, frames);
+     *     chain.process(block, block, frames);
+     * });
+     * renderer.start();
+     * // in the device callback:
+     * renderer.read(output, frames);
+     */
+    class RenderThread {
+    public:
+        using Source = std::function<void(float* block, int frames)>;
+
+        /** @brief Default frames per source call */
+        static constexpr int DEFAULT_BLOCK_SIZE = 256;
+        /** @brief Default ring size in frames, about 93 ms at 44.1 kHz */
+        static constexpr int DEFAULT_BUFFER_FRAMES = 4096;
+
+        /**
+         * @param source Called on the render thread to produce each block
+         * @param block_size Frames per source call
+         * @param buffer_frames Ring size; at least two blocks, rounded up to a power of two
+         */
+        explicit RenderThread(Source source, int block_size = DEFAULT_BLOCK_SIZE, int buffer_frames = DEFAULT_BUFFER_FRAMES);
+        ~RenderThread();
+
+        RenderThread(const RenderThread&) = delete;
+        RenderThread& operator=(const RenderThread&) = delete;
+
+        /**
+         * @brief Drops frames left from an earlier run, fills the ring and starts the render thread
+         *
+         * May be called while a consumer keeps calling read(); it waits for a
+         * read() in progress to leave the ring before emptying it.
+         *
+         * @return bool false if already running or the source is empty
+         */
+        bool start();
+
+        /** @brief Stops and joins the render thread; frames already queued can still be read */
+        void stop();
+
+        bool running() const { return running_.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Takes frames off the ring; wait-free, for one consumer thread
+         *
+         * A call made while another thread is inside read() gets silence and
+         * returns 0, so a second consumer cannot corrupt the ring.
+         *
+         * @param output Destination of frames samples; the part that was not
+         *               rendered in time, or all of it while start() empties
+         *               the ring or another read() is in progress, is zeroed
+         * @param frames Number of frames wanted
+         * @return int Frames that came from the source
+         */
+        int read(float* output, int frames);
+
+        /** @brief Snapshot of the counters; may be called from any thread */
+        RealtimeStats stats() const;
+
+        /** @brief Zeroes the counters; call while no read() is in progress */
+        void resetStats();
+
+        int blockSize() const { return block_size_; }
+        int bufferFrames() const { return static_cast<int>(ring_.capacity()); }
+
+    private:
+        void renderBlock();
+        void renderLoop();
+
+        Source source_;
+        int block_size_;
+        RingBuffer<float> ring_;
+        SampleBuffer block_;
+        std::thread thread_;
+        std::atomic<bool> running_;
+        std::atomic<bool> reading_;     // A read() owns the ring's consumer side
+        std::atomic<bool> restarting_;  // start() is resetting the ring
+
+        // Each counter has a single writer: the render thread or the consumer
+        std::atomic<long long> frames_rendered_;
+        std::atomic<long long> render_ns_max_;
+        std::atomic<long long> frames_read_;
+        std::atomic<long long> underruns_;
+        std::atomic<long long> underrun_frames_;
+        std::atomic<long long> min_buffered_;
+    };
+
+    /**
+     * @class SinkThread
+     * @brief Stand-in for an audio device, for running a RenderThread headless
+     *
+     * Pulls one period of frames from the RenderThread at a time and hands it
+     * to a sink, paced by the steady clock like a sound card, or as fast as
+     * possible to stress the renderer. nullSink() discards the samples and
+     * fileSink() records them.
+     */
+    class SinkThread {
+    public:
+        /** @brief Receives each period; returning false stops the thread */
+        using Sink = std::function<bool(const float* samples, int frames)>;
+
+        /** @brief Default frames per device period */
+        static constexpr int DEFAULT_PERIOD = 256;
+
+        /**
+         * @param source RenderThread to pull from; must outlive the SinkThread
+         * @param sink Receives every period on the sink thread
+         * @param period Frames pulled per period
+         * @param realtime Wait one period duration between pulls; false pulls back to back
+         */
+        SinkThread(RenderThread& source, Sink sink, int period = DEFAULT_PERIOD, bool realtime = true);
+        ~SinkThread();
+
+        SinkThread(const SinkThread&) = delete;
+        SinkThread& operator=(const SinkThread&) = delete;
+
+        /**
+         * @brief Starts pulling
+         *
+         * @param frames Frames to deliver before stopping by itself; -1 runs until stop()
+         * @return bool false if already running
+         */
+        bool start(long long frames = -1);
+
+        /** @brief Stops and joins the sink thread */
+        void stop();
+
+        /** @brief Blocks until a start() with a frame limit has delivered everything */
+        void wait();
+
+        bool running() const { return running_.load(std::memory_order_acquire); }
+        long long framesDelivered() const { return delivered_.load(std::memory_order_acquire); }
+
+    private:
+        void pullLoop(long long frames);
+
+        RenderThread& source_;
+        Sink sink_;
+        int period_;
+        bool realtime_;
+        SampleBuffer buffer_;
+        std::thread thread_;
+        std::atomic<bool> running_;
+        std::atomic<long long> delivered_;
+    };
+
+    /** @brief Sink that discards every period */
+    SinkThread::Sink nullSink();
+
+    /**
+     * @brief Sink that appends every period to an open mono AudioFileWriter
+     *
+     * The writer serializes its own calls, so other threads may keep writing
+     * to it; once one closes it the sink returns false and the run ends.
+     *
+     * @param writer Must outlive the SinkThread
+     */
+    SinkThread::Sink fileSink(AudioFileWriter& writer);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+/**
+ * @namespace Resampler
+ * @brief Polyphase sample-rate conversion
+ *
+ * Converts audio between arbitrary rational sample-rate ratios (e.g. 44100 Hz
+ * to 48000 Hz, or 2x/4x oversampling) using a windowed-sinc lowpass split into
+ * polyphase sub-filters. Filter banks are designed once per ratio and quality
+ * and shared between all resampler instances.
+ */
+namespace Resampler {
+    /**
+     * @enum Quality
+     * @brief Filter length presets, trading stopband attenuation for speed
+     */
+    enum Quality {
+        FAST,    ///< 8 taps per phase, ~50 dB stopband
+        MEDIUM,  ///< 16 taps per phase, ~75 dB stopband
+        HIGH,    ///< 32 taps per phase, ~100 dB stopband
+        BEST     ///< 64 taps per phase, ~120 dB stopband
+    };
+
+    /**
+     * @brief Precomputed polyphase filter bank for one reduced ratio
+     *
+     * Coefficients are stored phase-major with the taps of each phase reversed,
+     * so every output sample is a single contiguous inner product over the input
+     * history.
+     */
+    struct FilterBank {
+        int up;                          ///< Interpolation factor L
+        int down;                        ///< Decimation factor M
+        int taps;                        ///< Taps per phase
+        std::vector<float> coefficients; ///< up * taps coefficients
+    };
+
+    /**
+     * @brief Returns the cached filter bank for a ratio, designing it on first use
+     *
+     * @param up Interpolation factor (already reduced by gcd)
+     * @param down Decimation factor (already reduced by gcd)
+     * @param quality Filter length preset
+     * @return std::shared_ptr<const FilterBank> Shared bank, or nullptr if the ratio is invalid
+     *
+     * @note Thread-safe; concurrent callers receive the same bank
+     */
+    std::shared_ptr<const FilterBank> getFilterBank(int up, int down, Quality quality);
+
+    /**
+     * @class PolyphaseResampler
+     * @brief Streaming rational-ratio resampler
+     *
+     * Keeps the input history between calls, so a long signal can be fed in
+     * blocks of any size and produces the same output as a single call.
+     * Output is aligned to the input: the filter delay is compensated internally,
+     * which is why the first calls may return fewer samples than expected until
+     * enough lookahead has been buffered. Call flush() at the end of the stream.
+     *
+     * @example
+     * Resampler::PolyphaseResampler rs(44100, 48000, Resampler::HIGH);
+     * std::vector<float> out(rs.maxOutputLength(512));
+     * int produced = rs.process(block, 512, out.data(), static_cast<int>(out.size()));
+     */
+    class PolyphaseResampler {
+    public:
+        PolyphaseResampler(int input_rate, int output_rate, Quality quality = MEDIUM);
+
+        /**
+         * @brief Resamples a block of input
+         *
+         * @param input Input samples
+         * @param input_length Number of input samples
+         * @param output Destination buffer
+         * @param output_capacity Capacity of the destination buffer
+         * @return int Number of samples written to output
+         *
+         * @note With output_capacity below maxOutputLength(input_length) the
+         *       remaining output stays pending for the next process() or flush()
+         */
+        int process(const float* input, int input_length, float* output, int output_capacity);
+
+        /**
+         * @brief Drains the filter delay at the end of a stream
+         *
+         * @return int Number of samples written; total output then equals
+         *         ceil(total_input * output_rate / input_rate)
+         */
+        int flush(float* output, int output_capacity);
+
+        /** @brief Clears the history and restarts the stream */
+        void reset();
+
+        /** @brief Upper bound on samples produced by process() for a given input length */
+        int maxOutputLength(int input_length) const;
+
+        /** @brief Number of output samples flush() can still produce */
+        int pendingOutputLength() const;
+
+        /** @brief Input samples that must be buffered before the first output */
+        int latency() const;
+
+        bool valid() const { return bank_ != nullptr; }
+
+    private:
+        int run(const float* input, int input_length, float* output, int output_capacity);
+
+        std::shared_ptr<const FilterBank> bank_;
+        std::vector<float> buffer_;
+        int history_;
+        long long base_;
+        int phase_;
+        long long first_;       ///< Absolute input index of buffer_[0]
+        long long consumed_;    ///< Absolute input index one past the end of buffer_
+        long long input_total_;
+        long long produced_;
+    };
+}
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <memory>
+#include "AudioBuffer.hpp"
+#include "Pcm.hpp"
 #include "Generator.hpp"
+#include "Analysis.hpp"
 #include "Filter.hpp"
+#include "Resampler.hpp"
 
 /**
 * @namespace Resonix
@@ -35,9 +39,19 @@ namespace Resonix {
 
         // Hann functions
         HANN,        ///< Hann window
-        PHASED_HANN  ///< Phase-shifted Hann window
+        PHASED_HANN, ///< Phase-shifted Hann window
+
+        // Noise (frequency is ignored)
+        NOISE_WHITE, ///< Uniform white noise
+        NOISE_PINK,  ///< Pink (1/f) noise
+        NOISE_BROWN  ///< Brown (1/f^2) noise
     };
 
+    /** @brief Returns true for the NOISE_* shapes, which have no frequency */
+    inline bool isNoise(Shape shape) {
+        return shape == NOISE_WHITE || shape == NOISE_PINK || shape == NOISE_BROWN;
+    }
+
     /**
      * @brief Generates audio samples of the specified waveform shape
      *
@@ -48,18 +62,39 @@ namespace Resonix {
      * @param shape The waveform shape to generate (e.g., SINE, SQUARE, TRIANGLE)
      * @param sample_length Number of samples in seconds to generate in the output buffer
      * @param frequency Frequency of the waveform in Hz (e.g., 440.0 for A4)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
+     * @return SampleBuffer Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @warning Returns nullptr if allocation fails or if parameters are invalid
      *
      * @example
      * // Generate 1 second of 440Hz sine wave at 44100 Hz sample rate
-     * std::unique_ptr<float[]> samples = Resonix::generateSamples(Resonix::SINE, 44100, 440.0f);
+     * Resonix::SampleBuffer samples = Resonix::generateSamples(Resonix::SINE, 44100, 440.0f);
      * // Use samples...
-     * delete[] samples;
      */
-    std::unique_ptr<float[]> generateSamples(Shape shape, int sample_length, float frequency);
+    SampleBuffer generateSamples(Shape shape, int sample_length, float frequency);
+
+    /**
+     * @brief Generates seeded white, pink or brown noise
+     *
+     * The noise is counter-based: every sample is a pure function of the seed
+     * and its index, so long buffers are split across ThreadPool::global()
+     * and the result is identical to a single-threaded or block-by-block render.
+     * generateSamples() with a NOISE_* shape is equivalent to seed 0.
+     *
+     * @param shape NOISE_WHITE, NOISE_PINK or NOISE_BROWN
+     * @param sample_length Number of samples in seconds to generate in the output buffer
+     * @param seed Stream selector; equal seeds give equal noise
+     * @return SampleBuffer Pointer to dynamically allocated array of samples in range [-1.0, 1.0]
+     *
+     * @warning Returns nullptr if shape is not a noise shape or sample_length is not positive
+     *
+     * @example
+     * // Fricative source for bandpass_filter()
+     * auto noise = Resonix::generateNoise(Resonix::NOISE_WHITE, 1, 42);
+     * auto fricative = Resonix::bandpass_filter(noise.get(), Resonix::SAMPLE_RATE, 6000.0f, 4000.0f, 0.5f);
+     */
+    SampleBuffer generateNoise(Shape shape, int sample_length, unsigned long long seed = 0);
 
     /**
      * @brief Applies a lowpass filter to audio samples using a biquad filter design
@@ -73,26 +108,25 @@ namespace Resonix {
      * @param sample_length Number of samples in the input/output buffer
      * @param cutoff_hz Cutoff frequency in Hz (e.g., 1000.0 for 1kHz lowpass)
      * @param resonance Resonance/Q factor of the filter (default: 0.707f for Butterworth response)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of filtered samples
+     * @param stats Optional; receives analyze() statistics of the output, collected in the same pass
+     * @return SampleBuffer Pointer to dynamically allocated array of filtered samples
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @warning Returns nullptr if allocation fails, input is invalid, or parameters are out of range
      * @note Higher resonance values (e.g., > 0.9) create a resonant peak near the cutoff frequency
      * @note For stability, resonance should typically be between 0.5 and 10.0
      *
      * @example
      * // Filter audio with 1kHz cutoff and moderate resonance
-     * std::unique_ptr<float[]> filtered = Resonix::lowpass_filter(samples, 44100, 1000.0f, 0.707f);
+     * Resonix::SampleBuffer filtered = Resonix::lowpass_filter(samples, 44100, 1000.0f, 0.707f);
      * // Use filtered audio...
-     * delete[] filtered;
      *
      * @example
      * // Filter with stronger resonance effect (emphasizes cutoff frequency)
-     * std::unique_ptr<float[]> resonant = Resonix::lowpass_filter(samples, 44100, 500.0f, 2.5f);
+     * Resonix::SampleBuffer resonant = Resonix::lowpass_filter(samples, 44100, 500.0f, 2.5f);
      * // Has a noticeable "peak" at 500Hz
-     * delete[] resonant;
      */
-    std::unique_ptr<float[]> lowpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance = 0.707f);
+    SampleBuffer lowpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance = 0.707f, SignalStats* stats = nullptr);
 
     /**
      * @brief Applies a highpass filter to audio samples using a biquad filter design
@@ -105,24 +139,23 @@ namespace Resonix {
      * @param sample_length Number of samples in the input/output buffer
      * @param cutoff_hz Cutoff frequency in Hz (e.g., 200.0 for 200Hz highpass)
      * @param resonance Resonance/Q factor of the filter (default: 0.707f for Butterworth response)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of filtered samples
+     * @param stats Optional; receives analyze() statistics of the output, collected in the same pass
+     * @return SampleBuffer Pointer to dynamically allocated array of filtered samples
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @warning Returns nullptr if allocation fails, input is invalid, or parameters are out of range
      * @note Higher resonance values (e.g., > 0.9) create a resonant peak near the cutoff frequency
      * @note For stability, resonance should typically be between 0.5 and 10.0
      *
      * @example
      * // Remove low-frequency rumble below 80Hz
-     * std::unique_ptr<float[]> filtered = Resonix::highpass_filter(samples, 44100, 80.0f, 0.707f);
-     * delete[] filtered;
+     * Resonix::SampleBuffer filtered = Resonix::highpass_filter(samples, 44100, 80.0f, 0.707f);
      *
      * @example
      * // Create telephone effect (remove bass)
-     * std::unique_ptr<float[]> phone = Resonix::highpass_filter(samples, 44100, 300.0f, 0.707f);
-     * delete[] phone;
+     * Resonix::SampleBuffer phone = Resonix::highpass_filter(samples, 44100, 300.0f, 0.707f);
      */
-    std::unique_ptr<float[]> highpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance = 0.707f);
+    SampleBuffer highpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance = 0.707f, SignalStats* stats = nullptr);
 
     /**
      * @brief Applies a bandpass filter to audio samples using a biquad filter design
@@ -138,9 +171,10 @@ namespace Resonix {
      * @param center_hz Center frequency of the passband in Hz (e.g., 1000.0 for 1kHz center)
      * @param bandwidth_hz Width of the passband in Hz (e.g., 200.0 for ±100Hz around center)
      * @param resonance Resonance/Q multiplier of the filter (default: 0.707f for moderate response)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of filtered samples
+     * @param stats Optional; receives analyze() statistics of the output, collected in the same pass
+     * @return SampleBuffer Pointer to dynamically allocated array of filtered samples
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @note The filter passes frequencies approximately from (center_hz - bandwidth_hz/2) to (center_hz + bandwidth_hz/2)
      * @note Actual Q factor is calculated as: Q = (center_hz / bandwidth_hz) * resonance
      * @note Narrower bandwidths create sharper, more selective filtering
@@ -150,22 +184,19 @@ namespace Resonix {
      *
      * @example
      * // Isolate frequencies around 1kHz with 500Hz bandwidth (750Hz - 1250Hz)
-     * std::unique_ptr<float[]> filtered = Resonix::bandpass_filter(samples, 44100, 1000.0f, 500.0f);
-     * delete[] filtered;
+     * Resonix::SampleBuffer filtered = Resonix::bandpass_filter(samples, 44100, 1000.0f, 500.0f);
      *
      * @example
      * // Create narrow bandpass for fricative 's' sound (4kHz - 8kHz range)
-     * std::unique_ptr<float[]> fricative = Resonix::bandpass_filter(noise, 44100, 6000.0f, 4000.0f, 0.5f);
-     * delete[] fricative;
+     * Resonix::SampleBuffer fricative = Resonix::bandpass_filter(noise, 44100, 6000.0f, 4000.0f, 0.5f);
      *
      * @example
      * // Telephone effect - isolate voice frequencies (300Hz - 3400Hz)
-     * std::unique_ptr<float[]> phone = Resonix::bandpass_filter(voice, 44100, 1850.0f, 3100.0f, 0.707f);
-     * delete[] phone;
+     * Resonix::SampleBuffer phone = Resonix::bandpass_filter(voice, 44100, 1850.0f, 3100.0f, 0.707f);
      *
      * @see lowpass_filter(), highpass_filter(), formant_filter()
      */
-    std::unique_ptr<float[]> bandpass_filter(const float* samples, int sample_length, float center_hz, float bandwidth_hz, float resonance = 0.707f);
+    SampleBuffer bandpass_filter(const float* samples, int sample_length, float center_hz, float bandwidth_hz, float resonance = 0.707f, SignalStats* stats = nullptr);
 
     /**
      * @brief Applies a formant filter to simulate vowel sounds and vocal characteristics
@@ -196,9 +227,10 @@ namespace Resonix {
      *               - 0.0 = normal formant spacing
      *               - 0.5 = moderately widened formants
      *               - 1.0 = widely spread formants (creates more diffuse vocal character)
-     * @return std::unique_ptr<float[]> Pointer to dynamically allocated array of filtered samples
+     * @param stats Optional; receives analyze() statistics of the output, collected in the same pass
+     * @return SampleBuffer Pointer to dynamically allocated array of filtered samples
      *
-     * @note Caller is responsible for freeing the returned array with delete[]
+     * @note The buffer returns to Resonix::BufferPool when the handle is destroyed
      * @note Works best with harmonically rich input signals (sawtooth, square waves)
      * @note All parameters are automatically clamped to valid ranges [0.0, 1.0]
      * @note The filter uses high Q values (8-20) to create sharp formant peaks
@@ -208,18 +240,15 @@ namespace Resonix {
      * @example
      * // Create "ee" vowel sound from sawtooth wave
      * auto saw = Resonix::generateSamples(Resonix::SAWTOOTH, 1, 110.0f);
-     * std::unique_ptr<float[]> vowel_ee = Resonix::formant_filter(saw.get(), 44100, 0.5f, 1.0f, 0.0f);
-     * delete[] vowel_ee;
+     * Resonix::SampleBuffer vowel_ee = Resonix::formant_filter(saw.get(), 44100, 0.5f, 1.0f, 0.0f);
      *
      * @example
      * // Subtle vocal character with 50% mix
-     * std::unique_ptr<float[]> subtle = Resonix::formant_filter(audio, 44100, 0.3f, 0.5f, 0.0f);
-     * delete[] subtle;
+     * Resonix::SampleBuffer subtle = Resonix::formant_filter(audio, 44100, 0.3f, 0.5f, 0.0f);
      *
      * @example
      * // Wide, diffuse "ah" vowel
-     * std::unique_ptr<float[]> wide_ah = Resonix::formant_filter(synth, 44100, 0.1f, 0.8f, 0.7f);
-     * delete[] wide_ah;
+     * Resonix::SampleBuffer wide_ah = Resonix::formant_filter(synth, 44100, 0.1f, 0.8f, 0.7f);
      *
      * @example
      * // Talkbox-style effect morphing between vowels
@@ -231,5 +260,122 @@ namespace Resonix {
      * @see bandpass_filter() for individual formant band simulation
      * @see https://en.wikipedia.org/wiki/Formant for more information on formants
      */
-    std::unique_ptr<float[]> formant_filter(const float* samples, int sample_length, float peak, float mix, float spread);
-}
\ No newline at end of file
+    SampleBuffer formant_filter(const float* samples, int sample_length, float peak, float mix, float spread, SignalStats* stats = nullptr);
+
+    /**
+     * @brief Converts audio samples to another sample rate
+     *
+     * Resamples the whole buffer with a polyphase windowed-sinc filter. Any
+     * rational ratio is supported, e.g. 44100 -> 48000 Hz or 2x/4x oversampling.
+     * The filter delay is compensated, so output sample n corresponds to input
+     * time n * input_rate / output_rate.
+     *
+     * @param samples Pointer to input audio samples
+     * @param sample_length Number of input samples
+     * @param input_rate Sample rate of the input in Hz (usually SAMPLE_RATE)
+     * @param output_rate Desired output sample rate in Hz
+     * @param output_length Receives the number of output samples, ceil(sample_length * output_rate / input_rate)
+     * @param quality Filter length preset (default: Resampler::MEDIUM)
+     * @return SampleBuffer Pointer to dynamically allocated array of resampled samples
+     *
+     * @warning Returns nullptr if input is invalid or the reduced ratio is too large to tabulate
+     *
+     * @example
+     * // Deliver a 44.1 kHz render at 48 kHz
+     * int length = 0;
+     * auto tone = Resonix::generateSamples(Resonix::SINE, 1, 440.0f);
+     * auto out = Resonix::resample(tone.get(), Resonix::SAMPLE_RATE, 44100, 48000, length);
+     *
+     * @see Resampler::PolyphaseResampler for streaming use
+     */
+    SampleBuffer resample(const float* samples, int sample_length, int input_rate, int output_rate, int& output_length, Resampler::Quality quality = Resampler::MEDIUM);
+
+    /**
+     * @brief Fills every channel of a buffer with a waveform
+     *
+     * Tones are rendered once and copied to the other channels. NOISE_* shapes
+     * use stream seed + channel, so the channels are decorrelated. HANN and
+     * PHASED_HANN windows span the whole buffer.
+     *
+     * @param buffer Destination; its size sets the channel count and length
+     * @param shape The waveform shape to generate
+     * @param frequency Frequency in Hz; ignored by the NOISE_* shapes
+     * @param seed Noise stream of channel 0
+     * @return bool false if the buffer is empty or a tone frequency is not positive
+     *
+     * @example
+     * Resonix::AudioBuffer stereo(2, 5 * Resonix::SAMPLE_RATE);
+     * Resonix::generateSamples(stereo, Resonix::NOISE_BROWN, 0.0f, 42);
+     */
+    bool generateSamples(AudioBuffer& buffer, Shape shape, float frequency, unsigned long long seed = 0);
+
+    /**
+     * @brief Lowpass-filters every channel of a buffer in place
+     *
+     * Each channel gets its own filter state. Long multichannel buffers are
+     * split across the thread pool, one task per channel.
+     *
+     * @return bool false if the buffer is empty or cutoff_hz is not positive
+     */
+    bool lowpass_filter(AudioBuffer& buffer, float cutoff_hz, float resonance = 0.707f);
+
+    /** @brief Highpass-filters every channel of a buffer in place, see lowpass_filter(AudioBuffer&, float, float) */
+    bool highpass_filter(AudioBuffer& buffer, float cutoff_hz, float resonance = 0.707f);
+
+    /** @brief Bandpass-filters every channel of a buffer in place, see lowpass_filter(AudioBuffer&, float, float) */
+    bool bandpass_filter(AudioBuffer& buffer, float center_hz, float bandwidth_hz, float resonance = 0.707f);
+
+    /** @brief Formant-filters every channel of a buffer in place, see lowpass_filter(AudioBuffer&, float, float) */
+    bool formant_filter(AudioBuffer& buffer, float peak, float mix, float spread);
+
+    /**
+     * @brief Generates a waveform straight into an encoded buffer
+     *
+     * Samples are rendered in Generator::BLOCK_LENGTH blocks and each block is
+     * quantized by encodeSamples() while it is still in cache, so no float
+     * buffer of the full length exists. The samples match generateSamples().
+     *
+     * @param shape The waveform shape to generate
+     * @param sample_length Number of samples in seconds to generate
+     * @param frequency Frequency in Hz; ignored by the NOISE_* shapes
+     * @param format Encoding of output
+     * @param output Destination of sample_length * SAMPLE_RATE * bytesPerSample(format) bytes
+     * @param dither Dither stream for INT16 and INT24; nullptr rounds without dither
+     * @return bool false if output is null or a parameter is invalid
+     *
+     * @example
+     * // 16-bit delivery, half the memory of float32
+     * std::vector<int16_t> pcm(Resonix::SAMPLE_RATE);
+     * Resonix::Dither dither;
+     * Resonix::generateSamples(Resonix::SINE, 1, 440.0f, Resonix::INT16, pcm.data(), &dither);
+     */
+    bool generateSamples(Shape shape, int sample_length, float frequency, SampleFormat format, void* output, Dither* dither = nullptr);
+
+    /** @brief Seeded generateNoise() straight into an encoded buffer, see generateSamples(Shape, int, float, SampleFormat, void*, Dither*) */
+    bool generateNoise(Shape shape, int sample_length, unsigned long long seed, SampleFormat format, void* output, Dither* dither = nullptr);
+
+    /**
+     * @brief Lowpass-filters samples straight into an encoded buffer
+     *
+     * Filtered blocks are quantized by encodeSamples() while still in cache,
+     * so no float output buffer is allocated.
+     *
+     * @param output Destination of sample_length * bytesPerSample(format) bytes
+     * @param dither Dither stream for INT16 and INT24; nullptr rounds without dither
+     * @return bool false if an argument is invalid
+     */
+    bool lowpass_filter(const float* samples, int sample_length, SampleFormat format, void* output,
+                        float cutoff_hz, float resonance = 0.707f, Dither* dither = nullptr);
+
+    /** @brief Highpass-filters samples into an encoded buffer, see lowpass_filter(const float*, int, SampleFormat, void*, float, float, Dither*) */
+    bool highpass_filter(const float* samples, int sample_length, SampleFormat format, void* output,
+                         float cutoff_hz, float resonance = 0.707f, Dither* dither = nullptr);
+
+    /** @brief Bandpass-filters samples into an encoded buffer, see lowpass_filter(const float*, int, SampleFormat, void*, float, float, Dither*) */
+    bool bandpass_filter(const float* samples, int sample_length, SampleFormat format, void* output,
+                         float center_hz, float bandwidth_hz, float resonance = 0.707f, Dither* dither = nullptr);
+
+    /** @brief Formant-filters samples into an encoded buffer, see lowpass_filter(const float*, int, SampleFormat, void*, float, float, Dither*) */
+    bool formant_filter(const float* samples, int sample_length, SampleFormat format, void* output,
+                        float peak, float mix, float spread, Dither* dither = nullptr);
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "AudioBuffer.hpp"
+#include "Filter.hpp"
+#include "Resonix.hpp"
+
+namespace Filter {
+    /**
+     * @struct ReverbSettings
+     * @brief Parameters of a Reverb
+     */
+    struct ReverbSettings {
+        int lines = 8;                  // Delay lines in the network: 8 or 16
+        float decay = 2.0f;             // Seconds for the tail to fall by 60 dB (RT60)
+        float size = 1.0f;              // Scale of the delay lengths, from 0.25 (small room) to 2 (hall)
+        float damping_hz = 6000.0f;     // Cutoff of the lowpass in every loop; content above it dies away sooner
+        float mix = 0.3f;               // Wet share: output = (1 - mix) * dry + mix * wet
+    };
+
+    /**
+     * @class Reverb
+     * @brief Streaming feedback-delay-network reverb
+     *
+     * Every delay line feeds back into all of them through an orthogonal
+     * Hadamard matrix, scaled per line for the decay time and lowpass-filtered
+     * by a BiquadFilter for the damping. The lines share one allocation and one
+     * power-of-two length, so they are indexed with a mask. Since the shortest line is
+     * longer than BLOCK_FRAMES, a whole block of every line can be read before
+     * any of it is written, so the network runs one block at a time: each
+     * frame of the block holds one value per line side by side, and the
+     * filters, the matrix and the input are applied to all lines at once with
+     * vector instructions. The cost per sample depends on the number of lines,
+     * not on decay or size.
+     *
+     * The inputs are mixed to mono before they enter the network, and every
+     * output channel taps a different row of the matrix, so the channels are
+     * decorrelated. State carries over between process() calls like
+     * FilterChain.
+     *
+     * @example
+     * Filter::ReverbSettings settings;
+     * settings.decay = 3.5f;
+     * Filter::Reverb hall(settings, 2);
+     * float* channels[2] = {left, right};
+     * hall.process(channels, channels, 512);
+     */
+    class Reverb {
+    public:
+        static constexpr int MAX_LINES = 16;
+        static constexpr int MAX_CHANNELS = 8;
+        /** @brief Frames per pass through the network; the shortest line is at least this long */
+        static constexpr int BLOCK_FRAMES = 128;
+
+        /**
+         * @param settings Parameters; lines other than 16 mean 8, other values are clamped
+         * @param channels Channels processed together, clamped to [1, MAX_CHANNELS]
+         */
+        explicit Reverb(const ReverbSettings& settings = ReverbSettings(), int channels = 1);
+
+        /**
+         * @brief Processes count frames of every channel
+         *
+         * @param input channels() pointers to count samples each
+         * @param output channels() pointers; output[c] == input[c] is allowed
+         */
+        void process(const float* const* input, float* const* output, int count);
+
+        /** @brief Single-channel process() */
+        void process(const float* input, float* output, int count);
+
+        /** @brief Silences the tail, keeping the settings */
+        void reset();
+
+        int channels() const { return channels_; }
+        int lines() const { return settings_.lines; }
+        const ReverbSettings& settings() const { return settings_; }
+
+        /** @brief Length of delay line index in samples */
+        int delay(int index) const { return index >= 0 && index < settings_.lines ? delays_[index] : 0; }
+
+    private:
+        ReverbSettings settings_;
+        int channels_;
+        int mask_;                          // Line length - 1; every line has the same power-of-two length
+        long long position_;
+        int delays_[MAX_LINES];
+        BiquadFilter dampers_[MAX_LINES];   // Lowpass with the line's decay gain folded into b0..b2
+        Resonix::SampleBuffer delay_;       // settings_.lines lines of mask_ + 1 samples, one cache line apart
+        Resonix::SampleBuffer frames_;      // One block, the values of all lines side by side per frame
+        Resonix::SampleBuffer wet_;         // One block of every output channel
+        Resonix::SampleBuffer feed_;        // One block of the mono input
+    };
+
+    /**
+     * @brief Runs count frames and then tail frames of silence through a fresh Reverb
+     *
+     * @param output channels pointers to count + tail samples each;
+     * output[c] == input[c] is allowed when tail is 0
+     */
+    void apply_reverb(const float* const* input, float* const* output, int channels, int count, int tail, const ReverbSettings& settings);
+}
+
+namespace Resonix {
+    /**
+     * @brief Adds algorithmic reverb to audio samples, see Filter::Reverb
+     *
+     * The output has the length of the input, so the tail is cut at its end;
+     * pad the input with silence to keep it.
+     *
+     * @param samples Pointer to input audio samples
+     * @param sample_length Number of samples
+     * @param decay Seconds for the tail to fall by 60 dB
+     * @param mix Wet share of the output, 0 to 1
+     * @param size Scale of the delay lengths, 0.25 to 2
+     * @param damping_hz Lowpass cutoff inside the network
+     * @param stats Optional; receives analyze() statistics of the output
+     * @return SampleBuffer Reverberated samples, or nullptr if an argument is invalid
+     *
+     * @example
+     * Resonix::SampleBuffer wet = Resonix::reverb(samples, 88200, 2.5f, 0.35f);
+     */
+    SampleBuffer reverb(const float* samples, int sample_length, float decay = 2.0f, float mix = 0.3f, float size = 1.0f,
+                        float damping_hz = 6000.0f, SignalStats* stats = nullptr);
+
+    /**
+     * @brief Adds reverb to every channel of a buffer in place, each channel tapping its own matrix row
+     *
+     * @return bool false if the buffer is empty or has more than Filter::Reverb::MAX_CHANNELS channels
+     */
+    bool reverb(AudioBuffer& buffer, const Filter::ReverbSettings& settings);
+}
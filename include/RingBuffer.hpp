@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace Resonix {
+    /**
+     * @class RingBuffer
+     * @brief Wait-free single-producer/single-consumer queue of samples
+     *
+     * One thread writes and one thread reads, without locks and without
+     * allocating after construction, so either side may be a real-time audio
+     * thread. Each side owns one index on its own cache line and keeps a
+     * cached copy of the other side's index, so the shared lines are only
+     * touched when the cached view runs out.
+     *
+     * @example
+     * Resonix::RingBuffer<float> ring(4096);
+     * ring.write(block, 256);     // producer thread
+     * ring.read(output, 256);     // consumer thread
+     */
+    template <typename T>
+    class RingBuffer {
+        static_assert(std::is_trivially_copyable<T>::value, "RingBuffer copies its elements with memcpy");
+
+    public:
+        /** @param capacity Minimum number of elements held; rounded up to a power of two */
+        explicit RingBuffer(size_t capacity) {
+            size_t size = 1;
+
+            while (size < capacity) {
+                size <<= 1;
+            }
+            buffer_.reset(new T[size]);
+            mask_ = size - 1;
+        }
+
+        RingBuffer(const RingBuffer&) = delete;
+        RingBuffer& operator=(const RingBuffer&) = delete;
+
+        size_t capacity() const { return mask_ + 1; }
+
+        /** @brief Elements the producer can write now; producer side */
+        size_t writeAvailable() {
+            producer_tail_ = tail_.load(std::memory_order_acquire);
+            return capacity() - (head_.load(std::memory_order_relaxed) - producer_tail_);
+        }
+
+        /** @brief Elements the consumer can read now; consumer side */
+        size_t readAvailable() {
+            consumer_head_ = head_.load(std::memory_order_acquire);
+            return consumer_head_ - tail_.load(std::memory_order_relaxed);
+        }
+
+        /** @brief Elements queued, from any thread; a snapshot that may be stale */
+        size_t size() const {
+            return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Appends up to count elements; producer side
+         *
+         * @return size_t Elements written, fewer than count when the buffer is full
+         */
+        size_t write(const T* data, size_t count) {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            size_t free = capacity() - (head - producer_tail_);
+
+            if (free < count) {
+                producer_tail_ = tail_.load(std::memory_order_acquire);
+                free = capacity() - (head - producer_tail_);
+            }
+            if (count > free)
+                count = free;
+
+            copyIn(head & mask_, data, count);
+            head_.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * @brief Removes up to count elements; consumer side
+         *
+         * @return size_t Elements read, fewer than count when the buffer runs dry
+         */
+        size_t read(T* data, size_t count) {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            size_t queued = consumer_head_ - tail;
+
+            if (queued < count) {
+                consumer_head_ = head_.load(std::memory_order_acquire);
+                queued = consumer_head_ - tail;
+            }
+            if (count > queued)
+                count = queued;
+
+            copyOut(tail & mask_, data, count);
+            tail_.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        /** @brief Empties the buffer; only while neither side is active */
+        void reset() {
+            head_.store(0, std::memory_order_relaxed);
+            tail_.store(0, std::memory_order_relaxed);
+            producer_tail_ = 0;
+            consumer_head_ = 0;
+        }
+
+    private:
+        void copyIn(size_t start, const T* data, size_t count) {
+            const size_t first = count < capacity() - start ? count : capacity() - start;
+
+            std::memcpy(buffer_.get() + start, data, first * sizeof(T));
+            std::memcpy(buffer_.get(), data + first, (count - first) * sizeof(T));
+        }
+
+        void copyOut(size_t start, T* data, size_t count) const {
+            const size_t first = count < capacity() - start ? count : capacity() - start;
+
+            std::memcpy(data, buffer_.get() + start, first * sizeof(T));
+            std::memcpy(data + first, buffer_.get(), (count - first) * sizeof(T));
+        }
+
+        std::unique_ptr<T[]> buffer_;
+        size_t mask_;
+
+        // Indices grow without wrapping; only their low bits address the buffer
+        alignas(64) std::atomic<size_t> head_{0};
+        size_t producer_tail_ = 0;
+        alignas(64) std::atomic<size_t> tail_{0};
+        size_t consumer_head_ = 0;
+    };
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "Oscillator.hpp"
+
+namespace Resonix {
+    /** @brief Frames evaluated per pass when an expression is materialized */
+    constexpr int SIGNAL_BLOCK_LENGTH = 1024;
+
+    /**
+     * @brief CRTP base of every lazy signal expression
+     *
+     * An expression node implements three members:
+     * - long long length() const: number of defined samples, or -1 if unbounded
+     * - void prepare(long long offset, int count): readies the block starting at offset
+     * - float at(int i) const: sample i of the prepared block
+     *
+     * Arithmetic operators combine nodes into a compile-time expression tree.
+     * Nothing is computed until evaluate() or materialize(), which walk the
+     * tree once per block so the whole expression collapses into one fused,
+     * vectorizable loop with a single store per output sample.
+     *
+     * @example
+     * auto low  = Resonix::generateSamples(Resonix::SINE, 2, 100.0f);
+     * auto mix  = Resonix::Signal(low.get(), 2 * Resonix::SAMPLE_RATE) * 0.3f
+     *           + Resonix::tone(Resonix::SINE, 440.0f) * 0.5f
+     *           + Resonix::lowpass(Resonix::tone(Resonix::SAWTOOTH, 3000.0f), 4000.0f) * 0.3f;
+     * Resonix::SampleBuffer samples = Resonix::materialize(mix);
+     */
+    template <typename Derived>
+    struct SignalExpression {
+        Derived& derived() { return static_cast<Derived&>(*this); }
+        const Derived& derived() const { return static_cast<const Derived&>(*this); }
+    };
+
+    /**
+     * @class Signal
+     * @brief Non-owning view of existing samples as an expression leaf
+     *
+     * Samples past length read as silence, like a Graph input node, so an
+     * explicit evaluate() or materialize() length may exceed the buffer.
+     *
+     * @note The viewed buffer must outlive every evaluation of the expression
+     */
+    class Signal : public SignalExpression<Signal> {
+    public:
+        Signal(const float* samples, long long length) : samples_(samples), block_(samples), length_(length) {}
+
+        long long length() const { return length_; }
+        void prepare(long long offset, int count) {
+            if (offset + count <= length_) {
+                // Whole block inside the buffer: read it in place
+                block_ = samples_ + offset;
+                return;
+            }
+
+            tail_.assign(static_cast<size_t>(count), 0.0f);
+            for (long long i = offset; i < length_; i++) {
+                tail_[static_cast<size_t>(i - offset)] = samples_[i];
+            }
+            block_ = tail_.data();
+        }
+
+        float at(int i) const { return block_[i]; }
+
+    private:
+        const float* samples_;
+        const float* block_;
+        long long length_;
+        std::vector<float> tail_;   // Zero-padded copy of a block that runs past length_
+    };
+
+    /** @brief Constant operand, produced implicitly by arithmetic with a float */
+    class ScalarSignal : public SignalExpression<ScalarSignal> {
+    public:
+        explicit ScalarSignal(float value) : value_(value) {}
+
+        long long length() const { return -1; }
+        void prepare(long long, int) {}
+        float at(int) const { return value_; }
+
+    private:
+        float value_;
+    };
+
+    /** @brief Generator leaf rendering an Oscillator one block at a time */
+    class ToneSignal : public SignalExpression<ToneSignal> {
+    public:
+        ToneSignal(Shape shape, float frequency, long long length, unsigned long long seed = 0)
+            : oscillator_(shape, frequency, length, seed) {}
+
+        long long length() const { return -1; }
+
+        void prepare(long long offset, int count) {
+            if (block_.empty())
+                block_.resize(SIGNAL_BLOCK_LENGTH);
+            oscillator_.seek(offset);
+            oscillator_.render(block_.data(), count);
+        }
+
+        float at(int i) const { return block_[static_cast<size_t>(i)]; }
+
+    private:
+        Oscillator oscillator_;
+        std::vector<float> block_;
+    };
+
+    /** @brief Biquad stage; its input subtree is evaluated into a block and filtered in place */
+    template <typename E>
+    class FilteredSignal : public SignalExpression<FilteredSignal<E>> {
+    public:
+        FilteredSignal(const E& input, const Filter::BiquadFilter& filter) : input_(input), filter_(filter) {}
+
+        long long length() const { return input_.length(); }
+
+        void prepare(long long offset, int count) {
+            if (block_.empty())
+                block_.resize(SIGNAL_BLOCK_LENGTH);
+
+            input_.prepare(offset, count);
+            for (int i = 0; i < count; i++) {
+                block_[static_cast<size_t>(i)] = input_.at(i);
+            }
+            filter_.process(block_.data(), block_.data(), count);
+        }
+
+        float at(int i) const { return block_[static_cast<size_t>(i)]; }
+
+    private:
+        E input_;
+        Filter::BiquadFilter filter_;
+        std::vector<float> block_;
+    };
+
+    /** @brief Formant stage, evaluated like FilteredSignal */
+    template <typename E>
+    class FormantSignal : public SignalExpression<FormantSignal<E>> {
+    public:
+        FormantSignal(const E& input, const Filter::FormantFilter& filter) : input_(input), filter_(filter) {}
+
+        long long length() const { return input_.length(); }
+
+        void prepare(long long offset, int count) {
+            if (block_.empty())
+                block_.resize(SIGNAL_BLOCK_LENGTH);
+
+            input_.prepare(offset, count);
+            for (int i = 0; i < count; i++) {
+                block_[static_cast<size_t>(i)] = input_.at(i);
+            }
+            filter_.process(block_.data(), block_.data(), count);
+        }
+
+        float at(int i) const { return block_[static_cast<size_t>(i)]; }
+
+    private:
+        E input_;
+        Filter::FormantFilter filter_;
+        std::vector<float> block_;
+    };
+
+    struct AddOp { static float apply(float a, float b) { return a + b; } };
+    struct SubtractOp { static float apply(float a, float b) { return a - b; } };
+    struct MultiplyOp { static float apply(float a, float b) { return a * b; } };
+    struct DivideOp { static float apply(float a, float b) { return a / b; } };
+
+    /** @brief Element-wise combination of two expressions */
+    template <typename L, typename R, typename Op>
+    class BinarySignal : public SignalExpression<BinarySignal<L, R, Op>> {
+    public:
+        BinarySignal(const L& left, const R& right) : left_(left), right_(right) {}
+
+        long long length() const {
+            long long a = left_.length(), b = right_.length();
+
+            if (a < 0) return b;
+            if (b < 0) return a;
+            return a < b ? a : b;
+        }
+
+        void prepare(long long offset, int count) {
+            left_.prepare(offset, count);
+            right_.prepare(offset, count);
+        }
+
+        float at(int i) const { return Op::apply(left_.at(i), right_.at(i)); }
+
+    private:
+        L left_;
+        R right_;
+    };
+
+#define RESONIX_SIGNAL_OPERATOR(symbol, Op)                                                          \
+    template <typename L, typename R>                                                                \
+    BinarySignal<L, R, Op> operator symbol(const SignalExpression<L>& l, const SignalExpression<R>& r) { \
+        return BinarySignal<L, R, Op>(l.derived(), r.derived());                                     \
+    }                                                                                                \
+    template <typename L>                                                                            \
+    BinarySignal<L, ScalarSignal, Op> operator symbol(const SignalExpression<L>& l, float r) {       \
+        return BinarySignal<L, ScalarSignal, Op>(l.derived(), ScalarSignal(r));                      \
+    }                                                                                                \
+    template <typename R>                                                                            \
+    BinarySignal<ScalarSignal, R, Op> operator symbol(float l, const SignalExpression<R>& r) {       \
+        return BinarySignal<ScalarSignal, R, Op>(ScalarSignal(l), r.derived());                      \
+    }
+
+    RESONIX_SIGNAL_OPERATOR(+, AddOp)
+    RESONIX_SIGNAL_OPERATOR(-, SubtractOp)
+    RESONIX_SIGNAL_OPERATOR(*, MultiplyOp)
+    RESONIX_SIGNAL_OPERATOR(/, DivideOp)
+
+#undef RESONIX_SIGNAL_OPERATOR
+
+    template <typename E>
+    BinarySignal<ScalarSignal, E, MultiplyOp> operator-(const SignalExpression<E>& e) {
+        return BinarySignal<ScalarSignal, E, MultiplyOp>(ScalarSignal(-1.0f), e.derived());
+    }
+
+    /**
+     * @brief Lazy waveform source
+     *
+     * @param length Span of the window for HANN and PHASED_HANN, in samples
+     */
+    inline ToneSignal tone(Shape shape, float frequency, long long length = SAMPLE_RATE) {
+        return ToneSignal(shape, frequency, length);
+    }
+
+    /** @brief Lazy seeded NOISE_WHITE, NOISE_PINK or NOISE_BROWN source */
+    inline ToneSignal noise(Shape shape, unsigned long long seed = 0) {
+        return ToneSignal(shape, 0.0f, -1, seed);
+    }
+
+    /** @brief Lazy lowpass_filter() over an expression */
+    template <typename E>
+    FilteredSignal<E> lowpass(const SignalExpression<E>& input, float cutoff_hz, float resonance = 0.707f) {
+        return FilteredSignal<E>(input.derived(), Filter::make_lowpass_filter(cutoff_hz, resonance));
+    }
+
+    /** @brief Lazy highpass_filter() over an expression */
+    template <typename E>
+    FilteredSignal<E> highpass(const SignalExpression<E>& input, float cutoff_hz, float resonance = 0.707f) {
+        return FilteredSignal<E>(input.derived(), Filter::make_highpass_filter(cutoff_hz, resonance));
+    }
+
+    /** @brief Lazy bandpass_filter() over an expression */
+    template <typename E>
+    FilteredSignal<E> bandpass(const SignalExpression<E>& input, float center_hz, float bandwidth_hz, float resonance = 0.707f) {
+        return FilteredSignal<E>(input.derived(), Filter::make_bandpass_filter(center_hz, bandwidth_hz, resonance));
+    }
+
+    /** @brief Lazy formant_filter() over an expression */
+    template <typename E>
+    FormantSignal<E> formant(const SignalExpression<E>& input, float peak, float mix, float spread) {
+        Filter::FormantFilter filter;
+        filter.setup(peak, mix, spread);
+        return FormantSignal<E>(input.derived(), filter);
+    }
+
+    /**
+     * @brief Evaluates an expression into an existing buffer in one pass
+     *
+     * Works on a copy of the expression, so the same expression can be
+     * evaluated repeatedly with fresh filter state.
+     */
+    template <typename E>
+    void evaluate(const SignalExpression<E>& expression, float* output, long long length) {
+        E expr = expression.derived();
+        float* out;
+        int count, i;
+
+        for (long long offset = 0; offset < length; offset += count) {
+            count = static_cast<int>(length - offset < SIGNAL_BLOCK_LENGTH ? length - offset : SIGNAL_BLOCK_LENGTH);
+            out = output + offset;
+
+            expr.prepare(offset, count);
+            for (i = 0; i < count; i++) {
+                out[i] = expr.at(i);
+            }
+        }
+    }
+
+    /**
+     * @brief Evaluates an expression into a newly allocated buffer
+     *
+     * @param length Samples to produce; -1 uses the shortest Signal in the expression
+     * @return Resonix::SampleBuffer Evaluated samples, or nullptr if the length is unknown or not positive
+     */
+    template <typename E>
+    Resonix::SampleBuffer materialize(const SignalExpression<E>& expression, long long length = -1) {
+        if (length < 0)
+            length = expression.derived().length();
+        if (length <= 0)
+            return nullptr;
+
+        auto samples = Resonix::allocateSamples(static_cast<size_t>(length));
+        evaluate(expression, samples.get(), length);
+        return samples;
+    }
+}
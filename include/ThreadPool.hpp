@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Resonix {
+    /**
+     * @class ThreadPool
+     * @brief Work-stealing thread pool
+     *
+     * Every worker owns a task deque. Tasks submitted from a worker go to its own
+     * deque and are taken back LIFO, which keeps freshly produced data in that
+     * core's cache; idle workers steal FIFO from the other end of their peers'
+     * deques. Threads outside the pool can help drain work while they wait.
+     *
+     * @example
+     * std::atomic<int> remaining{2};
+     * auto& pool = Resonix::ThreadPool::global();
+     * pool.submit([&] { renderLeft(); remaining--; });
+     * pool.submit([&] { renderRight(); remaining--; });
+     * pool.wait(remaining);
+     */
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+
+        /**
+         * @param thread_count Number of worker threads; 0 uses the hardware concurrency
+         */
+        explicit ThreadPool(unsigned thread_count = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /** @brief Queues a task, on the calling worker's own deque when possible */
+        void submit(Task task);
+
+        /**
+         * @brief Runs one queued task on the calling thread
+         *
+         * @return bool true if a task was run, false if every deque was empty
+         */
+        bool runPending();
+
+        /** @brief Helps execute tasks until remaining drops to zero */
+        void wait(const std::atomic<int>& remaining);
+
+        /** @brief Number of worker threads */
+        unsigned size() const { return static_cast<unsigned>(threads_.size()); }
+
+        /** @brief Process-wide pool sized to the hardware concurrency */
+        static ThreadPool& global();
+
+    private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void workerLoop(unsigned index);
+        bool popTask(int self, Task& task);
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::vector<std::thread> threads_;
+        std::atomic<int> queued_;
+        std::atomic<unsigned> next_;
+        std::mutex sleep_mutex_;
+        std::condition_variable sleep_cv_;
+        bool stopping_;
+    };
+}
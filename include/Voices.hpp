@@ -0,0 +1,174 @@
+#pragma once
+
+#include <vector>
+#include "Filter.hpp"
+#include "Modulation.hpp"
+#include "Resonix.hpp"
+
+namespace Resonix {
+    /**
+     * @enum NoteEventType
+     * @brief Kind of a scheduled NoteEvent
+     */
+    enum NoteEventType {
+        NOTE_ON,       ///< Starts a voice playing note
+        NOTE_OFF,      ///< Releases every voice playing note
+        ALL_NOTES_OFF  ///< Releases every voice
+    };
+
+    /**
+     * @struct NoteEvent
+     * @brief One timed instruction for a VoiceAllocator
+     */
+    struct NoteEvent {
+        long long time = 0;         // Absolute sample index at which the event takes effect
+        NoteEventType type = NOTE_ON;
+        int note = 0;               // Matches a NOTE_OFF to its NOTE_ON; negative ids are reserved for addNote()
+        Shape shape = SINE;         // NOTE_ON only
+        float frequency = 0.0f;     // NOTE_ON only, in Hz
+        float velocity = 1.0f;      // NOTE_ON only, peak gain of the voice
+    };
+
+    /**
+     * @struct VoiceStats
+     * @brief Counters of a VoiceAllocator since construction or reset()
+     */
+    struct VoiceStats {
+        long long notes = 0;        // NOTE_ON events played
+        long long steals = 0;       // NOTE_ONs that had to take a busy voice
+        int active = 0;             // Voices sounding now, releasing ones included
+        int peak_active = 0;        // Most voices sounding at once
+    };
+
+    /**
+     * @class VoiceAllocator
+     * @brief Fixed pool of voices playing a time-ordered list of note events
+     *
+     * Events are queued with schedule() or addNote() and take effect on
+     * exactly their sample while render() streams the mix bus block by block:
+     * each block is split at the event times, and every segment adds all
+     * sounding voices straight into the bus, grouped by shape, without
+     * per-voice buffers. The shape is dispatched once per voice and segment,
+     * outside the vectorized sample loop.
+     *
+     * Every voice is allocated up front. When all of them are busy, a NOTE_ON
+     * takes over the oldest releasing voice, or failing that the oldest voice.
+     * Every voice is shaped by its own Envelope, by default a fade in and out
+     * over DECLICK_FRAMES so starts and releases do not click; a stolen voice
+     * is cut without a fade. The envelope is read as ramps and multiplied in
+     * inside the same sample loop that adds the voice to the bus.
+     *
+     * With setFilter(), each voice runs through its own copy of a FilterChain,
+     * reset on every NOTE_ON.
+     *
+     * @example
+     * Resonix::VoiceAllocator synth(128);
+     * synth.addNote(0, 22050, Resonix::SAWTOOTH, 220.0f, 0.3f);
+     * synth.addNote(11025, 22050, Resonix::SINE, 330.0f, 0.3f);
+     * float block[512];
+     * synth.render(block, 512);
+     */
+    class VoiceAllocator {
+    public:
+        /** @brief Default size of the voice pool */
+        static constexpr int DEFAULT_VOICE_COUNT = 64;
+        static constexpr int MAX_VOICE_COUNT = 1024;
+        /** @brief Length of the default fade at the start and release of every note */
+        static constexpr int DECLICK_FRAMES = 64;
+
+        /** @param voice_count Size of the pool, clamped to [1, MAX_VOICE_COUNT] */
+        explicit VoiceAllocator(int voice_count = DEFAULT_VOICE_COUNT);
+
+        /**
+         * @brief Queues an event
+         *
+         * Events may be scheduled in any order; those sharing a time apply
+         * releases before starts, then in the order they were scheduled.
+         *
+         * @return bool false if the event lies before position(), or a NOTE_ON
+         * has a shape other than SINE, COSINE, SQUARE, TRIANGLE or SAWTOOTH, a
+         * non-positive frequency or a negative velocity
+         */
+        bool schedule(const NoteEvent& event);
+
+        /**
+         * @brief Queues a NOTE_ON and its NOTE_OFF under a fresh reserved note id
+         *
+         * @param start Sample index of the NOTE_ON
+         * @param duration Samples until the NOTE_OFF; the release follows it
+         * @return bool false if schedule() would reject the NOTE_ON or duration <= 0
+         */
+        bool addNote(long long start, long long duration, Shape shape, float frequency, float velocity = 1.0f);
+
+        /**
+         * @brief Runs every voice through a copy of chain from now on
+         *
+         * Copies are made for the whole pool here, not per note. An empty chain
+         * turns per-voice filtering off.
+         */
+        void setFilter(const Filter::FilterChain& chain);
+
+        /**
+         * @brief Shapes every note started from now on with envelope
+         *
+         * The envelope is copied into every voice, which restarts it on NOTE_ON
+         * and releases it on NOTE_OFF; a voice is freed once its envelope is
+         * idle. Its levels are scaled by the velocity of the note.
+         */
+        void setEnvelope(const Envelope& envelope);
+
+        /**
+         * @brief Renders the next frames of the mix and advances position()
+         *
+         * @param output Destination of frames samples; overwritten, not added to
+         * @param frames Number of samples to render
+         */
+        void render(float* output, int frames);
+
+        /** @brief Silences every voice, drops queued events and restarts at sample 0 */
+        void reset();
+
+        long long position() const { return position_; }
+        int voiceCount() const { return static_cast<int>(voices_.size()); }
+        size_t pendingEvents() const { return events_.size(); }
+        VoiceStats stats() const { return stats_; }
+
+    private:
+        struct Voice {
+            bool active = false;
+            bool releasing = false;
+            int note = 0;
+            Shape shape = SINE;
+            float frequency = 0.0f;
+            long long age = 0;          // Samples since the NOTE_ON
+            long long started = 0;      // NOTE_ON order, for stealing the oldest
+            float velocity = 0.0f;
+            Envelope envelope;
+            Filter::FilterChain filter;
+        };
+
+        struct Queued {
+            NoteEvent event;
+            long long order;
+        };
+
+        void apply(const NoteEvent& event);
+        void release(Voice& voice);
+        Voice& allocate();
+        void renderSegment(float* output, int frames);
+        void renderVoice(Voice& voice, float* output, int frames);
+
+        std::vector<Voice> voices_;
+        std::vector<int> sounding_;         // Indices of active voices, grouped by shape per segment
+        std::vector<Queued> events_;        // Min-heap on time, releases first, then scheduling order
+        SampleBuffer scratch_;              // One segment of one voice, for per-voice filtering
+        Envelope envelope_;                 // Copied into a voice on every NOTE_ON
+        bool filtered_;
+        bool regroup_;                      // sounding_ changed since it was last grouped
+        long long position_;
+        long long scheduled_;
+        long long started_;
+        int next_note_;
+        VoiceStats stats_;
+    };
+}
@@ -1,143 +1,666 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <stdexcept>
 #include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 #include "Resonix.hpp"
+#include "Graph.hpp"
+#include "Oscillator.hpp"
+#include "AudioFile.hpp"
+#include "Dispatch.hpp"
+#include "Dynamics.hpp"
+#include "FM.hpp"
+#include "Instrument.hpp"
+#include "Modulation.hpp"
+#include "Realtime.hpp"
+#include "Reverb.hpp"
+#include "Voices.hpp"
 
 namespace py = pybind11;
 
-py::array_t<float> generateSamplesNumPy(Resonix::Shape shape, int sample_length, float frequency) {
+/*
+ * GIL policy. Kernels that only touch arrays and buffers (generators, filters,
+ * encoders, analysis, one-shot resampling and graph evaluation) release the
+ * GIL while they run, so Python threads scale across cores. Objects that carry
+ * streaming state between calls (oscillators, filter chains, modulation
+ * sources, Dynamics, Reverb, Resampler, voices, stream iterators and the
+ * RenderThread/SinkThread controls) are not synchronized, so their methods
+ * keep the GIL held and it serves as their lock. Graph and AudioFileWriter
+ * lock themselves and RenderThread::read() guards its consumer side, so those
+ * release it as well.
+ */
+
+// Releases a pooled block when NumPy frees the array that owns it
+void releasePooled(void* memory) {
+    Resonix::BufferPool::release(memory);
+}
+
+// Hands ownership of a sample buffer to a NumPy array without copying
+py::array_t<float> toNumPy(Resonix::SampleBuffer samples, py::ssize_t length) {
+    float* raw_ptr = samples.release();
+    py::capsule free_when_done(raw_ptr, releasePooled);
+
+    return py::array_t<float>(
+        {length},
+        {static_cast<py::ssize_t>(sizeof(float))},
+        raw_ptr,
+        free_when_done
+    );
+}
+
+// Uninitialized C-contiguous array on pooled memory, for outputs that are fully overwritten
+template <typename T>
+py::array_t<T> pooledArray(const std::vector<py::ssize_t>& shape) {
+    size_t count = 1;
+
+    for (py::ssize_t extent : shape) {
+        count *= static_cast<size_t>(extent);
+    }
+
+    void* memory = Resonix::BufferPool::global().allocate(count * sizeof(T));
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+
+    py::capsule free_when_done(memory, releasePooled);
+    return py::array_t<T>(shape, static_cast<T*>(memory), free_when_done);
+}
+
+/*
+ * Dither seed of one encoding call. Every call draws its own stream, so
+ * encoding a signal twice, or the same signal into two files, does not repeat
+ * one noise pattern; the sequence restarts with the process, so a script
+ * encodes the same bits on every run.
+ */
+unsigned long long ditherSeed() {
+    static std::atomic<unsigned long long> calls{0};
+    unsigned long long z = (calls.fetch_add(1, std::memory_order_relaxed) + 1) * 0x9E3779B97F4A7C15ULL;
+
+    // splitmix64 finalizer, so the seeds of consecutive calls (and their channels, seed + c) do not overlap
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uninitialized array for samples encoded as format; INT24 is uint8 with a trailing axis of 3 bytes
+py::array encodedArray(std::vector<py::ssize_t> shape, Resonix::SampleFormat format) {
+    switch (format) {
+        case Resonix::INT16:
+            return pooledArray<int16_t>(shape);
+        case Resonix::INT24:
+            shape.push_back(3);
+            return pooledArray<uint8_t>(shape);
+        case Resonix::FLOAT16:
+            return pooledArray<uint16_t>(shape).attr("view")("float16").cast<py::array>();
+        case Resonix::FLOAT32:
+            break;
+    }
+    return pooledArray<float>(shape);
+}
+
+py::array generateSamplesNumPy(Resonix::Shape shape, int sample_length, float frequency,
+                               Resonix::SampleFormat sample_format = Resonix::FLOAT32, bool dither = true) {
+    Resonix::MemoryTag tag("Resonix::generateSamples");
     if (sample_length <= 0) {
         throw std::invalid_argument("sample_length must be positive");
     }
-    if (frequency <= 0.0f) {
+    if (frequency <= 0.0f && !Resonix::isNoise(shape)) {
         throw std::invalid_argument("frequency must be positive");
     }
 
-    std::unique_ptr<float[]> samples_ptr = Resonix::generateSamples(shape, sample_length, frequency);
+    if (sample_format != Resonix::FLOAT32) {
+        py::array encoded = encodedArray({static_cast<py::ssize_t>(sample_length) * Resonix::SAMPLE_RATE}, sample_format);
+        Resonix::Dither state{ditherSeed(), 0};
+        bool ok;
+        {
+            py::gil_scoped_release release;
+            ok = Resonix::generateSamples(shape, sample_length, frequency, sample_format, encoded.mutable_data(), dither ? &state : nullptr);
+        }
+        if (!ok) {
+            throw std::runtime_error("Failed to generate samples");
+        }
+        return encoded;
+    }
+
+    Resonix::SampleBuffer samples_ptr;
+    {
+        py::gil_scoped_release release;
+        samples_ptr = Resonix::generateSamples(shape, sample_length, frequency);
+    }
 
     if (!samples_ptr) {
         throw std::runtime_error("Failed to generate samples");
     }
 
-    size_t total_samples = static_cast<size_t>(sample_length) * Resonix::SAMPLE_RATE;
+    return toNumPy(std::move(samples_ptr), static_cast<py::ssize_t>(sample_length) * Resonix::SAMPLE_RATE);
+}
 
-    float* raw_ptr = samples_ptr.release();
+py::array generateNoiseNumPy(Resonix::Shape shape, int sample_length, unsigned long long seed,
+                             Resonix::SampleFormat sample_format = Resonix::FLOAT32, bool dither = true) {
+    Resonix::MemoryTag tag("Resonix::generateNoise");
+    if (sample_length <= 0) {
+        throw std::invalid_argument("sample_length must be positive");
+    }
+    if (!Resonix::isNoise(shape)) {
+        throw std::invalid_argument("shape must be NOISE_WHITE, NOISE_PINK or NOISE_BROWN");
+    }
 
-    auto cleanup = [](void *f) {
-        if (f) {
-            float *data = static_cast<float*>(f);
-            delete[] data;
+    if (sample_format != Resonix::FLOAT32) {
+        py::array encoded = encodedArray({static_cast<py::ssize_t>(sample_length) * Resonix::SAMPLE_RATE}, sample_format);
+        Resonix::Dither state{ditherSeed(), 0};
+        bool ok;
+        {
+            py::gil_scoped_release release;
+            ok = Resonix::generateNoise(shape, sample_length, seed, sample_format, encoded.mutable_data(), dither ? &state : nullptr);
+        }
+        if (!ok) {
+            throw std::runtime_error("Failed to generate noise");
         }
-    };
+        return encoded;
+    }
 
-    py::capsule free_when_done(raw_ptr, cleanup);
+    Resonix::SampleBuffer samples_ptr;
+    {
+        py::gil_scoped_release release;
+        samples_ptr = Resonix::generateNoise(shape, sample_length, seed);
+    }
 
-    return py::array_t<float>(
-        {static_cast<py::ssize_t>(total_samples)},
-        {sizeof(float)},
-        raw_ptr,
-        free_when_done
-    );
-}
+    if (!samples_ptr) {
+        throw std::runtime_error("Failed to generate noise");
+    }
 
-py::array_t<float> lowpassFilterNumPy(py::array_t<float> samples, float cutoff_hz, float resonance = 0.707f) {
-    py::buffer_info buf = samples.request();
+    return toNumPy(std::move(samples_ptr), static_cast<py::ssize_t>(sample_length) * Resonix::SAMPLE_RATE);
+}
 
-    if (buf.ndim != 1) {
+py::array_t<float> analyzeBlocksNumPy(py::array_t<float, py::array::c_style | py::array::forcecast> samples, int block_size) {
+    if (samples.ndim() != 1) {
         throw std::invalid_argument("samples must be a 1D array");
     }
-    if (buf.size == 0) {
+    if (samples.size() == 0) {
         throw std::invalid_argument("samples array cannot be empty");
     }
-    if (buf.format != py::format_descriptor<float>::format()) {
-        throw std::invalid_argument("samples must be float32 array");
+    if (block_size <= 0) {
+        throw std::invalid_argument("block_size must be positive");
     }
 
-    float* input_ptr = static_cast<float*>(buf.ptr);
-    int sample_length = static_cast<int>(buf.size);
+    py::ssize_t blocks = (samples.size() + block_size - 1) / block_size;
+    py::array_t<float> envelope({blocks, static_cast<py::ssize_t>(2)});
+    std::vector<float> peak(static_cast<size_t>(blocks)), rms(static_cast<size_t>(blocks));
+
+    {
+        py::gil_scoped_release release;
+        Resonix::analyzeBlocks(samples.data(), static_cast<long long>(samples.size()), block_size, peak.data(), rms.data());
+    }
+
+    auto out = envelope.mutable_unchecked<2>();
+    for (py::ssize_t b = 0; b < blocks; b++) {
+        out(b, 0) = peak[static_cast<size_t>(b)];
+        out(b, 1) = rms[static_cast<size_t>(b)];
+    }
+
+    return envelope;
+}
 
+// Parameter checks shared by every binding that builds a filter
+void checkPassFilter(float cutoff_hz, float resonance) {
     if (cutoff_hz <= 0.0f) {
         throw std::invalid_argument("cutoff_hz must be positive");
     }
     if (resonance < 0.5f || resonance > 10.0f) {
         throw std::invalid_argument("resonance must be between 0.5 and 10.0");
     }
+}
 
-    std::unique_ptr<float[]> filtered_ptr = Resonix::lowpass_filter(input_ptr, sample_length, cutoff_hz, resonance);
+void checkBandpassFilter(float center_hz, float bandwidth_hz, float resonance) {
+    if (center_hz <= 0.0f) {
+        throw std::invalid_argument("center_hz must be positive");
+    }
+    if (bandwidth_hz <= 0.0f) {
+        throw std::invalid_argument("bandwidth_hz must be positive");
+    }
+    if (resonance < 0.5f || resonance > 10.0f) {
+        throw std::invalid_argument("resonance must be between 0.5 and 10.0");
+    }
+}
 
-    if (!filtered_ptr) {
-        throw std::runtime_error("Failed to apply lowpass filter");
+void checkFormantFilter(float peak, float mix, float spread) {
+    if (peak < 0.0f || peak > 1.0f) {
+        throw std::invalid_argument("peak must be between 0.0 and 1.0");
+    }
+    if (mix < 0.0f || mix > 1.0f) {
+        throw std::invalid_argument("mix must be between 0.0 and 1.0");
     }
+    if (spread < 0.0f || spread > 1.0f) {
+        throw std::invalid_argument("spread must be between 0.0 and 1.0");
+    }
+}
 
-    float* raw_ptr = filtered_ptr.release();
+// Float view of a filtered block; double blocks are narrowed into scratch
+const float* floatBlock(const float* block, float*, int) {
+    return block;
+}
 
-    auto cleanup = [](void *f) {
-        if (f) {
-            float *data = static_cast<float*>(f);
-            delete[] data;
+const float* floatBlock(const double* block, float* scratch, int count) {
+    for (int i = 0; i < count; i++) {
+        scratch[i] = static_cast<float>(block[i]);
+    }
+    return scratch;
+}
+
+// Element strides of a 1D (frames) or 2D (channels x frames) array of T
+struct ChannelLayout {
+    py::ssize_t channels = 1;
+    py::ssize_t frames = 0;
+    std::ptrdiff_t channel_stride = 0;
+    std::ptrdiff_t frame_stride = 1;
+};
+
+template <typename T>
+ChannelLayout channelLayout(py::array& samples) {
+    ChannelLayout layout;
+
+    for (py::ssize_t axis = 0; axis < samples.ndim(); axis++) {
+        if (samples.strides(axis) % static_cast<py::ssize_t>(sizeof(T)) != 0) {
+            // Unaligned views (e.g. record fields) fall back to one contiguous copy
+            samples = py::array_t<T, py::array::c_style | py::array::forcecast>::ensure(samples);
+            break;
         }
-    };
+    }
 
-    py::capsule free_when_done(raw_ptr, cleanup);
+    layout.frames = samples.shape(samples.ndim() - 1);
+    layout.frame_stride = samples.strides(samples.ndim() - 1) / static_cast<py::ssize_t>(sizeof(T));
+    if (samples.ndim() == 2) {
+        layout.channels = samples.shape(0);
+        layout.channel_stride = samples.strides(0) / static_cast<py::ssize_t>(sizeof(T));
+    }
 
-    return py::array_t<float>(
-        {static_cast<py::ssize_t>(sample_length)},
-        {sizeof(float)},
-        raw_ptr,
-        free_when_done
-    );
+    if (layout.frames > std::numeric_limits<int>::max()) {
+        throw std::invalid_argument("too many frames per channel");
+    }
+    return layout;
 }
 
-py::array_t<float> highpassFilterNumPy(py::array_t<float> samples, float cutoff_hz, float resonance = 0.707f) {
-    py::buffer_info buf = samples.request();
+// The filtered array, or (filtered, stats) with one SignalStats per channel for 2D input
+py::object filterResult(py::array filtered, py::ssize_t ndim, const std::vector<Resonix::SignalStats>& stats, bool return_stats) {
+    if (!return_stats) {
+        return std::move(filtered);
+    }
+    if (ndim == 1) {
+        return py::make_tuple(std::move(filtered), stats[0]);
+    }
+    return py::make_tuple(std::move(filtered), py::cast(stats));
+}
 
-    if (buf.ndim != 1) {
-        throw std::invalid_argument("samples must be a 1D array");
+/**
+ * Filters a 1D (frames) or 2D (channels x frames) array of T in place of a copy:
+ * the input is read through its own strides, and each channel gets a fresh
+ * copy of the prototype filter. Output is a new C-contiguous array of T.
+ */
+template <typename T, typename Processor>
+py::object filterSamples(py::array samples, const Processor& prototype, bool return_stats) {
+    const ChannelLayout layout = channelLayout<T>(samples);
+    const py::ssize_t channels = layout.channels, frames = layout.frames;
+    const std::ptrdiff_t channel_stride = layout.channel_stride, frame_stride = layout.frame_stride;
+
+    std::vector<py::ssize_t> shape(samples.shape(), samples.shape() + samples.ndim());
+    py::array_t<T> filtered = pooledArray<T>(shape);
+    std::vector<Resonix::SignalStats> stats(return_stats ? static_cast<size_t>(channels) : 0);
+    const T* input = static_cast<const T*>(samples.data());
+    T* output = filtered.mutable_data();
+    int count = static_cast<int>(frames);
+
+    {
+        py::gil_scoped_release release;
+
+        for (py::ssize_t c = 0; c < channels; c++) {
+            Processor filter = prototype;
+            const T* in = input + c * channel_stride;
+            T* out = output + c * frames;
+
+            if (!return_stats) {
+                filter.process(in, frame_stride, out, 1, count);
+                continue;
+            }
+
+            // Analyze each block right after it is written, while it is still in cache
+            Resonix::StatsAccumulator accumulator;
+            float narrowed[Filter::STATS_BLOCK_LENGTH];
+            for (int start = 0; start < count; start += Filter::STATS_BLOCK_LENGTH) {
+                int length = count - start < Filter::STATS_BLOCK_LENGTH ? count - start : Filter::STATS_BLOCK_LENGTH;
+                filter.process(in + start * frame_stride, frame_stride, out + start, 1, length);
+                accumulator.add(floatBlock(out + start, narrowed, length), length);
+            }
+            stats[static_cast<size_t>(c)] = accumulator.result();
+        }
     }
-    if (buf.size == 0) {
+
+    return filterResult(std::move(filtered), samples.ndim(), stats, return_stats);
+}
+
+/**
+ * filterSamples() with encoded output: each channel is filtered into a
+ * cache-resident block that encodeSamples() quantizes straight into the
+ * result, so no full-size float array is allocated. Channel c dithers with
+ * stream c; statistics describe the samples before encoding.
+ */
+template <typename T, typename Processor>
+py::object filterEncodedSamples(py::array samples, const Processor& prototype, Resonix::SampleFormat format, bool dither, bool return_stats) {
+    const ChannelLayout layout = channelLayout<T>(samples);
+    const size_t sample_bytes = static_cast<size_t>(Resonix::bytesPerSample(format));
+
+    std::vector<py::ssize_t> shape(samples.shape(), samples.shape() + samples.ndim());
+    py::array encoded = encodedArray(shape, format);
+    std::vector<Resonix::SignalStats> stats(return_stats ? static_cast<size_t>(layout.channels) : 0);
+    const T* input = static_cast<const T*>(samples.data());
+    unsigned char* output = static_cast<unsigned char*>(encoded.mutable_data());
+    int count = static_cast<int>(layout.frames);
+    const unsigned long long seed = ditherSeed();
+
+    {
+        py::gil_scoped_release release;
+
+        for (py::ssize_t c = 0; c < layout.channels; c++) {
+            Processor filter = prototype;
+            Resonix::Dither state{seed + static_cast<unsigned long long>(c), 0};
+            Resonix::StatsAccumulator accumulator;
+            const T* in = input + c * layout.channel_stride;
+            unsigned char* out = output + static_cast<size_t>(c * layout.frames) * sample_bytes;
+            T block[Filter::STATS_BLOCK_LENGTH];
+            float narrowed[Filter::STATS_BLOCK_LENGTH];
+
+            for (int start = 0; start < count; start += Filter::STATS_BLOCK_LENGTH) {
+                int length = count - start < Filter::STATS_BLOCK_LENGTH ? count - start : Filter::STATS_BLOCK_LENGTH;
+                filter.process(in + start * layout.frame_stride, layout.frame_stride, block, 1, length);
+
+                const float* filtered = floatBlock(block, narrowed, length);
+                if (return_stats)
+                    accumulator.add(filtered, length);
+                Resonix::encodeSamples(filtered, length, format, out + static_cast<size_t>(start) * sample_bytes, dither ? &state : nullptr);
+            }
+
+            if (return_stats)
+                stats[static_cast<size_t>(c)] = accumulator.result();
+        }
+    }
+
+    return filterResult(std::move(encoded), samples.ndim(), stats, return_stats);
+}
+
+/*
+ * float32 and float64 run natively at any strides; other dtypes are converted
+ * to float32. With a sample_format the output is encoded instead of keeping
+ * the input dtype.
+ */
+template <typename Processor>
+py::object filterNumPy(py::array samples, const Processor& prototype, bool return_stats, py::object sample_format, bool dither) {
+    if (samples.ndim() != 1 && samples.ndim() != 2) {
+        throw std::invalid_argument("samples must be a 1D (frames) or 2D (channels x frames) array");
+    }
+    if (samples.size() == 0) {
         throw std::invalid_argument("samples array cannot be empty");
     }
-    if (buf.format != py::format_descriptor<float>::format()) {
-        throw std::invalid_argument("samples must be float32 array");
+
+    if (!sample_format.is_none()) {
+        auto format = sample_format.cast<Resonix::SampleFormat>();
+        if (py::isinstance<py::array_t<double>>(samples)) {
+            return filterEncodedSamples<double>(samples, prototype, format, dither, return_stats);
+        }
+        if (py::isinstance<py::array_t<float>>(samples)) {
+            return filterEncodedSamples<float>(samples, prototype, format, dither, return_stats);
+        }
+        return filterEncodedSamples<float>(py::array_t<float, py::array::forcecast>::ensure(samples), prototype, format, dither, return_stats);
     }
 
-    float* input_ptr = static_cast<float*>(buf.ptr);
-    int sample_length = static_cast<int>(buf.size);
+    if (py::isinstance<py::array_t<double>>(samples)) {
+        return filterSamples<double>(samples, prototype, return_stats);
+    }
+    if (py::isinstance<py::array_t<float>>(samples)) {
+        return filterSamples<float>(samples, prototype, return_stats);
+    }
+    return filterSamples<float>(py::array_t<float, py::array::forcecast>::ensure(samples), prototype, return_stats);
+}
 
-    if (cutoff_hz <= 0.0f) {
-        throw std::invalid_argument("cutoff_hz must be positive");
+py::object lowpassFilterNumPy(py::array samples, float cutoff_hz, float resonance = 0.707f, bool return_stats = false,
+                              py::object sample_format = py::none(), bool dither = true) {
+    // Same stage as the C++ function, which this path bypasses for the strided and float64 kernels
+    RESONIX_PROFILE("Resonix::lowpass_filter", samples.size());
+    Resonix::MemoryTag tag("Resonix::lowpass_filter");
+    checkPassFilter(cutoff_hz, resonance);
+
+    return filterNumPy(samples, Filter::make_lowpass_filter(cutoff_hz, resonance), return_stats, sample_format, dither);
+}
+
+py::object highpassFilterNumPy(py::array samples, float cutoff_hz, float resonance = 0.707f, bool return_stats = false,
+                               py::object sample_format = py::none(), bool dither = true) {
+    RESONIX_PROFILE("Resonix::highpass_filter", samples.size());
+    Resonix::MemoryTag tag("Resonix::highpass_filter");
+    checkPassFilter(cutoff_hz, resonance);
+
+    return filterNumPy(samples, Filter::make_highpass_filter(cutoff_hz, resonance), return_stats, sample_format, dither);
+}
+
+py::object bandpassFilterNumPy(py::array samples, float center_hz, float bandwidth_hz, float resonance = 0.707f, bool return_stats = false,
+                               py::object sample_format = py::none(), bool dither = true) {
+    RESONIX_PROFILE("Resonix::bandpass_filter", samples.size());
+    Resonix::MemoryTag tag("Resonix::bandpass_filter");
+    checkBandpassFilter(center_hz, bandwidth_hz, resonance);
+
+    return filterNumPy(samples, Filter::make_bandpass_filter(center_hz, bandwidth_hz, resonance), return_stats, sample_format, dither);
+}
+
+py::object formantFilterNumPy(py::array samples, float peak, float mix = 0.5f, float spread = 0.0f, bool return_stats = false,
+                              py::object sample_format = py::none(), bool dither = true) {
+    RESONIX_PROFILE("Resonix::formant_filter", samples.size());
+    Resonix::MemoryTag tag("Resonix::formant_filter");
+    checkFormantFilter(peak, mix, spread);
+
+    Filter::FormantFilter filter;
+    filter.setup(peak, mix, spread);
+
+    return filterNumPy(samples, filter, return_stats, sample_format, dither);
+}
+
+void checkDynamics(const Filter::DynamicsSettings& settings) {
+    if (!(settings.ratio >= 1.0f)) {
+        throw std::invalid_argument("ratio must be at least 1.0");
     }
-    if (resonance < 0.5f || resonance > 10.0f) {
-        throw std::invalid_argument("resonance must be between 0.5 and 10.0");
+    if (!(settings.attack_ms >= 0.0f) || !(settings.release_ms >= 0.0f)) {
+        throw std::invalid_argument("attack_ms and release_ms must be non-negative");
     }
+    if (!(settings.lookahead_ms >= 0.0f) || settings.lookahead_ms > Filter::Dynamics::MAX_LOOKAHEAD_MS) {
+        throw std::invalid_argument("lookahead_ms must be between 0 and 500");
+    }
+    if (!(settings.range_db <= 0.0f)) {
+        throw std::invalid_argument("range_db must not be positive");
+    }
+}
 
-    std::unique_ptr<float[]> filtered_ptr = Resonix::highpass_filter(input_ptr, sample_length, cutoff_hz, resonance);
+void checkReverb(const Filter::ReverbSettings& settings) {
+    if (settings.lines != 8 && settings.lines != 16) {
+        throw std::invalid_argument("lines must be 8 or 16");
+    }
+    if (!(settings.decay > 0.0f) || !(settings.size > 0.0f) || !(settings.damping_hz > 0.0f)) {
+        throw std::invalid_argument("decay, size and damping_hz must be positive");
+    }
+    if (!(settings.mix >= 0.0f && settings.mix <= 1.0f)) {
+        throw std::invalid_argument("mix must be between 0 and 1");
+    }
+}
+
+// Channel pointers of a C-contiguous 1D (frames) or 2D (channels x frames) float32 array
+std::vector<float*> channelPointers(py::array_t<float>& samples) {
+    const py::ssize_t channels = samples.ndim() == 2 ? samples.shape(0) : 1, frames = samples.shape(samples.ndim() - 1);
+    std::vector<float*> pointers(static_cast<size_t>(channels));
 
-    if (!filtered_ptr) {
-        throw std::runtime_error("Failed to apply highpass filter");
+    for (py::ssize_t c = 0; c < channels; c++) {
+        pointers[static_cast<size_t>(c)] = samples.mutable_data() + c * frames;
     }
+    return pointers;
+}
 
-    float* raw_ptr = filtered_ptr.release();
+std::vector<const float*> channelPointers(const py::array_t<float, py::array::c_style | py::array::forcecast>& samples) {
+    const py::ssize_t channels = samples.ndim() == 2 ? samples.shape(0) : 1, frames = samples.shape(samples.ndim() - 1);
+    std::vector<const float*> pointers(static_cast<size_t>(channels));
 
-    auto cleanup = [](void *f) {
-        if (f) {
-            float *data = static_cast<float*>(f);
-            delete[] data;
+    for (py::ssize_t c = 0; c < channels; c++) {
+        pointers[static_cast<size_t>(c)] = samples.data() + c * frames;
+    }
+    return pointers;
+}
+
+// Checks a 1D or (channels, frames) array for whole-buffer multichannel processing
+py::array_t<float, py::array::c_style | py::array::forcecast> channelsInput(py::array samples_arg, int max_channels) {
+    py::array_t<float, py::array::c_style | py::array::forcecast> samples = py::array_t<float, py::array::c_style | py::array::forcecast>::ensure(samples_arg);
+
+    if (!samples || (samples.ndim() != 1 && samples.ndim() != 2)) {
+        throw std::invalid_argument("samples must be a 1D (frames) or 2D (channels x frames) array");
+    }
+    if (samples.size() == 0) {
+        throw std::invalid_argument("samples array cannot be empty");
+    }
+    if (samples.ndim() == 2 && samples.shape(0) > max_channels) {
+        throw std::invalid_argument("at most " + std::to_string(max_channels) + " channels are supported");
+    }
+    if (samples.shape(samples.ndim() - 1) > std::numeric_limits<int>::max()) {
+        throw std::invalid_argument("too many frames per channel");
+    }
+    return samples;
+}
+
+// Destination of a multichannel process() call: out if given (it may be samples), else a new array
+py::array_t<float> channelsOutput(const py::array_t<float, py::array::c_style | py::array::forcecast>& samples, py::object out, int channels) {
+    const int expected = channels == 1 ? 1 : 2;
+
+    if (samples.ndim() != expected || (expected == 2 && samples.shape(0) != channels)) {
+        throw std::invalid_argument(channels == 1 ? "samples must be a 1D array"
+                                                  : "samples must be a (channels, frames) array with this processor's channel count");
+    }
+    if (samples.shape(samples.ndim() - 1) > std::numeric_limits<int>::max()) {
+        throw std::invalid_argument("too many frames per channel");
+    }
+
+    std::vector<py::ssize_t> shape(samples.shape(), samples.shape() + samples.ndim());
+    py::array_t<float> output;
+    if (out.is_none()) {
+        output = pooledArray<float>(shape);
+    } else {
+        if (!py::isinstance<py::array_t<float>>(out)) {
+            throw std::invalid_argument("out must be a float32 array");
+        }
+        output = out.cast<py::array_t<float>>();
+        if (output.ndim() != samples.ndim() || !std::equal(shape.begin(), shape.end(), output.shape()) || !(output.flags() & py::array::c_style)) {
+            throw std::invalid_argument("out must be a contiguous array with the shape of samples");
         }
-    };
+    }
+    return output;
+}
 
-    py::capsule free_when_done(raw_ptr, cleanup);
+// Returns processed as is without a sample_format, else encoded, one dither stream per channel
+py::array encodeChannels(py::array_t<float>& processed, py::object sample_format, bool dither) {
+    if (sample_format.is_none()) {
+        return std::move(processed);
+    }
 
-    return py::array_t<float>(
-        {static_cast<py::ssize_t>(sample_length)},
-        {sizeof(float)},
-        raw_ptr,
-        free_when_done
-    );
+    auto format = sample_format.cast<Resonix::SampleFormat>();
+    std::vector<py::ssize_t> shape(processed.shape(), processed.shape() + processed.ndim());
+    const py::ssize_t frames = shape.back();
+    const size_t sample_bytes = static_cast<size_t>(Resonix::bytesPerSample(format));
+    std::vector<float*> channels = channelPointers(processed);
+    py::array encoded = encodedArray(shape, format);
+    unsigned char* output = static_cast<unsigned char*>(encoded.mutable_data());
+    const unsigned long long seed = ditherSeed();
+
+    {
+        py::gil_scoped_release release;
+
+        for (size_t c = 0; c < channels.size(); c++) {
+            Resonix::Dither state{seed + c, 0};
+            Resonix::encodeSamples(channels[c], frames, format, output + c * static_cast<size_t>(frames) * sample_bytes, dither ? &state : nullptr);
+        }
+    }
+    return encoded;
 }
 
-py::array_t<float> bandpassFilterNumPy(py::array_t<float> samples, float center_hz, float bandwidth_hz, float resonance = 0.707f) {
+/*
+ * Runs a whole 1D or (channels x frames) array through linked dynamics with
+ * the lookahead compensated, so the output lines up with the input.
+ */
+py::array dynamicsNumPy(py::array samples_arg, const Filter::DynamicsSettings& settings, py::object sample_format, bool dither) {
+    py::array_t<float, py::array::c_style | py::array::forcecast> samples = channelsInput(samples_arg, Filter::Dynamics::MAX_CHANNELS);
+    checkDynamics(settings);
+
+    std::vector<py::ssize_t> shape(samples.shape(), samples.shape() + samples.ndim());
+    py::array_t<float> processed = pooledArray<float>(shape);
+    std::vector<float*> outputs = channelPointers(processed);
+    std::vector<const float*> inputs = channelPointers(samples);
+
+    {
+        py::gil_scoped_release release;
+        Filter::apply_dynamics(inputs.data(), outputs.data(), static_cast<int>(outputs.size()), static_cast<int>(shape.back()), settings);
+    }
+    return encodeChannels(processed, sample_format, dither);
+}
+
+py::array dynamicsProcessNumPy(Filter::Dynamics& dynamics, py::array_t<float, py::array::c_style | py::array::forcecast> samples, py::object out) {
+    Resonix::MemoryTag tag("Dynamics");
+    py::array_t<float> output = channelsOutput(samples, out, dynamics.channels());
+    std::vector<float*> outputs = channelPointers(output);
+    std::vector<const float*> inputs = channelPointers(samples);
+
+    dynamics.process(inputs.data(), outputs.data(), static_cast<int>(samples.shape(samples.ndim() - 1)));
+    return std::move(output);
+}
+
+/*
+ * Reverberates a whole 1D or (channels x frames) array, followed by tail
+ * seconds of the decay past its end.
+ */
+py::array reverbNumPy(py::array samples_arg, const Filter::ReverbSettings& settings, float tail, py::object sample_format, bool dither) {
+    py::array_t<float, py::array::c_style | py::array::forcecast> samples = channelsInput(samples_arg, Filter::Reverb::MAX_CHANNELS);
+    const double tail_frames = static_cast<double>(tail) * Resonix::SAMPLE_RATE;
+    const py::ssize_t frames = samples.shape(samples.ndim() - 1);
+
+    checkReverb(settings);
+    if (!(tail >= 0.0f) || static_cast<double>(frames) + tail_frames > std::numeric_limits<int>::max()) {
+        throw std::invalid_argument("tail must be non-negative and the output shorter than 2^31 frames");
+    }
+
+    std::vector<py::ssize_t> shape(samples.shape(), samples.shape() + samples.ndim());
+    shape.back() = frames + static_cast<py::ssize_t>(std::llround(tail_frames));
+    py::array_t<float> processed = pooledArray<float>(shape);
+    std::vector<float*> outputs = channelPointers(processed);
+    std::vector<const float*> inputs = channelPointers(samples);
+
+    {
+        py::gil_scoped_release release;
+        Filter::apply_reverb(inputs.data(), outputs.data(), static_cast<int>(outputs.size()), static_cast<int>(frames),
+                             static_cast<int>(shape.back() - frames), settings);
+    }
+    return encodeChannels(processed, sample_format, dither);
+}
+
+py::array reverbProcessNumPy(Filter::Reverb& reverb, py::array_t<float, py::array::c_style | py::array::forcecast> samples, py::object out) {
+    Resonix::MemoryTag tag("Reverb");
+    py::array_t<float> output = channelsOutput(samples, out, reverb.channels());
+    std::vector<float*> outputs = channelPointers(output);
+    std::vector<const float*> inputs = channelPointers(samples);
+
+    reverb.process(inputs.data(), outputs.data(), static_cast<int>(samples.shape(samples.ndim() - 1)));
+    return std::move(output);
+}
+
+py::array_t<float> resampleNumPy(py::array_t<float, py::array::c_style | py::array::forcecast> samples, int output_rate, int input_rate = Resonix::SAMPLE_RATE, Resampler::Quality quality = Resampler::MEDIUM) {
     py::buffer_info buf = samples.request();
 
     if (buf.ndim != 1) {
@@ -146,98 +669,573 @@ py::array_t<float> bandpassFilterNumPy(py::array_t<float> samples, float center_
     if (buf.size == 0) {
         throw std::invalid_argument("samples array cannot be empty");
     }
-    if (buf.format != py::format_descriptor<float>::format()) {
-        throw std::invalid_argument("samples must be float32 array");
+    if (input_rate <= 0 || output_rate <= 0) {
+        throw std::invalid_argument("sample rates must be positive");
     }
 
     float* input_ptr = static_cast<float*>(buf.ptr);
     int sample_length = static_cast<int>(buf.size);
+    int output_length = 0;
 
-    if (center_hz <= 0.0f) {
-        throw std::invalid_argument("center_hz must be positive");
+    Resonix::SampleBuffer resampled_ptr;
+    {
+        py::gil_scoped_release release;
+        resampled_ptr = Resonix::resample(input_ptr, sample_length, input_rate, output_rate, output_length, quality);
     }
-    if (bandwidth_hz <= 0.0f) {
-        throw std::invalid_argument("bandwidth_hz must be positive");
+
+    if (!resampled_ptr) {
+        throw std::runtime_error("Failed to resample: ratio cannot be tabulated");
     }
-    if (resonance < 0.5f || resonance > 10.0f) {
-        throw std::invalid_argument("resonance must be between 0.5 and 10.0");
+
+    return toNumPy(std::move(resampled_ptr), output_length);
+}
+
+py::array_t<float> resamplerProcessNumPy(Resampler::PolyphaseResampler& resampler, py::array_t<float, py::array::c_style | py::array::forcecast> samples) {
+    py::buffer_info buf = samples.request();
+
+    if (buf.ndim != 1) {
+        throw std::invalid_argument("samples must be a 1D array");
     }
 
-    std::unique_ptr<float[]> filtered_ptr = Resonix::bandpass_filter(input_ptr, sample_length, center_hz, bandwidth_hz, resonance);
+    int sample_length = static_cast<int>(buf.size);
+    py::array_t<float> output(resampler.maxOutputLength(sample_length));
+    int written = resampler.process(static_cast<float*>(buf.ptr), sample_length, output.mutable_data(), static_cast<int>(output.size()));
+
+    output.resize({static_cast<py::ssize_t>(written)});
+    return output;
+}
+
+py::array_t<float> resamplerFlushNumPy(Resampler::PolyphaseResampler& resampler) {
+    py::array_t<float> output(resampler.pendingOutputLength());
+    int written = resampler.flush(output.mutable_data(), static_cast<int>(output.size()));
 
-    if (!filtered_ptr) {
-        throw std::runtime_error("Failed to apply bandpass filter");
+    output.resize({static_cast<py::ssize_t>(written)});
+    return output;
+}
+
+Resonix::Graph::NodeId checkedNode(Resonix::Graph::NodeId node) {
+    if (node < 0) {
+        throw std::invalid_argument("invalid input node or parameters");
     }
+    return node;
+}
 
-    float* raw_ptr = filtered_ptr.release();
+py::array_t<float> graphRenderNumPy(Resonix::Graph& graph, int frames, int block_size) {
+    if (frames <= 0) {
+        throw std::invalid_argument("frames must be positive");
+    }
 
-    auto cleanup = [](void *f) {
-        if (f) {
-            float *data = static_cast<float*>(f);
-            delete[] data;
-        }
-    };
+    Resonix::SampleBuffer samples_ptr;
+    {
+        py::gil_scoped_release release;
+        samples_ptr = graph.render(frames, block_size);
+    }
 
-    py::capsule free_when_done(raw_ptr, cleanup);
+    if (!samples_ptr) {
+        throw std::runtime_error("Failed to render graph: it has no nodes");
+    }
 
-    return py::array_t<float>(
-        {static_cast<py::ssize_t>(sample_length)},
-        {sizeof(float)},
-        raw_ptr,
-        free_when_done
-    );
+    return toNumPy(std::move(samples_ptr), frames);
 }
 
-py::array_t<float> formantFilterNumPy(py::array_t<float> samples, float peak, float mix = 0.5f, float spread = 0.0f) {
-    py::buffer_info buf = samples.request();
+// Node of a lazy Python signal expression; lowered onto a Resonix::Graph when evaluated
+struct SignalNode {
+    enum Kind { INPUT, TONE, CONSTANT, ADD, SUBTRACT, MULTIPLY, DIVIDE, LOWPASS, HIGHPASS, BANDPASS, FORMANT };
+
+    Kind kind = CONSTANT;
+    std::vector<std::shared_ptr<SignalNode>> children;
+    py::array_t<float, py::array::c_style | py::array::forcecast> samples;
+    Resonix::Shape shape = Resonix::SINE;
+    unsigned long long seed = 0;
+    float params[3] = {0.0f, 0.0f, 0.0f};
+};
+
+using SignalPtr = std::shared_ptr<SignalNode>;
+
+SignalPtr makeSignal(SignalNode::Kind kind, std::vector<SignalPtr> children, float a = 0.0f, float b = 0.0f, float c = 0.0f) {
+    auto node = std::make_shared<SignalNode>();
+    node->kind = kind;
+    node->children = std::move(children);
+    node->params[0] = a;
+    node->params[1] = b;
+    node->params[2] = c;
+    return node;
+}
 
-    if (buf.ndim != 1) {
+SignalPtr signalFromArray(py::array_t<float, py::array::c_style | py::array::forcecast> samples) {
+    if (samples.ndim() != 1) {
         throw std::invalid_argument("samples must be a 1D array");
     }
-    if (buf.size == 0) {
+    if (samples.size() == 0) {
         throw std::invalid_argument("samples array cannot be empty");
     }
-    if (buf.format != py::format_descriptor<float>::format()) {
-        throw std::invalid_argument("samples must be float32 array");
+
+    auto node = std::make_shared<SignalNode>();
+    node->kind = SignalNode::INPUT;
+    node->samples = std::move(samples);
+    return node;
+}
+
+SignalPtr signalConstant(float value) {
+    return makeSignal(SignalNode::CONSTANT, {}, value);
+}
+
+// Shortest array input in the expression, or -1 if it only contains tones and constants
+long long signalLength(const SignalNode& node) {
+    long long length = -1, child_length;
+
+    if (node.kind == SignalNode::INPUT)
+        return static_cast<long long>(node.samples.size());
+
+    for (const SignalPtr& child : node.children) {
+        child_length = signalLength(*child);
+        if (child_length >= 0 && (length < 0 || child_length < length))
+            length = child_length;
     }
 
-    float* input_ptr = static_cast<float*>(buf.ptr);
-    int sample_length = static_cast<int>(buf.size);
+    return length;
+}
 
-    // Validate parameters
-    if (peak < 0.0f || peak > 1.0f) {
-        throw std::invalid_argument("peak must be between 0.0 and 1.0");
+using LoweredSignals = std::unordered_map<const SignalNode*, Resonix::Graph::NodeId>;
+
+Resonix::Graph::NodeId lowerSignal(Resonix::Graph& graph, const SignalNode& node, LoweredSignals& lowered);
+
+// Flattens sums, differences and scalar products into weighted terms of one mix node
+void collectTerms(Resonix::Graph& graph, const SignalNode& node, float gain, LoweredSignals& lowered,
+                  std::vector<Resonix::Graph::NodeId>& inputs, std::vector<float>& gains) {
+    const SignalNode* left = node.children.empty() ? nullptr : node.children[0].get();
+    const SignalNode* right = node.children.size() < 2 ? nullptr : node.children[1].get();
+
+    if (node.kind == SignalNode::ADD || node.kind == SignalNode::SUBTRACT) {
+        collectTerms(graph, *left, gain, lowered, inputs, gains);
+        collectTerms(graph, *right, node.kind == SignalNode::ADD ? gain : -gain, lowered, inputs, gains);
+        return;
     }
-    if (mix < 0.0f || mix > 1.0f) {
-        throw std::invalid_argument("mix must be between 0.0 and 1.0");
+
+    if (node.kind == SignalNode::MULTIPLY && right->kind == SignalNode::CONSTANT) {
+        collectTerms(graph, *left, gain * right->params[0], lowered, inputs, gains);
+        return;
     }
-    if (spread < 0.0f || spread > 1.0f) {
-        throw std::invalid_argument("spread must be between 0.0 and 1.0");
+
+    if (node.kind == SignalNode::MULTIPLY && left->kind == SignalNode::CONSTANT) {
+        collectTerms(graph, *right, gain * left->params[0], lowered, inputs, gains);
+        return;
+    }
+
+    inputs.push_back(lowerSignal(graph, node, lowered));
+    gains.push_back(gain);
+}
+
+Resonix::Graph::NodeId lowerSignal(Resonix::Graph& graph, const SignalNode& node, LoweredSignals& lowered) {
+    std::vector<Resonix::Graph::NodeId> inputs;
+    std::vector<float> gains;
+    Resonix::Graph::NodeId id = -1;
+
+    auto found = lowered.find(&node);
+    if (found != lowered.end())
+        return found->second;
+
+    switch (node.kind) {
+        case SignalNode::INPUT:
+            id = graph.addInput(node.samples.data(), static_cast<long long>(node.samples.size()));
+            break;
+        case SignalNode::TONE:
+            if (Resonix::isNoise(node.shape))
+                id = graph.addNoise(node.shape, node.seed);
+            else
+                id = graph.addOscillator(node.shape, node.params[0]);
+            break;
+        case SignalNode::CONSTANT:
+            id = graph.addConstant(node.params[0]);
+            break;
+        case SignalNode::MULTIPLY:
+            if (node.children[0]->kind != SignalNode::CONSTANT && node.children[1]->kind != SignalNode::CONSTANT) {
+                id = graph.addMultiply(lowerSignal(graph, *node.children[0], lowered),
+                                       lowerSignal(graph, *node.children[1], lowered));
+                break;
+            }
+            // Scaling by a constant is just a weighted term
+            [[fallthrough]];
+        case SignalNode::ADD:
+        case SignalNode::SUBTRACT:
+            collectTerms(graph, node, 1.0f, lowered, inputs, gains);
+            id = inputs.size() == 1 ? graph.addGain(inputs[0], gains[0]) : graph.addMix(inputs, gains);
+            break;
+        case SignalNode::DIVIDE:
+            id = graph.addDivide(lowerSignal(graph, *node.children[0], lowered),
+                                 lowerSignal(graph, *node.children[1], lowered));
+            break;
+        case SignalNode::LOWPASS:
+            id = graph.addLowpass(lowerSignal(graph, *node.children[0], lowered), node.params[0], node.params[1]);
+            break;
+        case SignalNode::HIGHPASS:
+            id = graph.addHighpass(lowerSignal(graph, *node.children[0], lowered), node.params[0], node.params[1]);
+            break;
+        case SignalNode::BANDPASS:
+            id = graph.addBandpass(lowerSignal(graph, *node.children[0], lowered), node.params[0], node.params[1], node.params[2]);
+            break;
+        case SignalNode::FORMANT:
+            id = graph.addFormant(lowerSignal(graph, *node.children[0], lowered), node.params[0], node.params[1], node.params[2]);
+            break;
     }
 
-    std::unique_ptr<float[]> filtered_ptr = Resonix::formant_filter(input_ptr, sample_length, peak, mix, spread);
+    lowered[&node] = id;
+    return id;
+}
+
+py::array_t<float> evaluateSignal(const SignalPtr& signal, py::object length_arg, int block_size) {
+    Resonix::Graph graph;
+    LoweredSignals lowered;
+    long long length = length_arg.is_none() ? signalLength(*signal) : length_arg.cast<long long>();
 
-    if (!filtered_ptr) {
-        throw std::runtime_error("Failed to apply formant filter");
+    if (length <= 0) {
+        throw std::invalid_argument("length is required for signals without array inputs and must be positive");
     }
 
-    float* raw_ptr = filtered_ptr.release();
+    graph.setOutput(lowerSignal(graph, *signal, lowered));
+
+    Resonix::SampleBuffer samples_ptr;
+    {
+        py::gil_scoped_release release;
+        samples_ptr = graph.render(static_cast<int>(length), block_size);
+    }
 
-    auto cleanup = [](void *f) {
-        if (f) {
-            float *data = static_cast<float*>(f);
-            delete[] data;
+    if (!samples_ptr) {
+        throw std::runtime_error("Failed to evaluate signal");
+    }
+
+    return toNumPy(std::move(samples_ptr), static_cast<py::ssize_t>(length));
+}
+
+// Streams the output of a graph into a file; memory use does not depend on frames
+void renderToFile(Resonix::Graph& graph, Resonix::AudioFileWriter& writer, long long frames, int block_size) {
+    bool rendered, written = true;
+
+    if (frames <= 0) {
+        throw std::invalid_argument("frames must be positive");
+    }
+    if (!writer.isOpen() || writer.channels() != 1) {
+        throw std::invalid_argument("writer must be open with 1 channel");
+    }
+
+    {
+        py::gil_scoped_release release;
+        rendered = graph.render(frames, [&writer, &written](const float* block, int count) {
+            written = written && writer.write(block, count);
+        }, block_size);
+    }
+
+    if (!rendered) {
+        throw std::runtime_error("Failed to render graph: it has no nodes");
+    }
+    if (!written) {
+        throw std::runtime_error("Failed to write audio file");
+    }
+}
+
+void writeSignalToFile(const SignalPtr& signal, Resonix::AudioFileWriter& writer, py::object length_arg, int block_size) {
+    Resonix::Graph graph;
+    LoweredSignals lowered;
+    long long length = length_arg.is_none() ? signalLength(*signal) : length_arg.cast<long long>();
+
+    if (length <= 0) {
+        throw std::invalid_argument("length is required for signals without array inputs and must be positive");
+    }
+
+    graph.setOutput(lowerSignal(graph, *signal, lowered));
+    renderToFile(graph, writer, length, block_size);
+}
+
+void writeArrayToFile(Resonix::AudioFileWriter& writer, py::array_t<float, py::array::c_style | py::array::forcecast> samples) {
+    if (!writer.isOpen()) {
+        throw std::runtime_error("writer is closed");
+    }
+    if (samples.ndim() == 1 ? writer.channels() != 1 : samples.ndim() != 2 || samples.shape(1) != writer.channels()) {
+        throw std::invalid_argument("samples must be 1D for mono or (frames, channels) matching the writer");
+    }
+
+    bool written;
+    {
+        py::gil_scoped_release release;
+        written = writer.write(samples.data(), samples.shape(0));
+    }
+    if (!written) {
+        throw std::runtime_error("Failed to write audio file");
+    }
+}
+
+// close() joins the writer thread, so the GIL is released while it drains
+void closeWriter(Resonix::AudioFileWriter& writer) {
+    bool closed;
+    {
+        py::gil_scoped_release release;
+        closed = !writer.isOpen() || writer.close();
+    }
+    if (!closed) {
+        throw std::runtime_error("Failed to write audio file");
+    }
+}
+
+/**
+ * Python handle of a mapped file. Arrays viewing the mapping share ownership
+ * of the reader, so close() only drops this handle's reference and the file
+ * stays mapped until the last view is gone.
+ */
+struct MappedFile {
+    std::shared_ptr<Resonix::AudioFileReader> reader;
+
+    Resonix::AudioFileReader& get() const {
+        if (!reader) {
+            throw std::runtime_error("reader is closed");
         }
-    };
+        return *reader;
+    }
+};
 
-    py::capsule free_when_done(raw_ptr, cleanup);
+MappedFile openMappedFile(const std::string& path, bool raw, int channels, Resonix::SampleFormat format, int sample_rate) {
+    MappedFile file{std::make_shared<Resonix::AudioFileReader>()};
 
-    return py::array_t<float>(
-        {static_cast<py::ssize_t>(sample_length)},
-        {sizeof(float)},
-        raw_ptr,
-        free_when_done
-    );
+    if (raw ? !file.reader->openRaw(path, channels, format, sample_rate) : !file.reader->open(path)) {
+        throw std::runtime_error("Failed to open " + path + (raw ? "" : " as a float32, int16 or int24 WAV file"));
+    }
+    return file;
+}
+
+void releaseMappedFile(void* reader) {
+    delete static_cast<std::shared_ptr<Resonix::AudioFileReader>*>(reader);
+}
+
+// Read-only view of the mapped samples, (frames, channels) or 1D for mono
+py::array mappedSamplesNumPy(const MappedFile& file) {
+    const Resonix::AudioFileReader& reader = file.get();
+    Resonix::ConstSampleSpan samples = reader.samples();
+
+    if (samples.empty()) {
+        throw std::invalid_argument("only float32 files can be viewed without conversion; use read() or blocks()");
+    }
+
+    py::capsule owner(new std::shared_ptr<Resonix::AudioFileReader>(file.reader), releaseMappedFile);
+    const py::ssize_t frame_bytes = static_cast<py::ssize_t>(sizeof(float)) * reader.channels();
+    py::array_t<float> view = reader.channels() == 1
+        ? py::array_t<float>({static_cast<py::ssize_t>(reader.frames())}, {frame_bytes}, samples.data(), owner)
+        : py::array_t<float>({static_cast<py::ssize_t>(reader.frames()), static_cast<py::ssize_t>(reader.channels())},
+                             {frame_bytes, static_cast<py::ssize_t>(sizeof(float))}, samples.data(), owner);
+
+    // The mapping is read-only; a write through the view would fault
+    view.attr("flags").attr("writeable") = false;
+    return view;
+}
+
+py::array_t<float> mappedReadNumPy(const MappedFile& file, long long offset, py::object frames_arg) {
+    Resonix::MemoryTag tag("AudioFileReader::read");
+    const Resonix::AudioFileReader& reader = file.get();
+    // Keeps the file mapped if another thread closes the handle while the GIL is released
+    const std::shared_ptr<Resonix::AudioFileReader> mapping = file.reader;
+
+    if (offset < 0 || offset > reader.frames()) {
+        throw std::invalid_argument("offset must be within the file");
+    }
+    long long frames = frames_arg.is_none() ? reader.frames() - offset : frames_arg.cast<long long>();
+    if (frames < 0) {
+        throw std::invalid_argument("frames must not be negative");
+    }
+    frames = std::min(frames, reader.frames() - offset);
+
+    py::array_t<float> samples = reader.channels() == 1
+        ? pooledArray<float>({static_cast<py::ssize_t>(frames)})
+        : pooledArray<float>({static_cast<py::ssize_t>(frames), static_cast<py::ssize_t>(reader.channels())});
+    float* output = samples.mutable_data();
+    {
+        py::gil_scoped_release release;
+        reader.read(offset, frames, output);
+    }
+    return samples;
+}
+
+/**
+ * Iterator of fixed-size blocks from an Oscillator, a 1D array or one channel
+ * of a mapped file, optionally run through a FilterChain. Every full block is
+ * the same NumPy array, refilled in place, so a stream of any length
+ * allocates no sample memory.
+ */
+struct BlockStream {
+    py::object oscillator;        // Resonix::Oscillator, or None to read source
+    py::object chain;             // Filter::FilterChain, or None
+    py::object file;              // MappedFile read instead of source, or None
+    int channel = 0;              // Channel of file
+    py::array_t<float> source;
+    long long position = 0;       // Read position in source
+    long long remaining = -1;     // Frames left to yield, -1 when unbounded
+    py::array_t<float> buffer;
+};
+
+BlockStream makeBlockStream(py::object oscillator, py::object chain, py::object source, int block_size, py::object frames, int channel = 0) {
+    BlockStream stream;
+
+    if (block_size <= 0) {
+        throw std::invalid_argument("block_size must be positive");
+    }
+
+    stream.oscillator = oscillator;
+    stream.chain = chain;
+    stream.remaining = frames.is_none() ? -1 : frames.cast<long long>();
+    if (!frames.is_none() && stream.remaining < 0) {
+        throw std::invalid_argument("frames must not be negative");
+    }
+
+    if (oscillator.is_none() && py::isinstance<MappedFile>(source)) {
+        if (channel < 0 || channel >= source.cast<const MappedFile&>().get().channels()) {
+            throw std::invalid_argument("channel out of range");
+        }
+        stream.file = source;
+        stream.channel = channel;
+    } else if (oscillator.is_none()) {
+        stream.source = py::array_t<float, py::array::c_style | py::array::forcecast>::ensure(source);
+        if (!stream.source || stream.source.ndim() != 1) {
+            throw std::invalid_argument("source must be an Oscillator, an AudioFileReader or a 1D array");
+        }
+    }
+
+    stream.buffer = py::array_t<float>(block_size);
+    return stream;
+}
+
+py::array_t<float> nextBlock(BlockStream& stream) {
+    py::ssize_t block_size = stream.buffer.shape(0);
+    long long count = block_size;
+    float* block = stream.buffer.mutable_data();
+    const float* input = block;
+
+    const Resonix::AudioFileReader* reader = stream.file.is_none() ? nullptr : &stream.file.cast<const MappedFile&>().get();
+
+    if (stream.remaining >= 0 && stream.remaining < count)
+        count = stream.remaining;
+    if (reader && reader->frames() - stream.position < count)
+        count = reader->frames() - stream.position;
+    else if (!reader && stream.oscillator.is_none() && stream.source.shape(0) - stream.position < count)
+        count = stream.source.shape(0) - stream.position;
+    if (count <= 0) {
+        throw py::stop_iteration();
+    }
+
+    if (!stream.oscillator.is_none()) {
+        stream.oscillator.cast<Resonix::Oscillator&>().render(block, static_cast<int>(count));
+    } else if (reader) {
+        // Mono float32 is filtered straight from the mapping; anything else is converted into the block
+        if (reader->channels() == 1 && !reader->samples().empty())
+            input = reader->samples().data() + stream.position;
+        else
+            reader->readChannel(stream.channel, stream.position, count, block);
+        stream.position += count;
+    } else {
+        input = stream.source.data() + stream.position;
+        stream.position += count;
+    }
+
+    if (!stream.chain.is_none()) {
+        stream.chain.cast<Filter::FilterChain&>().process(input, block, static_cast<int>(count));
+    } else if (input != block) {
+        std::copy(input, input + count, block);
+    }
+
+    if (stream.remaining >= 0)
+        stream.remaining -= count;
+
+    if (count == block_size) {
+        return stream.buffer;
+    }
+    // The final short block is a view of the front of the same buffer
+    return py::array_t<float>({static_cast<py::ssize_t>(count)}, {static_cast<py::ssize_t>(sizeof(float))}, block, stream.buffer);
+}
+
+// Destination of a streaming process() call: out if given (it may be samples), else a new array
+py::array_t<float> processOutput(const py::array_t<float, py::array::c_style | py::array::forcecast>& samples, py::object out) {
+    if (samples.ndim() != 1) {
+        throw std::invalid_argument("samples must be a 1D array");
+    }
+
+    py::array_t<float> output;
+    if (out.is_none()) {
+        output = pooledArray<float>({samples.shape(0)});
+    } else {
+        if (!py::isinstance<py::array_t<float>>(out)) {
+            throw std::invalid_argument("out must be a float32 array");
+        }
+        output = out.cast<py::array_t<float>>();
+        if (output.ndim() != 1 || output.shape(0) != samples.shape(0) || !(output.flags() & py::array::c_style)) {
+            throw std::invalid_argument("out must be a contiguous 1D array with the length of samples");
+        }
+    }
+    return output;
+}
+
+py::array_t<float> filterChainProcessNumPy(Filter::FilterChain& chain, py::array_t<float, py::array::c_style | py::array::forcecast> samples, py::object out) {
+    Resonix::MemoryTag tag("FilterChain");
+    py::array_t<float> output = processOutput(samples, out);
+
+    chain.process(samples.data(), output.mutable_data(), static_cast<int>(samples.shape(0)));
+    return output;
+}
+
+// Calls plain() without a gain, or scaled(source) with the Envelope or LFO passed as gain
+template <typename Plain, typename Scaled>
+void renderWithGain(const py::object& gain, Plain&& plain, Scaled&& scaled) {
+    if (gain.is_none()) {
+        plain();
+    } else if (py::isinstance<Resonix::Envelope>(gain)) {
+        scaled(gain.cast<Resonix::Envelope&>());
+    } else if (py::isinstance<Resonix::LFO>(gain)) {
+        scaled(gain.cast<Resonix::LFO&>());
+    } else {
+        throw std::invalid_argument("gain must be an Envelope, an LFO or None");
+    }
+}
+
+// Memory tag of the Envelope and LFO bindings
+template <typename Source>
+constexpr const char* modulationTag() { return std::is_same_v<Source, Resonix::Envelope> ? "Envelope" : "LFO"; }
+
+template <typename Source>
+py::array_t<float> modulationApplyNumPy(Source& source, py::array_t<float, py::array::c_style | py::array::forcecast> samples, py::object out) {
+    Resonix::MemoryTag tag(modulationTag<Source>());
+    py::array_t<float> output = processOutput(samples, out);
+
+    source.apply(samples.data(), output.mutable_data(), static_cast<int>(samples.shape(0)));
+    return output;
+}
+
+template <typename Source>
+py::array_t<float> modulationRenderNumPy(Source& source, int frames) {
+    if (frames <= 0) {
+        throw std::invalid_argument("frames must be positive");
+    }
+
+    Resonix::MemoryTag tag(modulationTag<Source>());
+    py::array_t<float> values = pooledArray<float>({frames});
+    source.render(values.mutable_data(), frames);
+    return values;
+}
+
+// Lowpass or highpass biquad whose cutoff follows an Envelope or LFO passed to each process() call
+struct SweepFilter {
+    Filter::BiquadFilter filter;
+    Filter::BiquadFilter (*design)(float, float);
+    float cutoff_hz;
+    float octaves;
+    float resonance;
+};
+
+template <typename Source>
+py::array_t<float> sweepProcessNumPy(SweepFilter& sweep, py::array_t<float, py::array::c_style | py::array::forcecast> samples,
+                                     Source& source, py::object out) {
+    Resonix::MemoryTag tag("SweepFilter");
+    py::array_t<float> output = processOutput(samples, out);
+    const float* input = samples.data();
+    float* data = output.mutable_data();
+    const int frames = static_cast<int>(samples.shape(0));
+
+    Resonix::sweepFilter(sweep.filter, source, sweep.design, input, data, frames, sweep.cutoff_hz, sweep.octaves, sweep.resonance);
+    return output;
 }
 
 PYBIND11_MODULE(resonix, m) {
@@ -255,42 +1253,218 @@ PYBIND11_MODULE(resonix, m) {
         .value("COTANGENT", Resonix::Shape::COTANGENT, "Cotangent wave")
         .value("HANN", Resonix::Shape::HANN, "Hann window")
         .value("PHASED_HANN", Resonix::Shape::PHASED_HANN, "Phase-shifted Hann window")
+        .value("NOISE_WHITE", Resonix::Shape::NOISE_WHITE, "Uniform white noise")
+        .value("NOISE_PINK", Resonix::Shape::NOISE_PINK, "Pink (1/f) noise")
+        .value("NOISE_BROWN", Resonix::Shape::NOISE_BROWN, "Brown (1/f^2) noise")
+        .export_values();
+
+    py::enum_<Resampler::Quality>(m, "ResampleQuality")
+        .value("FAST", Resampler::Quality::FAST, "8 taps per phase")
+        .value("MEDIUM", Resampler::Quality::MEDIUM, "16 taps per phase")
+        .value("HIGH", Resampler::Quality::HIGH, "32 taps per phase")
+        .value("BEST", Resampler::Quality::BEST, "64 taps per phase");
+
+    py::enum_<Resonix::FileFormat>(m, "FileFormat")
+        .value("WAV", Resonix::FileFormat::WAV, "RIFF WAVE, RF64 beyond 4 GiB")
+        .value("RAW", Resonix::FileFormat::RAW, "Headerless interleaved samples");
+
+    py::enum_<Resonix::SampleFormat>(m, "SampleFormat")
+        .value("FLOAT32", Resonix::SampleFormat::FLOAT32, "32-bit IEEE float")
+        .value("INT16", Resonix::SampleFormat::INT16, "16-bit signed PCM")
+        .value("INT24", Resonix::SampleFormat::INT24, "24-bit signed PCM, packed in 3 bytes")
+        .value("FLOAT16", Resonix::SampleFormat::FLOAT16, "16-bit IEEE float");
+
+    py::enum_<Resonix::Access>(m, "Access")
+        .value("NORMAL", Resonix::Access::ACCESS_NORMAL, "Default readahead")
+        .value("SEQUENTIAL", Resonix::Access::ACCESS_SEQUENTIAL, "Aggressive readahead, pages dropped after use")
+        .value("RANDOM", Resonix::Access::ACCESS_RANDOM, "No readahead");
+
+    py::enum_<Filter::DynamicsMode>(m, "DynamicsMode")
+        .value("COMPRESSOR", Filter::DYNAMICS_COMPRESSOR, "Reduce the level above the threshold by ratio")
+        .value("LIMITER", Filter::DYNAMICS_LIMITER, "Keep every sample peak at or below the threshold")
+        .value("GATE", Filter::DYNAMICS_GATE, "Attenuate below the threshold, down to range_db")
+        .export_values();
+
+    py::enum_<Resonix::EnvelopeCurve>(m, "EnvelopeCurve")
+        .value("LINEAR", Resonix::ENVELOPE_LINEAR, "Straight decay and release, reaching their target in exactly the set time")
+        .value("EXPONENTIAL", Resonix::ENVELOPE_EXPONENTIAL, "Exponential decay and release, falling 60 dB in the set time")
         .export_values();
 
-    m.def("generate_samples", &generateSamplesNumPy,
+    py::enum_<Resonix::EnvelopeStage>(m, "EnvelopeStage")
+        .value("IDLE", Resonix::ENVELOPE_IDLE)
+        .value("ATTACK", Resonix::ENVELOPE_ATTACK)
+        .value("DECAY", Resonix::ENVELOPE_DECAY)
+        .value("SUSTAIN", Resonix::ENVELOPE_SUSTAIN)
+        .value("RELEASE", Resonix::ENVELOPE_RELEASE);
+
+    m.def("generate_samples", &generateSamplesNumPy,
+          py::arg("shape"),
+          py::arg("sample_length"),
+          py::arg("frequency"),
+          py::arg("sample_format") = Resonix::SampleFormat::FLOAT32,
+          py::arg("dither") = true,
+          R"pbdoc(
+            Generate audio samples of the specified waveform shape.
+
+            Parameters
+            ----------
+            shape : Shape
+                The waveform shape to generate (e.g., Shape.SINE, Shape.SQUARE)
+            sample_length : int
+                Number of seconds to generate
+            frequency : float
+                Frequency of the waveform in Hz (e.g., 440.0 for A4)
+            sample_format : SampleFormat, optional
+                Encoding of the result (default: FLOAT32). Other formats are
+                quantized block by block as they are generated, so no float32
+                array of the full length is created
+            dither : bool, optional
+                Add TPDF dither before INT16 and INT24 rounding, a new noise
+                stream on every call (default: True)
+
+            Returns
+            -------
+            numpy.ndarray
+                Array of sample_length * SAMPLE_RATE samples in range [-1.0, 1.0]:
+                float32, int16 or float16 by sample_format, or uint8 of shape
+                (length, 3) holding little-endian packed INT24
+
+            Examples
+            --------
+            >>> import resonix
+            >>> samples = resonix.generate_samples(resonix.Shape.SINE, 1, 440.0)
+            >>> print(samples.shape)
+            (44100,)
+
+            >>> # Delivery format directly, half the memory of float32
+            >>> pcm = resonix.generate_samples(resonix.Shape.SINE, 1, 440.0, resonix.SampleFormat.INT16)
+            >>> pcm.dtype
+            dtype('int16')
+          )pbdoc");
+
+    m.def("generate_noise", &generateNoiseNumPy,
           py::arg("shape"),
           py::arg("sample_length"),
-          py::arg("frequency"),
+          py::arg("seed") = 0,
+          py::arg("sample_format") = Resonix::SampleFormat::FLOAT32,
+          py::arg("dither") = true,
           R"pbdoc(
-            Generate audio samples of the specified waveform shape.
+            Generate seeded white, pink or brown noise.
+
+            Every sample is computed from the seed and its index with a
+            counter-based (Philox) generator, so the result does not depend on
+            how the work is split across threads or blocks.
 
             Parameters
             ----------
             shape : Shape
-                The waveform shape to generate (e.g., Shape.SINE, Shape.SQUARE)
+                Shape.NOISE_WHITE, Shape.NOISE_PINK or Shape.NOISE_BROWN
             sample_length : int
                 Number of seconds to generate
-            frequency : float
-                Frequency of the waveform in Hz (e.g., 440.0 for A4)
+            seed : int, optional
+                Stream selector; equal seeds give equal noise (default: 0)
+            sample_format : SampleFormat, optional
+                Encoding of the result, see generate_samples() (default: FLOAT32)
+            dither : bool, optional
+                Add TPDF dither before INT16 and INT24 rounding, a new noise
+                stream on every call (default: True)
 
             Returns
             -------
             numpy.ndarray
-                Array of float32 samples in range [-1.0, 1.0]
-                Length will be sample_length * SAMPLE_RATE
+                Array of sample_length * SAMPLE_RATE samples in range [-1.0, 1.0],
+                encoded as in generate_samples()
 
             Examples
             --------
             >>> import resonix
-            >>> samples = resonix.generate_samples(resonix.Shape.SINE, 1, 440.0)
-            >>> print(samples.shape)
-            (44100,)
+            >>> noise = resonix.generate_noise(resonix.Shape.NOISE_PINK, 1, seed=7)
+          )pbdoc");
+
+    py::class_<Resonix::SignalStats>(m, "SignalStats", "Quality-control statistics returned by analyze()")
+        .def_readonly("length", &Resonix::SignalStats::length, "Number of samples analyzed")
+        .def_readonly("peak", &Resonix::SignalStats::peak, "Largest absolute finite sample")
+        .def_readonly("rms", &Resonix::SignalStats::rms, "Root mean square of the finite samples")
+        .def_readonly("dc_offset", &Resonix::SignalStats::dc_offset, "Mean of the finite samples")
+        .def_readonly("zero_crossings", &Resonix::SignalStats::zero_crossings, "Sign changes between adjacent finite samples")
+        .def_readonly("nan_count", &Resonix::SignalStats::nan_count, "Number of NaN samples")
+        .def_readonly("inf_count", &Resonix::SignalStats::inf_count, "Number of infinite samples")
+        .def("__repr__", [](const Resonix::SignalStats& st) {
+            return "SignalStats(length=" + std::to_string(st.length) +
+                   ", peak=" + std::to_string(st.peak) +
+                   ", rms=" + std::to_string(st.rms) +
+                   ", dc_offset=" + std::to_string(st.dc_offset) +
+                   ", zero_crossings=" + std::to_string(st.zero_crossings) +
+                   ", nan_count=" + std::to_string(st.nan_count) +
+                   ", inf_count=" + std::to_string(st.inf_count) + ")";
+        });
+
+    m.def("analyze", [](py::array_t<float, py::array::c_style | py::array::forcecast> samples) {
+              if (samples.ndim() != 1) {
+                  throw std::invalid_argument("samples must be a 1D array");
+              }
+              py::gil_scoped_release release;
+              return Resonix::analyze(samples.data(), static_cast<long long>(samples.size()));
+          },
+          py::arg("samples"),
+          R"pbdoc(
+            Compute signal statistics in a single pass.
+
+            Returns peak, RMS, DC offset, zero-crossing count and NaN/Inf counts
+            at once. NaN and infinite samples (e.g. from Shape.TANGENT) are
+            counted and excluded from the other statistics. Long buffers are
+            analyzed on several threads.
+
+            Parameters
+            ----------
+            samples : numpy.ndarray
+                1D array of audio samples
+
+            Returns
+            -------
+            SignalStats
+                Object with length, peak, rms, dc_offset, zero_crossings,
+                nan_count and inf_count attributes
+
+            Examples
+            --------
+            >>> import resonix
+            >>> samples = resonix.generate_samples(resonix.Shape.TANGENT, 1, 440.0)
+            >>> stats = resonix.analyze(samples)
+            >>> print(stats.peak, stats.rms, stats.nan_count)
+          )pbdoc");
+
+    m.def("analyze_blocks", &analyzeBlocksNumPy,
+          py::arg("samples"),
+          py::arg("block_size") = 512,
+          R"pbdoc(
+            Envelope follower: peak and RMS of every block.
+
+            Parameters
+            ----------
+            samples : numpy.ndarray
+                1D array of audio samples
+            block_size : int, optional
+                Samples per block; the last block may be shorter (default: 512)
+
+            Returns
+            -------
+            numpy.ndarray
+                float32 array of shape (blocks, 2) holding [peak, rms] per block
+
+            Examples
+            --------
+            >>> envelope = resonix.analyze_blocks(samples, 256)
+            >>> peaks, rms = envelope[:, 0], envelope[:, 1]
           )pbdoc");
 
     m.def("lowpass_filter", &lowpassFilterNumPy,
           py::arg("samples"),
           py::arg("cutoff_hz"),
           py::arg("resonance") = 0.707f,
+          py::arg("return_stats") = false,
+          py::arg("sample_format") = py::none(),
+          py::arg("dither") = true,
           R"pbdoc(
             Apply a lowpass filter to audio samples.
 
@@ -301,18 +1475,33 @@ PYBIND11_MODULE(resonix, m) {
             Parameters
             ----------
             samples : numpy.ndarray
-                1D array of float32 audio samples to filter
+                float32 or float64 samples, 1D or (channels, frames); strided views
+                such as x[::2] or x.T are read in place without a copy
             cutoff_hz : float
                 Cutoff frequency in Hz (e.g., 1000.0 for 1kHz lowpass)
             resonance : float, optional
                 Resonance/Q factor of the filter (default: 0.707 for Butterworth response)
                 Higher values create a resonant peak near the cutoff frequency.
                 Should be between 0.5 and 10.0 for stability.
+            return_stats : bool, optional
+                Also return analyze() statistics of the output, collected in the
+                same pass while each block is in cache (default: False)
+            sample_format : SampleFormat, optional
+                Encode the output as this format while each block is in cache
+                instead of keeping the input dtype (default: None)
+            dither : bool, optional
+                Add TPDF dither before INT16 and INT24 rounding, a new noise
+                stream per channel on every call (default: True)
 
             Returns
             -------
             numpy.ndarray
-                Array of filtered float32 samples with same length as input
+                Filtered samples with the dtype and shape of the input; float64 is
+                filtered in double precision, other dtypes are converted to float32.
+                With sample_format the dtype is float32, int16 or float16, or uint8
+                with a trailing axis of 3 for packed INT24
+                (filtered, SignalStats) tuple if return_stats is True; for 2D input
+                the second element is a list with one SignalStats per channel
 
             Examples
             --------
@@ -325,6 +1514,9 @@ PYBIND11_MODULE(resonix, m) {
           py::arg("samples"),
           py::arg("cutoff_hz"),
           py::arg("resonance") = 0.707f,
+          py::arg("return_stats") = false,
+          py::arg("sample_format") = py::none(),
+          py::arg("dither") = true,
           R"pbdoc(
             Apply a highpass filter to audio samples.
 
@@ -335,18 +1527,33 @@ PYBIND11_MODULE(resonix, m) {
             Parameters
             ----------
             samples : numpy.ndarray
-                1D array of float32 audio samples to filter
+                float32 or float64 samples, 1D or (channels, frames); strided views
+                such as x[::2] or x.T are read in place without a copy
             cutoff_hz : float
                 Cutoff frequency in Hz (e.g., 200.0 for 200Hz highpass)
             resonance : float, optional
                 Resonance/Q factor of the filter (default: 0.707 for Butterworth response)
                 Higher values create a resonant peak near the cutoff frequency.
                 Should be between 0.5 and 10.0 for stability.
+            return_stats : bool, optional
+                Also return analyze() statistics of the output, collected in the
+                same pass while each block is in cache (default: False)
+            sample_format : SampleFormat, optional
+                Encode the output as this format while each block is in cache
+                instead of keeping the input dtype (default: None)
+            dither : bool, optional
+                Add TPDF dither before INT16 and INT24 rounding, a new noise
+                stream per channel on every call (default: True)
 
             Returns
             -------
             numpy.ndarray
-                Array of filtered float32 samples with same length as input
+                Filtered samples with the dtype and shape of the input; float64 is
+                filtered in double precision, other dtypes are converted to float32.
+                With sample_format the dtype is float32, int16 or float16, or uint8
+                with a trailing axis of 3 for packed INT24
+                (filtered, SignalStats) tuple if return_stats is True; for 2D input
+                the second element is a list with one SignalStats per channel
 
             Examples
             --------
@@ -360,6 +1567,9 @@ PYBIND11_MODULE(resonix, m) {
           py::arg("center_hz"),
           py::arg("bandwidth_hz"),
           py::arg("resonance") = 0.707f,
+          py::arg("return_stats") = false,
+          py::arg("sample_format") = py::none(),
+          py::arg("dither") = true,
           R"pbdoc(
             Apply a bandpass filter to audio samples.
 
@@ -370,7 +1580,8 @@ PYBIND11_MODULE(resonix, m) {
             Parameters
             ----------
             samples : numpy.ndarray
-                1D array of float32 audio samples to filter
+                float32 or float64 samples, 1D or (channels, frames); strided views
+                such as x[::2] or x.T are read in place without a copy
             center_hz : float
                 Center frequency of the passband in Hz (e.g., 1000.0 for 1kHz center)
             bandwidth_hz : float
@@ -379,11 +1590,25 @@ PYBIND11_MODULE(resonix, m) {
                 Resonance/Q multiplier of the filter (default: 0.707 for moderate response)
                 Higher values create sharper, more selective filtering.
                 Should be between 0.5 and 10.0 for stability.
+            return_stats : bool, optional
+                Also return analyze() statistics of the output, collected in the
+                same pass while each block is in cache (default: False)
+            sample_format : SampleFormat, optional
+                Encode the output as this format while each block is in cache
+                instead of keeping the input dtype (default: None)
+            dither : bool, optional
+                Add TPDF dither before INT16 and INT24 rounding, a new noise
+                stream per channel on every call (default: True)
 
             Returns
             -------
             numpy.ndarray
-                Array of filtered float32 samples with same length as input
+                Filtered samples with the dtype and shape of the input; float64 is
+                filtered in double precision, other dtypes are converted to float32.
+                With sample_format the dtype is float32, int16 or float16, or uint8
+                with a trailing axis of 3 for packed INT24
+                (filtered, SignalStats) tuple if return_stats is True; for 2D input
+                the second element is a list with one SignalStats per channel
 
             Notes
             -----
@@ -399,7 +1624,7 @@ PYBIND11_MODULE(resonix, m) {
             >>> filtered = resonix.bandpass_filter(samples, 1000.0, 500.0)
 
             >>> # Create fricative 's' sound (4kHz - 8kHz)
-            >>> noise = np.random.randn(44100).astype(np.float32)
+            >>> noise = resonix.generate_noise(resonix.Shape.NOISE_WHITE, 1)
             >>> fricative = resonix.bandpass_filter(noise, 6000.0, 4000.0, 0.5)
 
             >>> # Telephone effect (300Hz - 3400Hz)
@@ -411,6 +1636,9 @@ PYBIND11_MODULE(resonix, m) {
           py::arg("peak"),
           py::arg("mix") = 0.5f,
           py::arg("spread") = 0.0f,
+          py::arg("return_stats") = false,
+          py::arg("sample_format") = py::none(),
+          py::arg("dither") = true,
           R"pbdoc(
             Apply a formant filter to audio samples.
 
@@ -420,7 +1648,8 @@ PYBIND11_MODULE(resonix, m) {
             Parameters
             ----------
             samples : numpy.ndarray
-                1D array of float32 audio samples to filter
+                float32 or float64 samples, 1D or (channels, frames); strided views
+                such as x[::2] or x.T are read in place without a copy
             peak : float
                 Determines which vowel formant to emphasize (0.0-1.0):
                 0.0-0.2: "ah" as in "father"
@@ -432,11 +1661,25 @@ PYBIND11_MODULE(resonix, m) {
                 Dry/wet mix (0.0 = dry, 1.0 = wet, default: 0.5)
             spread : float, optional
                 Spread of formant frequencies (0.0 = normal, 1.0 = wide, default: 0.0)
+            return_stats : bool, optional
+                Also return analyze() statistics of the output, collected in the
+                same pass while each block is in cache (default: False)
+            sample_format : SampleFormat, optional
+                Encode the output as this format while each block is in cache
+                instead of keeping the input dtype (default: None)
+            dither : bool, optional
+                Add TPDF dither before INT16 and INT24 rounding, a new noise
+                stream per channel on every call (default: True)
 
             Returns
             -------
             numpy.ndarray
-                Array of filtered float32 samples with same length as input
+                Filtered samples with the dtype and shape of the input; float64 is
+                filtered in double precision, other dtypes are converted to float32.
+                With sample_format the dtype is float32, int16 or float16, or uint8
+                with a trailing axis of 3 for packed INT24
+                (filtered, SignalStats) tuple if return_stats is True; for 2D input
+                the second element is a list with one SignalStats per channel
 
             Examples
             --------
@@ -448,4 +1691,1617 @@ PYBIND11_MODULE(resonix, m) {
             >>> # Subtle vocal character with 50% mix
             >>> subtle = resonix.formant_filter(samples, 0.3, 0.5, 0.0)
           )pbdoc");
+
+    m.def("compressor", [](py::array samples, float threshold_db, float ratio, float attack_ms, float release_ms, float lookahead_ms,
+                           float makeup_db, py::object sample_format, bool dither) {
+              Resonix::MemoryTag tag("Resonix::compressor");
+              Filter::DynamicsSettings settings;
+              settings.mode = Filter::DYNAMICS_COMPRESSOR;
+              settings.threshold_db = threshold_db;
+              settings.ratio = ratio;
+              settings.attack_ms = attack_ms;
+              settings.release_ms = release_ms;
+              settings.lookahead_ms = lookahead_ms;
+              settings.makeup_db = makeup_db;
+              return dynamicsNumPy(samples, settings, sample_format, dither);
+          },
+          py::arg("samples"),
+          py::arg("threshold_db"),
+          py::arg("ratio") = 4.0f,
+          py::arg("attack_ms") = 5.0f,
+          py::arg("release_ms") = 100.0f,
+          py::arg("lookahead_ms") = 5.0f,
+          py::arg("makeup_db") = 0.0f,
+          py::arg("sample_format") = py::none(),
+          py::arg("dither") = true,
+          R"pbdoc(
+            Compress audio samples with a lookahead peak compressor.
+
+            Parameters
+            ----------
+            samples : numpy.ndarray
+                Samples, 1D or (channels, frames); all channels share one gain
+            threshold_db : float
+                Peak level above which the gain is reduced
+            ratio : float, optional
+                Input dB per output dB above the threshold (default: 4.0)
+            attack_ms, release_ms : float, optional
+                Time constants of gain reduction and recovery (defaults: 5, 100)
+            lookahead_ms : float, optional
+                How far ahead peaks are seen, up to 500; the output stays aligned
+                with the input (default: 5)
+            makeup_db : float, optional
+                Gain after compression (default: 0)
+            sample_format : SampleFormat, optional
+                Encode the output as this format (default: None)
+            dither : bool, optional
+                Add TPDF dither before INT16 and INT24 rounding, a new noise
+                stream on every call (default: True)
+
+            Returns
+            -------
+            numpy.ndarray
+                float32 samples with the shape of the input, or encoded samples
+          )pbdoc");
+
+    m.def("limiter", [](py::array samples, float ceiling_db, float release_ms, float lookahead_ms, py::object sample_format, bool dither) {
+              Resonix::MemoryTag tag("Resonix::limiter");
+              Filter::DynamicsSettings settings;
+              settings.mode = Filter::DYNAMICS_LIMITER;
+              settings.threshold_db = ceiling_db;
+              settings.release_ms = release_ms;
+              settings.lookahead_ms = lookahead_ms;
+              return dynamicsNumPy(samples, settings, sample_format, dither);
+          },
+          py::arg("samples"),
+          py::arg("ceiling_db") = -1.0f,
+          py::arg("release_ms") = 50.0f,
+          py::arg("lookahead_ms") = 5.0f,
+          py::arg("sample_format") = py::none(),
+          py::arg("dither") = true,
+          R"pbdoc(
+            Brickwall-limit audio samples to a peak ceiling.
+
+            Each gain reduction fades in over the lookahead and is complete when
+            its peak arrives, so no output sample exceeds the ceiling.
+
+            Parameters
+            ----------
+            samples : numpy.ndarray
+                Samples, 1D or (channels, frames); all channels share one gain
+            ceiling_db : float, optional
+                Highest sample peak of the output (default: -1.0)
+            release_ms : float, optional
+                Time constant of the recovery (default: 50)
+            lookahead_ms : float, optional
+                Length of the fade into each reduction, up to 500 (default: 5)
+            sample_format : SampleFormat, optional
+                Encode the output as this format (default: None)
+            dither : bool, optional
+                Add TPDF dither before INT16 and INT24 rounding, a new noise
+                stream on every call (default: True)
+
+            Examples
+            --------
+            >>> pcm = resonix.limiter(mix, -1.0, sample_format=resonix.SampleFormat.INT16)
+          )pbdoc");
+
+    m.def("gate", [](py::array samples, float threshold_db, float range_db, float attack_ms, float release_ms, float lookahead_ms,
+                     py::object sample_format, bool dither) {
+              Resonix::MemoryTag tag("Resonix::gate");
+              Filter::DynamicsSettings settings;
+              settings.mode = Filter::DYNAMICS_GATE;
+              settings.threshold_db = threshold_db;
+              settings.ratio = 20.0f;
+              settings.range_db = range_db;
+              settings.attack_ms = attack_ms;
+              settings.release_ms = release_ms;
+              settings.lookahead_ms = lookahead_ms;
+              return dynamicsNumPy(samples, settings, sample_format, dither);
+          },
+          py::arg("samples"),
+          py::arg("threshold_db"),
+          py::arg("range_db") = -80.0f,
+          py::arg("attack_ms") = 1.0f,
+          py::arg("release_ms") = 100.0f,
+          py::arg("lookahead_ms") = 5.0f,
+          py::arg("sample_format") = py::none(),
+          py::arg("dither") = true,
+          R"pbdoc(
+            Gate audio samples below a threshold.
+
+            Parameters
+            ----------
+            samples : numpy.ndarray
+                Samples, 1D or (channels, frames); all channels share one gain
+            threshold_db : float
+                Peak level below which the gate closes
+            range_db : float, optional
+                Attenuation of the closed gate (default: -80)
+            attack_ms, release_ms : float, optional
+                Opening and closing time constants (defaults: 1, 100)
+            lookahead_ms : float, optional
+                How early the gate opens before an onset, up to 500 (default: 5)
+          )pbdoc");
+
+    m.def("reverb", [](py::array samples, float decay, float mix, float size, float damping_hz, int lines, float tail,
+                       py::object sample_format, bool dither) {
+              Resonix::MemoryTag tag("Resonix::reverb");
+              Filter::ReverbSettings settings;
+              settings.lines = lines;
+              settings.decay = decay;
+              settings.mix = mix;
+              settings.size = size;
+              settings.damping_hz = damping_hz;
+              return reverbNumPy(samples, settings, tail, sample_format, dither);
+          },
+          py::arg("samples"),
+          py::arg("decay") = 2.0f,
+          py::arg("mix") = 0.3f,
+          py::arg("size") = 1.0f,
+          py::arg("damping_hz") = 6000.0f,
+          py::arg("lines") = 8,
+          py::arg("tail") = 0.0f,
+          py::arg("sample_format") = py::none(),
+          py::arg("dither") = true,
+          R"pbdoc(
+            Add feedback-delay-network reverb to audio samples.
+
+            The cost per sample depends only on lines, not on decay or size.
+
+            Parameters
+            ----------
+            samples : numpy.ndarray
+                Samples, 1D or (channels, frames) with up to 8 channels; each
+                channel gets its own decorrelated reverb of the mixed input
+            decay : float, optional
+                Seconds for the tail to fall by 60 dB (default: 2.0)
+            mix : float, optional
+                Wet share of the output, 0 to 1 (default: 0.3)
+            size : float, optional
+                Scale of the delay lengths, 0.25 to 2 (default: 1.0)
+            damping_hz : float, optional
+                Cutoff of the lowpass inside the network (default: 6000)
+            lines : int, optional
+                Delay lines, 8 or 16; 16 is denser and costs twice as much (default: 8)
+            tail : float, optional
+                Seconds of decay appended after the input (default: 0)
+            sample_format : SampleFormat, optional
+                Encode the output as this format (default: None)
+            dither : bool, optional
+                Add TPDF dither before INT16 and INT24 rounding, a new noise
+                stream on every call (default: True)
+
+            Returns
+            -------
+            numpy.ndarray
+                float32 samples, tail seconds longer than the input, or encoded samples
+
+            Examples
+            --------
+            >>> hall = resonix.reverb(stereo, decay=3.5, mix=0.35, size=1.8, tail=3.5)
+          )pbdoc");
+
+    m.def("resample", &resampleNumPy,
+          py::arg("samples"),
+          py::arg("output_rate"),
+          py::arg("input_rate") = Resonix::SAMPLE_RATE,
+          py::arg("quality") = Resampler::MEDIUM,
+          R"pbdoc(
+            Convert audio samples to another sample rate.
+
+            Uses a polyphase windowed-sinc filter. Any rational ratio is supported,
+            e.g. 44100 -> 48000 Hz or 2x/4x oversampling. Filter banks are cached
+            per ratio, so repeated calls only pay for the filtering.
+
+            Parameters
+            ----------
+            samples : numpy.ndarray
+                1D array of float32 audio samples
+            output_rate : int
+                Desired output sample rate in Hz
+            input_rate : int, optional
+                Sample rate of the input in Hz (default: SAMPLE_RATE)
+            quality : ResampleQuality, optional
+                Filter length preset (default: ResampleQuality.MEDIUM)
+
+            Returns
+            -------
+            numpy.ndarray
+                Array of float32 samples, ceil(len(samples) * output_rate / input_rate) long
+
+            Examples
+            --------
+            >>> import resonix
+            >>> samples = resonix.generate_samples(resonix.Shape.SINE, 1, 440.0)
+            >>> at_48k = resonix.resample(samples, 48000)
+            >>> print(at_48k.shape)
+            (48000,)
+          )pbdoc");
+
+    m.def("trim_buffer_pool", []() { Resonix::BufferPool::global().trim(); },
+          "Free the sample buffers cached for reuse by freed arrays");
+
+    m.def("set_buffer_cache_limit", [](size_t bytes) { Resonix::BufferPool::global().setCacheLimit(bytes); },
+          py::arg("bytes"),
+          "Cap the memory the buffer pool keeps for reuse (default: 256 MiB)");
+
+    m.def("set_cycle_cache_limit", &Resonix::setCycleCacheLimit,
+          py::arg("bytes"),
+          "Cap the memory of cached single cycles of steady tones (default: 16 MiB); 0 renders every sample directly");
+
+    m.def("buffer_pool_cached_bytes", []() { return Resonix::BufferPool::global().cachedBytes(); },
+          "Bytes currently cached by the buffer pool");
+
+    m.def("memory_stats", []() {
+              Resonix::MemoryStats snapshot = Resonix::memoryStats();
+              py::dict result, apis;
+
+              for (const Resonix::MemoryUsage& usage : snapshot.apis) {
+                  py::dict entry;
+                  entry["allocations"] = usage.allocations;
+                  entry["bytes"] = usage.bytes;
+                  entry["live_bytes"] = usage.live_bytes;
+                  entry["peak_bytes"] = usage.peak_bytes;
+                  apis[py::str(usage.name)] = entry;
+              }
+
+              result["live_bytes"] = snapshot.live_bytes;
+              result["peak_bytes"] = snapshot.peak_bytes;
+              result["reserved_bytes"] = snapshot.reserved_bytes;
+              result["peak_reserved_bytes"] = snapshot.peak_reserved_bytes;
+              result["cached_bytes"] = snapshot.cached_bytes;
+              result["allocations"] = snapshot.allocations;
+              result["apis"] = apis;
+              return result;
+          },
+          R"pbdoc(
+            Memory handed out by the buffer pool behind every resonix array.
+
+            Counts every sample buffer, including temporaries freed before a
+            call returns, so peak_bytes is the true high-water mark of a
+            workload rather than the size of its results.
+
+            Returns
+            -------
+            dict
+                live_bytes and peak_bytes (bytes requested and still in use,
+                and their maximum), reserved_bytes and peak_reserved_bytes (the
+                pool's real footprint including rounding and cached blocks),
+                cached_bytes, allocations, and apis: a dict mapping each API
+                (e.g. 'Resonix::formant_filter', or 'other') to its
+                allocations, bytes, live_bytes and peak_bytes
+
+            Examples
+            --------
+            >>> import resonix
+            >>> resonix.reset_memory_stats()
+            >>> samples = resonix.generate_samples(resonix.Shape.SINE, 10, 440.0)
+            >>> print(resonix.memory_stats()['peak_bytes'])
+          )pbdoc");
+
+    m.def("reset_memory_stats", &Resonix::resetMemoryStats,
+          "Zero the allocation counts of memory_stats() and lower the peaks to the memory still in use");
+
+    m.def("simd_level", &Resonix::simdLevel,
+          "Instruction set the generator and filter kernels use on this CPU: 'avx512', 'avx2', 'sse2', 'neon' or 'generic'");
+
+    m.attr("INSTRUMENTED") = Resonix::stats().enabled;
+
+    m.def("stats", []() {
+              Resonix::Stats snapshot = Resonix::stats();
+              py::dict stages;
+
+              for (const Resonix::StageStats& stage : snapshot.stages) {
+                  py::dict entry;
+                  entry["calls"] = stage.calls;
+                  entry["frames"] = stage.frames;
+                  entry["bytes"] = stage.bytes;
+                  entry["total_ms"] = stage.total_ms;
+                  entry["max_ms"] = stage.max_ms;
+                  stages[py::str(stage.name)] = entry;
+              }
+              return stages;
+          },
+          R"pbdoc(
+            Per-stage counters recorded since the last reset_stats().
+
+            Only available when resonix is built with RESONIX_INSTRUMENT set
+            (see INSTRUMENTED); otherwise the result is always empty. Times are
+            inclusive: a stage's time contains the stages it calls.
+
+            Returns
+            -------
+            dict
+                Maps every API function and graph stage that ran (e.g.
+                'Resonix::lowpass_filter', 'Graph::biquad') to a dict with
+                calls, frames, bytes (requested from the buffer pool),
+                total_ms and max_ms, longest total first
+
+            Examples
+            --------
+            >>> import resonix
+            >>> samples = resonix.generate_samples(resonix.Shape.SINE, 1, 440.0)
+            >>> resonix.stats()['Resonix::generateSamples']['calls']
+            1
+          )pbdoc");
+
+    m.def("reset_stats", &Resonix::resetStats,
+          "Zero the counters returned by stats() and drop the recorded trace");
+
+    m.def("set_tracing", &Resonix::setTracing,
+          py::arg("enabled"),
+          "Start or stop recording every call for write_trace() (off by default)");
+
+    m.def("write_trace", [](const std::string& path) {
+              if (!Resonix::stats().enabled) {
+                  throw std::runtime_error("resonix was built without RESONIX_INSTRUMENT");
+              }
+              if (!Resonix::writeTrace(path)) {
+                  throw std::runtime_error("Failed to open " + path + " for writing");
+              }
+          },
+          py::arg("path"),
+          R"pbdoc(
+            Write the calls recorded since set_tracing(True) as Chrome trace JSON.
+
+            Open the file in chrome://tracing or https://ui.perfetto.dev to see
+            every call on a timeline, one track per thread.
+
+            Parameters
+            ----------
+            path : str
+                Output file
+
+            Examples
+            --------
+            >>> resonix.set_tracing(True)
+            >>> filtered = resonix.lowpass_filter(samples, 1000.0)
+            >>> resonix.write_trace('resonix.json')
+          )pbdoc");
+
+    py::class_<Resampler::PolyphaseResampler>(m, "Resampler", R"pbdoc(
+            Streaming polyphase resampler.
+
+            Feed blocks of any size with process() and call flush() at the end;
+            the concatenated output equals a single resample() call.
+
+            Examples
+            --------
+            >>> rs = resonix.Resampler(44100, 48000, resonix.ResampleQuality.HIGH)
+            >>> out = [rs.process(block) for block in blocks] + [rs.flush()]
+          )pbdoc")
+        .def(py::init<int, int, Resampler::Quality>(),
+             py::arg("input_rate"),
+             py::arg("output_rate"),
+             py::arg("quality") = Resampler::MEDIUM)
+        .def("process", &resamplerProcessNumPy, py::arg("samples"),
+             "Resample a block, returning the float32 samples that are ready")
+        .def("flush", &resamplerFlushNumPy,
+             "Drain the filter delay at the end of the stream")
+        .def("reset", &Resampler::PolyphaseResampler::reset,
+             "Clear the history and restart the stream")
+        .def_property_readonly("latency", &Resampler::PolyphaseResampler::latency,
+             "Input samples buffered before the first output");
+
+    py::class_<BlockStream>(m, "BlockStream", R"pbdoc(
+            Iterator returned by Oscillator.blocks(), AudioFileReader.blocks() and
+            FilterChain.blocks().
+
+            Every full block is the same float32 array, refilled in place; copy a
+            block to keep it past the next iteration.
+          )pbdoc")
+        .def("__iter__", [](py::object self) { return self; })
+        .def("__next__", &nextBlock);
+
+    py::class_<Resonix::Oscillator>(m, "Oscillator", R"pbdoc(
+            Streaming waveform generator.
+
+            Renders any Shape block by block with continuous phase, so streams of
+            any length use bounded memory. Consecutive render() calls and blocks()
+            iterations continue exactly where the previous one stopped.
+
+            Parameters
+            ----------
+            shape : Shape
+                Waveform shape to render
+            frequency : float, optional
+                Frequency in Hz; required for all but the NOISE_* shapes
+            length : int, optional
+                Span of the HANN and PHASED_HANN windows in samples (default: SAMPLE_RATE)
+            seed : int, optional
+                Stream selector of the NOISE_* shapes (default: 0)
+
+            Examples
+            --------
+            >>> osc = resonix.Oscillator(resonix.Shape.SAWTOOTH, 110.0)
+            >>> for block in osc.blocks(512):
+            ...     stream.write(block)
+          )pbdoc")
+        .def(py::init([](Resonix::Shape shape, float frequency, long long length, unsigned long long seed) {
+                 if (!Resonix::isNoise(shape) && frequency <= 0.0f) {
+                     throw std::invalid_argument("frequency must be positive");
+                 }
+                 if (length <= 0) {
+                     throw std::invalid_argument("length must be positive");
+                 }
+                 return std::make_unique<Resonix::Oscillator>(shape, frequency, length, seed);
+             }),
+             py::arg("shape"),
+             py::arg("frequency") = 0.0f,
+             py::arg("length") = Resonix::SAMPLE_RATE,
+             py::arg("seed") = 0)
+        .def("render", [](Resonix::Oscillator& osc, int frames, py::object gain) {
+                 if (frames <= 0) {
+                     throw std::invalid_argument("frames must be positive");
+                 }
+                 Resonix::MemoryTag tag("Oscillator");
+                 py::array_t<float> samples = pooledArray<float>({frames});
+                 float* data = samples.mutable_data();
+                 renderWithGain(gain, [&] { osc.render(data, frames); },
+                                [&](auto& source) { osc.render(data, frames, source); });
+                 return samples;
+             }, py::arg("frames"), py::arg("gain") = py::none(),
+             "Render the next frames samples as a new float32 array, multiplied by gain (an Envelope or LFO) when given")
+        .def("blocks", [](py::object self, int block_size, py::object frames) {
+                 return makeBlockStream(self, py::none(), py::none(), block_size, frames);
+             }, py::arg("block_size") = 512, py::arg("frames") = py::none(),
+             "Iterate over blocks of block_size samples, endlessly or until frames samples")
+        .def("seek", &Resonix::Oscillator::seek, py::arg("position"),
+             "Move the stream to an absolute sample index")
+        .def_property_readonly("position", &Resonix::Oscillator::position)
+        .def_property_readonly("shape", &Resonix::Oscillator::shape)
+        .def_property_readonly("frequency", &Resonix::Oscillator::frequency);
+
+    py::class_<Filter::FilterChain>(m, "FilterChain", R"pbdoc(
+            Stateful chain of filters for block-by-block streams.
+
+            Stages are applied in the order they are added, and their state
+            carries over between process() calls, so filtering a stream in blocks
+            gives the same samples as filtering it in one piece. Each stage method
+            returns the chain, so stages can be chained in one expression.
+
+            Examples
+            --------
+            >>> osc = resonix.Oscillator(resonix.Shape.SAWTOOTH, 110.0)
+            >>> chain = resonix.FilterChain().lowpass(2000.0).formant(0.5, 1.0)
+            >>> for block in chain.blocks(osc, 512, frames=10 * resonix.SAMPLE_RATE):
+            ...     sock.send(block.tobytes())
+          )pbdoc")
+        .def(py::init<>())
+        .def("lowpass", [](py::object self, float cutoff_hz, float resonance) {
+                 checkPassFilter(cutoff_hz, resonance);
+                 self.cast<Filter::FilterChain&>().addBiquad(Filter::make_lowpass_filter(cutoff_hz, resonance));
+                 return self;
+             }, py::arg("cutoff_hz"), py::arg("resonance") = 0.707f, "Append a lowpass_filter() stage")
+        .def("highpass", [](py::object self, float cutoff_hz, float resonance) {
+                 checkPassFilter(cutoff_hz, resonance);
+                 self.cast<Filter::FilterChain&>().addBiquad(Filter::make_highpass_filter(cutoff_hz, resonance));
+                 return self;
+             }, py::arg("cutoff_hz"), py::arg("resonance") = 0.707f, "Append a highpass_filter() stage")
+        .def("bandpass", [](py::object self, float center_hz, float bandwidth_hz, float resonance) {
+                 checkBandpassFilter(center_hz, bandwidth_hz, resonance);
+                 self.cast<Filter::FilterChain&>().addBiquad(Filter::make_bandpass_filter(center_hz, bandwidth_hz, resonance));
+                 return self;
+             }, py::arg("center_hz"), py::arg("bandwidth_hz"), py::arg("resonance") = 0.707f, "Append a bandpass_filter() stage")
+        .def("formant", [](py::object self, float peak, float mix, float spread) {
+                 checkFormantFilter(peak, mix, spread);
+                 Filter::FormantFilter filter;
+                 filter.setup(peak, mix, spread);
+                 self.cast<Filter::FilterChain&>().addFormant(filter);
+                 return self;
+             }, py::arg("peak"), py::arg("mix") = 0.5f, py::arg("spread") = 0.0f, "Append a formant_filter() stage")
+        .def("process", &filterChainProcessNumPy,
+             py::arg("samples"),
+             py::arg("out") = py::none(),
+             "Filter the next block; writes into out (which may be samples) when given")
+        .def("blocks", [](py::object self, py::object source, int block_size, py::object frames, int channel) {
+                 if (py::isinstance<Resonix::Oscillator>(source)) {
+                     return makeBlockStream(source, self, py::none(), block_size, frames);
+                 }
+                 return makeBlockStream(py::none(), self, source, block_size, frames, channel);
+             }, py::arg("source"), py::arg("block_size") = 512, py::arg("frames") = py::none(), py::arg("channel") = 0,
+             "Iterate over filtered blocks of an Oscillator, a 1D array or a channel of an AudioFileReader")
+        .def("reset", &Filter::FilterChain::reset,
+             "Clear the state of every stage")
+        .def("__len__", &Filter::FilterChain::size);
+
+    py::class_<Filter::Dynamics>(m, "Dynamics", R"pbdoc(
+            Streaming lookahead compressor, limiter or gate.
+
+            State carries over between process() calls, and the output lags the
+            input by latency samples. All channels share one gain.
+
+            Parameters
+            ----------
+            mode : DynamicsMode, optional
+                COMPRESSOR, LIMITER or GATE (default: COMPRESSOR)
+            threshold_db : float, optional
+                Threshold, or the ceiling of a limiter (default: -12)
+            ratio : float, optional
+                Compression ratio, or expansion ratio of a gate (default: 4)
+            attack_ms, release_ms, lookahead_ms : float, optional
+                Time constants and lookahead (defaults: 5, 100, 5)
+            makeup_db : float, optional
+                Output gain of a compressor or gate (default: 0)
+            range_db : float, optional
+                Attenuation of a closed gate (default: -80)
+            channels : int, optional
+                Channels per process() call, 1 to 16 (default: 1)
+
+            Examples
+            --------
+            >>> limiter = resonix.Dynamics(resonix.DynamicsMode.LIMITER, -1.0, channels=2)
+            >>> for block in blocks:                 # (2, frames) float32 arrays
+            ...     stream.write(limiter.process(block))
+          )pbdoc")
+        .def(py::init([](Filter::DynamicsMode mode, float threshold_db, float ratio, float attack_ms, float release_ms,
+                         float lookahead_ms, float makeup_db, float range_db, int channels) {
+                 Filter::DynamicsSettings settings;
+                 settings.mode = mode;
+                 settings.threshold_db = threshold_db;
+                 settings.ratio = ratio;
+                 settings.attack_ms = attack_ms;
+                 settings.release_ms = release_ms;
+                 settings.lookahead_ms = lookahead_ms;
+                 settings.makeup_db = makeup_db;
+                 settings.range_db = range_db;
+                 checkDynamics(settings);
+                 if (channels < 1 || channels > Filter::Dynamics::MAX_CHANNELS) {
+                     throw std::invalid_argument("channels must be between 1 and 16");
+                 }
+                 return std::make_unique<Filter::Dynamics>(settings, channels);
+             }),
+             py::arg("mode") = Filter::DYNAMICS_COMPRESSOR,
+             py::arg("threshold_db") = -12.0f,
+             py::arg("ratio") = 4.0f,
+             py::arg("attack_ms") = 5.0f,
+             py::arg("release_ms") = 100.0f,
+             py::arg("lookahead_ms") = 5.0f,
+             py::arg("makeup_db") = 0.0f,
+             py::arg("range_db") = -80.0f,
+             py::arg("channels") = 1)
+        .def("process", &dynamicsProcessNumPy,
+             py::arg("samples"),
+             py::arg("out") = py::none(),
+             "Process the next block, 1D or (channels, frames); writes into out (which may be samples) when given")
+        .def("reset", &Filter::Dynamics::reset,
+             "Empty the delay line and release all gain reduction")
+        .def_property_readonly("latency", &Filter::Dynamics::latency)
+        .def_property_readonly("channels", &Filter::Dynamics::channels)
+        .def_property_readonly("gain_db", &Filter::Dynamics::gainDb);
+
+    py::class_<Filter::Reverb>(m, "Reverb", R"pbdoc(
+            Streaming feedback-delay-network reverb.
+
+            State carries over between process() calls, so a stream can be
+            processed block by block. Every channel taps its own row of the
+            feedback matrix.
+
+            Parameters
+            ----------
+            decay : float, optional
+                Seconds for the tail to fall by 60 dB (default: 2.0)
+            mix : float, optional
+                Wet share of the output, 0 to 1 (default: 0.3)
+            size : float, optional
+                Scale of the delay lengths, 0.25 to 2 (default: 1.0)
+            damping_hz : float, optional
+                Cutoff of the lowpass inside the network (default: 6000)
+            lines : int, optional
+                Delay lines, 8 or 16 (default: 8)
+            channels : int, optional
+                Channels per process() call, 1 to 8 (default: 1)
+
+            Examples
+            --------
+            >>> room = resonix.Reverb(decay=1.2, size=0.5, channels=2)
+            >>> for block in blocks:                 # (2, frames) float32 arrays
+            ...     stream.write(room.process(block))
+          )pbdoc")
+        .def(py::init([](float decay, float mix, float size, float damping_hz, int lines, int channels) {
+                 Filter::ReverbSettings settings;
+                 settings.lines = lines;
+                 settings.decay = decay;
+                 settings.mix = mix;
+                 settings.size = size;
+                 settings.damping_hz = damping_hz;
+                 checkReverb(settings);
+                 if (channels < 1 || channels > Filter::Reverb::MAX_CHANNELS) {
+                     throw std::invalid_argument("channels must be between 1 and 8");
+                 }
+                 return std::make_unique<Filter::Reverb>(settings, channels);
+             }),
+             py::arg("decay") = 2.0f,
+             py::arg("mix") = 0.3f,
+             py::arg("size") = 1.0f,
+             py::arg("damping_hz") = 6000.0f,
+             py::arg("lines") = 8,
+             py::arg("channels") = 1)
+        .def("process", &reverbProcessNumPy,
+             py::arg("samples"),
+             py::arg("out") = py::none(),
+             "Process the next block, 1D or (channels, frames); writes into out (which may be samples) when given")
+        .def("reset", &Filter::Reverb::reset,
+             "Silence the tail, keeping the settings")
+        .def_property_readonly("channels", &Filter::Reverb::channels)
+        .def_property_readonly("lines", &Filter::Reverb::lines);
+
+    py::class_<Resonix::AudioBuffer>(m, "AudioBuffer", py::buffer_protocol(), R"pbdoc(
+            Planar multichannel float32 buffer.
+
+            Owns one aligned allocation holding every channel. numpy.asarray(buffer)
+            is a zero-copy (channels, frames) view, so NumPy code and the in-place
+            methods below work on the same memory. Generation and filters run on
+            all channels in one call, in parallel for long buffers.
+
+            Parameters
+            ----------
+            channels : int
+                Number of channels
+            frames : int
+                Samples per channel; the buffer starts out silent
+
+            Examples
+            --------
+            >>> stereo = resonix.AudioBuffer(2, 5 * resonix.SAMPLE_RATE)
+            >>> stereo.generate(resonix.Shape.NOISE_PINK, seed=7)
+            >>> stereo.lowpass(2000.0)
+            >>> left, right = numpy.asarray(stereo)
+            >>> pcm = stereo.interleave()  # (frames, 2) for sounddevice / WAV writers
+          )pbdoc")
+        .def(py::init([](int channels, long long frames) {
+                 if (channels <= 0 || frames <= 0) {
+                     throw std::invalid_argument("channels and frames must be positive");
+                 }
+                 auto buffer = std::make_unique<Resonix::AudioBuffer>(channels, frames);
+                 if (buffer->empty()) {
+                     throw std::bad_alloc();
+                 }
+                 buffer->clear();
+                 return buffer;
+             }), py::arg("channels"), py::arg("frames"))
+        .def_buffer([](Resonix::AudioBuffer& buffer) {
+                 return py::buffer_info(
+                     buffer.data(),
+                     sizeof(float),
+                     py::format_descriptor<float>::format(),
+                     2,
+                     {static_cast<py::ssize_t>(buffer.channels()), static_cast<py::ssize_t>(buffer.frames())},
+                     {static_cast<py::ssize_t>(buffer.stride() * sizeof(float)), static_cast<py::ssize_t>(sizeof(float))}
+                 );
+             })
+        .def_static("from_interleaved", [](py::array_t<float, py::array::c_style | py::array::forcecast> samples) {
+                 if (samples.ndim() != 2 || samples.size() == 0) {
+                     throw std::invalid_argument("samples must be a non-empty (frames, channels) array");
+                 }
+                 auto buffer = std::make_unique<Resonix::AudioBuffer>(static_cast<int>(samples.shape(1)), samples.shape(0));
+                 if (buffer->empty()) {
+                     throw std::bad_alloc();
+                 }
+                 {
+                     py::gil_scoped_release release;
+                     Resonix::deinterleave(samples.data(), *buffer);
+                 }
+                 return buffer;
+             }, py::arg("samples"),
+             "Split a (frames, channels) array into a new planar buffer")
+        .def("interleave", [](const Resonix::AudioBuffer& buffer) {
+                 Resonix::MemoryTag tag("AudioBuffer");
+                 py::array_t<float> samples = pooledArray<float>({static_cast<py::ssize_t>(buffer.frames()), static_cast<py::ssize_t>(buffer.channels())});
+                 float* output = samples.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     Resonix::interleave(buffer, output);
+                 }
+                 return samples;
+             }, "Return the samples as a new (frames, channels) array")
+        .def("generate", [](Resonix::AudioBuffer& buffer, Resonix::Shape shape, float frequency, unsigned long long seed) {
+                 if (frequency <= 0.0f && !Resonix::isNoise(shape)) {
+                     throw std::invalid_argument("frequency must be positive");
+                 }
+                 py::gil_scoped_release release;
+                 Resonix::generateSamples(buffer, shape, frequency, seed);
+             }, py::arg("shape"), py::arg("frequency") = 0.0f, py::arg("seed") = 0,
+             "Fill every channel with a waveform; noise channels get decorrelated streams")
+        .def("lowpass", [](Resonix::AudioBuffer& buffer, float cutoff_hz, float resonance) {
+                 checkPassFilter(cutoff_hz, resonance);
+                 py::gil_scoped_release release;
+                 Resonix::lowpass_filter(buffer, cutoff_hz, resonance);
+             }, py::arg("cutoff_hz"), py::arg("resonance") = 0.707f, "lowpass_filter() every channel in place")
+        .def("highpass", [](Resonix::AudioBuffer& buffer, float cutoff_hz, float resonance) {
+                 checkPassFilter(cutoff_hz, resonance);
+                 py::gil_scoped_release release;
+                 Resonix::highpass_filter(buffer, cutoff_hz, resonance);
+             }, py::arg("cutoff_hz"), py::arg("resonance") = 0.707f, "highpass_filter() every channel in place")
+        .def("bandpass", [](Resonix::AudioBuffer& buffer, float center_hz, float bandwidth_hz, float resonance) {
+                 checkBandpassFilter(center_hz, bandwidth_hz, resonance);
+                 py::gil_scoped_release release;
+                 Resonix::bandpass_filter(buffer, center_hz, bandwidth_hz, resonance);
+             }, py::arg("center_hz"), py::arg("bandwidth_hz"), py::arg("resonance") = 0.707f, "bandpass_filter() every channel in place")
+        .def("formant", [](Resonix::AudioBuffer& buffer, float peak, float mix, float spread) {
+                 checkFormantFilter(peak, mix, spread);
+                 py::gil_scoped_release release;
+                 Resonix::formant_filter(buffer, peak, mix, spread);
+             }, py::arg("peak"), py::arg("mix") = 0.5f, py::arg("spread") = 0.0f, "formant_filter() every channel in place")
+        .def_property_readonly("channels", &Resonix::AudioBuffer::channels)
+        .def_property_readonly("frames", &Resonix::AudioBuffer::frames)
+        .def("__len__", &Resonix::AudioBuffer::channels);
+
+    py::class_<Resonix::AudioFileWriter>(m, "AudioFileWriter", R"pbdoc(
+            Streaming WAV/RF64 or raw file writer.
+
+            Blocks are encoded (float32, int16, int24 or float16) straight into large chunks that a background thread writes
+            while the next block is computed, so a render of any length needs
+            constant memory. Use it as a context manager or call close(), which
+            finalizes the WAV header.
+
+            Parameters
+            ----------
+            path : str
+                File to create or truncate
+            channels : int, optional
+                Interleaved channels per frame (default: 1)
+            sample_rate : int, optional
+                Sample rate stored in the header (default: SAMPLE_RATE)
+            format : FileFormat, optional
+                FileFormat.WAV or FileFormat.RAW (default: WAV)
+            sample_format : SampleFormat, optional
+                Encoding of the stored samples (default: FLOAT32)
+            dither : bool, optional
+                Add TPDF dither before INT16 and INT24 rounding, a new noise
+                stream per file (default: True)
+
+            Examples
+            --------
+            >>> osc = resonix.Oscillator(resonix.Shape.SAWTOOTH, 110.0)
+            >>> chain = resonix.FilterChain().formant(0.5, 1.0)
+            >>> with resonix.AudioFileWriter('output/hour.wav') as writer:
+            ...     for block in chain.blocks(osc, 4096, frames=3600 * resonix.SAMPLE_RATE):
+            ...         writer.write(block)
+
+            >>> # 16-bit delivery file, half the disk bandwidth
+            >>> with resonix.AudioFileWriter('output/hour16.wav', sample_format=resonix.SampleFormat.INT16) as writer:
+            ...     graph.render_to_file(writer, 3600 * resonix.SAMPLE_RATE)
+
+            >>> # Graphs and signals stream without Python in the loop
+            >>> with resonix.AudioFileWriter('output/drone.wav') as writer:
+            ...     graph.render_to_file(writer, 3600 * resonix.SAMPLE_RATE)
+          )pbdoc")
+        .def(py::init([](const std::string& path, int channels, int sample_rate, Resonix::FileFormat format,
+                         Resonix::SampleFormat sample_format, bool dither) {
+                 auto writer = std::make_unique<Resonix::AudioFileWriter>();
+                 if (!writer->open(path, channels, sample_rate, format, sample_format, dither, ditherSeed())) {
+                     throw std::runtime_error("Failed to open " + path + " for writing");
+                 }
+                 return writer;
+             }),
+             py::arg("path"),
+             py::arg("channels") = 1,
+             py::arg("sample_rate") = Resonix::SAMPLE_RATE,
+             py::arg("format") = Resonix::FileFormat::WAV,
+             py::arg("sample_format") = Resonix::SampleFormat::FLOAT32,
+             py::arg("dither") = true)
+        .def("write", [](Resonix::AudioFileWriter& writer, const Resonix::AudioBuffer& buffer) {
+                 if (buffer.channels() != writer.channels()) {
+                     throw std::invalid_argument("buffer channels must match the writer");
+                 }
+                 bool written;
+                 {
+                     py::gil_scoped_release release;
+                     written = writer.write(buffer);
+                 }
+                 if (!written) {
+                     throw std::runtime_error("Failed to write audio file");
+                 }
+             }, py::arg("samples"))
+        .def("write", &writeArrayToFile, py::arg("samples"),
+             "Append an AudioBuffer, a 1D mono array or a (frames, channels) array")
+        .def("close", &closeWriter, "Write the remaining samples and finalize the header")
+        .def("__enter__", [](py::object self) { return self; })
+        .def("__exit__", [](Resonix::AudioFileWriter& writer, py::args) { closeWriter(writer); })
+        .def_property_readonly("channels", &Resonix::AudioFileWriter::channels)
+        .def_property_readonly("sample_format", &Resonix::AudioFileWriter::sampleFormat)
+        .def_property_readonly("frames_written", &Resonix::AudioFileWriter::framesWritten);
+
+    py::class_<MappedFile>(m, "AudioFileReader", R"pbdoc(
+            Memory-mapped WAV/RF64 or raw file reader.
+
+            Opening maps the file without reading it; samples are paged in from
+            the page cache as they are touched. float32 files are exposed
+            zero-copy through samples(), so the filter functions run straight
+            over the mapping. int16 and int24 files are converted to float32 one
+            block at a time by read() and blocks(). Use it as a context manager
+            or call close(); arrays from samples() keep the file mapped after
+            close() until they are freed.
+
+            Parameters
+            ----------
+            path : str
+                WAV file with float32, int16 or int24 samples
+
+            Examples
+            --------
+            >>> with resonix.AudioFileReader('take.wav') as reader:
+            ...     filtered = resonix.lowpass_filter(reader.samples(), 2000.0)
+
+            >>> # Constant memory for files of any size and encoding
+            >>> chain = resonix.FilterChain().highpass(80.0).lowpass(8000.0)
+            >>> with resonix.AudioFileReader('hour.wav') as reader, \
+            ...      resonix.AudioFileWriter('clean.wav') as writer:
+            ...     for block in chain.blocks(reader, 4096):
+            ...         writer.write(block)
+          )pbdoc")
+        .def(py::init([](const std::string& path) {
+                 return openMappedFile(path, false, 0, Resonix::SampleFormat::FLOAT32, 0);
+             }), py::arg("path"))
+        .def_static("raw", [](const std::string& path, int channels, Resonix::SampleFormat format, int sample_rate) {
+                 if (channels <= 0 || sample_rate <= 0) {
+                     throw std::invalid_argument("channels and sample_rate must be positive");
+                 }
+                 return openMappedFile(path, true, channels, format, sample_rate);
+             }, py::arg("path"), py::arg("channels") = 1,
+             py::arg("format") = Resonix::SampleFormat::FLOAT32,
+             py::arg("sample_rate") = Resonix::SAMPLE_RATE,
+             "Map a headerless file of interleaved little-endian samples")
+        .def("samples", &mappedSamplesNumPy,
+             "Read-only zero-copy view of a float32 file: 1D for mono, else (frames, channels)")
+        .def("read", &mappedReadNumPy, py::arg("offset") = 0, py::arg("frames") = py::none(),
+             "Convert frames starting at offset into a new float32 array shaped like samples()")
+        .def("blocks", [](py::object self, int block_size, py::object frames, int channel) {
+                 return makeBlockStream(py::none(), py::none(), self, block_size, frames, channel);
+             }, py::arg("block_size") = 4096, py::arg("frames") = py::none(), py::arg("channel") = 0,
+             "Iterate over float32 blocks of one channel")
+        .def("advise", [](const MappedFile& file, Resonix::Access access) {
+                 file.get().advise(access);
+             }, py::arg("access"),
+             "Set the readahead policy (SEQUENTIAL after opening)")
+        .def("release", [](const MappedFile& file, long long offset, long long frames) {
+                 file.get().release(offset, frames);
+             }, py::arg("offset"), py::arg("frames"),
+             "Let the kernel drop the pages of frames that will not be read again")
+        .def("close", [](MappedFile& file) { file.reader.reset(); },
+             "Unmap the file once no samples() view remains")
+        .def("__enter__", [](py::object self) { return self; })
+        .def("__exit__", [](MappedFile& file, py::args) { file.reader.reset(); })
+        .def_property_readonly("channels", [](const MappedFile& file) { return file.get().channels(); })
+        .def_property_readonly("sample_rate", [](const MappedFile& file) { return file.get().sampleRate(); })
+        .def_property_readonly("format", [](const MappedFile& file) { return file.get().format(); })
+        .def_property_readonly("frames", [](const MappedFile& file) { return file.get().frames(); })
+        .def("__len__", [](const MappedFile& file) { return file.get().frames(); });
+
+    py::class_<Resonix::Envelope>(m, "Envelope", R"pbdoc(
+            Streaming ADSR envelope.
+
+            Evaluated as linear ramps between control points and applied inside
+            the sample loop, so shaping a block costs one multiply-add per sample.
+            Pass it as the gain of Oscillator.render() or a ModulatedOscillator
+            render to shape the tone as it is generated; apply() shapes samples
+            that already exist.
+
+            Parameters
+            ----------
+            attack, decay, release : float, optional
+                Segment times in seconds (defaults: 0.01, 0.1, 0.2)
+            sustain : float, optional
+                Level held until note_off(), 0 to 1 (default: 0.7)
+            curve : EnvelopeCurve, optional
+                Shape of the decay and release (default: LINEAR)
+
+            Examples
+            --------
+            >>> envelope = resonix.Envelope(0.01, 0.2, 0.6, 0.5)
+            >>> envelope.note_on()
+            >>> note = osc.render(22050, envelope)
+            >>> envelope.note_off()
+            >>> tail = osc.render(22050, envelope)
+          )pbdoc")
+        .def(py::init([](float attack, float decay, float sustain, float release, Resonix::EnvelopeCurve curve) {
+                 if (!(attack >= 0.0f) || !(decay >= 0.0f) || !(release >= 0.0f)) {
+                     throw std::invalid_argument("attack, decay and release must be non-negative");
+                 }
+                 if (!(sustain >= 0.0f && sustain <= 1.0f)) {
+                     throw std::invalid_argument("sustain must be between 0 and 1");
+                 }
+                 return std::make_unique<Resonix::Envelope>(attack, decay, sustain, release, curve);
+             }),
+             py::arg("attack") = 0.01f,
+             py::arg("decay") = 0.1f,
+             py::arg("sustain") = 0.7f,
+             py::arg("release") = 0.2f,
+             py::arg("curve") = Resonix::ENVELOPE_LINEAR)
+        .def("note_on", &Resonix::Envelope::noteOn, "Start the attack from the current level")
+        .def("note_off", &Resonix::Envelope::noteOff, "Start the release from the current level")
+        .def("reset", &Resonix::Envelope::reset, "Drop to idle at level 0")
+        .def("render", &modulationRenderNumPy<Resonix::Envelope>, py::arg("frames"),
+             "Return the next frames envelope values")
+        .def("apply", &modulationApplyNumPy<Resonix::Envelope>,
+             py::arg("samples"),
+             py::arg("out") = py::none(),
+             "Multiply the next block by the envelope; writes into out (which may be samples) when given")
+        .def_property_readonly("stage", &Resonix::Envelope::stage)
+        .def_property_readonly("value", &Resonix::Envelope::value)
+        .def_property_readonly("active", &Resonix::Envelope::active);
+
+    py::class_<Resonix::LFO>(m, "LFO", R"pbdoc(
+            Streaming low-frequency oscillator producing offset + depth * waveform.
+
+            Parameters
+            ----------
+            shape : Shape, optional
+                SINE, COSINE, SQUARE, TRIANGLE or SAWTOOTH (default: SINE)
+            frequency : float, optional
+                Rate in Hz (default: 1)
+            depth, offset : float, optional
+                Amplitude and center of the output (defaults: 1, 0)
+            phase : float, optional
+                Starting phase in cycles (default: 0)
+
+            Examples
+            --------
+            >>> tremolo = resonix.LFO(resonix.Shape.SINE, 5.0, depth=0.3, offset=0.7)
+            >>> block = osc.render(512, tremolo)
+          )pbdoc")
+        .def(py::init([](Resonix::Shape shape, float frequency, float depth, float offset, float phase) {
+                 if (shape != Resonix::SINE && shape != Resonix::COSINE && shape != Resonix::SQUARE
+                     && shape != Resonix::TRIANGLE && shape != Resonix::SAWTOOTH) {
+                     throw std::invalid_argument("shape must be SINE, COSINE, SQUARE, TRIANGLE or SAWTOOTH");
+                 }
+                 if (!(frequency >= 0.0f) || frequency > Resonix::SAMPLE_RATE / (2.0f * Resonix::CONTROL_PERIOD)) {
+                     throw std::invalid_argument("frequency must be between 0 and SAMPLE_RATE / 64");
+                 }
+                 return std::make_unique<Resonix::LFO>(shape, frequency, depth, offset, phase);
+             }),
+             py::arg("shape") = Resonix::Shape::SINE,
+             py::arg("frequency") = 1.0f,
+             py::arg("depth") = 1.0f,
+             py::arg("offset") = 0.0f,
+             py::arg("phase") = 0.0f)
+        .def("render", &modulationRenderNumPy<Resonix::LFO>, py::arg("frames"),
+             "Return the next frames values")
+        .def("apply", &modulationApplyNumPy<Resonix::LFO>,
+             py::arg("samples"),
+             py::arg("out") = py::none(),
+             "Multiply the next block by the LFO; writes into out (which may be samples) when given")
+        .def_property("phase", &Resonix::LFO::phase, &Resonix::LFO::setPhase)
+        .def_property_readonly("frequency", &Resonix::LFO::frequency)
+        .def_property_readonly("shape", &Resonix::LFO::shape);
+
+    py::class_<SweepFilter>(m, "SweepFilter", R"pbdoc(
+            Stateful lowpass or highpass filter whose cutoff follows an Envelope or LFO.
+
+            The cutoff is cutoff_hz * 2 ** (octaves * value), redesigned every 32
+            samples; the filter state carries over between process() calls.
+
+            Parameters
+            ----------
+            cutoff_hz : float
+                Cutoff at a modulation value of 0
+            octaves : float, optional
+                Cutoff shift per unit of the modulation (default: 1)
+            resonance : float, optional
+                Q factor (default: 0.707)
+            highpass : bool, optional
+                Highpass instead of lowpass (default: False)
+
+            Examples
+            --------
+            >>> envelope = resonix.Envelope(0.005, 0.3, 0.2, 0.3)
+            >>> sweep = resonix.SweepFilter(300.0, octaves=4.0, resonance=2.0)
+            >>> envelope.note_on()
+            >>> pluck = sweep.process(osc.render(22050), envelope)
+          )pbdoc")
+        .def(py::init([](float cutoff_hz, float octaves, float resonance, bool highpass) {
+                 checkPassFilter(cutoff_hz, resonance);
+                 return std::make_unique<SweepFilter>(SweepFilter{Filter::BiquadFilter(),
+                                                                  highpass ? &Filter::make_highpass_filter : &Filter::make_lowpass_filter,
+                                                                  cutoff_hz, octaves, resonance});
+             }),
+             py::arg("cutoff_hz"),
+             py::arg("octaves") = 1.0f,
+             py::arg("resonance") = 0.707f,
+             py::arg("highpass") = false)
+        .def("process", &sweepProcessNumPy<Resonix::Envelope>,
+             py::arg("samples"),
+             py::arg("modulation"),
+             py::arg("out") = py::none(),
+             "Filter the next block while advancing the envelope; writes into out (which may be samples) when given")
+        .def("process", &sweepProcessNumPy<Resonix::LFO>,
+             py::arg("samples"),
+             py::arg("modulation"),
+             py::arg("out") = py::none(),
+             "Filter the next block while advancing the LFO; writes into out (which may be samples) when given")
+        .def("reset", [](SweepFilter& sweep) { sweep.filter.reset(); },
+             "Clear the filter state");
+
+    py::class_<Resonix::ModulatedOscillator>(m, "ModulatedOscillator", R"pbdoc(
+            Oscillator with a running phase, for vibrato, glides, FM and PM at audio rate.
+
+            Parameters
+            ----------
+            shape : Shape, optional
+                SINE, COSINE, SQUARE, TRIANGLE or SAWTOOTH (default: SINE)
+            frequency : float, optional
+                Frequency in Hz of render() and render_pm() (default: 0)
+            phase : float, optional
+                Starting phase in cycles (default: 0)
+
+            Examples
+            --------
+            >>> lfo = resonix.ModulatedOscillator(resonix.Shape.SINE, 5.0)
+            >>> voice = resonix.ModulatedOscillator(resonix.Shape.SAWTOOTH)
+            >>> vibrato = voice.render_fm(220.0 + 3.0 * lfo.render(44100))
+            >>> glide = voice.render_fm(numpy.geomspace(220.0, 440.0, 44100, dtype=numpy.float32))
+          )pbdoc")
+        .def(py::init([](Resonix::Shape shape, float frequency, float phase) {
+                 if (shape != Resonix::SINE && shape != Resonix::COSINE && shape != Resonix::SQUARE
+                     && shape != Resonix::TRIANGLE && shape != Resonix::SAWTOOTH) {
+                     throw std::invalid_argument("shape must be SINE, COSINE, SQUARE, TRIANGLE or SAWTOOTH");
+                 }
+                 return std::make_unique<Resonix::ModulatedOscillator>(shape, frequency, phase);
+             }),
+             py::arg("shape") = Resonix::Shape::SINE,
+             py::arg("frequency") = 0.0f,
+             py::arg("phase") = 0.0f)
+        .def("render", [](Resonix::ModulatedOscillator& osc, int frames, py::object gain) {
+                 if (frames <= 0) {
+                     throw std::invalid_argument("frames must be positive");
+                 }
+                 Resonix::MemoryTag tag("ModulatedOscillator");
+                 py::array_t<float> samples = pooledArray<float>({frames});
+                 float* data = samples.mutable_data();
+                 renderWithGain(gain, [&] { osc.render(data, frames); },
+                                [&](auto& source) { osc.render(data, frames, source); });
+                 return samples;
+             }, py::arg("frames"), py::arg("gain") = py::none(),
+             "Render frames samples at the constant frequency, multiplied by gain (an Envelope or LFO) when given")
+        .def("render_fm", [](Resonix::ModulatedOscillator& osc, py::array_t<float, py::array::c_style | py::array::forcecast> frequency, py::object gain) {
+                 if (frequency.ndim() != 1 || frequency.size() == 0) {
+                     throw std::invalid_argument("frequency must be a non-empty 1D array");
+                 }
+                 const int frames = static_cast<int>(frequency.size());
+                 Resonix::MemoryTag tag("ModulatedOscillator");
+                 py::array_t<float> samples = pooledArray<float>({frames});
+                 float* data = samples.mutable_data();
+                 const float* input = frequency.data();
+                 renderWithGain(gain, [&] { osc.renderFM(data, frames, input); },
+                                [&](auto& source) { osc.renderFM(data, frames, input, source); });
+                 return samples;
+             }, py::arg("frequency"), py::arg("gain") = py::none(),
+             "Render one sample per entry of frequency, an array of instantaneous frequencies in Hz, multiplied by gain when given")
+        .def("render_pm", [](Resonix::ModulatedOscillator& osc, py::array_t<float, py::array::c_style | py::array::forcecast> modulation, float depth,
+                             py::object gain) {
+                 if (modulation.ndim() != 1 || modulation.size() == 0) {
+                     throw std::invalid_argument("modulation must be a non-empty 1D array");
+                 }
+                 const int frames = static_cast<int>(modulation.size());
+                 Resonix::MemoryTag tag("ModulatedOscillator");
+                 py::array_t<float> samples = pooledArray<float>({frames});
+                 float* data = samples.mutable_data();
+                 const float* input = modulation.data();
+                 renderWithGain(gain, [&] { osc.renderPM(data, frames, input, depth); },
+                                [&](auto& source) { osc.renderPM(data, frames, input, depth, source); });
+                 return samples;
+             }, py::arg("modulation"), py::arg("depth") = 1.0f, py::arg("gain") = py::none(),
+             "Render one sample per entry of modulation, shifting the phase by depth * modulation radians, multiplied by gain when given")
+        .def_property("frequency", &Resonix::ModulatedOscillator::frequency, &Resonix::ModulatedOscillator::setFrequency)
+        .def_property("phase", &Resonix::ModulatedOscillator::phase, &Resonix::ModulatedOscillator::setPhase)
+        .def_property_readonly("shape", &Resonix::ModulatedOscillator::shape);
+
+    py::class_<Resonix::FMVoice>(m, "FMVoice", R"pbdoc(
+            Phase-modulation synthesizer of 2 to 6 operators.
+
+            Operator i can be modulated by any operator with a higher index,
+            and the output is the sum of the operators weighted by their output
+            gain. The whole operator graph renders in one native pass.
+
+            Parameters
+            ----------
+            operators : int, optional
+                Number of operators, 1 to 6 (default: 2)
+            frequency : float, optional
+                Voice frequency in Hz (default: 0)
+
+            Examples
+            --------
+            >>> bell = resonix.FMVoice(2, 220.0)
+            >>> bell.set_operator(0, output=0.5)
+            >>> bell.set_operator(1, ratio=3.5)
+            >>> bell.set_modulation(0, 1, 4.0)
+            >>> samples = bell.render(2 * resonix.SAMPLE_RATE)
+          )pbdoc")
+        .def(py::init([](int operators, float frequency) {
+                 if (operators < 1 || operators > Resonix::MAX_OPERATORS) {
+                     throw std::invalid_argument("operators must be between 1 and 6");
+                 }
+                 return std::make_unique<Resonix::FMVoice>(operators, frequency);
+             }),
+             py::arg("operators") = 2,
+             py::arg("frequency") = 0.0f)
+        .def("set_operator", [](Resonix::FMVoice& voice, int index, float ratio, float frequency, float feedback, float output, Resonix::Shape shape) {
+                 Resonix::FMOperator settings;
+                 settings.shape = shape;
+                 settings.ratio = ratio;
+                 settings.frequency = frequency;
+                 settings.feedback = feedback;
+                 settings.output = output;
+                 if (!voice.setOperator(index, settings)) {
+                     throw std::invalid_argument("index must name an operator and shape must be SINE, COSINE, SQUARE, TRIANGLE or SAWTOOTH");
+                 }
+             }, py::arg("index"), py::arg("ratio") = 1.0f, py::arg("frequency") = 0.0f, py::arg("feedback") = 0.0f,
+             py::arg("output") = 0.0f, py::arg("shape") = Resonix::Shape::SINE,
+             "Set an operator's frequency ratio (or fixed frequency in Hz), self-feedback index in radians and output gain")
+        .def("set_modulation", [](Resonix::FMVoice& voice, int target, int source, float index) {
+                 if (!voice.setModulation(target, source, index)) {
+                     throw std::invalid_argument("source must be an operator with a higher index than target");
+                 }
+             }, py::arg("target"), py::arg("source"), py::arg("index"),
+             "Let source modulate the phase of target with a modulation index in radians")
+        .def("render", [](Resonix::FMVoice& voice, int frames) {
+                 if (frames <= 0) {
+                     throw std::invalid_argument("frames must be positive");
+                 }
+                 Resonix::MemoryTag tag("FMVoice");
+                 py::array_t<float> samples = pooledArray<float>({frames});
+                 voice.render(samples.mutable_data(), frames);
+                 return samples;
+             }, py::arg("frames"),
+             "Render the next frames samples of the voice")
+        .def("reset", &Resonix::FMVoice::reset,
+             "Restart every operator at phase 0")
+        .def_property("frequency", &Resonix::FMVoice::frequency, &Resonix::FMVoice::setFrequency)
+        .def_property_readonly("operators", &Resonix::FMVoice::operators);
+
+    py::class_<Resonix::VoiceAllocator>(m, "VoiceAllocator", R"pbdoc(
+            Polyphonic synthesizer playing timed note events on a fixed pool of voices.
+
+            Notes start and stop on exactly their sample, and every voice is
+            mixed straight into one output, so a whole sequence renders in a
+            single native pass instead of one array per note. When every voice
+            is busy, a new note takes over the oldest releasing voice, or else
+            the oldest one.
+
+            Parameters
+            ----------
+            voices : int, optional
+                Size of the voice pool, at most 1024 (default: 64)
+
+            Examples
+            --------
+            >>> synth = resonix.VoiceAllocator(128)
+            >>> starts = numpy.arange(64) * 2205
+            >>> synth.add_notes(starts, 8820, 220.0 * 2 ** (numpy.arange(64) % 12 / 12), 0.1,
+            ...                 resonix.Shape.SAWTOOTH)
+            >>> mix = synth.render(64 * 2205 + 8820 + 64)
+          )pbdoc")
+        .def(py::init([](int voices) {
+                 if (voices <= 0 || voices > Resonix::VoiceAllocator::MAX_VOICE_COUNT) {
+                     throw std::invalid_argument("voices must be between 1 and 1024");
+                 }
+                 return std::make_unique<Resonix::VoiceAllocator>(voices);
+             }),
+             py::arg("voices") = Resonix::VoiceAllocator::DEFAULT_VOICE_COUNT)
+        .def("note_on", [](Resonix::VoiceAllocator& synth, long long time, int note, Resonix::Shape shape, float frequency, float velocity) {
+                 if (note < 0) {
+                     throw std::invalid_argument("note must not be negative");
+                 }
+                 Resonix::NoteEvent event;
+                 event.time = time;
+                 event.type = Resonix::NOTE_ON;
+                 event.note = note;
+                 event.shape = shape;
+                 event.frequency = frequency;
+                 event.velocity = velocity;
+                 if (!synth.schedule(event)) {
+                     throw std::invalid_argument("note_on needs a time not yet rendered, a tonal shape, a positive frequency and a non-negative velocity");
+                 }
+             }, py::arg("time"), py::arg("note"), py::arg("shape"), py::arg("frequency"), py::arg("velocity") = 1.0f,
+             "Start a voice playing note at sample index time")
+        .def("note_off", [](Resonix::VoiceAllocator& synth, long long time, int note) {
+                 Resonix::NoteEvent event;
+                 event.time = time;
+                 event.type = Resonix::NOTE_OFF;
+                 event.note = note;
+                 if (!synth.schedule(event)) {
+                     throw std::invalid_argument("time has already been rendered");
+                 }
+             }, py::arg("time"), py::arg("note"),
+             "Release every voice playing note at sample index time")
+        .def("all_notes_off", [](Resonix::VoiceAllocator& synth, long long time) {
+                 Resonix::NoteEvent event;
+                 event.time = time;
+                 event.type = Resonix::ALL_NOTES_OFF;
+                 if (!synth.schedule(event)) {
+                     throw std::invalid_argument("time has already been rendered");
+                 }
+             }, py::arg("time"),
+             "Release every voice at sample index time")
+        .def("add_notes", [](Resonix::VoiceAllocator& synth,
+                             py::array_t<long long, py::array::c_style | py::array::forcecast> starts,
+                             py::array_t<long long, py::array::c_style | py::array::forcecast> durations,
+                             py::array_t<float, py::array::c_style | py::array::forcecast> frequencies,
+                             py::array_t<float, py::array::c_style | py::array::forcecast> velocities,
+                             Resonix::Shape shape) {
+                 const py::ssize_t count = std::max({starts.size(), durations.size(), frequencies.size(), velocities.size()});
+                 for (const py::ssize_t size : {starts.size(), durations.size(), frequencies.size(), velocities.size()}) {
+                     if (size != 1 && size != count) {
+                         throw std::invalid_argument("starts, durations, frequencies and velocities must have one element or the same length");
+                     }
+                 }
+
+                 const long long* start = starts.data();
+                 const long long* duration = durations.data();
+                 const float* frequency = frequencies.data();
+                 const float* velocity = velocities.data();
+                 for (py::ssize_t i = 0; i < count; i++) {
+                     if (!synth.addNote(start[starts.size() == 1 ? 0 : i], duration[durations.size() == 1 ? 0 : i], shape,
+                                        frequency[frequencies.size() == 1 ? 0 : i], velocity[velocities.size() == 1 ? 0 : i])) {
+                         throw std::invalid_argument("note " + std::to_string(i) + " is invalid or starts before position");
+                     }
+                 }
+             }, py::arg("starts"), py::arg("durations"), py::arg("frequencies"), py::arg("velocities") = 1.0f,
+             py::arg("shape") = Resonix::Shape::SINE,
+             R"pbdoc(
+            Schedule many notes at once, each as a note on and its note off.
+
+            Parameters
+            ----------
+            starts, durations : int or array of int
+                First sample and length in samples of each note
+            frequencies, velocities : float or array of float
+                Pitch in Hz and peak gain of each note
+            shape : Shape, optional
+                SINE, COSINE, SQUARE, TRIANGLE or SAWTOOTH (default: SINE)
+          )pbdoc")
+        .def("set_filter", [](Resonix::VoiceAllocator& synth, const Filter::FilterChain& chain) {
+                 synth.setFilter(chain);
+             }, py::arg("chain"),
+             "Run every voice through its own copy of chain, reset on each note; an empty chain turns it off")
+        .def("set_envelope", &Resonix::VoiceAllocator::setEnvelope, py::arg("envelope"),
+             "Shape every note started from now on with a copy of envelope, scaled by its velocity")
+        .def("render", [](Resonix::VoiceAllocator& synth, int frames) {
+                 if (frames <= 0) {
+                     throw std::invalid_argument("frames must be positive");
+                 }
+                 Resonix::MemoryTag tag("VoiceAllocator");
+                 py::array_t<float> samples = pooledArray<float>({frames});
+                 synth.render(samples.mutable_data(), frames);
+                 return samples;
+             }, py::arg("frames"),
+             "Render the next frames samples of the mix as a new float32 array")
+        .def("reset", &Resonix::VoiceAllocator::reset,
+             "Silence every voice, drop all events and restart at sample 0")
+        .def("stats", [](const Resonix::VoiceAllocator& synth) {
+                 Resonix::VoiceStats snapshot = synth.stats();
+                 py::dict result;
+                 result["notes"] = snapshot.notes;
+                 result["steals"] = snapshot.steals;
+                 result["active"] = snapshot.active;
+                 result["peak_active"] = snapshot.peak_active;
+                 return result;
+             }, "Notes played, voices stolen, voices sounding now and at most")
+        .def_property_readonly("position", &Resonix::VoiceAllocator::position)
+        .def_property_readonly("voice_count", &Resonix::VoiceAllocator::voiceCount)
+        .def_property_readonly("pending_events", &Resonix::VoiceAllocator::pendingEvents);
+
+    py::class_<Resonix::RenderThread>(m, "RenderThread", R"pbdoc(
+            Renders an oscillator, optionally through a filter chain, ahead of a real-time consumer.
+
+            A background thread fills a lock-free ring buffer one block at a
+            time. read() never waits: when the renderer falls behind, the
+            missing frames are silence and stats() counts an underrun. The
+            oscillator and chain are copied, so later changes to them do not
+            reach the running thread.
+
+            Parameters
+            ----------
+            oscillator : Oscillator
+                Source of the stream
+            chain : FilterChain, optional
+                Filters applied to every block (default: None)
+            block_size : int, optional
+                Frames rendered per step (default: 256)
+            buffer_frames : int, optional
+                Ring size in frames, rounded up to a power of two; this is the
+                latency and the headroom against stalls (default: 4096)
+
+            Examples
+            --------
+            >>> osc = resonix.Oscillator(resonix.Shape.SAWTOOTH, 110.0)
+            >>> renderer = resonix.RenderThread(osc, resonix.FilterChain().lowpass(1200.0))
+            >>> renderer.start()
+            >>> def callback(outdata, frames, time, status):   # sounddevice
+            ...     outdata[:, 0] = renderer.read(frames)
+          )pbdoc")
+        .def(py::init([](const Resonix::Oscillator& oscillator, py::object chain, int block_size, int buffer_frames) {
+                 if (block_size <= 0 || buffer_frames <= 0) {
+                     throw std::invalid_argument("block_size and buffer_frames must be positive");
+                 }
+                 Filter::FilterChain filters;
+                 if (!chain.is_none()) {
+                     filters = chain.cast<const Filter::FilterChain&>();
+                 }
+                 Resonix::Oscillator source = oscillator;
+                 return std::make_unique<Resonix::RenderThread>(
+                     [source, filters](float* block, int frames) mutable {
+                         source.render(block, frames);
+                         if (filters.size() > 0) {
+                             filters.process(block, block, frames);
+                         }
+                     },
+                     block_size, buffer_frames);
+             }),
+             py::arg("oscillator"),
+             py::arg("chain") = py::none(),
+             py::arg("block_size") = Resonix::RenderThread::DEFAULT_BLOCK_SIZE,
+             py::arg("buffer_frames") = Resonix::RenderThread::DEFAULT_BUFFER_FRAMES)
+        .def("start", [](Resonix::RenderThread& renderer) {
+                 if (!renderer.start()) {
+                     throw std::runtime_error("RenderThread is already running");
+                 }
+             }, "Fill the buffer and start rendering in the background")
+        .def("stop", &Resonix::RenderThread::stop,
+             "Stop the render thread; frames already buffered can still be read")
+        .def("read", [](Resonix::RenderThread& renderer, int frames) {
+                 if (frames <= 0) {
+                     throw std::invalid_argument("frames must be positive");
+                 }
+                 Resonix::MemoryTag tag("RenderThread");
+                 py::array_t<float> samples = pooledArray<float>({frames});
+                 float* data = samples.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     renderer.read(data, frames);
+                 }
+                 return samples;
+             }, py::arg("frames"),
+             "Take the next frames samples as a new float32 array, padded with silence on underrun;\n"
+             "all silence while another thread, such as a SinkThread, is reading")
+        .def("stats", [](const Resonix::RenderThread& renderer) {
+                 Resonix::RealtimeStats snapshot = renderer.stats();
+                 py::dict result;
+                 result["frames_rendered"] = snapshot.frames_rendered;
+                 result["frames_read"] = snapshot.frames_read;
+                 result["underruns"] = snapshot.underruns;
+                 result["underrun_frames"] = snapshot.underrun_frames;
+                 result["buffered_frames"] = snapshot.buffered_frames;
+                 result["min_buffered_frames"] = snapshot.min_buffered_frames;
+                 result["latency_ms"] = 1000.0 * static_cast<double>(snapshot.buffered_frames) / Resonix::SAMPLE_RATE;
+                 result["max_render_ms"] = snapshot.max_render_ms;
+                 return result;
+             }, R"pbdoc(
+            Counters since start() or reset_stats().
+
+            Returns
+            -------
+            dict
+                frames_rendered, frames_read, underruns (reads that came up
+                short), underrun_frames (frames replaced by silence),
+                buffered_frames and latency_ms (what is queued right now),
+                min_buffered_frames (the least headroom any read saw) and
+                max_render_ms (the slowest block)
+          )pbdoc")
+        .def("reset_stats", &Resonix::RenderThread::resetStats,
+             "Zero the counters; do not call while another thread reads")
+        .def_property_readonly("running", &Resonix::RenderThread::running)
+        .def_property_readonly("block_size", &Resonix::RenderThread::blockSize)
+        .def_property_readonly("buffer_frames", &Resonix::RenderThread::bufferFrames);
+
+    py::class_<Resonix::SinkThread>(m, "SinkThread", R"pbdoc(
+            Pulls a RenderThread like an audio device would, without one.
+
+            Every period of frames goes to a file, or nowhere, either at the
+            pace of the sample clock or as fast as possible. Useful to run a
+            renderer headless and read its underrun counters. While it runs,
+            RenderThread.read() from other threads returns silence, and closing
+            the writer ends the run.
+
+            Parameters
+            ----------
+            render_thread : RenderThread
+                Stream to pull
+            writer : AudioFileWriter, optional
+                Mono file that receives every period; None discards them (default: None)
+            period : int, optional
+                Frames pulled at a time (default: 256)
+            realtime : bool, optional
+                Pull one period per period duration; False pulls back to back (default: True)
+
+            Examples
+            --------
+            >>> renderer.start()
+            >>> sink = resonix.SinkThread(renderer)
+            >>> sink.start(10 * resonix.SAMPLE_RATE)
+            >>> sink.wait()
+            >>> print(renderer.stats()['underruns'])
+          )pbdoc")
+        .def(py::init([](Resonix::RenderThread& renderer, py::object writer, int period, bool realtime) {
+                 if (period <= 0) {
+                     throw std::invalid_argument("period must be positive");
+                 }
+                 if (writer.is_none()) {
+                     return std::make_unique<Resonix::SinkThread>(renderer, Resonix::nullSink(), period, realtime);
+                 }
+                 Resonix::AudioFileWriter& file = writer.cast<Resonix::AudioFileWriter&>();
+                 if (!file.isOpen() || file.channels() != 1) {
+                     throw std::invalid_argument("writer must be an open mono AudioFileWriter");
+                 }
+                 return std::make_unique<Resonix::SinkThread>(renderer, Resonix::fileSink(file), period, realtime);
+             }),
+             py::keep_alive<1, 2>(),
+             py::keep_alive<1, 3>(),
+             py::arg("render_thread"),
+             py::arg("writer") = py::none(),
+             py::arg("period") = Resonix::SinkThread::DEFAULT_PERIOD,
+             py::arg("realtime") = true)
+        .def("start", [](Resonix::SinkThread& sink, py::object frames) {
+                 long long limit = frames.is_none() ? -1 : frames.cast<long long>();
+                 if (limit == 0 || limit < -1) {
+                     throw std::invalid_argument("frames must be positive");
+                 }
+                 if (!sink.start(limit)) {
+                     throw std::runtime_error("SinkThread is already running");
+                 }
+             }, py::arg("frames") = py::none(),
+             "Start pulling, until stop() or until frames samples have been delivered")
+        .def("stop", &Resonix::SinkThread::stop, "Stop pulling")
+        .def("wait", [](Resonix::SinkThread& sink) {
+                 // Only the wait for the run to end lets other threads in; the join itself is immediate
+                 while (sink.running()) {
+                     py::gil_scoped_release release;
+                     std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                 }
+                 sink.wait();
+             }, "Block until a start() with a frame count has delivered every frame")
+        .def_property_readonly("running", &Resonix::SinkThread::running)
+        .def_property_readonly("frames_delivered", &Resonix::SinkThread::framesDelivered);
+
+    py::class_<Resonix::Graph>(m, "Graph", R"pbdoc(
+            Block-based processing graph.
+
+            Nodes wrap the generators and filters and are evaluated in cache-sized
+            blocks in a single streaming pass, without full-length intermediate
+            arrays. Independent branches run in parallel on a work-stealing pool.
+            Every add_* method returns the id of the new node.
+
+            Examples
+            --------
+            >>> g = resonix.Graph()
+            >>> saw = g.add_oscillator(resonix.Shape.SAWTOOTH, 110.0)
+            >>> sine = g.add_oscillator(resonix.Shape.SINE, 440.0)
+            >>> vowel = g.add_formant(g.add_lowpass(saw, 2000.0), 0.5, 1.0, 0.0)
+            >>> g.set_output(g.add_mix([vowel, sine], [0.7, 0.3]))
+            >>> samples = g.render(2 * resonix.SAMPLE_RATE)
+          )pbdoc")
+        .def(py::init<>())
+        .def("add_oscillator", [](Resonix::Graph& g, Resonix::Shape shape, float frequency) {
+                 return checkedNode(g.addOscillator(shape, frequency));
+             }, py::arg("shape"), py::arg("frequency"))
+        .def("add_lowpass", [](Resonix::Graph& g, int input, float cutoff_hz, float resonance) {
+                 return checkedNode(g.addLowpass(input, cutoff_hz, resonance));
+             }, py::arg("input"), py::arg("cutoff_hz"), py::arg("resonance") = 0.707f)
+        .def("add_highpass", [](Resonix::Graph& g, int input, float cutoff_hz, float resonance) {
+                 return checkedNode(g.addHighpass(input, cutoff_hz, resonance));
+             }, py::arg("input"), py::arg("cutoff_hz"), py::arg("resonance") = 0.707f)
+        .def("add_bandpass", [](Resonix::Graph& g, int input, float center_hz, float bandwidth_hz, float resonance) {
+                 return checkedNode(g.addBandpass(input, center_hz, bandwidth_hz, resonance));
+             }, py::arg("input"), py::arg("center_hz"), py::arg("bandwidth_hz"), py::arg("resonance") = 0.707f)
+        .def("add_formant", [](Resonix::Graph& g, int input, float peak, float mix, float spread) {
+                 return checkedNode(g.addFormant(input, peak, mix, spread));
+             }, py::arg("input"), py::arg("peak"), py::arg("mix") = 0.5f, py::arg("spread") = 0.0f)
+        .def("add_gain", [](Resonix::Graph& g, int input, float gain) {
+                 return checkedNode(g.addGain(input, gain));
+             }, py::arg("input"), py::arg("gain"))
+        .def("add_mix", [](Resonix::Graph& g, const std::vector<int>& inputs, const std::vector<float>& gains) {
+                 return checkedNode(g.addMix(inputs, gains));
+             }, py::arg("inputs"), py::arg("gains"))
+        .def("set_output", [](Resonix::Graph& g, int node) {
+                 checkedNode(g.setOutput(node) ? node : -1);
+             }, py::arg("node"))
+        .def("render", &graphRenderNumPy,
+             py::arg("frames"),
+             py::arg("block_size") = Resonix::Graph::DEFAULT_BLOCK_SIZE,
+             "Render frames samples of the output node as a float32 array")
+        .def("render_to_file", &renderToFile,
+             py::arg("writer"),
+             py::arg("frames"),
+             py::arg("block_size") = Resonix::Graph::DEFAULT_BLOCK_SIZE,
+             "Stream frames samples of the output node into a mono AudioFileWriter")
+        .def("__len__", &Resonix::Graph::size);
+
+    py::class_<SignalNode, SignalPtr> signal(m, "Signal", R"pbdoc(
+            Lazy signal expression.
+
+            Arithmetic on Signal objects (and on NumPy arrays or numbers mixed with
+            them) only records an expression. evaluate() computes the whole
+            expression in one blocked C++ pass: sums of scaled inputs collapse into
+            a single fused mix, and arrays are read in place, so mixing costs one
+            write per output sample instead of one temporary per operator.
+
+            Examples
+            --------
+            >>> low = resonix.generate_samples(resonix.Shape.SINE, 2, 100.0)
+            >>> mid = resonix.generate_samples(resonix.Shape.SINE, 2, 440.0)
+            >>> mixed = (resonix.Signal(low) * 0.3 + mid * 0.5).evaluate()
+
+            >>> # Generators and filters are lazy too
+            >>> vowel = resonix.Signal.tone(resonix.Shape.SAWTOOTH, 110.0).lowpass(2000.0).formant(0.5, 1.0)
+            >>> samples = vowel.evaluate(resonix.SAMPLE_RATE)
+          )pbdoc");
+
+    signal
+        .def(py::init(&signalFromArray), py::arg("samples"),
+             "Wrap a 1D array of samples; float32 arrays are not copied")
+        .def_static("tone", [](Resonix::Shape shape, float frequency) {
+                 if (frequency <= 0.0f) {
+                     throw std::invalid_argument("frequency must be positive");
+                 }
+                 SignalPtr node = makeSignal(SignalNode::TONE, {}, frequency);
+                 node->shape = shape;
+                 return node;
+             }, py::arg("shape"), py::arg("frequency"),
+             "Lazy waveform generator")
+        .def_static("noise", [](Resonix::Shape shape, unsigned long long seed) {
+                 if (!Resonix::isNoise(shape)) {
+                     throw std::invalid_argument("shape must be NOISE_WHITE, NOISE_PINK or NOISE_BROWN");
+                 }
+                 SignalPtr node = makeSignal(SignalNode::TONE, {});
+                 node->shape = shape;
+                 node->seed = seed;
+                 return node;
+             }, py::arg("shape"), py::arg("seed") = 0,
+             "Lazy seeded noise generator")
+        .def("__add__", [](const SignalPtr& a, const SignalPtr& b) { return makeSignal(SignalNode::ADD, {a, b}); }, py::is_operator())
+        .def("__add__", [](const SignalPtr& a, float b) { return makeSignal(SignalNode::ADD, {a, signalConstant(b)}); }, py::is_operator())
+        .def("__radd__", [](const SignalPtr& a, const SignalPtr& b) { return makeSignal(SignalNode::ADD, {b, a}); }, py::is_operator())
+        .def("__radd__", [](const SignalPtr& a, float b) { return makeSignal(SignalNode::ADD, {signalConstant(b), a}); }, py::is_operator())
+        .def("__sub__", [](const SignalPtr& a, const SignalPtr& b) { return makeSignal(SignalNode::SUBTRACT, {a, b}); }, py::is_operator())
+        .def("__sub__", [](const SignalPtr& a, float b) { return makeSignal(SignalNode::SUBTRACT, {a, signalConstant(b)}); }, py::is_operator())
+        .def("__rsub__", [](const SignalPtr& a, const SignalPtr& b) { return makeSignal(SignalNode::SUBTRACT, {b, a}); }, py::is_operator())
+        .def("__rsub__", [](const SignalPtr& a, float b) { return makeSignal(SignalNode::SUBTRACT, {signalConstant(b), a}); }, py::is_operator())
+        .def("__mul__", [](const SignalPtr& a, const SignalPtr& b) { return makeSignal(SignalNode::MULTIPLY, {a, b}); }, py::is_operator())
+        .def("__mul__", [](const SignalPtr& a, float b) { return makeSignal(SignalNode::MULTIPLY, {a, signalConstant(b)}); }, py::is_operator())
+        .def("__rmul__", [](const SignalPtr& a, const SignalPtr& b) { return makeSignal(SignalNode::MULTIPLY, {b, a}); }, py::is_operator())
+        .def("__rmul__", [](const SignalPtr& a, float b) { return makeSignal(SignalNode::MULTIPLY, {signalConstant(b), a}); }, py::is_operator())
+        .def("__truediv__", [](const SignalPtr& a, const SignalPtr& b) { return makeSignal(SignalNode::DIVIDE, {a, b}); }, py::is_operator())
+        .def("__truediv__", [](const SignalPtr& a, float b) { return makeSignal(SignalNode::DIVIDE, {a, signalConstant(b)}); }, py::is_operator())
+        .def("__rtruediv__", [](const SignalPtr& a, const SignalPtr& b) { return makeSignal(SignalNode::DIVIDE, {b, a}); }, py::is_operator())
+        .def("__rtruediv__", [](const SignalPtr& a, float b) { return makeSignal(SignalNode::DIVIDE, {signalConstant(b), a}); }, py::is_operator())
+        .def("__neg__", [](const SignalPtr& a) { return makeSignal(SignalNode::MULTIPLY, {a, signalConstant(-1.0f)}); }, py::is_operator())
+        .def("lowpass", [](const SignalPtr& a, float cutoff_hz, float resonance) {
+                 checkPassFilter(cutoff_hz, resonance);
+                 return makeSignal(SignalNode::LOWPASS, {a}, cutoff_hz, resonance);
+             }, py::arg("cutoff_hz"), py::arg("resonance") = 0.707f, "Lazy lowpass_filter()")
+        .def("highpass", [](const SignalPtr& a, float cutoff_hz, float resonance) {
+                 checkPassFilter(cutoff_hz, resonance);
+                 return makeSignal(SignalNode::HIGHPASS, {a}, cutoff_hz, resonance);
+             }, py::arg("cutoff_hz"), py::arg("resonance") = 0.707f, "Lazy highpass_filter()")
+        .def("bandpass", [](const SignalPtr& a, float center_hz, float bandwidth_hz, float resonance) {
+                 checkBandpassFilter(center_hz, bandwidth_hz, resonance);
+                 return makeSignal(SignalNode::BANDPASS, {a}, center_hz, bandwidth_hz, resonance);
+             }, py::arg("center_hz"), py::arg("bandwidth_hz"), py::arg("resonance") = 0.707f, "Lazy bandpass_filter()")
+        .def("formant", [](const SignalPtr& a, float peak, float mix, float spread) {
+                 checkFormantFilter(peak, mix, spread);
+                 return makeSignal(SignalNode::FORMANT, {a}, peak, mix, spread);
+             }, py::arg("peak"), py::arg("mix") = 0.5f, py::arg("spread") = 0.0f, "Lazy formant_filter()")
+        .def_property_readonly("length", [](const SignalPtr& a) -> py::object {
+                 long long length = signalLength(*a);
+                 return length < 0 ? py::object(py::none()) : py::object(py::int_(length));
+             }, "Length of the shortest array input, or None if unbounded")
+        .def("evaluate", &evaluateSignal,
+             py::arg("length") = py::none(),
+             py::arg("block_size") = Resonix::Graph::DEFAULT_BLOCK_SIZE,
+             "Compute the expression in one pass and return a float32 array")
+        .def("write", &writeSignalToFile,
+             py::arg("writer"),
+             py::arg("length") = py::none(),
+             py::arg("block_size") = Resonix::Graph::DEFAULT_BLOCK_SIZE,
+             "Stream the expression into a mono AudioFileWriter instead of an array")
+        .def("__array__", [](const SignalPtr& a, py::args, py::kwargs) {
+                 return evaluateSignal(a, py::none(), Resonix::Graph::DEFAULT_BLOCK_SIZE);
+             });
+
+    // Arrays mixed with a Signal must defer to it instead of broadcasting element-wise
+    signal.attr("__array_ufunc__") = py::none();
+    py::implicitly_convertible<py::array, SignalNode>();
 }
\ No newline at end of file
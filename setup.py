@@ -17,6 +17,9 @@ ext_modules = [
             'src/generator/Trigonometric.cpp',
             'src/generator/Primitives.cpp',
             'src/generator/Hann.cpp',
+            'src/generator/Oscillator.cpp',
+            'src/generator/Noise.cpp',
+            'src/analysis/Analysis.cpp',
             'src/math/Trigonometry.cpp',
             'src/math/Utils.cpp',
             'src/math/NaN.cpp',
@@ -24,13 +27,33 @@ ext_modules = [
             'src/Filter/FormantFilter.cpp',
             'src/Filter/PassFilter.cpp',
             'src/Filter/BandpassFilter.cpp',
+            'src/Filter/FilterChain.cpp',
+            'src/Filter/Dynamics.cpp',
+            'src/Filter/Reverb.cpp',
+            'src/resampler/Polyphase.cpp',
+            'src/parallel/ThreadPool.cpp',
+            'src/graph/Graph.cpp',
+            'src/memory/BufferPool.cpp',
+            'src/memory/AudioBuffer.cpp',
+            'src/io/Pcm.cpp',
+            'src/io/AudioFileReader.cpp',
+            'src/io/AudioFileWriter.cpp',
+            'src/instrument/Instrument.cpp',
+            'src/realtime/RenderThread.cpp',
+            'src/generator/FM.cpp',
+            'src/generator/Modulation.cpp',
+            'src/synth/Voices.cpp',
         ],
         include_dirs=[
             get_pybind_include(),
             'include',
         ],
         language='c++',
-        extra_compile_args=['-std=c++17'],
+        # RESONIX_INSTRUMENT=1 pip install . builds with per-stage counters (see Instrument.hpp)
+        define_macros=[('RESONIX_INSTRUMENT', '1')] if os.environ.get('RESONIX_INSTRUMENT') else [],
+        # Portable baseline; the hot kernels add AVX2 and AVX-512 versions picked at load time (see Dispatch.hpp)
+        extra_compile_args=['-std=c++17', '-pthread', '-O3', '-fno-math-errno', '-fno-trapping-math'],
+        extra_link_args=['-pthread'],
     ),
 ]
 
@@ -1,12 +1,9 @@
+#include <cmath>
 #include "Filter.hpp"
 #include "Math.hpp"
 
 namespace Filter {
-    std::unique_ptr<float[]> apply_bandpass_filter(const float* samples, int sample_length, float center_hz, float bandwidth_hz, float resonance) {
-        if (!samples || sample_length <= 0 || center_hz <= 0 || bandwidth_hz <= 0)
-            return nullptr;
-
-        auto filtered = std::make_unique<float[]>(sample_length);
+    BiquadFilter make_bandpass_filter(float center_hz, float bandwidth_hz, float resonance) {
         BiquadFilter filter;
         float q, omega, omega_degrees, sin_omega, cos_omega, alpha;
         float b0, b1, b2, a0, a1, a2;
@@ -35,10 +32,26 @@ namespace Filter {
         filter.a1 = a1 / a0;
         filter.a2 = a2 / a0;
 
-        for (int i = 0; i < sample_length; i++) {
-            filtered[i] = filter.process(samples[i]);
-        }
+        // process<double> gets the same design evaluated in double precision
+        double omega_wide = 2.0 * M_PI * center_hz / Resonix::SAMPLE_RATE;
+        double alpha_wide = std::sin(omega_wide) / (2.0 * q);
+        double a0_wide = 1.0 + alpha_wide;
+
+        filter.setPreciseCoefficients(alpha_wide / a0_wide, 0.0, -alpha_wide / a0_wide,
+                                      -2.0 * std::cos(omega_wide) / a0_wide, (1.0 - alpha_wide) / a0_wide);
+
+        return filter;
+    }
+
+    Resonix::SampleBuffer apply_bandpass_filter(const float* samples, int sample_length, float center_hz, float bandwidth_hz, float resonance, Resonix::SignalStats* stats) {
+        if (!samples || sample_length <= 0 || center_hz <= 0 || bandwidth_hz <= 0)
+            return nullptr;
+
+        auto filtered = Resonix::allocateSamples(sample_length);
+
+        BiquadFilter filter = make_bandpass_filter(center_hz, bandwidth_hz, resonance);
+        process_with_stats(filter, samples, filtered.get(), sample_length, stats);
 
         return filtered;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,433 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "Dynamics.hpp"
+#include "Analysis.hpp"
+#include "Dispatch.hpp"
+#include "Instrument.hpp"
+
+namespace Filter {
+    namespace {
+        // dB per unit of log2 amplitude: 20 * log10(2)
+        constexpr float DB_PER_OCTAVE = 6.0205999f;
+        // Detector floor, about -200 dB, keeps log2 finite on silence
+        constexpr float LEVEL_FLOOR = 1e-10f;
+
+        int ringLength(int frames) {
+            int length = 1;
+
+            while (length < frames) {
+                length <<= 1;
+            }
+            return length;
+        }
+
+        float timeCoefficient(float milliseconds) {
+            const double frames = static_cast<double>(milliseconds) * 1e-3 * Resonix::SAMPLE_RATE;
+            return frames > 0.0 ? static_cast<float>(std::exp(-1.0 / frames)) : 0.0f;
+        }
+
+        // log2 by exponent extraction and the atanh series of the mantissa in [sqrt(0.5), sqrt(2)), within 1e-7.
+        // Branch-free integer splitting, so the loops around it vectorize
+        inline float log2Fast(float value) {
+            int bits, exponent;
+            float mantissa, s, s2;
+
+            std::memcpy(&bits, &value, sizeof(bits));
+            exponent = (bits - 0x3F3504F3) >> 23;
+            bits -= exponent * (1 << 23);
+            std::memcpy(&mantissa, &bits, sizeof(bits));
+
+            s = (mantissa - 1.0f) / (mantissa + 1.0f);
+            s2 = s * s;
+            return static_cast<float>(exponent)
+                   + s * (2.88539008f + s2 * (0.96179669f + s2 * (0.57707801f + s2 * 0.41219858f)));
+        }
+
+        // 2^x for x in [-126, 0] by exponent insertion and the Taylor series of e^(f ln 2) for f in [-0.5, 0.5], within 2e-7
+        inline float exp2Fast(float value) {
+            float x, result;
+            int whole, bits;
+
+            whole = static_cast<int>(value + 126.5f) - 126;
+            x = (value - static_cast<float>(whole)) * 0.69314718f;
+            result = 1.0f + x * (1.0f + x * (0.5f + x * (1.0f / 6.0f + x * (1.0f / 24.0f + x * (1.0f / 120.0f + x * (1.0f / 720.0f))))));
+
+            std::memcpy(&bits, &result, sizeof(bits));
+            bits += whole * (1 << 23);
+            std::memcpy(&result, &bits, sizeof(bits));
+            return result;
+        }
+
+        // levels[i] = max(levels[i], |input[i]|): the linked detector
+        RESONIX_CLONES
+        void linkPeaks(float* levels, const float* input, int count) {
+            for (int i = 0; i < count; i++) {
+                const float magnitude = input[i] < 0.0f ? -input[i] : input[i];
+                levels[i] = levels[i] > magnitude ? levels[i] : magnitude;
+            }
+        }
+
+        // levels[i] = max(levels[i], suffix[i]): joins the two halves of each window
+        RESONIX_CLONES
+        void combineMaxima(float* levels, const float* suffix, int count) {
+            for (int i = 0; i < count; i++) {
+                levels[i] = levels[i] > suffix[i] ? levels[i] : suffix[i];
+            }
+        }
+
+        // Static gain law in log2 units: levels (at least LEVEL_FLOOR) are replaced by linear gains, in place
+        RESONIX_CLONES
+        void gainLaw(DynamicsMode mode, float* levels, int count, float threshold, float slope, float range) {
+            // Bounds of the log2 gain; one clamp per mode keeps every loop free of branches
+            const float lowest = mode == DYNAMICS_GATE ? range : -126.0f;
+            const float direction = mode == DYNAMICS_GATE ? -slope : slope;
+            float gain;
+
+            for (int i = 0; i < count; i++) {
+                gain = (threshold - log2Fast(levels[i])) * direction;
+                gain = gain < 0.0f ? gain : 0.0f;
+                levels[i] = exp2Fast(gain > lowest ? gain : lowest);
+            }
+        }
+
+        // One-pole attack/release smoothing of gains in place; returns the last state. Both candidates are
+        // one multiply-add from the previous state, so the serial dependency per sample is that plus a select
+        RESONIX_CLONES
+        float followGains(float* gains, int count, float state, bool rising_attacks, float attack, float release) {
+            const float attack_rest = 1.0f - attack, release_rest = 1.0f - release;
+            float target, attacked, released;
+
+            if (rising_attacks) {
+                for (int i = 0; i < count; i++) {
+                    target = gains[i];
+                    attacked = attack * state + attack_rest * target;
+                    released = release * state + release_rest * target;
+                    state = target > state ? attacked : released;
+                    gains[i] = state;
+                }
+                return state;
+            }
+
+            for (int i = 0; i < count; i++) {
+                target = gains[i];
+                attacked = attack * state + attack_rest * target;
+                released = release * state + release_rest * target;
+                state = target < state ? attacked : released;
+                gains[i] = state;
+            }
+            return state;
+        }
+
+        // Limiter smoothing: instant hold, released exponentially, then averaged over length frames
+        // through the ring average, so each reduction is complete exactly when its peak leaves the delay line
+        RESONIX_CLONES
+        float holdGains(float* gains, int count, float state, float release, float* average, int mask, int length,
+                        long long position, double& sum) {
+            const float release_rest = 1.0f - release;
+            const double scale = 1.0 / static_cast<double>(length);
+            double total = sum;
+            float target, released;
+
+            for (int i = 0; i < count; i++) {
+                target = gains[i];
+                released = release * state + release_rest * target;
+                state = target < released ? target : released;
+                total += static_cast<double>(state) - average[(position + i - length) & mask];
+                average[(position + i) & mask] = state;
+                gains[i] = static_cast<float>(total * scale);
+            }
+
+            sum = total;
+            return state;
+        }
+
+        // output[i] = delayed[i] * gains[i] * makeup
+        RESONIX_CLONES
+        void applyGains(float* output, const float* delayed, const float* gains, float makeup, int count) {
+            for (int i = 0; i < count; i++) {
+                output[i] = delayed[i] * gains[i] * makeup;
+            }
+        }
+    }
+
+    Dynamics::Dynamics(const DynamicsSettings& settings, int channels)
+        : settings_(settings), channels_(std::min(std::max(channels, 1), MAX_CHANNELS)) {
+        Resonix::MemoryTag tag("Dynamics");
+
+        settings_.ratio = std::max(settings_.ratio, 1.0f);
+        settings_.attack_ms = std::max(settings_.attack_ms, 0.0f);
+        settings_.release_ms = std::max(settings_.release_ms, 0.0f);
+        settings_.lookahead_ms = std::min(std::max(settings_.lookahead_ms, 0.0f), MAX_LOOKAHEAD_MS);
+        settings_.range_db = std::min(settings_.range_db, 0.0f);
+
+        lookahead_ = static_cast<int>(std::lround(static_cast<double>(settings_.lookahead_ms) * 1e-3 * Resonix::SAMPLE_RATE));
+        delay_mask_ = ringLength(lookahead_ + BLOCK_FRAMES) - 1;
+        average_mask_ = ringLength(lookahead_ + 1) - 1;
+        attack_coefficient_ = timeCoefficient(settings_.attack_ms);
+        release_coefficient_ = timeCoefficient(settings_.release_ms);
+        makeup_ = settings_.mode == DYNAMICS_LIMITER ? 1.0f : std::pow(10.0f, settings_.makeup_db / 20.0f);
+
+        delay_ = Resonix::allocateSamples(static_cast<size_t>(channels_) * static_cast<size_t>(delay_mask_ + 1));
+        scratch_ = Resonix::allocateSamples(BLOCK_FRAMES);
+        average_ = Resonix::allocateSamples(static_cast<size_t>(average_mask_ + 1));
+        segment_.resize(static_cast<size_t>(lookahead_ + 1));
+        suffix_.resize(static_cast<size_t>(lookahead_ + 2));
+        reset();
+    }
+
+    void Dynamics::reset() {
+        position_ = 0;
+        segment_offset_ = 0;
+        prefix_ = LEVEL_FLOOR;
+        gain_ = applied_ = 1.0f;
+        std::fill(suffix_.begin(), suffix_.end(), LEVEL_FLOOR);
+
+        if (delay_)
+            std::fill(delay_.get(), delay_.get() + static_cast<size_t>(channels_) * static_cast<size_t>(delay_mask_ + 1), 0.0f);
+        if (average_)
+            std::fill(average_.get(), average_.get() + average_mask_ + 1, 1.0f);
+        average_sum_ = static_cast<double>(lookahead_ + 1);
+    }
+
+    float Dynamics::gainDb() const {
+        return DB_PER_OCTAVE * std::log2(std::max(applied_, LEVEL_FLOOR));
+    }
+
+    void Dynamics::detect(const float* const* input, int count) {
+        const int window = lookahead_ + 1;
+        float* levels = scratch_.get();
+        float* segment = segment_.data();
+        float* suffix = suffix_.data();
+        float prefix = prefix_, level;
+
+        std::fill(levels, levels + count, LEVEL_FLOOR);
+        for (int c = 0; c < channels_; c++) {
+            linkPeaks(levels, input[c], count);
+        }
+        if (window == 1)
+            return;
+
+        // The window ending at offset o of a segment is offsets 0..o of it plus o+1.. of the previous one
+        for (int start = 0, length; start < count; start += length) {
+            const int offset = segment_offset_;
+
+            length = std::min(count - start, window - offset);
+            if (offset == 0)
+                prefix = LEVEL_FLOOR;
+
+            for (int i = 0; i < length; i++) {
+                level = levels[start + i];
+                segment[offset + i] = level;
+                prefix = prefix > level ? prefix : level;
+                levels[start + i] = prefix;
+            }
+            combineMaxima(levels + start, suffix + offset + 1, length);
+
+            segment_offset_ = offset + length;
+            if (segment_offset_ < window)
+                continue;
+
+            // Segment complete: its suffix maxima serve the next one
+            suffix[window - 1] = segment[window - 1];
+            for (int i = window - 2; i >= 0; i--) {
+                suffix[i] = segment[i] > suffix[i + 1] ? segment[i] : suffix[i + 1];
+            }
+            segment_offset_ = 0;
+        }
+
+        prefix_ = prefix;
+    }
+
+    void Dynamics::smooth(int count) {
+        float* gains = scratch_.get();
+
+        if (settings_.mode == DYNAMICS_LIMITER) {
+            gain_ = holdGains(gains, count, gain_, release_coefficient_, average_.get(), average_mask_, lookahead_ + 1, position_, average_sum_);
+        } else {
+            // A gate attacks when it opens, i.e. when the gain rises
+            gain_ = followGains(gains, count, gain_, settings_.mode == DYNAMICS_GATE, attack_coefficient_, release_coefficient_);
+        }
+        applied_ = gains[count - 1];
+    }
+
+    void Dynamics::process(const float* const* input, float* const* output, int count) {
+        RESONIX_PROFILE("Dynamics::process", count);
+        const float threshold = settings_.threshold_db / DB_PER_OCTAVE, range = settings_.range_db / DB_PER_OCTAVE;
+        const float slope = settings_.mode == DYNAMICS_LIMITER ? 1.0f
+                            : settings_.mode == DYNAMICS_GATE ? settings_.ratio - 1.0f : 1.0f - 1.0f / settings_.ratio;
+        const int ring = delay_mask_ + 1;
+        const float* in[MAX_CHANNELS];
+
+        if (!input || !output || count <= 0 || !delay_ || !scratch_ || !average_)
+            return;
+
+        for (int start = 0, length; start < count; start += length) {
+            length = std::min(count - start, BLOCK_FRAMES);
+            for (int c = 0; c < channels_; c++) {
+                in[c] = input[c] + start;
+            }
+
+            detect(in, length);
+            gainLaw(settings_.mode, scratch_.get(), length, threshold, slope, range);
+            smooth(length);
+
+            // Into the delay line, then out lookahead_ frames later; both in at most two contiguous runs
+            for (int c = 0; c < channels_; c++) {
+                float* line = delay_.get() + static_cast<size_t>(c) * static_cast<size_t>(ring);
+                const int write = static_cast<int>(position_ & delay_mask_);
+                const int read = static_cast<int>((position_ - lookahead_) & delay_mask_);
+                const int write_run = std::min(length, ring - write), read_run = std::min(length, ring - read);
+
+                std::memcpy(line + write, in[c], static_cast<size_t>(write_run) * sizeof(float));
+                std::memcpy(line, in[c] + write_run, static_cast<size_t>(length - write_run) * sizeof(float));
+                applyGains(output[c] + start, line + read, scratch_.get(), makeup_, read_run);
+                applyGains(output[c] + start + read_run, line, scratch_.get() + read_run, makeup_, length - read_run);
+            }
+
+            position_ += length;
+        }
+    }
+
+    void Dynamics::process(const float* input, float* output, int count) {
+        process(&input, &output, count);
+    }
+
+    void apply_dynamics(const float* const* input, float* const* output, int channels, int count, const DynamicsSettings& settings) {
+        const int block = Dynamics::BLOCK_FRAMES;
+        Dynamics dynamics(settings, channels);
+        const int latency = dynamics.latency();
+        Resonix::SampleBuffer buffers;
+        const float* in[Dynamics::MAX_CHANNELS];
+        float* out[Dynamics::MAX_CHANNELS];
+
+        if (channels < 1 || channels > Dynamics::MAX_CHANNELS || count <= 0)
+            return;
+
+        // Per channel, a padded input block for the tail and one output block
+        buffers = Resonix::allocateSamples(static_cast<size_t>(2 * channels * block));
+        if (!buffers)
+            return;
+
+        // The output trails the input by latency frames, so writing it never overtakes reading
+        for (long long start = 0, length; start < static_cast<long long>(count) + latency; start += length) {
+            length = std::min<long long>(block, static_cast<long long>(count) + latency - start);
+            const long long available = std::min<long long>(length, std::max<long long>(count - start, 0));
+            const long long skip = std::max<long long>(latency - start, 0);
+
+            for (int c = 0; c < channels; c++) {
+                float* padded = buffers.get() + static_cast<size_t>(2 * c) * block;
+
+                out[c] = padded + block;
+                if (available == length) {
+                    in[c] = input[c] + start;
+                    continue;
+                }
+                std::copy(input[c] + start, input[c] + start + available, padded);
+                std::fill(padded + available, padded + length, 0.0f);
+                in[c] = padded;
+            }
+
+            dynamics.process(in, out, static_cast<int>(length));
+
+            for (int c = 0; c < channels; c++) {
+                if (skip < length)
+                    std::copy(out[c] + skip, out[c] + length, output[c] + start + skip - latency);
+            }
+        }
+    }
+}
+
+namespace Resonix {
+    namespace {
+        SampleBuffer runDynamics(const float* samples, int sample_length, const Filter::DynamicsSettings& settings, SignalStats* stats) {
+            SampleBuffer output;
+            float* destination;
+
+            if (!samples || sample_length <= 0)
+                return nullptr;
+
+            output = allocateSamples(static_cast<size_t>(sample_length));
+            if (!output)
+                return nullptr;
+
+            destination = output.get();
+            Filter::apply_dynamics(&samples, &destination, 1, sample_length, settings);
+            if (stats)
+                *stats = analyze(destination, sample_length);
+            return output;
+        }
+
+        bool validTimes(float attack_ms, float release_ms, float lookahead_ms) {
+            return attack_ms >= 0.0f && release_ms >= 0.0f && lookahead_ms >= 0.0f && lookahead_ms <= Filter::Dynamics::MAX_LOOKAHEAD_MS;
+        }
+    }
+
+    SampleBuffer compressor(const float* samples, int sample_length, float threshold_db, float ratio, float attack_ms,
+                            float release_ms, float lookahead_ms, SignalStats* stats) {
+        RESONIX_PROFILE("Resonix::compressor", sample_length);
+        MemoryTag tag("Resonix::compressor");
+        Filter::DynamicsSettings settings;
+
+        if (!(ratio >= 1.0f) || !validTimes(attack_ms, release_ms, lookahead_ms))
+            return nullptr;
+
+        settings.mode = Filter::DYNAMICS_COMPRESSOR;
+        settings.threshold_db = threshold_db;
+        settings.ratio = ratio;
+        settings.attack_ms = attack_ms;
+        settings.release_ms = release_ms;
+        settings.lookahead_ms = lookahead_ms;
+        return runDynamics(samples, sample_length, settings, stats);
+    }
+
+    SampleBuffer limiter(const float* samples, int sample_length, float ceiling_db, float release_ms, float lookahead_ms, SignalStats* stats) {
+        RESONIX_PROFILE("Resonix::limiter", sample_length);
+        MemoryTag tag("Resonix::limiter");
+        Filter::DynamicsSettings settings;
+
+        if (!validTimes(0.0f, release_ms, lookahead_ms))
+            return nullptr;
+
+        settings.mode = Filter::DYNAMICS_LIMITER;
+        settings.threshold_db = ceiling_db;
+        settings.release_ms = release_ms;
+        settings.lookahead_ms = lookahead_ms;
+        return runDynamics(samples, sample_length, settings, stats);
+    }
+
+    SampleBuffer gate(const float* samples, int sample_length, float threshold_db, float range_db, float attack_ms,
+                      float release_ms, float lookahead_ms, SignalStats* stats) {
+        RESONIX_PROFILE("Resonix::gate", sample_length);
+        MemoryTag tag("Resonix::gate");
+        Filter::DynamicsSettings settings;
+
+        if (!(range_db <= 0.0f) || !validTimes(attack_ms, release_ms, lookahead_ms))
+            return nullptr;
+
+        // A gate proper: the level drops by the whole range within a few dB below the threshold
+        settings.mode = Filter::DYNAMICS_GATE;
+        settings.threshold_db = threshold_db;
+        settings.ratio = 20.0f;
+        settings.range_db = range_db;
+        settings.attack_ms = attack_ms;
+        settings.release_ms = release_ms;
+        settings.lookahead_ms = lookahead_ms;
+        return runDynamics(samples, sample_length, settings, stats);
+    }
+
+    bool dynamics(AudioBuffer& buffer, const Filter::DynamicsSettings& settings) {
+        RESONIX_PROFILE("Resonix::dynamics", buffer.frames());
+        MemoryTag tag("Resonix::dynamics");
+        float* channels[Filter::Dynamics::MAX_CHANNELS];
+
+        if (buffer.empty() || buffer.channels() > Filter::Dynamics::MAX_CHANNELS || buffer.frames() > 0x7FFFFFFF)
+            return false;
+
+        for (int c = 0; c < buffer.channels(); c++) {
+            channels[c] = buffer.channel(c);
+        }
+        Filter::apply_dynamics(channels, channels, buffer.channels(), static_cast<int>(buffer.frames()), settings);
+        return true;
+    }
+}
@@ -0,0 +1,49 @@
+#include "Filter.hpp"
+#include "Instrument.hpp"
+
+namespace Filter {
+    void FilterChain::addBiquad(const BiquadFilter& filter) {
+        Stage stage;
+        stage.is_formant = false;
+        stage.biquad = filter;
+        stages_.push_back(stage);
+    }
+
+    void FilterChain::addFormant(const FormantFilter& filter) {
+        Stage stage;
+        stage.is_formant = true;
+        stage.formant = filter;
+        stages_.push_back(stage);
+    }
+
+    void FilterChain::process(const float* input, float* output, int count) {
+        const float* source = input;
+
+        RESONIX_PROFILE("FilterChain::process", count);
+
+        if (!input || !output || count <= 0)
+            return;
+
+        if (stages_.empty()) {
+            for (int i = 0; input != output && i < count; i++) {
+                output[i] = input[i];
+            }
+            return;
+        }
+
+        for (Stage& stage : stages_) {
+            if (stage.is_formant)
+                stage.formant.process(source, output, count);
+            else
+                stage.biquad.process(source, output, count);
+            source = output;
+        }
+    }
+
+    void FilterChain::reset() {
+        for (Stage& stage : stages_) {
+            stage.biquad.clear();
+            stage.formant.reset();
+        }
+    }
+}
@@ -1,19 +1,17 @@
+#include <cmath>
 #include "Filter.hpp"
 #include "Math.hpp"
+#include "Dispatch.hpp"
+#include "Instrument.hpp"
 
 namespace Filter {
-    std::unique_ptr<float[]> apply_formant_filter(const float* samples, int sample_length, float peak, float mix, float spread) {
-        if (!samples || sample_length <= 0)
-            return nullptr;
-
-        int num_formants, vowel_index, f, i;
-        BiquadFilter formant_filters[4];
-        std::unique_ptr<float[]> filtered;
-		float q_values[4] = {8.0f, 12.0f, 16.0f, 20.0f};
+    void FormantFilter::setup(float peak, float mix_, float spread) {
+        int vowel_index, f;
+		float q_values[NUM_FORMANTS] = {8.0f, 12.0f, 16.0f, 20.0f};
         float base_freq, spread_factor, formant_freq, q;
         float omega, omega_degrees, sin_omega, cos_omega, alpha;
         float b0, b1, b2, a0, a1, a2;
-        float filtered_sample, weight, normalization, formant_output;
+        double omega_wide, alpha_wide;
 
         static const float vowel_formants[5][4] = {
             {800.0f, 1150.0f, 2900.0f, 3900.0f},   // "ah"
@@ -23,29 +21,16 @@ namespace Filter {
             {325.0f, 700.0f, 2530.0f, 3500.0f}     // "oo"
         };
 
-        num_formants = 4;
-
         peak = Math::clamp(peak, 0.0f, 1.0f);
-        mix = Math::clamp(mix, 0.0f, 1.0f);
+        mix = Math::clamp(mix_, 0.0f, 1.0f);
         spread = Math::clamp(spread, 0.0f, 1.0f);
 
-        // Reset all filters
-        for (f = 0; f < num_formants; f++) {
-            formant_filters[f].reset();
-        }
-
-        filtered = std::make_unique<float[]>(sample_length);
-
-        for (i = 0; i < sample_length; i++) {
-            filtered[i] = 0.0f;
-        }
-
         vowel_index = static_cast<int>(peak * 4.99f);
         if (vowel_index > 4) vowel_index = 4;
 
-        for (f = 0; f < num_formants; f++) {
+        for (f = 0; f < NUM_FORMANTS; f++) {
             base_freq = vowel_formants[vowel_index][f];
-            spread_factor = 1.0f + (f * spread * 0.2f);
+            spread_factor = 1.0f + (static_cast<float>(f) * spread * 0.2f);
             formant_freq = base_freq * spread_factor;
             q = q_values[f] * (1.0f + spread * 0.5f);
 
@@ -63,21 +48,40 @@ namespace Filter {
             a1 = -2.0f * cos_omega;
             a2 = 1.0f - alpha;
 
-            formant_filters[f].setCoefficients(b0/a0, b1/a0, b2/a0, a1/a0, a2/a0);
+            bands[f].reset();
+            bands[f].setCoefficients(b0/a0, b1/a0, b2/a0, a1/a0, a2/a0);
 
-            for (i = 0; i < sample_length; i++) {
-                filtered_sample = formant_filters[f].process(samples[i]);
-                weight = 1.0f - (f * 0.15f);
-                filtered[i] += filtered_sample * weight;
-            }
+            // process<double> gets the same band evaluated in double precision
+            omega_wide = 2.0 * M_PI * formant_freq / Resonix::SAMPLE_RATE;
+            alpha_wide = std::sin(omega_wide) / (2.0 * q);
+            bands[f].setPreciseCoefficients(alpha_wide / (1.0 + alpha_wide), 0.0, -alpha_wide / (1.0 + alpha_wide),
+                                            -2.0 * std::cos(omega_wide) / (1.0 + alpha_wide), (1.0 - alpha_wide) / (1.0 + alpha_wide));
+            weights[f] = 1.0f - (static_cast<float>(f) * 0.15f);
         }
+    }
 
-        normalization = 0.5f;
-        for (i = 0; i < sample_length; i++) {
-            formant_output = filtered[i] * normalization;
-            filtered[i] = samples[i] * (1.0f - mix) + formant_output * mix;
+    namespace {
+        RESONIX_CLONES
+        void formantBlock(FormantFilter& filter, const float* input, float* output, int count) {
+            filter.process<float>(input, 1, output, 1, count);
         }
+    }
+
+    void FormantFilter::process(const float* input, float* output, int count) {
+        RESONIX_PROFILE("FormantFilter::process", count);
+        formantBlock(*this, input, output, count);
+    }
+
+    Resonix::SampleBuffer apply_formant_filter(const float* samples, int sample_length, float peak, float mix, float spread, Resonix::SignalStats* stats) {
+        if (!samples || sample_length <= 0)
+            return nullptr;
+
+        FormantFilter filter;
+        Resonix::SampleBuffer filtered = Resonix::allocateSamples(sample_length);
+
+        filter.setup(peak, mix, spread);
+        process_with_stats(filter, samples, filtered.get(), sample_length, stats);
 
         return filtered;
     }
-}
\ No newline at end of file
+}
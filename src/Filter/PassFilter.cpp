@@ -1,12 +1,24 @@
+#include <cmath>
 #include "Filter.hpp"
+#include "Dispatch.hpp"
+#include "Instrument.hpp"
 
 namespace Filter {
-    std::unique_ptr<float[]> apply_lowpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance) {
-        if (!samples || sample_length <= 0 || cutoff_hz <= 0)
-            return nullptr;
+    namespace {
+        // The recursion is serial, so the gain of the wider clones is FMA shortening the dependency chain
+        RESONIX_CLONES
+        void biquadBlock(BiquadFilter& filter, const float* input, float* output, int count) {
+            filter.process<float>(input, 1, output, 1, count);
+        }
+    }
 
-        auto filtered = std::make_unique<float[]>(sample_length);
+    // Member functions are not cloned directly: GCC's LTO mishandles their resolvers
+    void BiquadFilter::process(const float* input, float* output, int count) {
+        RESONIX_PROFILE("BiquadFilter::process", count);
+        biquadBlock(*this, input, output, count);
+    }
 
+    BiquadFilter make_lowpass_filter(float cutoff_hz, float resonance) {
         BiquadFilter filter;
 
         float omega = 2.0f * Math::PI * cutoff_hz / Resonix::SAMPLE_RATE;
@@ -28,19 +40,19 @@ namespace Filter {
         filter.a1 = a1 / a0;
         filter.a2 = a2 / a0;
 
-        for (int i = 0; i < sample_length; i++) {
-            filtered[i] = filter.process(samples[i]);
-        }
+        // process<double> gets the same design evaluated in double precision
+        double omega_wide = 2.0 * M_PI * cutoff_hz / Resonix::SAMPLE_RATE;
+        double alpha_wide = std::sin(omega_wide) / (2.0 * resonance);
+        double cos_wide = std::cos(omega_wide);
+        double a0_wide = 1.0 + alpha_wide;
 
-        return filtered;
-    }
+        filter.setPreciseCoefficients((1.0 - cos_wide) / 2.0 / a0_wide, (1.0 - cos_wide) / a0_wide, (1.0 - cos_wide) / 2.0 / a0_wide,
+                                      -2.0 * cos_wide / a0_wide, (1.0 - alpha_wide) / a0_wide);
 
-    std::unique_ptr<float[]> apply_highpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance) {
-        if (!samples || sample_length <= 0 || cutoff_hz <= 0)
-            return nullptr;
-
-        auto filtered = std::make_unique<float[]>(sample_length);
+        return filter;
+    }
 
+    BiquadFilter make_highpass_filter(float cutoff_hz, float resonance) {
         BiquadFilter filter;
 
         float omega = 2.0f * Math::PI * cutoff_hz / Resonix::SAMPLE_RATE;
@@ -62,10 +74,39 @@ namespace Filter {
         filter.a1 = a1 / a0;
         filter.a2 = a2 / a0;
 
-        for (int i = 0; i < sample_length; i++) {
-            filtered[i] = filter.process(samples[i]);
-        }
+        // process<double> gets the same design evaluated in double precision
+        double omega_wide = 2.0 * M_PI * cutoff_hz / Resonix::SAMPLE_RATE;
+        double alpha_wide = std::sin(omega_wide) / (2.0 * resonance);
+        double cos_wide = std::cos(omega_wide);
+        double a0_wide = 1.0 + alpha_wide;
+
+        filter.setPreciseCoefficients((1.0 + cos_wide) / 2.0 / a0_wide, (cos_wide - 1.0) / a0_wide, (1.0 + cos_wide) / 2.0 / a0_wide,
+                                      -2.0 * cos_wide / a0_wide, (1.0 - alpha_wide) / a0_wide);
+
+        return filter;
+    }
+
+    Resonix::SampleBuffer apply_lowpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance, Resonix::SignalStats* stats) {
+        if (!samples || sample_length <= 0 || cutoff_hz <= 0)
+            return nullptr;
+
+        auto filtered = Resonix::allocateSamples(sample_length);
+
+        BiquadFilter filter = make_lowpass_filter(cutoff_hz, resonance);
+        process_with_stats(filter, samples, filtered.get(), sample_length, stats);
+
+        return filtered;
+    }
+
+    Resonix::SampleBuffer apply_highpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance, Resonix::SignalStats* stats) {
+        if (!samples || sample_length <= 0 || cutoff_hz <= 0)
+            return nullptr;
+
+        auto filtered = Resonix::allocateSamples(sample_length);
+
+        BiquadFilter filter = make_highpass_filter(cutoff_hz, resonance);
+        process_with_stats(filter, samples, filtered.get(), sample_length, stats);
 
         return filtered;
     }
-}
\ No newline at end of file
+}
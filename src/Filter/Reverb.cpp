@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <cmath>
+#include "Reverb.hpp"
+#include "Analysis.hpp"
+#include "Dispatch.hpp"
+#include "Instrument.hpp"
+
+namespace Filter {
+    namespace {
+        // Delay lengths spread geometrically between these at size 1
+        constexpr double SHORTEST_LINE_MS = 25.0;
+        constexpr double LONGEST_LINE_MS = 80.0;
+        constexpr float MIN_SIZE = 0.25f;
+        constexpr float MAX_SIZE = 2.0f;
+        constexpr float MIN_DECAY = 0.05f;
+        constexpr float MAX_DECAY = 100.0f;
+        // Butterworth: no resonant peak, so the loop gain stays below one at every frequency
+        constexpr float DAMPING_RESONANCE = 0.70710678f;
+        // Added to the input so decaying tails level off far above the denormal range (about -360 dB)
+        constexpr float ANTI_DENORMAL = 1e-18f;
+        // Space between lines, one cache line, so lines written at the same position fall in different cache sets
+        constexpr int LINE_PADDING = 16;
+        // Wet level for about the loudness of the dry signal at the default decay
+        constexpr float WET_LEVEL = 1.35f;
+
+        // Input signs per line; not a row of the matrix, so the first pass already reaches every output
+        constexpr float INPUT_SIGNS[Reverb::MAX_LINES] = {1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f, -1.0f, -1.0f,
+                                                          -1.0f, 1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f};
+
+        int ringLength(int frames) {
+            int length = 1;
+
+            while (length < frames) {
+                length <<= 1;
+            }
+            return length;
+        }
+
+        // Prime lengths keep the echoes of different lines from lining up
+        int nextPrime(int value) {
+            for (;; value++) {
+                bool prime = value > 1;
+
+                for (int d = 2; prime && d * d <= value; d++) {
+                    prime = value % d != 0;
+                }
+                if (prime)
+                    return value;
+            }
+        }
+
+        // Damping filter and decay gain of every line, frame by frame. Each frame holds the N lines side by
+        // side, so the filters run as one recurrence across vector lanes
+        template <int N>
+        RESONIX_CLONES
+        void filterLanes(float* frames, int count, BiquadFilter* dampers) {
+            float b0[N], b1[N], b2[N], a1[N], a2[N], x1[N], x2[N], y1[N], y2[N];
+            float in, out;
+            int k;
+
+            for (k = 0; k < N; k++) {
+                b0[k] = dampers[k].b0;
+                b1[k] = dampers[k].b1;
+                b2[k] = dampers[k].b2;
+                a1[k] = dampers[k].a1;
+                a2[k] = dampers[k].a2;
+                x1[k] = dampers[k].x1;
+                x2[k] = dampers[k].x2;
+                y1[k] = dampers[k].y1;
+                y2[k] = dampers[k].y2;
+            }
+
+            for (int i = 0; i < count; i++) {
+                float* frame = frames + i * N;
+
+                // Kept a loop so it is vectorized across the lanes rather than unrolled into scalars
+#pragma GCC unroll 1
+                for (k = 0; k < N; k++) {
+                    in = frame[k];
+                    out = b0[k] * in + b1[k] * x1[k] + b2[k] * x2[k] - a1[k] * y1[k] - a2[k] * y2[k];
+                    x2[k] = x1[k];
+                    x1[k] = in;
+                    y2[k] = y1[k];
+                    y1[k] = out;
+                    frame[k] = out;
+                }
+            }
+
+            for (k = 0; k < N; k++) {
+                dampers[k].x1 = x1[k];
+                dampers[k].x2 = x2[k];
+                dampers[k].y1 = y1[k];
+                dampers[k].y2 = y2[k];
+            }
+        }
+
+        // One butterfly stage of the Walsh-Hadamard transform over a whole block: every element pairs
+        // with the one span lanes away in the same frame
+        template <int span>
+        inline void hadamardStage(float* values, int total) {
+            float a, b;
+
+            for (int p = 0; p < total; p += 2 * span) {
+                for (int m = p; m < p + span; m++) {
+                    a = values[m];
+                    b = values[m + span];
+                    values[m] = a + b;
+                    values[m + span] = a - b;
+                }
+            }
+        }
+
+        // Unnormalized Hadamard matrix applied to every frame; the 1/sqrt(N) is folded into the filters
+        template <int N>
+        RESONIX_CLONES
+        void hadamard(float* frames, int count) {
+            hadamardStage<1>(frames, N * count);
+            hadamardStage<2>(frames, N * count);
+            hadamardStage<4>(frames, N * count);
+            if (N == 16)
+                hadamardStage<8>(frames, N * count);
+        }
+
+        // frames[i * N + k] = sources[k][i]: one frame of every line per row
+        template <int N>
+        RESONIX_CLONES
+        void gatherLines(float* frames, const float* const* sources, int count) {
+            const float* lines[N];
+
+            std::copy(sources, sources + N, lines);
+            for (int i = 0; i < count; i++) {
+                for (int k = 0; k < N; k++) {
+                    frames[i * N + k] = lines[k][i];
+                }
+            }
+        }
+
+        // targets[k][i] = frames[i * N + k] + signs[k] * feed[i]: the network output plus the input, back into the lines
+        template <int N>
+        RESONIX_CLONES
+        void scatterLines(const float* frames, float* const* targets, const float* feed, int count) {
+            float* lines[N];
+
+            std::copy(targets, targets + N, lines);
+            for (int i = 0; i < count; i++) {
+                for (int k = 0; k < N; k++) {
+                    lines[k][i] = frames[i * N + k] + INPUT_SIGNS[k] * feed[i];
+                }
+            }
+        }
+
+        // One block through the network. No line is shorter than the block, so every read precedes every write
+        template <int N>
+        void runNetwork(float* frames, const float* const* sources, float* const* targets, BiquadFilter* dampers,
+                        const float* feed, float* wet, int channels, int count) {
+            gatherLines<N>(frames, sources, count);
+            filterLanes<N>(frames, count, dampers);
+            hadamard<N>(frames, count);
+
+            // Every output channel taps its own row of the matrix, before the input joins
+            for (int c = 0; c < channels; c++) {
+                for (int i = 0; i < count; i++) {
+                    wet[c * Reverb::BLOCK_FRAMES + i] = frames[i * N + c];
+                }
+            }
+
+            scatterLines<N>(frames, targets, feed, count);
+        }
+
+        // feed[i] += input[i] * gain
+        RESONIX_CLONES
+        void addScaled(float* feed, const float* input, float gain, int count) {
+            for (int i = 0; i < count; i++) {
+                feed[i] += input[i] * gain;
+            }
+        }
+
+        // output[i] = input[i] * dry + wet[i] * level; output == input is allowed
+        RESONIX_CLONES
+        void mixWet(float* output, const float* input, const float* wet, float dry, float level, int count) {
+            for (int i = 0; i < count; i++) {
+                output[i] = input[i] * dry + wet[i] * level;
+            }
+        }
+    }
+
+    Reverb::Reverb(const ReverbSettings& settings, int channels)
+        : settings_(settings), channels_(std::min(std::max(channels, 1), MAX_CHANNELS)) {
+        Resonix::MemoryTag tag("Reverb");
+        const float nyquist = 0.5f * static_cast<float>(Resonix::SAMPLE_RATE);
+        int longest = 0;
+
+        settings_.lines = settings_.lines == 16 ? 16 : 8;
+        settings_.decay = std::min(std::max(settings_.decay, MIN_DECAY), MAX_DECAY);
+        settings_.size = std::min(std::max(settings_.size, MIN_SIZE), MAX_SIZE);
+        settings_.damping_hz = std::min(std::max(settings_.damping_hz, 20.0f), 0.9f * nyquist);
+        settings_.mix = std::min(std::max(settings_.mix, 0.0f), 1.0f);
+
+        const int lines = settings_.lines;
+        const float normalization = 1.0f / std::sqrt(static_cast<float>(lines));
+
+        for (int k = 0; k < lines; k++) {
+            const double spread = static_cast<double>(k) / (lines - 1);
+            const double ms = SHORTEST_LINE_MS * std::pow(LONGEST_LINE_MS / SHORTEST_LINE_MS, spread) * settings_.size;
+            const int frames = static_cast<int>(std::lround(ms * 1e-3 * Resonix::SAMPLE_RATE));
+
+            delays_[k] = nextPrime(std::max(frames, BLOCK_FRAMES));
+            longest = std::max(longest, delays_[k]);
+
+            // -60 dB per decay seconds, spent over this line's length; the gain rides on the damping filter
+            const float gain = static_cast<float>(std::pow(1e-3, delays_[k] / (static_cast<double>(settings_.decay) * Resonix::SAMPLE_RATE)));
+            const BiquadFilter damper = make_lowpass_filter(settings_.damping_hz, DAMPING_RESONANCE);
+            const float scale = gain * normalization;
+            dampers_[k].setCoefficients(damper.b0 * scale, damper.b1 * scale, damper.b2 * scale, damper.a1, damper.a2);
+        }
+
+        mask_ = ringLength(longest + BLOCK_FRAMES) - 1;
+        delay_ = Resonix::allocateSamples(static_cast<size_t>(lines) * static_cast<size_t>(mask_ + 1 + LINE_PADDING));
+        frames_ = Resonix::allocateSamples(static_cast<size_t>(lines * BLOCK_FRAMES));
+        wet_ = Resonix::allocateSamples(static_cast<size_t>(channels_ * BLOCK_FRAMES));
+        feed_ = Resonix::allocateSamples(BLOCK_FRAMES);
+        reset();
+    }
+
+    void Reverb::reset() {
+        position_ = 0;
+
+        for (int k = 0; k < settings_.lines; k++) {
+            dampers_[k].clear();
+        }
+        if (delay_)
+            std::fill(delay_.get(), delay_.get() + static_cast<size_t>(settings_.lines) * static_cast<size_t>(mask_ + 1 + LINE_PADDING), 0.0f);
+    }
+
+    void Reverb::process(const float* const* input, float* const* output, int count) {
+        RESONIX_PROFILE("Reverb::process", count);
+        const int lines = settings_.lines, ring = mask_ + 1;
+        const float share = 1.0f / static_cast<float>(channels_);
+        const float dry = 1.0f - settings_.mix, level = settings_.mix * WET_LEVEL;
+        float* frames = frames_.get();
+        float* feed = feed_.get();
+        const float* sources[MAX_LINES];
+        float* targets[MAX_LINES];
+
+        if (!input || !output || count <= 0 || !delay_ || !frames_ || !wet_ || !feed_)
+            return;
+
+        for (int start = 0, length; start < count; start += length) {
+            const int write = static_cast<int>(position_ & mask_);
+
+            // Blocks also end where any line wraps around, so each line is read and written in one run
+            length = std::min(std::min(count - start, BLOCK_FRAMES), ring - write);
+            for (int k = 0; k < lines; k++) {
+                float* line = delay_.get() + static_cast<size_t>(k) * static_cast<size_t>(ring + LINE_PADDING);
+                const int read = static_cast<int>((position_ - delays_[k]) & mask_);
+
+                length = std::min(length, ring - read);
+                sources[k] = line + read;
+                targets[k] = line + write;
+            }
+
+            std::fill(feed, feed + length, ANTI_DENORMAL);
+            for (int c = 0; c < channels_; c++) {
+                addScaled(feed, input[c] + start, share, length);
+            }
+
+            if (lines == 16)
+                runNetwork<16>(frames, sources, targets, dampers_, feed, wet_.get(), channels_, length);
+            else
+                runNetwork<8>(frames, sources, targets, dampers_, feed, wet_.get(), channels_, length);
+
+            for (int c = 0; c < channels_; c++) {
+                mixWet(output[c] + start, input[c] + start, wet_.get() + c * BLOCK_FRAMES, dry, level, length);
+            }
+            position_ += length;
+        }
+    }
+
+    void Reverb::process(const float* input, float* output, int count) {
+        process(&input, &output, count);
+    }
+
+    void apply_reverb(const float* const* input, float* const* output, int channels, int count, int tail, const ReverbSettings& settings) {
+        const int block = Reverb::BLOCK_FRAMES;
+        const float* silence[Reverb::MAX_CHANNELS];
+        float* out[Reverb::MAX_CHANNELS];
+        float zeros[block] = {};
+
+        if (channels < 1 || channels > Reverb::MAX_CHANNELS || count <= 0 || tail < 0)
+            return;
+
+        Reverb reverb(settings, channels);
+        reverb.process(input, output, count);
+
+        for (int c = 0; c < channels; c++) {
+            silence[c] = zeros;
+        }
+        for (int start = 0, length; start < tail; start += length) {
+            length = std::min(tail - start, block);
+            for (int c = 0; c < channels; c++) {
+                out[c] = output[c] + count + start;
+            }
+            reverb.process(silence, out, length);
+        }
+    }
+}
+
+namespace Resonix {
+    SampleBuffer reverb(const float* samples, int sample_length, float decay, float mix, float size, float damping_hz, SignalStats* stats) {
+        RESONIX_PROFILE("Resonix::reverb", sample_length);
+        MemoryTag tag("Resonix::reverb");
+        Filter::ReverbSettings settings;
+        SampleBuffer output;
+        float* destination;
+
+        if (!samples || sample_length <= 0 || !(decay > 0.0f) || !(mix >= 0.0f && mix <= 1.0f) || !(size > 0.0f) || !(damping_hz > 0.0f))
+            return nullptr;
+
+        output = allocateSamples(static_cast<size_t>(sample_length));
+        if (!output)
+            return nullptr;
+
+        settings.decay = decay;
+        settings.mix = mix;
+        settings.size = size;
+        settings.damping_hz = damping_hz;
+
+        destination = output.get();
+        Filter::apply_reverb(&samples, &destination, 1, sample_length, 0, settings);
+        if (stats)
+            *stats = analyze(destination, sample_length);
+        return output;
+    }
+
+    bool reverb(AudioBuffer& buffer, const Filter::ReverbSettings& settings) {
+        RESONIX_PROFILE("Resonix::reverb", buffer.frames());
+        MemoryTag tag("Resonix::reverb");
+        float* channels[Filter::Reverb::MAX_CHANNELS];
+
+        if (buffer.empty() || buffer.channels() > Filter::Reverb::MAX_CHANNELS || buffer.frames() > 0x7FFFFFFF)
+            return false;
+
+        for (int c = 0; c < buffer.channels(); c++) {
+            channels[c] = buffer.channel(c);
+        }
+        Filter::apply_reverb(channels, channels, buffer.channels(), static_cast<int>(buffer.frames()), 0, settings);
+        return true;
+    }
+}
@@ -1,11 +1,142 @@
+#include <cstring>
 #include "Resonix.hpp"
+#include "Dispatch.hpp"
+#include "Instrument.hpp"
+#include "Oscillator.hpp"
+#include "ThreadPool.hpp"
 
 namespace Resonix {
-    std::unique_ptr<float[]> generateSamples(Shape shape, int sample_length, float frequency) {
+    namespace {
+        // Smallest piece of a noise buffer worth handing to another thread
+        constexpr int NOISE_TASK_LENGTH = 1 << 16;
+        // Channels shorter than this are processed on the calling thread
+        constexpr long long CHANNEL_TASK_LENGTH = 1 << 16;
+        // Samples per call into the int-sized block kernels
+        constexpr int CHANNEL_CHUNK = 1 << 20;
+
+        void renderNoise(Shape shape, float* output, long long offset, int count, unsigned long long seed) {
+            switch (shape) {
+                case NOISE_WHITE:
+                    Generator::WhiteNoise(output, offset, count, seed);
+                    break;
+                case NOISE_PINK:
+                    Generator::PinkNoise(output, offset, count, seed);
+                    break;
+                case NOISE_BROWN:
+                    Generator::BrownNoise(output, offset, count, seed);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Runs work(channel) for every channel, one pool task per channel when worth it
+        template <typename Work>
+        void forEachChannel(const AudioBuffer& buffer, int channels, const Work& work) {
+            ThreadPool& pool = ThreadPool::global();
+
+            if (channels < 2 || pool.size() < 2 || buffer.frames() < CHANNEL_TASK_LENGTH) {
+                for (int c = 0; c < channels; c++) {
+                    work(c);
+                }
+                return;
+            }
+
+            std::atomic<int> remaining{channels};
+            for (int c = 0; c < channels; c++) {
+                pool.submit([&work, c, &remaining] {
+                    work(c);
+                    remaining.fetch_sub(1, std::memory_order_release);
+                });
+            }
+            pool.wait(remaining);
+        }
+
+        // Filters into a cache-resident block and encodes it before moving on
+        template <typename Processor>
+        void filterEncoded(const float* samples, int sample_length, Processor filter, SampleFormat format, void* output, Dither* dither) {
+            float block[Generator::BLOCK_LENGTH];
+            unsigned char* out = static_cast<unsigned char*>(output);
+            const int sample_bytes = bytesPerSample(format);
+            int start, count;
+
+            for (start = 0; start < sample_length; start += count) {
+                count = sample_length - start < Generator::BLOCK_LENGTH ? sample_length - start : Generator::BLOCK_LENGTH;
+                filter.process(samples + start, block, count);
+                encodeSamples(block, count, format, out + static_cast<size_t>(start) * sample_bytes, dither);
+            }
+        }
+
+        template <typename Processor>
+        void filterChannels(AudioBuffer& buffer, const Processor& prototype) {
+            forEachChannel(buffer, buffer.channels(), [&buffer, &prototype](int c) {
+                Processor filter = prototype;
+                float* samples = buffer.channel(c);
+                long long start;
+                int count;
+
+                for (start = 0; start < buffer.frames(); start += count) {
+                    count = buffer.frames() - start < CHANNEL_CHUNK ? static_cast<int>(buffer.frames() - start) : CHANNEL_CHUNK;
+                    filter.process(samples + start, samples + start, count);
+                }
+            });
+        }
+    }
+
+    SampleBuffer generateNoise(Shape shape, int sample_length, unsigned long long seed) {
+        RESONIX_PROFILE("Resonix::generateNoise", static_cast<long long>(sample_length) * SAMPLE_RATE);
+        MemoryTag tag("Resonix::generateNoise");
+        if (sample_length <= 0 || !isNoise(shape))
+            return nullptr;
+
+        int total = sample_length * SAMPLE_RATE;
+        auto samples = allocateSamples(total);
+        ThreadPool& pool = ThreadPool::global();
+        float* output = samples.get();
+
+        if (pool.size() < 2 || total < 2 * NOISE_TASK_LENGTH) {
+            renderNoise(shape, output, 0, total, seed);
+            return samples;
+        }
+
+        // A few tasks per worker so stealing can even out brown noise warm-ups
+        int task_length = total / static_cast<int>(4 * pool.size());
+        if (task_length < NOISE_TASK_LENGTH)
+            task_length = NOISE_TASK_LENGTH;
+
+        std::atomic<int> remaining{(total + task_length - 1) / task_length};
+
+        for (int start = 0; start < total; start += task_length) {
+            int count = total - start < task_length ? total - start : task_length;
+            pool.submit([shape, output, start, count, seed, &remaining] {
+                renderNoise(shape, output + start, start, count, seed);
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        pool.wait(remaining);
+
+        return samples;
+    }
+
+    SampleBuffer generateSamples(Shape shape, int sample_length, float frequency) {
+        RESONIX_PROFILE("Resonix::generateSamples", static_cast<long long>(sample_length) * SAMPLE_RATE);
+        MemoryTag tag("Resonix::generateSamples");
+        if (isNoise(shape))
+            return generateNoise(shape, sample_length);
+
         if (sample_length <= 0 || frequency <= 0.0f)
             return nullptr;
 
         const float phase_increment = (2.0f * 3.14159265359f * frequency) / SAMPLE_RATE;
+        const int total = sample_length * SAMPLE_RATE;
+
+        // Steady tones are copied from one rendered cycle
+        if (auto cycle = findCycle(shape, frequency, total)) {
+            auto samples = allocateSamples(static_cast<size_t>(total));
+            if (samples)
+                cycle->tile(0, samples.get(), total);
+            return samples;
+        }
 
         switch (shape) {
             case SINE:
@@ -31,19 +162,271 @@ namespace Resonix {
         }
     }
 
-    std::unique_ptr<float[]> lowpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance) {
-        return Filter::apply_lowpass_filter(samples, sample_length, cutoff_hz, resonance);
+    SampleBuffer lowpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance, SignalStats* stats) {
+        RESONIX_PROFILE("Resonix::lowpass_filter", sample_length);
+        MemoryTag tag("Resonix::lowpass_filter");
+        return Filter::apply_lowpass_filter(samples, sample_length, cutoff_hz, resonance, stats);
     }
 
-    std::unique_ptr<float[]> highpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance) {
-        return Filter::apply_highpass_filter(samples, sample_length, cutoff_hz, resonance);
+    SampleBuffer highpass_filter(const float* samples, int sample_length, float cutoff_hz, float resonance, SignalStats* stats) {
+        RESONIX_PROFILE("Resonix::highpass_filter", sample_length);
+        MemoryTag tag("Resonix::highpass_filter");
+        return Filter::apply_highpass_filter(samples, sample_length, cutoff_hz, resonance, stats);
     }
 
-    std::unique_ptr<float[]> formant_filter(const float* samples, int sample_length, float peak, float mix, float spread) {
-        return Filter::apply_formant_filter(samples, sample_length, peak, mix, spread);
+    SampleBuffer formant_filter(const float* samples, int sample_length, float peak, float mix, float spread, SignalStats* stats) {
+        RESONIX_PROFILE("Resonix::formant_filter", sample_length);
+        MemoryTag tag("Resonix::formant_filter");
+        return Filter::apply_formant_filter(samples, sample_length, peak, mix, spread, stats);
     }
 
-	std::unique_ptr<float[]> bandpass_filter(const float* samples, int sample_length, float center_hz, float bandwidth_hz, float resonance) {
-		return Filter::apply_bandpass_filter(samples, sample_length, center_hz, bandwidth_hz, resonance);
+	SampleBuffer bandpass_filter(const float* samples, int sample_length, float center_hz, float bandwidth_hz, float resonance, SignalStats* stats) {
+		RESONIX_PROFILE("Resonix::bandpass_filter", sample_length);
+		MemoryTag tag("Resonix::bandpass_filter");
+		return Filter::apply_bandpass_filter(samples, sample_length, center_hz, bandwidth_hz, resonance, stats);
 	}
+
+    SampleBuffer resample(const float* samples, int sample_length, int input_rate, int output_rate, int& output_length, Resampler::Quality quality) {
+        RESONIX_PROFILE("Resonix::resample", sample_length);
+        MemoryTag tag("Resonix::resample");
+
+        output_length = 0;
+
+        if (!samples || sample_length <= 0)
+            return nullptr;
+
+        Resampler::PolyphaseResampler resampler(input_rate, output_rate, quality);
+
+        if (!resampler.valid())
+            return nullptr;
+
+        int capacity = resampler.maxOutputLength(sample_length);
+        auto resampled = allocateSamples(capacity);
+
+        output_length = resampler.process(samples, sample_length, resampled.get(), capacity);
+        output_length += resampler.flush(resampled.get() + output_length, capacity - output_length);
+
+        return resampled;
+    }
+
+    bool generateSamples(AudioBuffer& buffer, Shape shape, float frequency, unsigned long long seed) {
+        RESONIX_PROFILE("Resonix::generateSamples", buffer.frames());
+
+        if (buffer.empty() || (!isNoise(shape) && frequency <= 0.0f))
+            return false;
+
+        // Tones are identical on every channel, noise gets one stream per channel
+        int rendered = isNoise(shape) ? buffer.channels() : 1;
+
+        forEachChannel(buffer, rendered, [&buffer, shape, frequency, seed](int c) {
+            Oscillator oscillator(shape, frequency, buffer.frames(), seed + static_cast<unsigned long long>(c));
+            float* samples = buffer.channel(c);
+            long long start;
+            int count;
+
+            // Same blocks as the whole-buffer generators, so mono and multichannel renders match
+            for (start = 0; start < buffer.frames(); start += count) {
+                count = buffer.frames() - start < Generator::BLOCK_LENGTH ? static_cast<int>(buffer.frames() - start) : Generator::BLOCK_LENGTH;
+                oscillator.render(samples + start, count);
+            }
+        });
+
+        for (int c = rendered; c < buffer.channels(); c++) {
+            std::memcpy(buffer.channel(c), buffer.channel(0), static_cast<size_t>(buffer.frames()) * sizeof(float));
+        }
+
+        return true;
+    }
+
+    bool generateNoise(Shape shape, int sample_length, unsigned long long seed, SampleFormat format, void* output, Dither* dither) {
+        RESONIX_PROFILE("Resonix::generateNoise", static_cast<long long>(sample_length) * SAMPLE_RATE);
+
+        if (sample_length <= 0 || !isNoise(shape) || !output)
+            return false;
+
+        const int total = sample_length * SAMPLE_RATE;
+        const int sample_bytes = bytesPerSample(format);
+        unsigned char* out = static_cast<unsigned char*>(output);
+        ThreadPool& pool = ThreadPool::global();
+        const unsigned long long dither_start = dither ? dither->position : 0;
+
+        // Noise and dither are both counter-based, so tasks encode their own slices independently
+        auto encodeRange = [shape, seed, total, format, out, sample_bytes, dither, dither_start](int begin, int end) {
+            // The oscillator carries the brown noise state from block to block, so only the first block warms up
+            Oscillator oscillator(shape, 0.0f, total, seed);
+            float block[Generator::BLOCK_LENGTH];
+            Dither local;
+            int count;
+
+            oscillator.seek(begin);
+            if (dither)
+                local = {dither->seed, dither_start + static_cast<unsigned long long>(begin)};
+
+            for (int start = begin; start < end; start += count) {
+                count = end - start < Generator::BLOCK_LENGTH ? end - start : Generator::BLOCK_LENGTH;
+                oscillator.render(block, count);
+                encodeSamples(block, count, format, out + static_cast<size_t>(start) * sample_bytes, dither ? &local : nullptr);
+            }
+        };
+
+        if (pool.size() < 2 || total < 2 * NOISE_TASK_LENGTH) {
+            encodeRange(0, total);
+        } else {
+            int task_length = total / static_cast<int>(4 * pool.size());
+            if (task_length < NOISE_TASK_LENGTH)
+                task_length = NOISE_TASK_LENGTH;
+
+            std::atomic<int> remaining{(total + task_length - 1) / task_length};
+
+            for (int start = 0; start < total; start += task_length) {
+                int end = total - start < task_length ? total : start + task_length;
+                pool.submit([&encodeRange, start, end, &remaining] {
+                    encodeRange(start, end);
+                    remaining.fetch_sub(1, std::memory_order_release);
+                });
+            }
+            pool.wait(remaining);
+        }
+
+        if (dither)
+            dither->position += static_cast<unsigned long long>(total);
+        return true;
+    }
+
+    bool generateSamples(Shape shape, int sample_length, float frequency, SampleFormat format, void* output, Dither* dither) {
+        RESONIX_PROFILE("Resonix::generateSamples", static_cast<long long>(sample_length) * SAMPLE_RATE);
+
+        if (isNoise(shape))
+            return generateNoise(shape, sample_length, 0, format, output, dither);
+
+        if (sample_length <= 0 || frequency <= 0.0f || !output)
+            return false;
+
+        const long long total = static_cast<long long>(sample_length) * SAMPLE_RATE;
+        const int sample_bytes = bytesPerSample(format);
+        unsigned char* out = static_cast<unsigned char*>(output);
+        Oscillator oscillator(shape, frequency, total);
+        float block[Generator::BLOCK_LENGTH];
+        long long start;
+        int count;
+
+        // Same blocks as the whole-buffer generators, so the samples match before encoding
+        for (start = 0; start < total; start += count) {
+            count = total - start < Generator::BLOCK_LENGTH ? static_cast<int>(total - start) : Generator::BLOCK_LENGTH;
+            oscillator.render(block, count);
+            encodeSamples(block, count, format, out + static_cast<size_t>(start) * sample_bytes, dither);
+        }
+
+        return true;
+    }
+
+    bool lowpass_filter(const float* samples, int sample_length, SampleFormat format, void* output,
+                        float cutoff_hz, float resonance, Dither* dither) {
+        RESONIX_PROFILE("Resonix::lowpass_filter", sample_length);
+
+        if (!samples || sample_length <= 0 || !output || cutoff_hz <= 0.0f)
+            return false;
+
+        filterEncoded(samples, sample_length, Filter::make_lowpass_filter(cutoff_hz, resonance), format, output, dither);
+        return true;
+    }
+
+    bool highpass_filter(const float* samples, int sample_length, SampleFormat format, void* output,
+                         float cutoff_hz, float resonance, Dither* dither) {
+        RESONIX_PROFILE("Resonix::highpass_filter", sample_length);
+
+        if (!samples || sample_length <= 0 || !output || cutoff_hz <= 0.0f)
+            return false;
+
+        filterEncoded(samples, sample_length, Filter::make_highpass_filter(cutoff_hz, resonance), format, output, dither);
+        return true;
+    }
+
+    bool bandpass_filter(const float* samples, int sample_length, SampleFormat format, void* output,
+                         float center_hz, float bandwidth_hz, float resonance, Dither* dither) {
+        RESONIX_PROFILE("Resonix::bandpass_filter", sample_length);
+
+        if (!samples || sample_length <= 0 || !output || center_hz <= 0.0f || bandwidth_hz <= 0.0f)
+            return false;
+
+        filterEncoded(samples, sample_length, Filter::make_bandpass_filter(center_hz, bandwidth_hz, resonance), format, output, dither);
+        return true;
+    }
+
+    bool formant_filter(const float* samples, int sample_length, SampleFormat format, void* output,
+                        float peak, float mix, float spread, Dither* dither) {
+        RESONIX_PROFILE("Resonix::formant_filter", sample_length);
+        Filter::FormantFilter filter;
+
+        if (!samples || sample_length <= 0 || !output)
+            return false;
+
+        filter.setup(peak, mix, spread);
+        filterEncoded(samples, sample_length, filter, format, output, dither);
+        return true;
+    }
+
+    bool lowpass_filter(AudioBuffer& buffer, float cutoff_hz, float resonance) {
+        RESONIX_PROFILE("Resonix::lowpass_filter", buffer.frames());
+
+        if (buffer.empty() || cutoff_hz <= 0.0f)
+            return false;
+
+        filterChannels(buffer, Filter::make_lowpass_filter(cutoff_hz, resonance));
+        return true;
+    }
+
+    bool highpass_filter(AudioBuffer& buffer, float cutoff_hz, float resonance) {
+        RESONIX_PROFILE("Resonix::highpass_filter", buffer.frames());
+
+        if (buffer.empty() || cutoff_hz <= 0.0f)
+            return false;
+
+        filterChannels(buffer, Filter::make_highpass_filter(cutoff_hz, resonance));
+        return true;
+    }
+
+    bool bandpass_filter(AudioBuffer& buffer, float center_hz, float bandwidth_hz, float resonance) {
+        RESONIX_PROFILE("Resonix::bandpass_filter", buffer.frames());
+
+        if (buffer.empty() || center_hz <= 0.0f || bandwidth_hz <= 0.0f)
+            return false;
+
+        filterChannels(buffer, Filter::make_bandpass_filter(center_hz, bandwidth_hz, resonance));
+        return true;
+    }
+
+    bool formant_filter(AudioBuffer& buffer, float peak, float mix, float spread) {
+        RESONIX_PROFILE("Resonix::formant_filter", buffer.frames());
+        Filter::FormantFilter filter;
+
+        if (buffer.empty())
+            return false;
+
+        filter.setup(peak, mix, spread);
+        filterChannels(buffer, filter);
+        return true;
+    }
+
+    const char* simdLevel() {
+#if defined(RESONIX_DISPATCH)
+        // Mirrors the order in which the ifunc resolvers pick a clone
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("x86-64-v4"))
+            return "avx512";
+        if (__builtin_cpu_supports("x86-64-v3"))
+            return "avx2";
+        return "sse2";
+#elif defined(__AVX512F__)
+        return "avx512";
+#elif defined(__AVX2__)
+        return "avx2";
+#elif defined(__SSE2__)
+        return "sse2";
+#elif defined(__ARM_NEON)
+        return "neon";
+#else
+        return "generic";
+#endif
+    }
 }
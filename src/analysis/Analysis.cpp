@@ -0,0 +1,217 @@
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "Analysis.hpp"
+#include "Instrument.hpp"
+#include "ThreadPool.hpp"
+
+namespace Resonix {
+    namespace {
+        // Independent accumulators per lane let the main loop vectorize without -ffast-math
+        constexpr int LANES = 8;
+        // Float partial sums are folded into doubles after every chunk
+        constexpr int CHUNK = 4096;
+        // Smallest piece of a buffer worth handing to another thread
+        constexpr int TASK_LENGTH = 1 << 18;
+
+        constexpr uint32_t ABS_MASK = 0x7FFFFFFFu;
+        constexpr uint32_t INF_BITS = 0x7F800000u;
+        constexpr uint32_t SIGN_BIT = 0x80000000u;
+
+        inline uint32_t bitsAt(const float* samples, long long index) {
+            uint32_t bits;
+            std::memcpy(&bits, samples + index, sizeof(bits));
+            return bits;
+        }
+
+        inline uint32_t isFinite(uint32_t bits) {
+            return (bits & ABS_MASK) < INF_BITS ? 1u : 0u;
+        }
+
+        // Strictly negative and finite; -0.0 counts as non-negative
+        inline uint32_t isNegative(uint32_t bits) {
+            return bits > SIGN_BIT && bits < (SIGN_BIT | INF_BITS) ? 1u : 0u;
+        }
+
+        inline uint32_t crosses(uint32_t previous, uint32_t current) {
+            return isFinite(previous) & isFinite(current) & (isNegative(previous) ^ isNegative(current));
+        }
+    }
+
+    void StatsAccumulator::add(const float* samples, int count) {
+        float sum[LANES], squares[LANES], value;
+        uint32_t peak[LANES], finite[LANES], nans[LANES], infs[LANES], crossings[LANES];
+        uint32_t bits, magnitude, ok;
+        int start, end, vector_end, i, l;
+
+        if (!samples || count <= 0)
+            return;
+
+        // The first sample pairs with the end of the previous call, the rest with their predecessor
+        bits = bitsAt(samples, 0);
+        magnitude = bits & ABS_MASK;
+        if (length_ > 0)
+            zero_crossings_ += crosses(last_bits_, bits);
+        else
+            first_bits_ = bits;
+
+        if (magnitude < INF_BITS) {
+            sum_ += samples[0];
+            sum_squares_ += static_cast<double>(samples[0]) * samples[0];
+            peak_bits_ = magnitude > peak_bits_ ? magnitude : peak_bits_;
+            finite_++;
+        } else if (magnitude == INF_BITS) {
+            inf_count_++;
+        } else {
+            nan_count_++;
+        }
+
+        for (start = 1; start < count; start = end) {
+            end = count - start < CHUNK ? count : start + CHUNK;
+            vector_end = start + (end - start) / LANES * LANES;
+
+            for (l = 0; l < LANES; l++) {
+                sum[l] = squares[l] = 0.0f;
+                peak[l] = finite[l] = nans[l] = infs[l] = crossings[l] = 0u;
+            }
+
+            for (i = start; i < end; i += LANES) {
+                // Full groups of LANES samples vectorize; the tail runs lane by lane
+                for (l = 0; l < LANES && (i < vector_end || i + l < end); l++) {
+                    bits = bitsAt(samples, i + l);
+                    magnitude = bits & ABS_MASK;
+                    ok = magnitude < INF_BITS ? 1u : 0u;
+                    value = ok ? samples[i + l] : 0.0f;
+
+                    sum[l] += value;
+                    squares[l] += value * value;
+                    peak[l] = ok && magnitude > peak[l] ? magnitude : peak[l];
+                    finite[l] += ok;
+                    nans[l] += magnitude > INF_BITS ? 1u : 0u;
+                    infs[l] += magnitude == INF_BITS ? 1u : 0u;
+                    crossings[l] += crosses(bitsAt(samples, i + l - 1), bits);
+                }
+            }
+
+            for (l = 0; l < LANES; l++) {
+                sum_ += sum[l];
+                sum_squares_ += squares[l];
+                peak_bits_ = peak[l] > peak_bits_ ? peak[l] : peak_bits_;
+                finite_ += finite[l];
+                nan_count_ += nans[l];
+                inf_count_ += infs[l];
+                zero_crossings_ += crossings[l];
+            }
+        }
+
+        last_bits_ = bitsAt(samples, count - 1);
+        length_ += count;
+    }
+
+    void StatsAccumulator::merge(const StatsAccumulator& next) {
+        if (next.length_ == 0)
+            return;
+
+        if (length_ > 0)
+            zero_crossings_ += crosses(last_bits_, next.first_bits_);
+        else
+            first_bits_ = next.first_bits_;
+
+        sum_ += next.sum_;
+        sum_squares_ += next.sum_squares_;
+        peak_bits_ = next.peak_bits_ > peak_bits_ ? next.peak_bits_ : peak_bits_;
+        length_ += next.length_;
+        finite_ += next.finite_;
+        zero_crossings_ += next.zero_crossings_;
+        nan_count_ += next.nan_count_;
+        inf_count_ += next.inf_count_;
+        last_bits_ = next.last_bits_;
+    }
+
+    SignalStats StatsAccumulator::result() const {
+        SignalStats stats;
+
+        stats.length = length_;
+        std::memcpy(&stats.peak, &peak_bits_, sizeof(stats.peak));
+        stats.zero_crossings = zero_crossings_;
+        stats.nan_count = nan_count_;
+        stats.inf_count = inf_count_;
+
+        if (finite_ > 0) {
+            stats.rms = static_cast<float>(std::sqrt(sum_squares_ / static_cast<double>(finite_)));
+            stats.dc_offset = static_cast<float>(sum_ / static_cast<double>(finite_));
+        }
+
+        return stats;
+    }
+
+    SignalStats analyze(const float* samples, long long length, ThreadPool* pool) {
+        StatsAccumulator total;
+        long long start;
+        int count;
+
+        RESONIX_PROFILE("Resonix::analyze", length);
+
+        if (!samples || length <= 0)
+            return SignalStats();
+
+        if (!pool)
+            pool = &ThreadPool::global();
+
+        if (pool->size() < 2 || length < 2LL * TASK_LENGTH) {
+            for (start = 0; start < length; start += count) {
+                count = length - start < TASK_LENGTH ? static_cast<int>(length - start) : TASK_LENGTH;
+                total.add(samples + start, count);
+            }
+            return total.result();
+        }
+
+        std::vector<StatsAccumulator> parts(static_cast<size_t>((length + TASK_LENGTH - 1) / TASK_LENGTH));
+        std::atomic<int> remaining{static_cast<int>(parts.size())};
+
+        for (size_t k = 0; k < parts.size(); k++) {
+            start = static_cast<long long>(k) * TASK_LENGTH;
+            count = length - start < TASK_LENGTH ? static_cast<int>(length - start) : TASK_LENGTH;
+
+            StatsAccumulator* part = &parts[k];
+            const float* chunk = samples + start;
+            pool->submit([part, chunk, count, &remaining] {
+                part->add(chunk, count);
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        pool->wait(remaining);
+
+        for (const StatsAccumulator& part : parts) {
+            total.merge(part);
+        }
+
+        return total.result();
+    }
+
+    long long analyzeBlocks(const float* samples, long long length, int block_size, float* peak, float* rms) {
+        StatsAccumulator block;
+        SignalStats stats;
+        long long start, blocks = 0;
+        int count;
+
+        RESONIX_PROFILE("Resonix::analyzeBlocks", length);
+
+        if (!samples || length <= 0 || block_size <= 0 || !peak || !rms)
+            return -1;
+
+        for (start = 0; start < length; start += count) {
+            count = length - start < block_size ? static_cast<int>(length - start) : block_size;
+
+            block.reset();
+            block.add(samples + start, count);
+            stats = block.result();
+
+            peak[blocks] = stats.peak;
+            rms[blocks] = stats.rms;
+            blocks++;
+        }
+
+        return blocks;
+    }
+}
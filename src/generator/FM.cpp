@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <cmath>
+#include "FM.hpp"
+#include "Dispatch.hpp"
+#include "Generator.hpp"
+#include "Instrument.hpp"
+#include "Math.hpp"
+#include "Tones.hpp"
+
+namespace Resonix {
+    namespace {
+        // Frames per constant-frequency pass; keeps start + i * step exact in float
+        constexpr int PHASE_BLOCK = Generator::BLOCK_LENGTH;
+
+        double advance(double phase, double cycles) {
+            phase += cycles;
+            return phase - std::floor(phase);
+        }
+
+        template <Shape S>
+        inline void toneLoop(float* output, int count, float start, float step, const float* modulation, float depth,
+                             float gain, float gain_step) {
+            if (modulation) {
+                for (int i = 0; i < count; i++) {
+                    output[i] = (gain + static_cast<float>(i) * gain_step)
+                                * Generator::Tone::at<S>(start + static_cast<float>(i) * step + depth * modulation[i]);
+                }
+            } else {
+                for (int i = 0; i < count; i++) {
+                    output[i] = (gain + static_cast<float>(i) * gain_step) * Generator::Tone::at<S>(start + static_cast<float>(i) * step);
+                }
+            }
+        }
+
+        // Writes count samples from start cycles on, each shifted by depth * modulation[i] when given
+        // and scaled by gain + i * gain_step
+        RESONIX_CLONES
+        void renderTones(Shape shape, float* output, int count, float start, float step, const float* modulation, float depth,
+                         float gain, float gain_step) {
+            switch (shape) {
+                case SINE:
+                    toneLoop<SINE>(output, count, start, step, modulation, depth, gain, gain_step);
+                    break;
+                case COSINE:
+                    toneLoop<COSINE>(output, count, start, step, modulation, depth, gain, gain_step);
+                    break;
+                case SQUARE:
+                    toneLoop<SQUARE>(output, count, start, step, modulation, depth, gain, gain_step);
+                    break;
+                case TRIANGLE:
+                    toneLoop<TRIANGLE>(output, count, start, step, modulation, depth, gain, gain_step);
+                    break;
+                default:
+                    toneLoop<SAWTOOTH>(output, count, start, step, modulation, depth, gain, gain_step);
+                    break;
+            }
+        }
+
+        template <Shape S>
+        inline void shapeLoop(float* cycles, int count, float gain, float gain_step) {
+            for (int i = 0; i < count; i++) {
+                cycles[i] = (gain + static_cast<float>(i) * gain_step) * Generator::Tone::at<S>(cycles[i]);
+            }
+        }
+
+        // Replaces positions in cycles by the waveform there scaled by gain + i * gain_step, in place
+        RESONIX_CLONES
+        void shapeCycles(Shape shape, float* cycles, int count, float gain, float gain_step) {
+            switch (shape) {
+                case SINE:
+                    shapeLoop<SINE>(cycles, count, gain, gain_step);
+                    break;
+                case COSINE:
+                    shapeLoop<COSINE>(cycles, count, gain, gain_step);
+                    break;
+                case SQUARE:
+                    shapeLoop<SQUARE>(cycles, count, gain, gain_step);
+                    break;
+                case TRIANGLE:
+                    shapeLoop<TRIANGLE>(cycles, count, gain, gain_step);
+                    break;
+                default:
+                    shapeLoop<SAWTOOTH>(cycles, count, gain, gain_step);
+                    break;
+            }
+        }
+
+        // Self-modulation by the mean of the last two outputs, which tames the
+        // oscillation of plain one-sample feedback; inherently sample by sample
+        template <Shape S>
+        inline void feedbackLoop(float* output, int count, float start, float step, const float* modulation, float feedback, float* history) {
+            float last = history[0], before = history[1], cycles;
+
+            for (int i = 0; i < count; i++) {
+                cycles = start + static_cast<float>(i) * step + feedback * 0.5f * (last + before);
+                if (modulation)
+                    cycles += modulation[i];
+                before = last;
+                last = Generator::Tone::at<S>(cycles);
+                output[i] = last;
+            }
+
+            history[0] = last;
+            history[1] = before;
+        }
+
+        void renderFeedback(Shape shape, float* output, int count, float start, float step, const float* modulation, float feedback, float* history) {
+            switch (shape) {
+                case SINE:
+                    feedbackLoop<SINE>(output, count, start, step, modulation, feedback, history);
+                    break;
+                case COSINE:
+                    feedbackLoop<COSINE>(output, count, start, step, modulation, feedback, history);
+                    break;
+                case SQUARE:
+                    feedbackLoop<SQUARE>(output, count, start, step, modulation, feedback, history);
+                    break;
+                case TRIANGLE:
+                    feedbackLoop<TRIANGLE>(output, count, start, step, modulation, feedback, history);
+                    break;
+                default:
+                    feedbackLoop<SAWTOOTH>(output, count, start, step, modulation, feedback, history);
+                    break;
+            }
+        }
+
+        RESONIX_CLONES
+        void accumulate(float* output, const float* input, float gain, int count) {
+            for (int i = 0; i < count; i++) {
+                output[i] += gain * input[i];
+            }
+        }
+    }
+
+    ModulatedOscillator::ModulatedOscillator(Shape shape, float frequency, float phase)
+        : shape_(shape), frequency_(frequency), phase_(0.0) {
+        setPhase(phase);
+    }
+
+    void ModulatedOscillator::setPhase(float phase) {
+        phase_ = advance(0.0, phase);
+    }
+
+    void ModulatedOscillator::render(float* output, int count) {
+        renderPM(output, count, nullptr);
+    }
+
+    void ModulatedOscillator::renderPM(float* output, int count, const float* modulation, float depth) {
+        RESONIX_PROFILE("ModulatedOscillator::render", count);
+
+        if (!output || count <= 0)
+            return;
+
+        renderPhase(output, count, modulation, depth / (2.0f * Math::PI), 1.0f, 0.0f);
+    }
+
+    void ModulatedOscillator::renderFM(float* output, int count, const float* frequency) {
+        RESONIX_PROFILE("ModulatedOscillator::renderFM", count);
+
+        if (!output || !frequency || count <= 0)
+            return;
+
+        integrate(output, count, frequency);
+        shape(output, count, 1.0f, 0.0f);
+    }
+
+    template <typename Source>
+    void ModulatedOscillator::render(float* output, int count, Source& gain) {
+        renderPM(output, count, nullptr, 1.0f, gain);
+    }
+
+    template <typename Source>
+    void ModulatedOscillator::renderPM(float* output, int count, const float* modulation, float depth, Source& gain) {
+        RESONIX_PROFILE("ModulatedOscillator::render", count);
+        Ramp ramp;
+
+        if (!output || count <= 0)
+            return;
+
+        for (int start = 0; start < count; start += ramp.frames) {
+            ramp = gain.next(std::min(count - start, PHASE_BLOCK));
+            renderPhase(output + start, ramp.frames, modulation ? modulation + start : nullptr, depth / (2.0f * Math::PI),
+                        ramp.start, ramp.delta);
+        }
+    }
+
+    template <typename Source>
+    void ModulatedOscillator::renderFM(float* output, int count, const float* frequency, Source& gain) {
+        RESONIX_PROFILE("ModulatedOscillator::renderFM", count);
+        Ramp ramp;
+
+        if (!output || !frequency || count <= 0)
+            return;
+
+        integrate(output, count, frequency);
+        for (int start = 0; start < count; start += ramp.frames) {
+            ramp = gain.next(count - start);
+            shape(output + start, ramp.frames, ramp.start, ramp.delta);
+        }
+    }
+
+    template void ModulatedOscillator::render<Envelope>(float* output, int count, Envelope& gain);
+    template void ModulatedOscillator::render<LFO>(float* output, int count, LFO& gain);
+    template void ModulatedOscillator::renderPM<Envelope>(float* output, int count, const float* modulation, float depth, Envelope& gain);
+    template void ModulatedOscillator::renderPM<LFO>(float* output, int count, const float* modulation, float depth, LFO& gain);
+    template void ModulatedOscillator::renderFM<Envelope>(float* output, int count, const float* frequency, Envelope& gain);
+    template void ModulatedOscillator::renderFM<LFO>(float* output, int count, const float* frequency, LFO& gain);
+
+    // Constant-frequency blocks from the running phase, which advances by count samples
+    void ModulatedOscillator::renderPhase(float* output, int count, const float* modulation, float depth_cycles, float gain, float gain_step) {
+        const float step = frequency_ / SAMPLE_RATE;
+
+        if (!Generator::Tone::supports(shape_)) {
+            std::fill(output, output + count, 0.0f);
+            return;
+        }
+
+        for (int start = 0, length; start < count; start += length) {
+            length = std::min(count - start, PHASE_BLOCK);
+            renderTones(shape_, output + start, length, static_cast<float>(phase_), step,
+                        modulation ? modulation + start : nullptr, depth_cycles,
+                        gain + static_cast<float>(start) * gain_step, gain_step);
+            phase_ = advance(phase_, static_cast<double>(length) * frequency_ / SAMPLE_RATE);
+        }
+    }
+
+    // Writes the position in cycles of each sample; the running sum is the only serial part
+    void ModulatedOscillator::integrate(float* output, int count, const float* frequency) {
+        const double scale = 1.0 / SAMPLE_RATE;
+        double phase = phase_, increment;
+
+        for (int i = 0; i < count; i++) {
+            increment = static_cast<double>(frequency[i]) * scale;
+            output[i] = static_cast<float>(phase);
+            phase += increment;
+            if (phase >= 1.0 || phase < 0.0)
+                phase -= std::floor(phase);
+        }
+
+        phase_ = phase;
+    }
+
+    void ModulatedOscillator::shape(float* cycles, int count, float gain, float gain_step) const {
+        if (Generator::Tone::supports(shape_))
+            shapeCycles(shape_, cycles, count, gain, gain_step);
+        else
+            std::fill(cycles, cycles + count, 0.0f);
+    }
+
+    FMVoice::FMVoice(int operators, float frequency)
+        : operator_count_(std::min(std::max(operators, 1), MAX_OPERATORS)), frequency_(frequency) {
+        MemoryTag tag("FMVoice");
+
+        blocks_ = allocateSamples(static_cast<size_t>(MAX_OPERATORS + 1) * BLOCK_FRAMES);
+        for (float (&row)[MAX_OPERATORS] : modulation_) {
+            std::fill(row, row + MAX_OPERATORS, 0.0f);
+        }
+        reset();
+    }
+
+    bool FMVoice::setOperator(int index, const FMOperator& settings) {
+        if (index < 0 || index >= operator_count_ || !Generator::Tone::supports(settings.shape))
+            return false;
+
+        operators_[index] = settings;
+        return true;
+    }
+
+    bool FMVoice::setModulation(int target, int source, float index) {
+        if (target < 0 || source <= target || source >= operator_count_)
+            return false;
+
+        modulation_[target][source] = index / (2.0f * Math::PI);
+        return true;
+    }
+
+    void FMVoice::reset() {
+        for (int i = 0; i < MAX_OPERATORS; i++) {
+            phases_[i] = 0.0;
+            feedback_[i][0] = feedback_[i][1] = 0.0f;
+        }
+    }
+
+    void FMVoice::renderBlock(float* output, int count) {
+        float* modulation = blocks_.get() + MAX_OPERATORS * BLOCK_FRAMES;
+        bool needed[MAX_OPERATORS];
+
+        // An operator matters if it is heard or modulates one that is
+        for (int op = 0; op < operator_count_; op++) {
+            needed[op] = operators_[op].output != 0.0f;
+            for (int target = 0; target < op && !needed[op]; target++) {
+                needed[op] = needed[target] && modulation_[target][op] != 0.0f;
+            }
+        }
+
+        for (int op = operator_count_ - 1; op >= 0; op--) {
+            const FMOperator& settings = operators_[op];
+            const float frequency = settings.frequency > 0.0f ? settings.frequency : settings.ratio * frequency_;
+            const float step = frequency / SAMPLE_RATE;
+            float* block = blocks_.get() + op * BLOCK_FRAMES;
+            bool modulated = false;
+
+            if (needed[op]) {
+                for (int source = op + 1; source < operator_count_; source++) {
+                    if (modulation_[op][source] == 0.0f)
+                        continue;
+                    if (!modulated)
+                        std::fill(modulation, modulation + count, 0.0f);
+                    accumulate(modulation, blocks_.get() + source * BLOCK_FRAMES, modulation_[op][source], count);
+                    modulated = true;
+                }
+
+                if (settings.feedback != 0.0f)
+                    renderFeedback(settings.shape, block, count, static_cast<float>(phases_[op]), step, modulated ? modulation : nullptr,
+                                   settings.feedback / (2.0f * Math::PI), feedback_[op]);
+                else
+                    renderTones(settings.shape, block, count, static_cast<float>(phases_[op]), step, modulated ? modulation : nullptr, 1.0f, 1.0f, 0.0f);
+            }
+
+            phases_[op] = advance(phases_[op], static_cast<double>(count) * frequency / SAMPLE_RATE);
+        }
+
+        std::fill(output, output + count, 0.0f);
+        for (int op = 0; op < operator_count_; op++) {
+            if (operators_[op].output != 0.0f)
+                accumulate(output, blocks_.get() + op * BLOCK_FRAMES, operators_[op].output, count);
+        }
+    }
+
+    void FMVoice::render(float* output, int count) {
+        RESONIX_PROFILE("FMVoice::render", count);
+
+        if (!output || count <= 0 || !blocks_)
+            return;
+
+        for (int start = 0, length; start < count; start += length) {
+            length = std::min(count - start, BLOCK_FRAMES);
+            renderBlock(output + start, length);
+        }
+    }
+}
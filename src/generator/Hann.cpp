@@ -1,39 +1,117 @@
+#include <climits>
 #include "Resonix.hpp"
 #include "Generator.hpp"
 #include "Math.hpp"
+#include "Dispatch.hpp"
+#include "../math/Kernels.hpp"
 
 namespace Generator {
-    std::unique_ptr<float[]> Hann(int sample_length, float frequency, const float phaseIncrement) {
-        std::unique_ptr<float[]> samples = std::make_unique<float[]>(sample_length * Resonix::SAMPLE_RATE);
-        float t, sine_wave, hann_window;
-        int N = static_cast<int>(sample_length * Resonix::SAMPLE_RATE);
-
-        for (int i = 0; i < sample_length * Resonix::SAMPLE_RATE; i++) {
-            t = static_cast<float>(i) / Resonix::SAMPLE_RATE;
-            sine_wave = Math::Sine(360.0f * frequency * t);
-            hann_window = Math::Hann(static_cast<float>(i), N);
-            samples[i] = sine_wave * hann_window;
+    namespace {
+        // Math::Hann is NaN for windows of at most one sample; checked once per block instead of per sample
+        bool fillUndefinedWindow(float* output, int count, float N) {
+            if (N > 1.0f)
+                return true;
+
+            for (int i = 0; i < count; i++) {
+                output[i] = Math::Kernel::getNaN();
+            }
+            return false;
+        }
+
+        /*
+         * The sample loops, templated on the type of the absolute position.
+         * Converting a 64-bit integer to float has no vector instruction below
+         * AVX-512DQ, so blocks whose positions fit in an int use int; the
+         * float is the same either way.
+         */
+        template <typename Position>
+        inline void hannLoop(float* output, Position first, int count, float start, float step, float inverse_N_minus_1) {
+            float sine_wave, hann_window;
+
+            for (int i = 0; i < count; i++) {
+                sine_wave = Math::Kernel::Sine(360.0f * (start + static_cast<float>(i) * step));
+                hann_window = Math::Kernel::Hann(static_cast<float>(first + i), inverse_N_minus_1);
+                output[i] = sine_wave * hann_window;
+            }
+        }
+
+        template <typename Position>
+        inline void phasedHannLoop(float* output, Position first, int count, float start, float step, float phase_degrees,
+                                   float N, float phaseOffsetSamples, float inverse_N_minus_1) {
+            float sine_wave, hann_window, windowPosition;
+
+            for (int i = 0; i < count; i++) {
+                sine_wave = Math::Kernel::Sine(360.0f * (start + static_cast<float>(i) * step) + phase_degrees);
+                // Math::fmod without its zero-divisor branch, which keeps the loop from vectorizing; N > 1 here
+                windowPosition = static_cast<float>(first + i) + phaseOffsetSamples;
+                windowPosition -= static_cast<float>(static_cast<int>(windowPosition / N)) * N;
+                windowPosition = windowPosition < 0.0f ? windowPosition + N : windowPosition;
+
+                hann_window = Math::Kernel::Hann(windowPosition, inverse_N_minus_1);
+                output[i] = sine_wave * hann_window;
+            }
+        }
+
+        bool fitsInt(long long offset, int count) {
+            return offset >= 0 && offset + count <= INT_MAX;
+        }
+    }
+
+    RESONIX_CLONES
+    void Hann(float* output, long long offset, int count, float frequency, const float phaseIncrement, long long window_length) {
+        float start = cycleAt(offset, frequency);
+        float step = frequency / Resonix::SAMPLE_RATE;
+        float N = static_cast<float>(window_length);
+        float inverse_N_minus_1;
+
+        if (!fillUndefinedWindow(output, count, N))
+            return;
+        inverse_N_minus_1 = 1.0f / (N - 1.0f);
+
+        if (fitsInt(offset, count))
+            hannLoop(output, static_cast<int>(offset), count, start, step, inverse_N_minus_1);
+        else
+            hannLoop(output, offset, count, start, step, inverse_N_minus_1);
+    }
+
+    Resonix::SampleBuffer Hann(int sample_length, float frequency, const float phaseIncrement) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
+
+        for (int i = 0; i < total; i += BLOCK_LENGTH) {
+            Hann(samples.get() + i, i, total - i < BLOCK_LENGTH ? total - i : BLOCK_LENGTH, frequency, phaseIncrement, total);
         }
 
         return samples;
     }
 
-    std::unique_ptr<float[]> Phased_Hann(int sample_length, float frequency, const float phaseIncrement) {
-        std::unique_ptr<float[]> samples = std::make_unique<float[]>(sample_length * Resonix::SAMPLE_RATE);
-        float t, sine_wave, hann_window;
-        int N = static_cast<int>(sample_length * Resonix::SAMPLE_RATE);
+    RESONIX_CLONES
+    void Phased_Hann(float* output, long long offset, int count, float frequency, const float phaseIncrement, long long window_length) {
+        float start = cycleAt(offset, frequency);
+        float step = frequency / Resonix::SAMPLE_RATE;
+        float phase_degrees = phaseIncrement * 180.0f / Math::PI;
+        float N = static_cast<float>(window_length);
         float phaseOffsetSamples = (phaseIncrement / (2.0f * Math::PI)) * N;
+        float inverse_N_minus_1;
+
+        if (!fillUndefinedWindow(output, count, N))
+            return;
+        inverse_N_minus_1 = 1.0f / (N - 1.0f);
+
+        if (fitsInt(offset, count))
+            phasedHannLoop(output, static_cast<int>(offset), count, start, step, phase_degrees, N, phaseOffsetSamples, inverse_N_minus_1);
+        else
+            phasedHannLoop(output, offset, count, start, step, phase_degrees, N, phaseOffsetSamples, inverse_N_minus_1);
+    }
 
-        for (int i = 0; i < sample_length * Resonix::SAMPLE_RATE; i++) {
-            t = static_cast<float>(i) / Resonix::SAMPLE_RATE;
-            sine_wave = Math::Sine(360.0f * frequency * t + phaseIncrement * 180.0f / Math::PI);
-            float windowPosition = Math::fmod(static_cast<float>(i) + phaseOffsetSamples, static_cast<float>(N));
-            if (windowPosition < 0.0f) windowPosition += N;
+    Resonix::SampleBuffer Phased_Hann(int sample_length, float frequency, const float phaseIncrement) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
 
-            hann_window = Math::Hann(windowPosition, N);
-            samples[i] = sine_wave * hann_window;
+        for (int i = 0; i < total; i += BLOCK_LENGTH) {
+            Phased_Hann(samples.get() + i, i, total - i < BLOCK_LENGTH ? total - i : BLOCK_LENGTH, frequency, phaseIncrement, total);
         }
 
         return samples;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,251 @@
+#include <cmath>
+#include "Modulation.hpp"
+#include "Dispatch.hpp"
+#include "Instrument.hpp"
+#include "Tones.hpp"
+
+namespace Resonix {
+    namespace {
+        // Where an exponential segment counts as finished: -80 dB
+        constexpr float SILENCE = 1e-4f;
+        // Level an exponential segment falls to over its set time: -60 dB
+        constexpr double SEGMENT_FALL = 1e-3;
+
+        long long toFrames(float seconds) {
+            return seconds > 0.0f ? std::llround(static_cast<double>(seconds) * SAMPLE_RATE) : 0;
+        }
+
+        float stepOver(float distance, long long frames) {
+            return frames > 0 ? distance / static_cast<float>(frames) : 0.0f;
+        }
+
+        float factorOver(long long frames) {
+            return frames > 0 ? static_cast<float>(std::pow(SEGMENT_FALL, 1.0 / static_cast<double>(frames))) : 0.0f;
+        }
+
+        // Samples a linear segment needs to cover distance, at least one
+        int framesToCover(float distance, float step, int limit) {
+            const double frames = std::ceil(static_cast<double>(distance) / step - 1e-4);
+            return frames < 1.0 ? 1 : frames < limit ? static_cast<int>(frames) : limit;
+        }
+
+        RESONIX_CLONES
+        void fillRamp(float* output, float start, float delta, int count) {
+            for (int i = 0; i < count; i++) {
+                output[i] = start + static_cast<float>(i) * delta;
+            }
+        }
+
+        float toneAt(Shape shape, float cycles) {
+            switch (shape) {
+                case SINE:
+                    return Generator::Tone::at<SINE>(cycles);
+                case COSINE:
+                    return Generator::Tone::at<COSINE>(cycles);
+                case SQUARE:
+                    return Generator::Tone::at<SQUARE>(cycles);
+                case TRIANGLE:
+                    return Generator::Tone::at<TRIANGLE>(cycles);
+                case SAWTOOTH:
+                    return Generator::Tone::at<SAWTOOTH>(cycles);
+                default:
+                    return 0.0f;
+            }
+        }
+    }
+
+    RESONIX_CLONES
+    void multiplyRamp(const float* input, float* output, float start, float delta, int count) {
+        for (int i = 0; i < count; i++) {
+            output[i] = input[i] * (start + static_cast<float>(i) * delta);
+        }
+    }
+
+    Envelope::Envelope(float attack, float decay, float sustain, float release, EnvelopeCurve curve)
+        : curve_(curve),
+          sustain_(std::min(std::max(sustain, 0.0f), 1.0f)),
+          attack_step_(stepOver(1.0f, toFrames(attack))),
+          decay_step_(stepOver(1.0f - sustain_, toFrames(decay))),
+          release_frames_(toFrames(release)),
+          release_step_(0.0f),
+          decay_factor_(factorOver(toFrames(decay))),
+          release_factor_(factorOver(toFrames(release))),
+          stage_(ENVELOPE_IDLE),
+          value_(0.0f) {}
+
+    void Envelope::noteOn() {
+        stage_ = ENVELOPE_ATTACK;
+    }
+
+    void Envelope::noteOff() {
+        if (stage_ == ENVELOPE_IDLE)
+            return;
+
+        stage_ = ENVELOPE_RELEASE;
+        release_step_ = stepOver(value_, release_frames_);
+    }
+
+    void Envelope::reset() {
+        stage_ = ENVELOPE_IDLE;
+        value_ = 0.0f;
+    }
+
+    Ramp Envelope::next(int frames) {
+        Ramp ramp;
+        float end;
+
+        ramp.frames = frames > 0 ? frames : 1;
+
+        // Segments of zero length are passed through without producing a ramp
+        for (;;) {
+            ramp.start = value_;
+
+            switch (stage_) {
+                case ENVELOPE_ATTACK:
+                    if (attack_step_ <= 0.0f || value_ >= 1.0f) {
+                        value_ = 1.0f;
+                        stage_ = ENVELOPE_DECAY;
+                        continue;
+                    }
+                    ramp.frames = framesToCover(1.0f - value_, attack_step_, ramp.frames);
+                    end = value_ + attack_step_ * static_cast<float>(ramp.frames);
+                    if (end >= 1.0f - 1e-6f) {
+                        end = 1.0f;
+                        stage_ = ENVELOPE_DECAY;
+                    }
+                    break;
+
+                case ENVELOPE_DECAY:
+                    if (value_ <= sustain_ || (curve_ == ENVELOPE_LINEAR ? decay_step_ <= 0.0f : decay_factor_ <= 0.0f)) {
+                        value_ = sustain_;
+                        stage_ = ENVELOPE_SUSTAIN;
+                        continue;
+                    }
+                    if (curve_ == ENVELOPE_LINEAR) {
+                        ramp.frames = framesToCover(value_ - sustain_, decay_step_, ramp.frames);
+                        end = value_ - decay_step_ * static_cast<float>(ramp.frames);
+                    } else {
+                        ramp.frames = std::min(ramp.frames, CONTROL_PERIOD);
+                        end = sustain_ + (value_ - sustain_) * std::pow(decay_factor_, static_cast<float>(ramp.frames));
+                    }
+                    if (end <= sustain_ + SILENCE) {
+                        end = sustain_;
+                        stage_ = ENVELOPE_SUSTAIN;
+                    }
+                    break;
+
+                case ENVELOPE_SUSTAIN:
+                    ramp.delta = 0.0f;
+                    return ramp;
+
+                case ENVELOPE_RELEASE:
+                    if (value_ <= 0.0f || (curve_ == ENVELOPE_LINEAR ? release_step_ <= 0.0f : release_factor_ <= 0.0f)) {
+                        value_ = 0.0f;
+                        stage_ = ENVELOPE_IDLE;
+                        continue;
+                    }
+                    if (curve_ == ENVELOPE_LINEAR) {
+                        ramp.frames = framesToCover(value_, release_step_, ramp.frames);
+                        end = value_ - release_step_ * static_cast<float>(ramp.frames);
+                    } else {
+                        ramp.frames = std::min(ramp.frames, CONTROL_PERIOD);
+                        end = value_ * std::pow(release_factor_, static_cast<float>(ramp.frames));
+                    }
+                    if (end <= SILENCE) {
+                        end = 0.0f;
+                        stage_ = ENVELOPE_IDLE;
+                    }
+                    break;
+
+                default:
+                    ramp.start = 0.0f;
+                    ramp.delta = 0.0f;
+                    return ramp;
+            }
+
+            ramp.delta = (end - value_) / static_cast<float>(ramp.frames);
+            value_ = end;
+            return ramp;
+        }
+    }
+
+    void Envelope::render(float* output, int count) {
+        Ramp ramp;
+
+        if (!output)
+            return;
+
+        for (int start = 0; start < count; start += ramp.frames) {
+            ramp = next(count - start);
+            fillRamp(output + start, ramp.start, ramp.delta, ramp.frames);
+        }
+    }
+
+    void Envelope::apply(const float* input, float* output, int count) {
+        RESONIX_PROFILE("Envelope::apply", count);
+        Ramp ramp;
+
+        if (!input || !output)
+            return;
+
+        for (int start = 0; start < count; start += ramp.frames) {
+            ramp = next(count - start);
+            multiplyRamp(input + start, output + start, ramp.start, ramp.delta, ramp.frames);
+        }
+    }
+
+    LFO::LFO(Shape shape, float frequency, float depth, float offset, float phase)
+        : shape_(shape), frequency_(frequency), depth_(depth), offset_(offset), phase_(0.0), value_(0.0f) {
+        setPhase(phase);
+    }
+
+    float LFO::at(double phase) const {
+        return offset_ + depth_ * toneAt(shape_, static_cast<float>(phase));
+    }
+
+    void LFO::setPhase(float phase) {
+        phase_ = static_cast<double>(phase) - std::floor(static_cast<double>(phase));
+        value_ = at(phase_);
+    }
+
+    Ramp LFO::next(int frames) {
+        Ramp ramp;
+        float end;
+
+        ramp.frames = std::min(std::max(frames, 1), CONTROL_PERIOD);
+        ramp.start = value_;
+
+        phase_ += static_cast<double>(ramp.frames) * frequency_ / SAMPLE_RATE;
+        phase_ -= std::floor(phase_);
+        end = at(phase_);
+
+        ramp.delta = (end - value_) / static_cast<float>(ramp.frames);
+        value_ = end;
+        return ramp;
+    }
+
+    void LFO::render(float* output, int count) {
+        Ramp ramp;
+
+        if (!output)
+            return;
+
+        for (int start = 0; start < count; start += ramp.frames) {
+            ramp = next(count - start);
+            fillRamp(output + start, ramp.start, ramp.delta, ramp.frames);
+        }
+    }
+
+    void LFO::apply(const float* input, float* output, int count) {
+        RESONIX_PROFILE("LFO::apply", count);
+        Ramp ramp;
+
+        if (!input || !output)
+            return;
+
+        for (int start = 0; start < count; start += ramp.frames) {
+            ramp = next(count - start);
+            multiplyRamp(input + start, output + start, ramp.start, ramp.delta, ramp.frames);
+        }
+    }
+}
@@ -0,0 +1,230 @@
+#include <cmath>
+#include <cstdint>
+#include "Resonix.hpp"
+#include "Generator.hpp"
+#include "Math.hpp"
+#include "Dispatch.hpp"
+
+namespace Generator {
+    namespace {
+        // Philox4x32-10 constants (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+        constexpr uint32_t PHILOX_M0 = 0xD2511F53u;
+        constexpr uint32_t PHILOX_M1 = 0xCD9E8D57u;
+        constexpr uint32_t PHILOX_W0 = 0x9E3779B9u;
+        constexpr uint32_t PHILOX_W1 = 0xBB67AE85u;
+        constexpr int PHILOX_ROUNDS = 10;
+
+        // Counter groups hashed per batch
+        constexpr int PHILOX_LANES = 16;
+        constexpr int NOISE_CHUNK = 1024;
+        constexpr int PINK_ROWS = 16;
+        constexpr float BROWN_CUTOFF_HZ = 20.0f;
+
+        /**
+         * Writes the 4 words of each counter group [first_group, first_group + PHILOX_LANES)
+         * for the given stream. A group covers 4 consecutive values of that stream.
+         * The rounds are fully unrolled, so the lane loop compiles to vector code.
+         */
+        RESONIX_CLONES
+        void philoxBatch(uint32_t* words, unsigned long long first_group, uint32_t stream, unsigned long long seed) {
+            const uint32_t seed_lo = static_cast<uint32_t>(seed);
+            const uint32_t seed_hi = static_cast<uint32_t>(seed >> 32);
+
+            for (int l = 0; l < PHILOX_LANES; l++) {
+                unsigned long long group = first_group + static_cast<unsigned long long>(l);
+                uint32_t c0 = static_cast<uint32_t>(group);
+                uint32_t c1 = static_cast<uint32_t>(group >> 32);
+                uint32_t c2 = stream;
+                uint32_t c3 = 0u;
+                uint32_t k0 = seed_lo, k1 = seed_hi;
+                uint64_t p0, p1;
+
+                for (int round = 0; round < PHILOX_ROUNDS; round++) {
+                    p0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+                    p1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+
+                    c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+                    c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+                    c1 = static_cast<uint32_t>(p1);
+                    c3 = static_cast<uint32_t>(p0);
+
+                    k0 += PHILOX_W0;
+                    k1 += PHILOX_W1;
+                }
+
+                words[4 * l] = c0;
+                words[4 * l + 1] = c1;
+                words[4 * l + 2] = c2;
+                words[4 * l + 3] = c3;
+            }
+        }
+
+        // Fills 4 * groups words starting at group first_group of a stream
+        void fillWords(uint32_t* words, unsigned long long first_group, int groups, uint32_t stream, unsigned long long seed) {
+            uint32_t tail[4 * PHILOX_LANES];
+            int g = 0;
+
+            for (; g + PHILOX_LANES <= groups; g += PHILOX_LANES) {
+                philoxBatch(words + 4 * g, first_group + static_cast<unsigned long long>(g), stream, seed);
+            }
+
+            if (g < groups) {
+                philoxBatch(tail, first_group + static_cast<unsigned long long>(g), stream, seed);
+                for (int i = 0; i < 4 * (groups - g); i++) {
+                    words[4 * g + i] = tail[i];
+                }
+            }
+        }
+
+        inline float toUniform(uint32_t word) {
+            return static_cast<float>(static_cast<int32_t>(word)) * (1.0f / 2147483648.0f);
+        }
+
+        float brownLeak() {
+            return std::exp(-Math::TWO_PI * BROWN_CUTOFF_HZ / Resonix::SAMPLE_RATE);
+        }
+
+        // Cell length of 24 time constants: older history is scaled by e^-24
+        long long brownCell(float leak) {
+            return static_cast<long long>(24.0f / (1.0f - leak));
+        }
+    }
+
+    void WhiteNoise(float* output, long long offset, int count, unsigned long long seed) {
+        uint32_t words[NOISE_CHUNK + 8];
+        long long first;
+        int done, n, skip;
+
+        for (done = 0; done < count; done += n) {
+            n = count - done < NOISE_CHUNK ? count - done : NOISE_CHUNK;
+            first = offset + done;
+            skip = static_cast<int>(first & 3);
+
+            fillWords(words, static_cast<unsigned long long>(first >> 2), (skip + n + 3) >> 2, 0u, seed);
+
+            for (int i = 0; i < n; i++) {
+                output[done + i] = toUniform(words[skip + i]);
+            }
+        }
+    }
+
+    void PinkNoise(float* output, long long offset, int count, unsigned long long seed) {
+        uint32_t words[NOISE_CHUNK + 8];
+        long long first, last, j0, j1, j, from, to;
+        float value;
+        float* out;
+        int done, n, skip, i;
+
+        for (done = 0; done < count; done += n) {
+            n = count - done < NOISE_CHUNK ? count - done : NOISE_CHUNK;
+            first = offset + done;
+            last = first + n - 1;
+            out = output + done;
+
+            // Row 0 changes every sample and is the white noise stream itself
+            WhiteNoise(out, first, n, seed);
+
+            for (int k = 1; k < PINK_ROWS; k++) {
+                j0 = first >> k;
+                j1 = last >> k;
+                skip = static_cast<int>(j0 & 3);
+
+                fillWords(words, static_cast<unsigned long long>(j0 >> 2), (skip + static_cast<int>(j1 - j0) + 4) >> 2,
+                          static_cast<uint32_t>(k), seed);
+
+                for (j = j0; j <= j1; j++) {
+                    value = toUniform(words[skip + (j - j0)]);
+                    from = (j << k) > first ? (j << k) : first;
+                    to = ((j + 1) << k) < last + 1 ? ((j + 1) << k) : last + 1;
+
+                    for (long long s = from; s < to; s++) {
+                        out[s - first] += value;
+                    }
+                }
+            }
+
+            for (i = 0; i < n; i++) {
+                out[i] *= 1.0f / PINK_ROWS;
+            }
+        }
+    }
+
+    void BrownNoise(float* output, long long offset, int count, unsigned long long seed, BrownNoiseState* state) {
+        const float leak = brownLeak();
+        const long long cell = brownCell(leak);
+        const float gain = 0.25f * std::sqrt(3.0f * (1.0f - leak * leak));
+        const long long end = offset + count;
+        float white[NOISE_CHUNK];
+        float current = 0.0f, next = 0.0f;
+        long long position, boundary;
+        int n, i;
+
+        if (state && state->position == offset) {
+            position = offset;
+            current = state->current;
+            next = state->next;
+        } else {
+            // Rebuild both integrators from the start of the previous cell
+            position = (offset / cell - 1) * cell;
+            if (position < 0)
+                position = 0;
+        }
+
+        while (position < end) {
+            n = end - position < NOISE_CHUNK ? static_cast<int>(end - position) : NOISE_CHUNK;
+            boundary = (position / cell + 1) * cell;
+            if (boundary - position < n)
+                n = static_cast<int>(boundary - position);
+
+            // Entering a cell: it integrates from the previous boundary, which next started at
+            if (position % cell == 0) {
+                current = next;
+                next = 0.0f;
+            }
+
+            WhiteNoise(white, position, n, seed);
+
+            for (i = 0; i < n; i++) {
+                current = leak * current + white[i];
+                next = leak * next + white[i];
+                if (position + i >= offset)
+                    output[position + i - offset] = Math::clamp(current * gain, -1.0f, 1.0f);
+            }
+
+            position += n;
+        }
+
+        if (state) {
+            state->position = end;
+            state->current = current;
+            state->next = next;
+        }
+    }
+
+    Resonix::SampleBuffer WhiteNoise(int sample_length, unsigned long long seed) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
+
+        WhiteNoise(samples.get(), 0, total, seed);
+
+        return samples;
+    }
+
+    Resonix::SampleBuffer PinkNoise(int sample_length, unsigned long long seed) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
+
+        PinkNoise(samples.get(), 0, total, seed);
+
+        return samples;
+    }
+
+    Resonix::SampleBuffer BrownNoise(int sample_length, unsigned long long seed) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
+
+        BrownNoise(samples.get(), 0, total, seed);
+
+        return samples;
+    }
+}
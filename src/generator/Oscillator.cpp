@@ -0,0 +1,344 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include "Oscillator.hpp"
+#include "Instrument.hpp"
+#include "Math.hpp"
+
+namespace Resonix {
+    namespace {
+        // Shortest run copied per memcpy; short periods are stored repeated up to it
+        constexpr int MIN_TILE_LENGTH = 1024;
+        // Largest phase drift, in cycles, a tiled tone may build up against the direct render
+        constexpr double DRIFT_TOLERANCE = 1e-5;
+
+        bool isPeriodic(Shape shape) {
+            switch (shape) {
+                case SINE:
+                case SQUARE:
+                case TRIANGLE:
+                case SAWTOOTH:
+                case COSINE:
+                case TANGENT:
+                case COTANGENT:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // The shapes whose samples depend only on the frequency and the absolute index
+        void renderTone(Shape shape, float frequency, float phase_increment, float* output, long long offset, int count) {
+            switch (shape) {
+                case SINE:
+                    Generator::Sine(output, offset, count, frequency, phase_increment);
+                    break;
+                case SQUARE:
+                    Generator::Square(output, offset, count, frequency, phase_increment);
+                    break;
+                case TRIANGLE:
+                    Generator::Triangle(output, offset, count, frequency, phase_increment);
+                    break;
+                case SAWTOOTH:
+                    Generator::Sawtooth(output, offset, count, frequency, phase_increment);
+                    break;
+                case COSINE:
+                    Generator::Cosine(output, offset, count, frequency, phase_increment);
+                    break;
+                case TANGENT:
+                    Generator::Tangent(output, offset, count, frequency, phase_increment);
+                    break;
+                case COTANGENT:
+                    Generator::Cotangent(output, offset, count, frequency, phase_increment);
+                    break;
+                default:
+                    for (int i = 0; i < count; i++) {
+                        output[i] = 0.0f;
+                    }
+                    break;
+            }
+        }
+
+        /*
+         * Smallest period holding a whole number of cycles for at least length
+         * samples. The convergents p/q of the continued fraction of
+         * frequency / SAMPLE_RATE are its best rational approximations; each
+         * repetition of q samples is off by |frequency * q - p * SAMPLE_RATE| /
+         * SAMPLE_RATE cycles, so the first one whose drift stays below
+         * DRIFT_TOLERANCE over length samples has the smallest usable q. A float
+         * frequency times q < 2^29 is exact in double, so an exact period is
+         * recognized as such and never drifts. Returns 0 when none fits within
+         * max_period, otherwise q, with the samples it stays valid for in *horizon.
+         */
+        long long findPeriod(float frequency, long long max_period, long long length, long long* horizon) {
+            const double ratio = static_cast<double>(frequency) / SAMPLE_RATE;
+            double rest = ratio, a, drift, valid;
+            long long p0 = 0, p1 = 1, q0 = 1, q1 = 0, p, q;
+
+            for (;;) {
+                a = std::floor(rest);
+                if (a > static_cast<double>(max_period))
+                    return 0;
+
+                p = static_cast<long long>(a) * p1 + p0;
+                q = static_cast<long long>(a) * q1 + q0;
+                if (q > max_period)
+                    return 0;
+                if (p > 0) {
+                    drift = std::fabs(static_cast<double>(frequency) * static_cast<double>(q) - static_cast<double>(p) * SAMPLE_RATE) / SAMPLE_RATE;
+                    if (drift == 0.0) {
+                        *horizon = LLONG_MAX;
+                        return q;
+                    }
+                    valid = DRIFT_TOLERANCE / drift * static_cast<double>(q);
+                    if (valid >= static_cast<double>(length)) {
+                        *horizon = valid < static_cast<double>(LLONG_MAX / 2) ? static_cast<long long>(valid) : LLONG_MAX / 2;
+                        return q;
+                    }
+                }
+
+                if (rest - a < 1e-12)
+                    return 0;
+                rest = 1.0 / (rest - a);
+                p0 = p1; p1 = p;
+                q0 = q1; q1 = q;
+            }
+        }
+
+        struct CycleKey {
+            int shape;
+            float frequency;
+            int sample_rate;
+
+            bool operator==(const CycleKey& other) const {
+                return shape == other.shape && std::memcmp(&frequency, &other.frequency, sizeof(float)) == 0
+                       && sample_rate == other.sample_rate;
+            }
+        };
+
+        struct CycleKeyHash {
+            size_t operator()(const CycleKey& key) const {
+                unsigned int bits;
+                std::memcpy(&bits, &key.frequency, sizeof(bits));
+                return (static_cast<size_t>(bits) * 0x9E3779B97F4A7C15ull) ^ (static_cast<size_t>(key.shape) << 48)
+                       ^ static_cast<size_t>(key.sample_rate);
+            }
+        };
+
+        // Most recently used first; entries stay alive while an Oscillator holds them
+        class CycleCache {
+        public:
+            std::shared_ptr<const Cycle> find(const CycleKey& key) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = index_.find(key);
+
+                if (it == index_.end())
+                    return nullptr;
+                entries_.splice(entries_.begin(), entries_, it->second);
+                return it->second->second;
+            }
+
+            void insert(const CycleKey& key, const std::shared_ptr<const Cycle>& cycle) {
+                const size_t bytes = static_cast<size_t>(cycle->length) * sizeof(float);
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                if (bytes > limit_)
+                    return;
+
+                // A longer render may have found a longer-lasting cycle for the same tone
+                auto it = index_.find(key);
+                if (it != index_.end()) {
+                    bytes_ -= static_cast<size_t>(it->second->second->length) * sizeof(float);
+                    entries_.erase(it->second);
+                    index_.erase(it);
+                }
+
+                entries_.emplace_front(key, cycle);
+                index_.emplace(key, entries_.begin());
+                bytes_ += bytes;
+                evict();
+            }
+
+            size_t limit() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return limit_;
+            }
+
+            void setLimit(size_t bytes) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                limit_ = bytes;
+                evict();
+            }
+
+        private:
+            using Entry = std::pair<CycleKey, std::shared_ptr<const Cycle>>;
+
+            void evict() {
+                while (bytes_ > limit_ && !entries_.empty()) {
+                    bytes_ -= static_cast<size_t>(entries_.back().second->length) * sizeof(float);
+                    index_.erase(entries_.back().first);
+                    entries_.pop_back();
+                }
+            }
+
+            std::mutex mutex_;
+            std::list<Entry> entries_;
+            std::unordered_map<CycleKey, std::list<Entry>::iterator, CycleKeyHash> index_;
+            size_t bytes_ = 0;
+            size_t limit_ = DEFAULT_CYCLE_CACHE_LIMIT;
+        };
+
+        CycleCache& cycleCache() {
+            static CycleCache cache;
+            return cache;
+        }
+    }
+
+    void Cycle::tile(long long offset, float* output, long long count) const {
+        long long start = offset % period, run;
+
+        while (count > 0) {
+            run = count < length - start ? count : length - start;
+            std::memcpy(output, samples.get() + start, static_cast<size_t>(run) * sizeof(float));
+            output += run;
+            count -= run;
+            start = 0;
+        }
+    }
+
+    void Cycle::tile(long long offset, float* output, long long count, float gain, float gain_step) const {
+        long long start = offset % period, run;
+
+        while (count > 0) {
+            run = count < length - start ? count : length - start;
+            multiplyRamp(samples.get() + start, output, gain, gain_step, static_cast<int>(run));
+            gain += static_cast<float>(run) * gain_step;
+            output += run;
+            count -= run;
+            start = 0;
+        }
+    }
+
+    std::shared_ptr<const Cycle> findCycle(Shape shape, float frequency, long long length) {
+        const long long limit = length / 2 < MAX_CYCLE_LENGTH ? length / 2 : MAX_CYCLE_LENGTH;
+        const CycleKey key = {static_cast<int>(shape), frequency, SAMPLE_RATE};
+        CycleCache& cache = cycleCache();
+        long long period, horizon = 0;
+
+        if (!isPeriodic(shape) || !(frequency > 0.0f) || limit < 1 || cache.limit() == 0)
+            return nullptr;
+
+        if (auto cached = cache.find(key)) {
+            if (cached->period <= limit && cached->horizon >= length)
+                return cached;
+        }
+
+        period = findPeriod(frequency, limit, length, &horizon);
+        if (period == 0)
+            return nullptr;
+
+        auto cycle = std::make_shared<Cycle>();
+        const float phase_increment = (2.0f * Math::PI * frequency) / SAMPLE_RATE;
+
+        cycle->period = static_cast<int>(period);
+        cycle->horizon = horizon;
+        cycle->length = static_cast<int>((MIN_TILE_LENGTH + period - 1) / period * period);
+        cycle->samples = allocateSamples(static_cast<size_t>(cycle->length));
+        if (!cycle->samples)
+            return nullptr;
+
+        // The first period exactly as the block kernels render it, then copies
+        for (int start = 0, count; start < cycle->period; start += count) {
+            count = cycle->period - start < Generator::BLOCK_LENGTH ? cycle->period - start : Generator::BLOCK_LENGTH;
+            renderTone(shape, frequency, phase_increment, cycle->samples.get() + start, start, count);
+        }
+        for (int start = cycle->period; start < cycle->length; start += cycle->period) {
+            std::memcpy(cycle->samples.get() + start, cycle->samples.get(), static_cast<size_t>(cycle->period) * sizeof(float));
+        }
+
+        cache.insert(key, cycle);
+        return cycle;
+    }
+
+    void setCycleCacheLimit(size_t bytes) {
+        cycleCache().setLimit(bytes);
+    }
+
+    Oscillator::Oscillator(Shape shape, float frequency, long long length, unsigned long long seed)
+        : shape_(shape),
+          frequency_(frequency),
+          phase_increment_((2.0f * Math::PI * frequency) / SAMPLE_RATE),
+          length_(length),
+          position_(0),
+          seed_(seed),
+          cycle_(findCycle(shape, frequency, length)) {}
+
+    void Oscillator::render(float* output, int count) {
+        RESONIX_PROFILE("Oscillator::render", count);
+
+        if (!output || count <= 0)
+            return;
+
+        renderBlock(output, count);
+    }
+
+    template <typename Source>
+    void Oscillator::render(float* output, int count, Source& gain) {
+        RESONIX_PROFILE("Oscillator::render", count);
+        Ramp ramp;
+
+        if (!output || count <= 0)
+            return;
+
+        // Ramps of at most one kernel block, so the multiply finds the samples in L1
+        for (int start = 0; start < count; start += ramp.frames) {
+            ramp = gain.next(std::min(count - start, Generator::BLOCK_LENGTH));
+
+            if (cycle_ && position_ >= 0 && position_ + ramp.frames <= cycle_->horizon) {
+                cycle_->tile(position_, output + start, ramp.frames, ramp.start, ramp.delta);
+                position_ += ramp.frames;
+            } else {
+                renderBlock(output + start, ramp.frames);
+                multiplyRamp(output + start, output + start, ramp.start, ramp.delta, ramp.frames);
+            }
+        }
+    }
+
+    template void Oscillator::render<Envelope>(float* output, int count, Envelope& gain);
+    template void Oscillator::render<LFO>(float* output, int count, LFO& gain);
+
+    void Oscillator::renderBlock(float* output, int count) {
+        if (cycle_ && position_ >= 0 && position_ + count <= cycle_->horizon) {
+            cycle_->tile(position_, output, count);
+            position_ += count;
+            return;
+        }
+
+        switch (shape_) {
+            case HANN:
+                Generator::Hann(output, position_, count, frequency_, phase_increment_, length_);
+                break;
+            case PHASED_HANN:
+                Generator::Phased_Hann(output, position_, count, frequency_, phase_increment_, length_);
+                break;
+            case NOISE_WHITE:
+                Generator::WhiteNoise(output, position_, count, seed_);
+                break;
+            case NOISE_PINK:
+                Generator::PinkNoise(output, position_, count, seed_);
+                break;
+            case NOISE_BROWN:
+                Generator::BrownNoise(output, position_, count, seed_, &brown_);
+                break;
+            default:
+                renderTone(shape_, frequency_, phase_increment_, output, position_, count);
+                break;
+        }
+
+        position_ += count;
+    }
+}
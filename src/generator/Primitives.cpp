@@ -1,57 +1,103 @@
 #include "Resonix.hpp"
 #include "Generator.hpp"
 #include "Math.hpp"
+#include "Dispatch.hpp"
+#include "../math/Kernels.hpp"
 
 namespace Generator {
-    std::unique_ptr<float[]> Sine(int sample_length, float frequency, const float phaseIncrement) {
-        std::unique_ptr<float[]> samples = std::make_unique<float[]>(sample_length * Resonix::SAMPLE_RATE);
-        float t, phase;
+    float cycleAt(long long offset, float frequency) {
+        double cycles = static_cast<double>(offset) * frequency / Resonix::SAMPLE_RATE;
+        return static_cast<float>(cycles - static_cast<double>(static_cast<long long>(cycles)));
+    }
+
+    RESONIX_CLONES
+    void Sine(float* output, long long offset, int count, float frequency, const float phaseIncrement) {
+        float start = cycleAt(offset, frequency);
+        float step = frequency / Resonix::SAMPLE_RATE;
+        float phase_degrees = phaseIncrement * 180.0f / Math::PI;
 
-        for (int i = 0; i < sample_length * Resonix::SAMPLE_RATE; i++) {
-            t = static_cast<float>(i) / Resonix::SAMPLE_RATE;
-            phase = 2.0f * Math::PI * frequency * t + phaseIncrement;
-            samples[i] = Math::Sine(phase * 180.0f / Math::PI);
+        for (int i = 0; i < count; i++) {
+            output[i] = Math::Kernel::Sine(360.0f * (start + static_cast<float>(i) * step) + phase_degrees);
+        }
+    }
+
+    Resonix::SampleBuffer Sine(int sample_length, float frequency, const float phaseIncrement) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
+
+        for (int i = 0; i < total; i += BLOCK_LENGTH) {
+            Sine(samples.get() + i, i, total - i < BLOCK_LENGTH ? total - i : BLOCK_LENGTH, frequency, phaseIncrement);
         }
 
         return samples;
     }
 
-    std::unique_ptr<float[]> Square(int sample_length, float frequency, const float phaseIncrement) {
-        std::unique_ptr<float[]> samples = std::make_unique<float[]>(sample_length * Resonix::SAMPLE_RATE);
-        float t, phase;
+    RESONIX_CLONES
+    void Square(float* output, long long offset, int count, float frequency, const float phaseIncrement) {
+        float start = cycleAt(offset, frequency) + phaseIncrement / (2.0f * Math::PI);
+        float step = frequency / Resonix::SAMPLE_RATE;
+        float phase;
+
+        for (int i = 0; i < count; i++) {
+            phase = Math::Kernel::fmod(start + static_cast<float>(i) * step, 1.0f);
+            output[i] = phase < 0.5f ? 1.0f : -1.0f;
+        }
+    }
+
+    Resonix::SampleBuffer Square(int sample_length, float frequency, const float phaseIncrement) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
 
-        for (int i = 0; i < sample_length * Resonix::SAMPLE_RATE; i++) {
-            t = static_cast<float>(i) / Resonix::SAMPLE_RATE;
-            phase = Math::fmod(t * frequency + phaseIncrement / (2.0f * Math::PI), 1.0f);
-            samples[i] = phase < 0.5f ? 1.0f : -1.0f;
+        for (int i = 0; i < total; i += BLOCK_LENGTH) {
+            Square(samples.get() + i, i, total - i < BLOCK_LENGTH ? total - i : BLOCK_LENGTH, frequency, phaseIncrement);
         }
 
         return samples;
     }
 
-    std::unique_ptr<float[]> Triangle(int sample_length, float frequency, const float phaseIncrement) {
-        std::unique_ptr<float[]> samples = std::make_unique<float[]>(sample_length * Resonix::SAMPLE_RATE);
-        float t, phase;
+    RESONIX_CLONES
+    void Triangle(float* output, long long offset, int count, float frequency, const float phaseIncrement) {
+        float start = cycleAt(offset, frequency) + phaseIncrement / (2.0f * Math::PI);
+        float step = frequency / Resonix::SAMPLE_RATE;
+        float phase;
+
+        for (int i = 0; i < count; i++) {
+            phase = Math::Kernel::fmod(start + static_cast<float>(i) * step, 1.0f);
+            output[i] = phase < 0.5f ? 4.0f * phase - 1.0f : 3.0f - 4.0f * phase;
+        }
+    }
+
+    Resonix::SampleBuffer Triangle(int sample_length, float frequency, const float phaseIncrement) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
 
-        for (int i = 0; i < sample_length * Resonix::SAMPLE_RATE; i++) {
-            t = static_cast<float>(i) / Resonix::SAMPLE_RATE;
-            phase = Math::fmod(t * frequency + phaseIncrement / (2.0f * Math::PI), 1.0f);
-            samples[i] = phase < 0.5f ? 4.0f * phase - 1.0f : 3.0f - 4.0f * phase;
+        for (int i = 0; i < total; i += BLOCK_LENGTH) {
+            Triangle(samples.get() + i, i, total - i < BLOCK_LENGTH ? total - i : BLOCK_LENGTH, frequency, phaseIncrement);
         }
 
         return samples;
     }
 
-    std::unique_ptr<float[]> Sawtooth(int sample_length, float frequency, const float phaseIncrement) {
-        std::unique_ptr<float[]> samples = std::make_unique<float[]>(sample_length * Resonix::SAMPLE_RATE);
-        float t, phase;
+    RESONIX_CLONES
+    void Sawtooth(float* output, long long offset, int count, float frequency, const float phaseIncrement) {
+        float start = cycleAt(offset, frequency) + phaseIncrement / (2.0f * Math::PI);
+        float step = frequency / Resonix::SAMPLE_RATE;
+        float phase;
+
+        for (int i = 0; i < count; i++) {
+            phase = Math::Kernel::fmod(start + static_cast<float>(i) * step, 1.0f);
+            output[i] = 2.0f * phase - 1.0f;
+        }
+    }
+
+    Resonix::SampleBuffer Sawtooth(int sample_length, float frequency, const float phaseIncrement) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
 
-        for (int i = 0; i < sample_length * Resonix::SAMPLE_RATE; i++) {
-            t = static_cast<float>(i) / Resonix::SAMPLE_RATE;
-            phase = Math::fmod(t * frequency + phaseIncrement / (2.0f * Math::PI), 1.0f);
-            samples[i] = 2.0f * phase - 1.0f;
+        for (int i = 0; i < total; i += BLOCK_LENGTH) {
+            Sawtooth(samples.get() + i, i, total - i < BLOCK_LENGTH ? total - i : BLOCK_LENGTH, frequency, phaseIncrement);
         }
 
         return samples;
     }
-}
\ No newline at end of file
+}
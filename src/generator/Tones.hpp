@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Resonix.hpp"
+#include "Math.hpp"
+
+/*
+ * The tonal waveforms as functions of a position in cycles, for sample loops
+ * that track their own phase (voices, modulated oscillators and FM operators).
+ * Inline, so they vectorize inside RESONIX_CLONES kernels. The shapes are
+ * those of the Generator block kernels, but SINE and COSINE use a quarter-wave
+ * polynomial accurate to about 4e-6 instead of Math::Kernel::Sine, whose
+ * error of up to 0.04 near 180 degrees would be multiplied by the modulation
+ * index of an FM operator.
+ */
+namespace Generator {
+    namespace Tone {
+        /** @brief Shapes at() can evaluate: SINE, COSINE, SQUARE, TRIANGLE and SAWTOOTH */
+        inline bool supports(Resonix::Shape shape) {
+            return shape == Resonix::SINE || shape == Resonix::COSINE || shape == Resonix::SQUARE
+                   || shape == Resonix::TRIANGLE || shape == Resonix::SAWTOOTH;
+        }
+
+        /** @brief Fractional part in [0, 1), also for negative positions */
+        inline float wrap(float cycles) {
+            const float fraction = cycles - static_cast<float>(static_cast<int>(cycles));
+            return fraction < 0.0f ? fraction + 1.0f : fraction;
+        }
+
+        /** @brief sin(2 pi cycles), folded onto [-pi/2, pi/2] and evaluated by its Taylor series to x^9 */
+        inline float sine(float cycles) {
+            float half = wrap(cycles + 0.5f) - 0.5f, x, x2;
+
+            half = half > 0.25f ? 0.5f - half : half < -0.25f ? -0.5f - half : half;
+            x = Math::TWO_PI * half;
+            x2 = x * x;
+            return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f + x2 * (1.0f / 362880.0f)))));
+        }
+
+        template <Resonix::Shape S>
+        inline float at(float cycles) {
+            if constexpr (S == Resonix::SINE) {
+                return sine(cycles);
+            } else if constexpr (S == Resonix::COSINE) {
+                return sine(cycles + 0.25f);
+            } else {
+                const float phase = wrap(cycles);
+
+                if constexpr (S == Resonix::SQUARE)
+                    return phase < 0.5f ? 1.0f : -1.0f;
+                else if constexpr (S == Resonix::TRIANGLE)
+                    return phase < 0.5f ? 4.0f * phase - 1.0f : 3.0f - 4.0f * phase;
+                else
+                    return 2.0f * phase - 1.0f;
+            }
+        }
+    }
+}
@@ -1,44 +1,73 @@
 #include "Resonix.hpp"
 #include "Generator.hpp"
 #include "Math.hpp"
+#include "Dispatch.hpp"
+#include "../math/Kernels.hpp"
 
 namespace Generator {
-    std::unique_ptr<float[]> Cosine(int sample_length, float frequency, const float phaseIncrement) {
-        std::unique_ptr<float[]> samples = std::make_unique<float[]>(sample_length * Resonix::SAMPLE_RATE);
-        float t, phase;
-
-        for (int i = 0; i < sample_length * Resonix::SAMPLE_RATE; i++) {
-            t = static_cast<float>(i) / Resonix::SAMPLE_RATE;
-            phase = 2.0f * Math::PI * frequency * t + phaseIncrement;
-            samples[i] = Math::Cosine(phase * 180.0f / Math::PI);
+    RESONIX_CLONES
+    void Cosine(float* output, long long offset, int count, float frequency, const float phaseIncrement) {
+        float start = cycleAt(offset, frequency);
+        float step = frequency / Resonix::SAMPLE_RATE;
+        float phase_degrees = phaseIncrement * 180.0f / Math::PI;
+
+        for (int i = 0; i < count; i++) {
+            output[i] = Math::Kernel::Cosine(360.0f * (start + static_cast<float>(i) * step) + phase_degrees);
+        }
+    }
+
+    Resonix::SampleBuffer Cosine(int sample_length, float frequency, const float phaseIncrement) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
+
+        for (int i = 0; i < total; i += BLOCK_LENGTH) {
+            Cosine(samples.get() + i, i, total - i < BLOCK_LENGTH ? total - i : BLOCK_LENGTH, frequency, phaseIncrement);
         }
 
         return samples;
     }
 
-    std::unique_ptr<float[]> Tangent(int sample_length, float frequency, const float phaseIncrement) {
-        std::unique_ptr<float[]> samples = std::make_unique<float[]>(sample_length * Resonix::SAMPLE_RATE);
-        float t, phase;
+    RESONIX_CLONES
+    void Tangent(float* output, long long offset, int count, float frequency, const float phaseIncrement) {
+        float start = cycleAt(offset, frequency);
+        float step = frequency / Resonix::SAMPLE_RATE;
+        float phase_degrees = phaseIncrement * 180.0f / Math::PI;
 
-        for (int i = 0; i < sample_length * Resonix::SAMPLE_RATE; i++) {
-            t = static_cast<float>(i) / Resonix::SAMPLE_RATE;
-            phase = 2.0f * Math::PI * frequency * t + phaseIncrement;
-            samples[i] = Math::Tangent(phase * 180.0f / Math::PI);
+        for (int i = 0; i < count; i++) {
+            output[i] = Math::Kernel::Tangent(360.0f * (start + static_cast<float>(i) * step) + phase_degrees);
+        }
+    }
+
+    Resonix::SampleBuffer Tangent(int sample_length, float frequency, const float phaseIncrement) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
+
+        for (int i = 0; i < total; i += BLOCK_LENGTH) {
+            Tangent(samples.get() + i, i, total - i < BLOCK_LENGTH ? total - i : BLOCK_LENGTH, frequency, phaseIncrement);
         }
 
         return samples;
     }
 
-    std::unique_ptr<float[]> Cotangent(int sample_length, float frequency, const float phaseIncrement) {
-        std::unique_ptr<float[]> samples = std::make_unique<float[]>(sample_length * Resonix::SAMPLE_RATE);
-        float t, phase;
+    RESONIX_CLONES
+    void Cotangent(float* output, long long offset, int count, float frequency, const float phaseIncrement) {
+        float start = cycleAt(offset, frequency);
+        float step = frequency / Resonix::SAMPLE_RATE;
+        float phase_degrees = phaseIncrement * 180.0f / Math::PI;
+
+        for (int i = 0; i < count; i++) {
+            output[i] = Math::Kernel::Cotangent(360.0f * (start + static_cast<float>(i) * step) + phase_degrees);
+        }
+    }
+
+    Resonix::SampleBuffer Cotangent(int sample_length, float frequency, const float phaseIncrement) {
+        int total = sample_length * Resonix::SAMPLE_RATE;
+        Resonix::SampleBuffer samples = Resonix::allocateSamples(total);
 
-        for (int i = 0; i < sample_length * Resonix::SAMPLE_RATE; i++) {
-            t = static_cast<float>(i) / Resonix::SAMPLE_RATE;
-            phase = 2.0f * Math::PI * frequency * t + phaseIncrement;
-            samples[i] = Math::Cotangent(phase * 180.0f / Math::PI);
+        for (int i = 0; i < total; i += BLOCK_LENGTH) {
+            Cotangent(samples.get() + i, i, total - i < BLOCK_LENGTH ? total - i : BLOCK_LENGTH, frequency, phaseIncrement);
         }
 
         return samples;
     }
-}
\ No newline at end of file
+}
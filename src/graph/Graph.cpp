@@ -0,0 +1,407 @@
+#include <algorithm>
+#include "Graph.hpp"
+#include "Instrument.hpp"
+#include "Oscillator.hpp"
+
+namespace Resonix {
+    struct Graph::Node {
+        enum Kind { OSCILLATOR, INPUT, CONSTANT, BIQUAD, FORMANT, GAIN, MIX, MULTIPLY, DIVIDE };
+
+        Kind kind;
+        std::vector<NodeId> inputs;
+        std::vector<float> gains;
+        std::vector<Node*> consumers;
+        SampleBuffer block;
+        int block_capacity = 0;
+        const float* data = nullptr;
+        std::atomic<int> pending{0};
+
+        Shape shape = SINE;
+        float frequency = 0.0f;
+        unsigned long long seed = 0;
+        std::unique_ptr<Oscillator> oscillator;
+        const float* samples = nullptr;
+        long long length = 0;
+        long long position = 0;
+        Filter::BiquadFilter biquad;
+        Filter::FormantFilter formant;
+    };
+
+#ifdef RESONIX_INSTRUMENT
+    namespace {
+        // Stage names per Node::Kind
+        const char* const STAGE_NAMES[] = {
+            "Graph::oscillator", "Graph::input", "Graph::constant", "Graph::biquad", "Graph::formant",
+            "Graph::gain", "Graph::mix", "Graph::multiply", "Graph::divide"
+        };
+    }
+#endif
+
+    Graph::Graph() : output_(-1), block_count_(0), pool_(nullptr), remaining_(0) {}
+
+    Graph::~Graph() = default;
+
+    int Graph::size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<int>(nodes_.size());
+    }
+
+    // Called with mutex_ held
+    bool Graph::valid(NodeId node) const {
+        return node >= 0 && node < static_cast<int>(nodes_.size());
+    }
+
+    // Inputs are checked under the lock, so a concurrent addNode() cannot change the node count meanwhile
+    Graph::NodeId Graph::addNode(std::unique_ptr<Node> node) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (NodeId input : node->inputs) {
+            if (!valid(input))
+                return -1;
+        }
+
+        nodes_.push_back(std::move(node));
+        output_ = static_cast<NodeId>(nodes_.size()) - 1;
+        return output_;
+    }
+
+    Graph::NodeId Graph::addOscillator(Shape shape, float frequency) {
+        if (frequency <= 0.0f)
+            return -1;
+
+        auto node = std::make_unique<Node>();
+        node->kind = Node::OSCILLATOR;
+        node->shape = shape;
+        node->frequency = frequency;
+
+        return addNode(std::move(node));
+    }
+
+    Graph::NodeId Graph::addNoise(Shape shape, unsigned long long seed) {
+        if (!isNoise(shape))
+            return -1;
+
+        auto node = std::make_unique<Node>();
+        node->kind = Node::OSCILLATOR;
+        node->shape = shape;
+        node->seed = seed;
+
+        return addNode(std::move(node));
+    }
+
+    Graph::NodeId Graph::addInput(const float* samples, long long length) {
+        if (!samples || length <= 0)
+            return -1;
+
+        auto node = std::make_unique<Node>();
+        node->kind = Node::INPUT;
+        node->samples = samples;
+        node->length = length;
+
+        return addNode(std::move(node));
+    }
+
+    Graph::NodeId Graph::addConstant(float value) {
+        auto node = std::make_unique<Node>();
+        node->kind = Node::CONSTANT;
+        node->gains = {value};
+
+        return addNode(std::move(node));
+    }
+
+    Graph::NodeId Graph::addLowpass(NodeId input, float cutoff_hz, float resonance) {
+        if (cutoff_hz <= 0.0f || resonance <= 0.0f)
+            return -1;
+
+        auto node = std::make_unique<Node>();
+        node->kind = Node::BIQUAD;
+        node->inputs = {input};
+        node->biquad = Filter::make_lowpass_filter(cutoff_hz, resonance);
+
+        return addNode(std::move(node));
+    }
+
+    Graph::NodeId Graph::addHighpass(NodeId input, float cutoff_hz, float resonance) {
+        if (cutoff_hz <= 0.0f || resonance <= 0.0f)
+            return -1;
+
+        auto node = std::make_unique<Node>();
+        node->kind = Node::BIQUAD;
+        node->inputs = {input};
+        node->biquad = Filter::make_highpass_filter(cutoff_hz, resonance);
+
+        return addNode(std::move(node));
+    }
+
+    Graph::NodeId Graph::addBandpass(NodeId input, float center_hz, float bandwidth_hz, float resonance) {
+        if (center_hz <= 0.0f || bandwidth_hz <= 0.0f)
+            return -1;
+
+        auto node = std::make_unique<Node>();
+        node->kind = Node::BIQUAD;
+        node->inputs = {input};
+        node->biquad = Filter::make_bandpass_filter(center_hz, bandwidth_hz, resonance);
+
+        return addNode(std::move(node));
+    }
+
+    Graph::NodeId Graph::addFormant(NodeId input, float peak, float mix, float spread) {
+        auto node = std::make_unique<Node>();
+        node->kind = Node::FORMANT;
+        node->inputs = {input};
+        node->formant.setup(peak, mix, spread);
+
+        return addNode(std::move(node));
+    }
+
+    Graph::NodeId Graph::addGain(NodeId input, float gain) {
+        auto node = std::make_unique<Node>();
+        node->kind = Node::GAIN;
+        node->inputs = {input};
+        node->gains = {gain};
+
+        return addNode(std::move(node));
+    }
+
+    Graph::NodeId Graph::addMix(const std::vector<NodeId>& inputs, const std::vector<float>& gains) {
+        if (inputs.empty() || inputs.size() != gains.size())
+            return -1;
+
+        auto node = std::make_unique<Node>();
+        node->kind = Node::MIX;
+        node->inputs = inputs;
+        node->gains = gains;
+
+        return addNode(std::move(node));
+    }
+
+    Graph::NodeId Graph::addMultiply(NodeId left, NodeId right) {
+        auto node = std::make_unique<Node>();
+        node->kind = Node::MULTIPLY;
+        node->inputs = {left, right};
+
+        return addNode(std::move(node));
+    }
+
+    Graph::NodeId Graph::addDivide(NodeId left, NodeId right) {
+        auto node = std::make_unique<Node>();
+        node->kind = Node::DIVIDE;
+        node->inputs = {left, right};
+
+        return addNode(std::move(node));
+    }
+
+    bool Graph::setOutput(NodeId node) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!valid(node))
+            return false;
+        output_ = node;
+        return true;
+    }
+
+    void Graph::process(Node& node, int count) {
+        float* out = node.block.get();
+        const float *in, *other;
+        float gain;
+        long long available;
+        size_t k;
+        int i;
+
+        RESONIX_PROFILE(STAGE_NAMES[node.kind], count);
+
+        switch (node.kind) {
+            case Node::OSCILLATOR:
+                node.oscillator->render(out, count);
+                break;
+            case Node::INPUT:
+                available = node.length - node.position;
+                if (available >= count) {
+                    // Whole block inside the buffer: hand it out without copying
+                    node.data = node.samples + node.position;
+                    node.position += count;
+                    return;
+                }
+                for (i = 0; i < count; i++) {
+                    out[i] = i < available ? node.samples[node.position + i] : 0.0f;
+                }
+                node.position += count;
+                break;
+            case Node::CONSTANT:
+                break;
+            case Node::BIQUAD:
+                node.biquad.process(nodes_[static_cast<size_t>(node.inputs[0])]->data, out, count);
+                break;
+            case Node::FORMANT:
+                node.formant.process(nodes_[static_cast<size_t>(node.inputs[0])]->data, out, count);
+                break;
+            case Node::GAIN:
+                in = nodes_[static_cast<size_t>(node.inputs[0])]->data;
+                gain = node.gains[0];
+                for (i = 0; i < count; i++) {
+                    out[i] = in[i] * gain;
+                }
+                break;
+            case Node::MIX:
+                in = nodes_[static_cast<size_t>(node.inputs[0])]->data;
+                gain = node.gains[0];
+                for (i = 0; i < count; i++) {
+                    out[i] = in[i] * gain;
+                }
+                for (k = 1; k < node.inputs.size(); k++) {
+                    in = nodes_[static_cast<size_t>(node.inputs[k])]->data;
+                    gain = node.gains[k];
+                    for (i = 0; i < count; i++) {
+                        out[i] += in[i] * gain;
+                    }
+                }
+                break;
+            case Node::MULTIPLY:
+                in = nodes_[static_cast<size_t>(node.inputs[0])]->data;
+                other = nodes_[static_cast<size_t>(node.inputs[1])]->data;
+                for (i = 0; i < count; i++) {
+                    out[i] = in[i] * other[i];
+                }
+                break;
+            case Node::DIVIDE:
+                in = nodes_[static_cast<size_t>(node.inputs[0])]->data;
+                other = nodes_[static_cast<size_t>(node.inputs[1])]->data;
+                for (i = 0; i < count; i++) {
+                    out[i] = in[i] / other[i];
+                }
+                break;
+        }
+
+        node.data = out;
+    }
+
+    void Graph::runTask(Node& node) {
+        process(node, block_count_);
+
+        for (Node* consumer : node.consumers) {
+            if (consumer->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                pool_->submit([this, consumer] { runTask(*consumer); });
+        }
+
+        remaining_.fetch_sub(1, std::memory_order_release);
+    }
+
+    bool Graph::render(long long frames, const BlockCallback& sink, int block_size, ThreadPool* pool) {
+        std::vector<bool> needed;
+        std::vector<Node*> sources;
+        Node* output;
+        long long done;
+        int id, sources_count;
+
+        RESONIX_PROFILE("Graph::render", frames);
+        MemoryTag tag("Graph::render");
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!valid(output_) || frames <= 0)
+            return false;
+
+        if (block_size < MIN_BLOCK_SIZE) block_size = MIN_BLOCK_SIZE;
+        if (block_size > MAX_BLOCK_SIZE) block_size = MAX_BLOCK_SIZE;
+
+        // Mark everything the output depends on; ids are topologically ordered
+        needed.assign(nodes_.size(), false);
+        needed[static_cast<size_t>(output_)] = true;
+        for (id = output_; id >= 0; id--) {
+            if (!needed[static_cast<size_t>(id)])
+                continue;
+            for (NodeId input : nodes_[static_cast<size_t>(id)]->inputs) {
+                needed[static_cast<size_t>(input)] = true;
+            }
+        }
+
+        active_.clear();
+        for (id = 0; id <= output_; id++) {
+            Node& node = *nodes_[static_cast<size_t>(id)];
+
+            node.consumers.clear();
+            if (!needed[static_cast<size_t>(id)])
+                continue;
+
+            if (node.block_capacity < block_size) {
+                node.block = allocateSamples(static_cast<size_t>(block_size));
+                node.block_capacity = node.block ? block_size : 0;
+                if (!node.block)
+                    return false;
+            }
+            std::fill(node.block.get(), node.block.get() + block_size, node.kind == Node::CONSTANT ? node.gains[0] : 0.0f);
+            node.data = node.block.get();
+            node.position = 0;
+            node.biquad.clear();
+            node.formant.reset();
+            if (node.kind == Node::OSCILLATOR)
+                node.oscillator = std::make_unique<Oscillator>(node.shape, node.frequency, frames, node.seed);
+
+            for (NodeId input : node.inputs) {
+                nodes_[static_cast<size_t>(input)]->consumers.push_back(&node);
+            }
+            active_.push_back(&node);
+        }
+
+        sources_count = 0;
+        for (Node* node : active_) {
+            if (!node->inputs.empty())
+                continue;
+            sources.push_back(node);
+            if (node->kind != Node::CONSTANT)
+                sources_count++;
+        }
+
+        // A single chain has nothing to run concurrently
+        pool_ = pool ? pool : &ThreadPool::global();
+        if (sources_count < 2 || pool_->size() < 2)
+            pool_ = nullptr;
+
+        output = nodes_[static_cast<size_t>(output_)].get();
+
+        for (done = 0; done < frames; done += block_count_) {
+            block_count_ = static_cast<int>(frames - done < block_size ? frames - done : block_size);
+
+            if (!pool_) {
+                for (Node* node : active_) {
+                    process(*node, block_count_);
+                }
+            } else {
+                for (Node* node : active_) {
+                    node->pending.store(static_cast<int>(node->inputs.size()), std::memory_order_relaxed);
+                }
+                remaining_.store(static_cast<int>(active_.size()), std::memory_order_relaxed);
+
+                for (Node* source : sources) {
+                    pool_->submit([this, source] { runTask(*source); });
+                }
+                pool_->wait(remaining_);
+            }
+
+            sink(output->data, block_count_);
+        }
+
+        return true;
+    }
+
+    Resonix::SampleBuffer Graph::render(int frames, int block_size, ThreadPool* pool) {
+        MemoryTag tag("Graph::render");
+
+        if (frames <= 0 || size() == 0)
+            return nullptr;
+
+        auto samples = Resonix::allocateSamples(frames);
+        float* cursor = samples.get();
+        auto copy = [&cursor](const float* block, int count) {
+            for (int i = 0; i < count; i++) {
+                cursor[i] = block[i];
+            }
+            cursor += count;
+        };
+
+        // render() checks the output node again under the lock
+        if (!samples || !render(static_cast<long long>(frames), copy, block_size, pool))
+            return nullptr;
+
+        return samples;
+    }
+}
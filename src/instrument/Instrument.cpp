@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <cstdio>
+#include "Instrument.hpp"
+
+#ifdef RESONIX_INSTRUMENT
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <unordered_map>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace Resonix {
+#ifdef RESONIX_INSTRUMENT
+    namespace {
+        using SteadyClock = std::chrono::steady_clock;
+
+        // Per-thread open-addressed table of stages, keyed by the address of the name
+        constexpr size_t SITE_COUNT = 256;
+
+        // Cycle counter where there is one, otherwise nanoseconds
+        inline uint64_t readTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#elif defined(__aarch64__)
+            uint64_t value;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+            return value;
+#else
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                SteadyClock::now().time_since_epoch()).count());
+#endif
+        }
+
+        struct Origin {
+            uint64_t ticks;
+            SteadyClock::time_point time;
+        };
+
+        const Origin& origin() {
+            static const Origin value = {readTicks(), SteadyClock::now()};
+            return value;
+        }
+
+        // Counters are written only by the owning thread, so relaxed load-add-store suffices
+        void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        struct Site {
+            std::atomic<const char*> name{nullptr};
+            std::atomic<uint64_t> calls{0};
+            std::atomic<uint64_t> frames{0};
+            std::atomic<uint64_t> bytes{0};
+            std::atomic<uint64_t> ticks{0};
+            std::atomic<uint64_t> max_ticks{0};
+        };
+
+        struct Event {
+            const char* name;
+            uint64_t start;
+            uint64_t ticks;
+            long long frames;
+        };
+
+        struct ThreadLog {
+            int id = 0;
+            std::atomic<bool> in_use{true};
+            Site sites[SITE_COUNT];
+            std::unique_ptr<Event[]> events;
+            std::atomic<size_t> event_count{0};
+
+            Site* find(const char* name) {
+                size_t slot = (reinterpret_cast<uintptr_t>(name) >> 3) * 0x9E3779B97F4A7C15ull % SITE_COUNT;
+
+                for (size_t probe = 0; probe < SITE_COUNT; probe++, slot = (slot + 1) % SITE_COUNT) {
+                    const char* current = sites[slot].name.load(std::memory_order_relaxed);
+
+                    if (current == name)
+                        return &sites[slot];
+                    if (!current) {
+                        sites[slot].name.store(name, std::memory_order_release);
+                        return &sites[slot];
+                    }
+                }
+                return nullptr;
+            }
+
+            void record(const char* name, uint64_t start, uint64_t ticks, long long frames) {
+                const size_t count = event_count.load(std::memory_order_relaxed);
+
+                if (count >= Instrument::TRACE_CAPACITY)
+                    return;
+                if (!events)
+                    events.reset(new (std::nothrow) Event[Instrument::TRACE_CAPACITY]);
+                if (!events)
+                    return;
+
+                events[count] = {name, start, ticks, frames};
+                event_count.store(count + 1, std::memory_order_release);
+            }
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadLog>> logs;
+        };
+
+        // Leaked on purpose: worker threads may still close scopes during static destruction
+        Registry& registry() {
+            static Registry* value = new Registry();
+            return *value;
+        }
+
+        std::atomic<bool> tracing{false};
+
+        // Hands the log back for reuse when its thread exits
+        struct LogHandle {
+            ThreadLog* log = nullptr;
+
+            ~LogHandle() {
+                if (log)
+                    log->in_use.store(false, std::memory_order_release);
+            }
+        };
+
+        thread_local LogHandle log_handle;
+        thread_local Instrument::Scope* current_scope = nullptr;
+
+        ThreadLog& threadLog() {
+            if (!log_handle.log) {
+                Registry& logs = registry();
+                std::lock_guard<std::mutex> lock(logs.mutex);
+
+                for (const std::unique_ptr<ThreadLog>& log : logs.logs) {
+                    bool idle = false;
+                    if (log->in_use.compare_exchange_strong(idle, true, std::memory_order_acquire)) {
+                        log_handle.log = log.get();
+                        break;
+                    }
+                }
+                if (!log_handle.log) {
+                    logs.logs.push_back(std::make_unique<ThreadLog>());
+                    logs.logs.back()->id = static_cast<int>(logs.logs.size());
+                    log_handle.log = logs.logs.back().get();
+                }
+            }
+            return *log_handle.log;
+        }
+
+        // Nanoseconds per tick, measured against the steady clock since the first scope
+        double tickPeriod() {
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+            const Origin& start = origin();
+            SteadyClock::time_point now = SteadyClock::now();
+
+            // A short baseline would make the ratio noisy
+            if (now - start.time < std::chrono::milliseconds(10)) {
+                std::this_thread::sleep_until(start.time + std::chrono::milliseconds(10));
+                now = SteadyClock::now();
+            }
+
+            const uint64_t ticks = readTicks() - start.ticks;
+            return ticks ? std::chrono::duration<double, std::nano>(now - start.time).count() / static_cast<double>(ticks) : 1.0;
+#else
+            return 1.0;
+#endif
+        }
+    }
+
+    namespace Instrument {
+        Scope::Scope(const char* name, long long frames)
+            : name_(name), frames_(frames), bytes_(0), parent_(current_scope) {
+            current_scope = this;
+            start_ = readTicks();
+        }
+
+        Scope::~Scope() {
+            const uint64_t ticks = readTicks() - start_;
+            ThreadLog& log = threadLog();
+            Site* site = log.find(name_);
+
+            current_scope = parent_;
+            if (parent_)
+                parent_->bytes_ += bytes_;
+
+            if (site) {
+                bump(site->calls, 1);
+                bump(site->frames, frames_ > 0 ? static_cast<uint64_t>(frames_) : 0);
+                bump(site->bytes, bytes_);
+                bump(site->ticks, ticks);
+                if (ticks > site->max_ticks.load(std::memory_order_relaxed))
+                    site->max_ticks.store(ticks, std::memory_order_relaxed);
+            }
+
+            if (tracing.load(std::memory_order_relaxed))
+                log.record(name_, start_, ticks, frames_);
+        }
+
+        void Scope::addBytes(size_t bytes) {
+            if (current_scope)
+                current_scope->bytes_ += bytes;
+        }
+    }
+
+    Stats stats() {
+        const double period = tickPeriod() * 1e-6;
+        std::unordered_map<std::string, size_t> index;
+        Registry& logs = registry();
+        Stats result;
+
+        result.enabled = true;
+
+        {
+            std::lock_guard<std::mutex> lock(logs.mutex);
+
+            for (const std::unique_ptr<ThreadLog>& log : logs.logs) {
+                for (const Site& site : log->sites) {
+                    const char* name = site.name.load(std::memory_order_acquire);
+                    const uint64_t calls = site.calls.load(std::memory_order_relaxed);
+
+                    if (!name || !calls)
+                        continue;
+
+                    // The same literal may live at different addresses in different translation units
+                    auto inserted = index.emplace(name, result.stages.size());
+                    if (inserted.second) {
+                        result.stages.emplace_back();
+                        result.stages.back().name = name;
+                    }
+
+                    StageStats& stage = result.stages[inserted.first->second];
+                    stage.calls += calls;
+                    stage.frames += site.frames.load(std::memory_order_relaxed);
+                    stage.bytes += site.bytes.load(std::memory_order_relaxed);
+                    stage.total_ms += static_cast<double>(site.ticks.load(std::memory_order_relaxed)) * period;
+                    stage.max_ms = std::max(stage.max_ms, static_cast<double>(site.max_ticks.load(std::memory_order_relaxed)) * period);
+                }
+            }
+        }
+
+        std::sort(result.stages.begin(), result.stages.end(), [](const StageStats& a, const StageStats& b) {
+            return a.total_ms > b.total_ms;
+        });
+        return result;
+    }
+
+    void resetStats() {
+        Registry& logs = registry();
+        std::lock_guard<std::mutex> lock(logs.mutex);
+
+        for (const std::unique_ptr<ThreadLog>& log : logs.logs) {
+            for (Site& site : log->sites) {
+                site.calls.store(0, std::memory_order_relaxed);
+                site.frames.store(0, std::memory_order_relaxed);
+                site.bytes.store(0, std::memory_order_relaxed);
+                site.ticks.store(0, std::memory_order_relaxed);
+                site.max_ticks.store(0, std::memory_order_relaxed);
+            }
+            log->event_count.store(0, std::memory_order_release);
+        }
+    }
+
+    void setTracing(bool enabled) {
+        origin();
+        tracing.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool writeTrace(const std::string& path) {
+        const double period = tickPeriod() * 1e-3;
+        const uint64_t start = origin().ticks;
+        Registry& logs = registry();
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        bool first = true;
+
+        if (!file)
+            return false;
+
+        std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+
+        {
+            std::lock_guard<std::mutex> lock(logs.mutex);
+
+            for (const std::unique_ptr<ThreadLog>& log : logs.logs) {
+                const size_t count = log->event_count.load(std::memory_order_acquire);
+
+                std::fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                             first ? "" : ",", log->id, log->id);
+                first = false;
+
+                for (size_t i = 0; i < count; i++) {
+                    const Event& event = log->events[i];
+
+                    // Stage names are identifiers, nothing in them needs escaping
+                    std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"resonix\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                                       "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frames\":%lld}}",
+                                 event.name, log->id, static_cast<double>(static_cast<int64_t>(event.start - start)) * period,
+                                 static_cast<double>(event.ticks) * period, event.frames);
+                }
+            }
+        }
+
+        std::fputs("\n]}\n", file);
+        return std::fclose(file) == 0;
+    }
+#else
+    Stats stats() {
+        return Stats();
+    }
+
+    void resetStats() {}
+
+    void setTracing(bool) {}
+
+    bool writeTrace(const std::string&) {
+        return false;
+    }
+#endif
+}
@@ -0,0 +1,293 @@
+#include <cstdint>
+#include <cstring>
+#include "AudioFile.hpp"
+#include "Instrument.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RESONIX_HAS_MMAP 1
+#endif
+
+namespace Resonix {
+    namespace {
+        constexpr unsigned FORMAT_PCM = 1;
+        constexpr unsigned FORMAT_IEEE_FLOAT = 3;
+        constexpr unsigned FORMAT_EXTENSIBLE = 0xFFFE;
+        constexpr unsigned long long U32_LIMIT = 0xFFFFFFFFull;
+
+        unsigned get16(const unsigned char* in) {
+            return static_cast<unsigned>(in[0]) | static_cast<unsigned>(in[1]) << 8;
+        }
+
+        unsigned long long get32(const unsigned char* in) {
+            unsigned long long value = 0;
+            for (int i = 3; i >= 0; i--) {
+                value = value << 8 | in[i];
+            }
+            return value;
+        }
+
+        unsigned long long get64(const unsigned char* in) {
+            return get32(in) | get32(in + 4) << 32;
+        }
+    }
+
+    AudioFileReader::AudioFileReader()
+        : file_data_(nullptr),
+          file_size_(0),
+          mapped_(false),
+          data_(nullptr),
+          channels_(0),
+          sample_rate_(0),
+          format_(FLOAT32),
+          frames_(0) {}
+
+    AudioFileReader::~AudioFileReader() {
+        close();
+    }
+
+    bool AudioFileReader::map(const std::string& path) {
+        close();
+
+#ifdef RESONIX_HAS_MMAP
+        struct stat info;
+        void* memory;
+        int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+            return false;
+
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        memory = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping keeps the file referenced
+        ::close(fd);
+        if (memory == MAP_FAILED)
+            return false;
+
+        file_data_ = static_cast<const unsigned char*>(memory);
+        file_size_ = static_cast<size_t>(info.st_size);
+        mapped_ = true;
+        return true;
+#else
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        long size;
+        void* memory;
+
+        if (!file)
+            return false;
+
+        if (std::fseek(file, 0, SEEK_END) != 0 || (size = std::ftell(file)) <= 0 || std::fseek(file, 0, SEEK_SET) != 0) {
+            std::fclose(file);
+            return false;
+        }
+
+        MemoryTag tag("AudioFileReader::open");
+        memory = BufferPool::global().allocate(static_cast<size_t>(size));
+        if (!memory || std::fread(memory, 1, static_cast<size_t>(size), file) != static_cast<size_t>(size)) {
+            BufferPool::release(memory);
+            std::fclose(file);
+            return false;
+        }
+        std::fclose(file);
+
+        file_data_ = static_cast<const unsigned char*>(memory);
+        file_size_ = static_cast<size_t>(size);
+        mapped_ = false;
+        return true;
+#endif
+    }
+
+    bool AudioFileReader::open(const std::string& path) {
+        if (!map(path))
+            return false;
+
+        if (!parseWav()) {
+            close();
+            return false;
+        }
+
+        advise(ACCESS_SEQUENTIAL);
+        return true;
+    }
+
+    bool AudioFileReader::openRaw(const std::string& path, int channels, SampleFormat format, int sample_rate) {
+        if (channels <= 0 || sample_rate <= 0 || !map(path))
+            return false;
+
+        data_ = file_data_;
+        channels_ = channels;
+        sample_rate_ = sample_rate;
+        format_ = format;
+        frames_ = static_cast<long long>(file_size_ / static_cast<size_t>(channels * bytesPerSample(format)));
+
+        advise(ACCESS_SEQUENTIAL);
+        return true;
+    }
+
+    bool AudioFileReader::parseWav() {
+        const unsigned char* end = file_data_ + file_size_;
+        const unsigned char* p;
+        const unsigned char* format_chunk = nullptr;
+        const unsigned char* data = nullptr;
+        unsigned long long size, data_size = 0, ds64_data_size = 0;
+        unsigned tag, bits;
+        bool rf64;
+
+        if (file_size_ < 12 || std::memcmp(file_data_ + 8, "WAVE", 4) != 0)
+            return false;
+
+        if (std::memcmp(file_data_, "RIFF", 4) == 0)
+            rf64 = false;
+        else if (std::memcmp(file_data_, "RF64", 4) == 0)
+            rf64 = true;
+        else
+            return false;
+
+        for (p = file_data_ + 12; end - p >= 8; p += 8 + size + (size & 1)) {
+            size = get32(p + 4);
+
+            // The data chunk may be cut short (see below); every other chunk must fit before it is read
+            if (std::memcmp(p, "data", 4) == 0) {
+                data = p + 8;
+                data_size = rf64 && size == U32_LIMIT ? ds64_data_size : size;
+                break;
+            }
+
+            if (size > static_cast<unsigned long long>(end - p) - 8)
+                return false;
+
+            if (std::memcmp(p, "ds64", 4) == 0 && size >= 24)
+                ds64_data_size = get64(p + 16);
+            else if (std::memcmp(p, "fmt ", 4) == 0 && size >= 16)
+                format_chunk = p + 8;
+        }
+
+        if (!format_chunk || !data)
+            return false;
+
+        tag = get16(format_chunk);
+        channels_ = static_cast<int>(get16(format_chunk + 2));
+        sample_rate_ = static_cast<int>(get32(format_chunk + 4));
+        bits = get16(format_chunk + 14);
+
+        // WAVE_FORMAT_EXTENSIBLE stores the real tag at the start of the sub-format GUID
+        if (tag == FORMAT_EXTENSIBLE && get32(format_chunk - 4) >= 40)
+            tag = get16(format_chunk + 24);
+
+        if (tag == FORMAT_IEEE_FLOAT && bits == 32)
+            format_ = FLOAT32;
+        else if (tag == FORMAT_IEEE_FLOAT && bits == 16)
+            format_ = FLOAT16;
+        else if (tag == FORMAT_PCM && bits == 16)
+            format_ = INT16;
+        else if (tag == FORMAT_PCM && bits == 24)
+            format_ = INT24;
+        else
+            return false;
+
+        if (channels_ <= 0 || sample_rate_ <= 0)
+            return false;
+
+        // Recordings cut off mid-write still open with the frames that made it to disk
+        if (data_size > static_cast<unsigned long long>(end - data))
+            data_size = static_cast<unsigned long long>(end - data);
+
+        data_ = data;
+        frames_ = static_cast<long long>(data_size / static_cast<unsigned long long>(channels_ * bytesPerSample(format_)));
+        return true;
+    }
+
+    void AudioFileReader::close() {
+        if (file_data_) {
+#ifdef RESONIX_HAS_MMAP
+            if (mapped_)
+                munmap(const_cast<unsigned char*>(file_data_), file_size_);
+#endif
+            if (!mapped_)
+                BufferPool::release(const_cast<unsigned char*>(file_data_));
+        }
+
+        file_data_ = nullptr;
+        file_size_ = 0;
+        mapped_ = false;
+        data_ = nullptr;
+        channels_ = 0;
+        sample_rate_ = 0;
+        frames_ = 0;
+    }
+
+    ConstSampleSpan AudioFileReader::samples() const {
+        if (!data_ || format_ != FLOAT32 || reinterpret_cast<uintptr_t>(data_) % alignof(float) != 0)
+            return ConstSampleSpan();
+
+        return ConstSampleSpan(reinterpret_cast<const float*>(data_), frames_ * channels_);
+    }
+
+    long long AudioFileReader::read(long long offset, long long frames, float* output) const {
+        RESONIX_PROFILE("AudioFileReader::read", frames);
+
+        if (!data_ || !output || offset < 0 || frames < 0)
+            return -1;
+
+        if (offset >= frames_)
+            return 0;
+        if (frames > frames_ - offset)
+            frames = frames_ - offset;
+
+        decodeSamples(data_ + offset * channels_ * bytesPerSample(format_), frames * channels_, 1, format_, output);
+        return frames;
+    }
+
+    long long AudioFileReader::readChannel(int channel, long long offset, long long frames, float* output) const {
+        RESONIX_PROFILE("AudioFileReader::readChannel", frames);
+
+        if (!data_ || !output || channel < 0 || channel >= channels_ || offset < 0 || frames < 0)
+            return -1;
+
+        if (offset >= frames_)
+            return 0;
+        if (frames > frames_ - offset)
+            frames = frames_ - offset;
+
+        decodeSamples(data_ + (offset * channels_ + channel) * bytesPerSample(format_), frames, channels_, format_, output);
+        return frames;
+    }
+
+    void AudioFileReader::advise(Access access) const {
+#ifdef RESONIX_HAS_MMAP
+        int advice = access == ACCESS_SEQUENTIAL ? MADV_SEQUENTIAL : access == ACCESS_RANDOM ? MADV_RANDOM : MADV_NORMAL;
+
+        if (mapped_)
+            madvise(const_cast<unsigned char*>(file_data_), file_size_, advice);
+#endif
+    }
+
+    void AudioFileReader::release(long long offset, long long frames) const {
+#ifdef RESONIX_HAS_MMAP
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t frame_bytes = static_cast<size_t>(channels_ * bytesPerSample(format_));
+        size_t first, last;
+
+        if (!mapped_ || offset < 0 || frames <= 0)
+            return;
+
+        // Only pages entirely inside the range, so neighbouring frames stay mapped
+        first = static_cast<size_t>(data_ - file_data_) + static_cast<size_t>(offset) * frame_bytes;
+        last = first + static_cast<size_t>(frames) * frame_bytes;
+        if (last > file_size_)
+            last = file_size_;
+        first = (first + page - 1) / page * page;
+        last = last / page * page;
+
+        if (first < last)
+            madvise(const_cast<unsigned char*>(file_data_) + first, last - first, MADV_DONTNEED);
+#endif
+    }
+}
@@ -0,0 +1,335 @@
+#include <cstring>
+#include "AudioFile.hpp"
+#include "Instrument.hpp"
+
+namespace Resonix {
+    namespace {
+        constexpr unsigned short FORMAT_PCM = 1;
+        constexpr unsigned short FORMAT_IEEE_FLOAT = 3;
+        constexpr unsigned long long U32_LIMIT = 0xFFFFFFFFull;
+        // Samples interleaved per step when writing a planar buffer
+        constexpr long long INTERLEAVE_SAMPLES = 8192;
+
+        void put16(unsigned char* out, unsigned value) {
+            out[0] = static_cast<unsigned char>(value);
+            out[1] = static_cast<unsigned char>(value >> 8);
+        }
+
+        void put32(unsigned char* out, unsigned long long value) {
+            for (int i = 0; i < 4; i++) {
+                out[i] = static_cast<unsigned char>(value >> (8 * i));
+            }
+        }
+
+        void put64(unsigned char* out, unsigned long long value) {
+            for (int i = 0; i < 8; i++) {
+                out[i] = static_cast<unsigned char>(value >> (8 * i));
+            }
+        }
+
+        /*
+         * RIFF/RF64 header of exactly AudioFileWriter::WAV_HEADER_BYTES:
+         *   RIFF|RF64, JUNK|ds64 (28 bytes, reserved for the RF64 sizes),
+         *   fmt, fact, JUNK padding, data.
+         * Files over 4 GiB turn the reserved JUNK chunk into ds64 and store
+         * 0xFFFFFFFF in the 32-bit size fields.
+         */
+        void buildWavHeader(unsigned char* header, int channels, int sample_rate, int bits, unsigned short format_tag,
+                            unsigned long long data_bytes) {
+            const int header_bytes = AudioFileWriter::WAV_HEADER_BYTES;
+            const unsigned block_align = static_cast<unsigned>(channels * bits / 8);
+            // An odd data chunk is followed by a pad byte, which counts towards the RIFF size but not the data size
+            const unsigned long long riff_bytes = static_cast<unsigned long long>(header_bytes) - 8 + data_bytes + (data_bytes & 1);
+            const unsigned long long frames = data_bytes / block_align;
+            const bool rf64 = riff_bytes > U32_LIMIT;
+            unsigned char* p = header;
+
+            std::memset(header, 0, static_cast<size_t>(header_bytes));
+
+            std::memcpy(p, rf64 ? "RF64" : "RIFF", 4);
+            put32(p + 4, rf64 ? U32_LIMIT : riff_bytes);
+            std::memcpy(p + 8, "WAVE", 4);
+            p += 12;
+
+            std::memcpy(p, rf64 ? "ds64" : "JUNK", 4);
+            put32(p + 4, 28);
+            if (rf64) {
+                put64(p + 8, riff_bytes);
+                put64(p + 16, data_bytes);
+                put64(p + 24, frames);
+            }
+            p += 36;
+
+            std::memcpy(p, "fmt ", 4);
+            put32(p + 4, 16);
+            put16(p + 8, format_tag);
+            put16(p + 10, static_cast<unsigned>(channels));
+            put32(p + 12, static_cast<unsigned long long>(sample_rate));
+            put32(p + 16, static_cast<unsigned long long>(sample_rate) * block_align);
+            put16(p + 20, block_align);
+            put16(p + 22, static_cast<unsigned>(bits));
+            p += 24;
+
+            std::memcpy(p, "fact", 4);
+            put32(p + 4, 4);
+            put32(p + 8, rf64 ? U32_LIMIT : frames);
+            p += 12;
+
+            // Pads the header so the data chunk payload starts at header_bytes
+            std::memcpy(p, "JUNK", 4);
+            put32(p + 4, static_cast<unsigned long long>(header + header_bytes - 8 - (p + 8)));
+
+            p = header + header_bytes - 8;
+            std::memcpy(p, "data", 4);
+            put32(p + 4, rf64 ? U32_LIMIT : data_bytes);
+        }
+    }
+
+    AudioFileWriter::AudioFileWriter()
+        : file_(nullptr),
+          format_(WAV),
+          sample_format_(FLOAT32),
+          dithered_(false),
+          channels_(0),
+          sample_rate_(0),
+          samples_written_(0),
+          current_{nullptr, 0},
+          chunk_bytes_(0),
+          stopping_(false),
+          failed_(false) {}
+
+    AudioFileWriter::~AudioFileWriter() {
+        close();
+    }
+
+    bool AudioFileWriter::isOpen() const {
+        std::lock_guard<std::mutex> lock(call_mutex_);
+        return file_ != nullptr;
+    }
+
+    int AudioFileWriter::channels() const {
+        std::lock_guard<std::mutex> lock(call_mutex_);
+        return channels_;
+    }
+
+    SampleFormat AudioFileWriter::sampleFormat() const {
+        std::lock_guard<std::mutex> lock(call_mutex_);
+        return sample_format_;
+    }
+
+    long long AudioFileWriter::framesWritten() const {
+        std::lock_guard<std::mutex> lock(call_mutex_);
+        return samples_written_ / (channels_ > 0 ? channels_ : 1);
+    }
+
+    bool AudioFileWriter::open(const std::string& path, int channels, int sample_rate, FileFormat format,
+                               SampleFormat sample_format, bool dither, unsigned long long dither_seed) {
+        std::lock_guard<std::mutex> lock(call_mutex_);
+
+        if (file_ || channels <= 0 || channels > 0xFFFF || sample_rate <= 0)
+            return false;
+
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_)
+            return false;
+
+        // Chunks are already large, so stdio buffering would only add a copy
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+
+        format_ = format;
+        sample_format_ = sample_format;
+        dither_ = {dither_seed, 0};
+        dithered_ = dither;
+        channels_ = channels;
+        sample_rate_ = sample_rate;
+        samples_written_ = 0;
+        stopping_ = false;
+        failed_ = false;
+        chunk_bytes_ = static_cast<size_t>(CHUNK_SAMPLES) * static_cast<size_t>(bytesPerSample(sample_format));
+        scratch_.resize(static_cast<size_t>(INTERLEAVE_SAMPLES / channels > 0 ? INTERLEAVE_SAMPLES / channels * channels : channels));
+
+        MemoryTag tag("AudioFileWriter::open");
+        for (int i = 0; i < CHUNK_COUNT; i++) {
+            auto* bytes = static_cast<unsigned char*>(BufferPool::global().allocate(chunk_bytes_));
+            if (!bytes) {
+                failed_ = true;
+                closeLocked();
+                return false;
+            }
+            storage_.push_back(bytes);
+        }
+
+        current_ = {storage_[0], 0};
+        free_.assign(storage_.begin() + 1, storage_.end());
+
+        if (format_ == WAV && !writeHeader(false)) {
+            failed_ = true;
+            closeLocked();
+            return false;
+        }
+
+        thread_ = std::thread(&AudioFileWriter::writerLoop, this);
+        return true;
+    }
+
+    bool AudioFileWriter::write(const float* samples, long long frames) {
+        std::lock_guard<std::mutex> lock(call_mutex_);
+        return append(samples, frames);
+    }
+
+    bool AudioFileWriter::append(const float* samples, long long frames) {
+        const size_t sample_bytes = static_cast<size_t>(bytesPerSample(sample_format_));
+        size_t remaining, count;
+
+        RESONIX_PROFILE("AudioFileWriter::write", frames);
+
+        if (!file_ || failed_.load() || !samples || frames < 0)
+            return false;
+
+        // Chunks hold whole samples, so every piece is encoded straight into place
+        remaining = static_cast<size_t>(frames) * static_cast<size_t>(channels_);
+        while (remaining > 0) {
+            count = (chunk_bytes_ - current_.size) / sample_bytes;
+            if (count > remaining)
+                count = remaining;
+            encodeSamples(samples, static_cast<long long>(count), sample_format_, current_.bytes + current_.size, dithered_ ? &dither_ : nullptr);
+            current_.size += count * sample_bytes;
+            samples += count;
+            remaining -= count;
+
+            if (current_.size == chunk_bytes_ && !submitCurrent())
+                return false;
+        }
+
+        samples_written_ += frames * channels_;
+        return true;
+    }
+
+    bool AudioFileWriter::write(const AudioBuffer& buffer) {
+        std::lock_guard<std::mutex> lock(call_mutex_);
+        long long frames_per_step, start, count;
+
+        if (!file_ || buffer.empty() || buffer.channels() != channels_)
+            return false;
+
+        if (channels_ == 1)
+            return append(buffer.channel(0), buffer.frames());
+
+        // Interleaved through a small cache-resident block straight into the chunks
+        frames_per_step = static_cast<long long>(scratch_.size()) / channels_;
+        for (start = 0; start < buffer.frames(); start += count) {
+            count = buffer.frames() - start < frames_per_step ? buffer.frames() - start : frames_per_step;
+            interleave(buffer, start, count, scratch_.data());
+            if (!append(scratch_.data(), count))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool AudioFileWriter::submitCurrent() {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        queued_.push_back(current_);
+        ready_cv_.notify_one();
+
+        free_cv_.wait(lock, [this] { return !free_.empty() || failed_; });
+        if (failed_)
+            return false;
+
+        current_ = {free_.back(), 0};
+        free_.pop_back();
+        return true;
+    }
+
+    void AudioFileWriter::writerLoop() {
+        Chunk chunk;
+        bool ok;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_cv_.wait(lock, [this] { return !queued_.empty() || stopping_; });
+                if (queued_.empty())
+                    return;
+
+                chunk = queued_.front();
+                queued_.pop_front();
+                ok = !failed_;
+            }
+
+            if (ok) {
+                RESONIX_PROFILE("AudioFileWriter::disk", chunk.size / (static_cast<size_t>(bytesPerSample(sample_format_)) * channels_));
+                ok = std::fwrite(chunk.bytes, 1, chunk.size, file_) == chunk.size;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!ok)
+                    failed_ = true;
+                free_.push_back(chunk.bytes);
+            }
+            free_cv_.notify_one();
+        }
+    }
+
+    bool AudioFileWriter::writeHeader(bool final) {
+        unsigned char header[WAV_HEADER_BYTES];
+        const int sample_bytes = bytesPerSample(sample_format_);
+        const unsigned long long data_bytes = final ? static_cast<unsigned long long>(samples_written_) * static_cast<unsigned>(sample_bytes) : 0;
+        const bool integer = sample_format_ == INT16 || sample_format_ == INT24;
+
+        buildWavHeader(header, channels_, sample_rate_, 8 * sample_bytes, integer ? FORMAT_PCM : FORMAT_IEEE_FLOAT, data_bytes);
+
+        if (final && std::fseek(file_, 0, SEEK_SET) != 0)
+            return false;
+
+        return std::fwrite(header, 1, sizeof(header), file_) == sizeof(header);
+    }
+
+    bool AudioFileWriter::close() {
+        std::lock_guard<std::mutex> lock(call_mutex_);
+        return closeLocked();
+    }
+
+    bool AudioFileWriter::closeLocked() {
+        bool ok;
+
+        if (!file_)
+            return false;
+
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (current_.size > 0 && !failed_)
+                    queued_.push_back(current_);
+                stopping_ = true;
+            }
+            ready_cv_.notify_one();
+            thread_.join();
+        }
+
+        ok = !failed_;
+        if (ok && format_ == WAV) {
+            // RIFF chunks have even lengths; INT24 with an odd sample count needs the pad byte
+            if ((samples_written_ * bytesPerSample(sample_format_)) & 1)
+                ok = std::fseek(file_, 0, SEEK_END) == 0 && std::fputc(0, file_) != EOF;
+            ok = ok && writeHeader(true);
+        }
+        if (std::fclose(file_) != 0)
+            ok = false;
+
+        for (unsigned char* bytes : storage_) {
+            BufferPool::release(bytes);
+        }
+        storage_.clear();
+        free_.clear();
+        queued_.clear();
+        scratch_.clear();
+        scratch_.shrink_to_fit();
+        current_ = {nullptr, 0};
+        file_ = nullptr;
+
+        return ok;
+    }
+}
@@ -0,0 +1,250 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "Instrument.hpp"
+#include "Pcm.hpp"
+
+namespace Resonix {
+    namespace {
+        constexpr float INT16_SCALE = 32768.0f;
+        constexpr float INT24_SCALE = 8388608.0f;
+        constexpr uint32_t GOLDEN_RATIO = 0x9E3779B9u;
+
+        // Samples per batch; keeps the dither and quantized words in L1 next to the output
+        constexpr long long DITHER_BATCH = 256;
+
+        // Integer finalizer with low bias (Wellons, "Prospecting for Hash Functions"); plain 32-bit ops, so it vectorizes
+        inline uint32_t hash32(uint32_t x) {
+            x ^= x >> 16;
+            x *= 0x7FEB352Du;
+            x ^= x >> 15;
+            x *= 0x846CA68Bu;
+            x ^= x >> 16;
+            return x;
+        }
+
+        /*
+         * TPDF dither in LSBs for samples [position, position + count) of a
+         * stream: the difference of the two 16-bit halves of one hash, which is
+         * triangular on (-1, 1).
+         */
+        void ditherBatch(float* noise, const Dither& dither, long long count) {
+            const uint32_t key = hash32(static_cast<uint32_t>(dither.seed) ^ hash32(static_cast<uint32_t>(dither.seed >> 32) + GOLDEN_RATIO));
+
+            for (long long i = 0; i < count; i++) {
+                unsigned long long index = dither.position + static_cast<unsigned long long>(i);
+                uint32_t h = hash32(static_cast<uint32_t>(index) ^ (static_cast<uint32_t>(index >> 32) * GOLDEN_RATIO) ^ key);
+                noise[i] = (static_cast<float>(h & 0xFFFFu) - static_cast<float>(h >> 16)) * (1.0f / 65536.0f);
+            }
+        }
+
+        /*
+         * Scales, dithers, clips and rounds half away from zero; NaN becomes 0.
+         * Clipping works on the magnitude bits with integer compares: float
+         * compares may trap, and under the default -ftrapping-math that keeps
+         * GCC from turning them into vector selects.
+         */
+        template <int BITS>
+        inline int32_t quantize(float sample, float noise) {
+            constexpr float SCALE = BITS == 16 ? INT16_SCALE : INT24_SCALE;
+            constexpr int32_t SCALE_BITS = BITS == 16 ? 0x47000000 : 0x4B000000; // SCALE as a float bit pattern
+            constexpr int32_t POSITIVE_INFINITY = 0x7F800000;
+            constexpr int32_t HALF = 0x3F000000;
+            constexpr int32_t TOP = static_cast<int32_t>(SCALE) - 1;
+
+            float y = sample * SCALE + noise;
+            int32_t bits, sign, magnitude, top;
+            float rounding;
+
+            std::memcpy(&bits, &y, sizeof(bits));
+            sign = bits & INT32_MIN;
+            magnitude = bits & INT32_MAX;
+            magnitude = magnitude > POSITIVE_INFINITY ? 0 : magnitude;
+            magnitude = magnitude < SCALE_BITS ? magnitude : SCALE_BITS;
+
+            bits = sign | magnitude;
+            std::memcpy(&y, &bits, sizeof(y));
+            bits = sign | HALF;
+            std::memcpy(&rounding, &bits, sizeof(rounding));
+
+            top = static_cast<int32_t>(y + rounding);
+            return top < TOP ? top : TOP;
+        }
+
+        // DITHERED is a template parameter so neither loop carries a branch
+        template <bool DITHERED>
+        void encodeInt16(const float* input, long long count, int16_t* output, const float* noise) {
+            for (long long i = 0; i < count; i++) {
+                output[i] = static_cast<int16_t>(quantize<16>(input[i], DITHERED ? noise[i] : 0.0f));
+            }
+        }
+
+        template <bool DITHERED>
+        void encodeInt24(const float* input, long long count, int32_t* output, const float* noise) {
+            for (long long i = 0; i < count; i++) {
+                output[i] = quantize<24>(input[i], DITHERED ? noise[i] : 0.0f);
+            }
+        }
+
+        // Packs 24-bit values, four at a time into three little-endian words
+        void packInt24(const int32_t* values, long long count, unsigned char* output) {
+            long long i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                const uint32_t v0 = static_cast<uint32_t>(values[i]) & 0xFFFFFFu;
+                const uint32_t v1 = static_cast<uint32_t>(values[i + 1]) & 0xFFFFFFu;
+                const uint32_t v2 = static_cast<uint32_t>(values[i + 2]) & 0xFFFFFFu;
+                const uint32_t v3 = static_cast<uint32_t>(values[i + 3]) & 0xFFFFFFu;
+                const uint32_t words[3] = {v0 | v1 << 24, v1 >> 8 | v2 << 16, v2 >> 16 | v3 << 8};
+                std::memcpy(output + 3 * i, words, sizeof(words));
+            }
+            for (; i < count; i++) {
+                const uint32_t value = static_cast<uint32_t>(values[i]);
+                output[3 * i] = static_cast<unsigned char>(value);
+                output[3 * i + 1] = static_cast<unsigned char>(value >> 8);
+                output[3 * i + 2] = static_cast<unsigned char>(value >> 16);
+            }
+        }
+
+        /*
+         * Round-to-nearest-even float to half on the bit patterns (after
+         * F. Giesen's float_to_half_fast3_rtne), branch-free apart from selects.
+         * Magnitudes that would round to infinity, and NaN, saturate at 65504.
+         */
+        inline uint16_t toHalf(float value) {
+            uint32_t bits, sign, normal, subnormal;
+            float magnitude;
+
+            std::memcpy(&bits, &value, sizeof(bits));
+            sign = (bits >> 16) & 0x8000u;
+            bits &= 0x7FFFFFFFu;
+
+            // Below 2^-14 the FPU does the rounding: adding 0.5 aligns the half mantissa to the float LSBs
+            std::memcpy(&magnitude, &bits, sizeof(magnitude));
+            magnitude += 0.5f;
+            std::memcpy(&subnormal, &magnitude, sizeof(subnormal));
+            subnormal -= 0x3F000000u;
+
+            normal = (bits + 0xC8000FFFu + ((bits >> 13) & 1u)) >> 13;
+
+            bits = bits >= 0x477FF000u ? 0x7BFFu : bits < 0x38800000u ? subnormal : normal;
+            return static_cast<uint16_t>(sign | bits);
+        }
+
+        inline float fromHalf(uint16_t half) {
+            const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+            uint32_t bits = static_cast<uint32_t>(half & 0x7FFFu) << 13;
+            float value;
+
+            if (bits >= 0x0F800000u) {
+                // Infinity and NaN keep an all-ones exponent
+                bits += 0x70000000u;
+                std::memcpy(&value, &bits, sizeof(value));
+            } else {
+                // Rebiasing by a multiply also normalizes subnormals
+                std::memcpy(&value, &bits, sizeof(value));
+                value *= 5.192296858534828e+33f;
+            }
+
+            std::memcpy(&bits, &value, sizeof(bits));
+            bits |= sign;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    }
+
+    void encodeSamples(const float* input, long long count, SampleFormat format, void* output, Dither* dither) {
+        unsigned char* out = static_cast<unsigned char*>(output);
+        float noise[DITHER_BATCH];
+        long long start, length;
+
+        RESONIX_PROFILE("Resonix::encodeSamples", count);
+
+        if (!input || !output || count <= 0)
+            return;
+
+        switch (format) {
+            case FLOAT32:
+                std::memcpy(output, input, static_cast<size_t>(count) * sizeof(float));
+                return;
+            case FLOAT16:
+                for (long long i = 0; i < count; i++) {
+                    uint16_t half = toHalf(input[i]);
+                    std::memcpy(out + 2 * i, &half, sizeof(half));
+                }
+                return;
+            case INT16:
+            case INT24:
+                break;
+        }
+
+        for (start = 0; start < count; start += length) {
+            length = count - start < DITHER_BATCH ? count - start : DITHER_BATCH;
+
+            if (dither) {
+                ditherBatch(noise, *dither, length);
+                dither->position += static_cast<unsigned long long>(length);
+            }
+
+            // Quantized into aligned scratch, since output is only byte-aligned
+            if (format == INT16) {
+                int16_t converted[DITHER_BATCH];
+                if (dither)
+                    encodeInt16<true>(input + start, length, converted, noise);
+                else
+                    encodeInt16<false>(input + start, length, converted, noise);
+                std::memcpy(out + 2 * start, converted, static_cast<size_t>(length) * sizeof(int16_t));
+            } else {
+                int32_t converted[DITHER_BATCH];
+                if (dither)
+                    encodeInt24<true>(input + start, length, converted, noise);
+                else
+                    encodeInt24<false>(input + start, length, converted, noise);
+                packInt24(converted, length, out + 3 * start);
+            }
+        }
+    }
+
+    void decodeSamples(const void* input, long long count, long long stride, SampleFormat format, float* output) {
+        const unsigned char* in = static_cast<const unsigned char*>(input);
+        const long long step = stride * bytesPerSample(format);
+        long long i;
+
+        RESONIX_PROFILE("Resonix::decodeSamples", count);
+
+        if (!input || !output || count <= 0)
+            return;
+
+        // The loops vectorize for stride 1
+        switch (format) {
+            case INT16:
+                for (i = 0; i < count; i++) {
+                    const unsigned char* p = in + i * step;
+                    int16_t value = static_cast<int16_t>(static_cast<uint16_t>(p[0] | p[1] << 8));
+                    output[i] = static_cast<float>(value) * (1.0f / INT16_SCALE);
+                }
+                break;
+            case INT24:
+                for (i = 0; i < count; i++) {
+                    const unsigned char* p = in + i * step;
+                    // Assemble in the top 24 bits, then an arithmetic shift sign-extends
+                    int32_t value = static_cast<int32_t>(static_cast<uint32_t>(p[0]) << 8
+                                                        | static_cast<uint32_t>(p[1]) << 16
+                                                        | static_cast<uint32_t>(p[2]) << 24) >> 8;
+                    output[i] = static_cast<float>(value) * (1.0f / INT24_SCALE);
+                }
+                break;
+            case FLOAT16:
+                for (i = 0; i < count; i++) {
+                    const unsigned char* p = in + i * step;
+                    output[i] = fromHalf(static_cast<uint16_t>(p[0] | p[1] << 8));
+                }
+                break;
+            case FLOAT32:
+                for (i = 0; i < count; i++) {
+                    std::memcpy(output + i, in + i * step, sizeof(float));
+                }
+                break;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Math.hpp"
+
+/*
+ * Inline bodies of the Math functions, for the sample loops of the generators.
+ * The out-of-line Math:: functions call these, so both give the same results;
+ * inlined, the loops vectorize for whichever ISA a RESONIX_CLONES kernel is
+ * compiled for instead of making one call per sample.
+ */
+namespace Math {
+    namespace Kernel {
+        inline float getNaN() {
+            return __builtin_nanf("");
+        }
+
+        inline bool isNaN(float a) {
+            return a != a;
+        }
+
+        inline float fmod(float a, float b) {
+            float quotient, truncated_quotient;
+
+            if (b == 0.0f)
+                return getNaN();
+
+            quotient = a / b;
+            truncated_quotient = static_cast<float>(static_cast<int>(quotient));
+            return a - truncated_quotient * b;
+        }
+
+        inline float abs(float a) {
+            if (isNaN(a))
+                return getNaN();
+
+            return a < 0 ? -a : a;
+        }
+
+        inline float Sine(float degrees) {
+            constexpr float c7 = 0.9999966f;
+            constexpr float c5 = -0.16664824f;
+            constexpr float c3 = 0.00830629f;
+            constexpr float c1 = -0.00018363f;
+            float angle, x, x2;
+
+            angle = fmod(degrees, 360.0f);
+            angle = angle < 0.0f ? angle + 360.0f : angle;
+
+            x = fmod(angle * DEG_TO_RAD + PI, TWO_PI) - PI;
+            x2 = x * x;
+            return x * (c7 + x2 * (c5 + x2 * (c3 + x2 * c1)));
+        }
+
+        inline float Cosine(float degrees) {
+            float angle = fmod(degrees, 360.0f);
+
+            angle = angle < 0.0f ? angle + 360.0f : angle;
+            return Sine(angle + 90.0f);
+        }
+
+        // Written with selects rather than early returns: the branchy form is too much for if-conversion
+        inline float Tangent(float degrees) {
+            float mod180, x, x2, num, den;
+            bool pole;
+
+            degrees = fmod(degrees, 360.0f);
+            degrees = degrees < 0.0f ? degrees + 360.0f : degrees;
+
+            mod180 = fmod(degrees, 180.0f);
+            pole = abs(mod180 - 90.0f) < 0.1f;
+
+            x = fmod(degrees * DEG_TO_RAD + PI, TWO_PI) - PI;
+            x = x > PI/2 ? x - PI : x < -PI/2 ? x + PI : x;
+
+            x2 = x * x;
+            num = x * (-135135.0f + x2 * (17325.0f + x2 * (-378.0f + x2)));
+            den = -135135.0f + x2 * (62370.0f + x2 * (-3150.0f + 28.0f * x2));
+
+            return pole || abs(den) < EPSILON ? getNaN() : num / den;
+        }
+
+        inline float Cotangent(float degrees) {
+            float x, x2, x4, numerator, denominator, mod180;
+
+            degrees = fmod(degrees, 360.0f);
+            if (degrees < 0.0f) degrees += 360.0f;
+
+            mod180 = fmod(degrees, 180.0f);
+            if (abs(mod180) < 0.1f) {
+                return getNaN();
+            }
+
+            x = degrees * DEG_TO_RAD;
+
+            if (x > PI/2) {
+                x -= PI;
+            } else if (x < -PI/2) {
+                x += PI;
+            }
+
+            if (abs(x) < 0.001f) {
+                return getNaN();
+            }
+
+            x2 = x * x;
+            x4 = x2 * x2;
+
+            numerator = 945.0f - 105.0f * x2 + x4;
+            denominator = x * (945.0f - 420.0f * x2 + 15.0f * x4);
+
+            if (abs(denominator) < EPSILON) {
+                return getNaN();
+            }
+
+            return numerator / denominator;
+        }
+
+        /** @brief Hann coefficient of position n, given 1 / (N - 1) */
+        inline float Hann(float n, float inverse_N_minus_1) {
+            return 0.5f * (1.0f - Cosine(360.0f * n * inverse_N_minus_1));
+        }
+    }
+}
@@ -1,16 +1,9 @@
 #include "../include/Math.hpp"
+#include "Kernels.hpp"
 
 namespace Math {
     float fmod(float a, float b) {
-        if (b == 0.0f)
-            return getNaN();
-
-        float quotient = a / b;
-        float truncated_quotient = static_cast<int>(quotient);
-
-        float remainder = a - truncated_quotient * b;
-
-        return remainder;
+        return Kernel::fmod(a, b);
     }
 
     float min(float a, float b) {
@@ -21,10 +14,7 @@ namespace Math {
     }
 
     float abs(float a) {
-        if (isNaN(a))
-            return getNaN();
-
-        return a < 0 ? -a : a;
+        return Kernel::abs(a);
     }
 
     float clamp(float value, float min, float max) {
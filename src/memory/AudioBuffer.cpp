@@ -0,0 +1,168 @@
+#include <cstring>
+#include <limits>
+#include "AudioBuffer.hpp"
+
+namespace Resonix {
+    namespace {
+        constexpr long long ALIGNMENT_SAMPLES = static_cast<long long>(BUFFER_ALIGNMENT / sizeof(float));
+
+        /*
+         * With the channel count known at compile time the inner loop unrolls
+         * into shuffles of whole vectors (zip/unzip for stereo), so the common
+         * layouts get dedicated kernels and only unusual counts run generically.
+         */
+        template <int CHANNELS>
+        void interleaveFixed(const AudioBuffer& input, long long offset, long long frames, float* output) {
+            const float* source[CHANNELS];
+
+            for (int c = 0; c < CHANNELS; c++) {
+                source[c] = input.channel(c) + offset;
+            }
+
+            for (long long i = 0; i < frames; i++) {
+                for (int c = 0; c < CHANNELS; c++) {
+                    output[i * CHANNELS + c] = source[c][i];
+                }
+            }
+        }
+
+        template <int CHANNELS>
+        void deinterleaveFixed(const float* input, AudioBuffer& output) {
+            float* destination[CHANNELS];
+            const long long frames = output.frames();
+
+            for (int c = 0; c < CHANNELS; c++) {
+                destination[c] = output.channel(c);
+            }
+
+            for (long long i = 0; i < frames; i++) {
+                for (int c = 0; c < CHANNELS; c++) {
+                    destination[c][i] = input[i * CHANNELS + c];
+                }
+            }
+        }
+    }
+
+    AudioBuffer::AudioBuffer(int channels, long long frames) : channels_(0), frames_(0), stride_(0) {
+        MemoryTag tag("AudioBuffer");
+        long long stride;
+
+        if (channels <= 0 || frames <= 0)
+            return;
+
+        stride = (frames + ALIGNMENT_SAMPLES - 1) / ALIGNMENT_SAMPLES * ALIGNMENT_SAMPLES;
+        if (stride > std::numeric_limits<long long>::max() / channels)
+            return;
+
+        storage_ = allocateSamples(static_cast<size_t>(stride * channels));
+        if (!storage_)
+            return;
+
+        channels_ = channels;
+        frames_ = frames;
+        stride_ = stride;
+    }
+
+    AudioBuffer::AudioBuffer(AudioBuffer&& other) noexcept
+        : storage_(std::move(other.storage_)),
+          channels_(other.channels_),
+          frames_(other.frames_),
+          stride_(other.stride_) {
+        other.channels_ = 0;
+        other.frames_ = 0;
+        other.stride_ = 0;
+    }
+
+    AudioBuffer& AudioBuffer::operator=(AudioBuffer&& other) noexcept {
+        if (this != &other) {
+            storage_ = std::move(other.storage_);
+            channels_ = other.channels_;
+            frames_ = other.frames_;
+            stride_ = other.stride_;
+            other.channels_ = 0;
+            other.frames_ = 0;
+            other.stride_ = 0;
+        }
+        return *this;
+    }
+
+    void AudioBuffer::clear() {
+        if (storage_)
+            std::memset(storage_.get(), 0, static_cast<size_t>(stride_ * channels_) * sizeof(float));
+    }
+
+    SampleBuffer AudioBuffer::release() {
+        channels_ = 0;
+        frames_ = 0;
+        stride_ = 0;
+        return std::move(storage_);
+    }
+
+    void interleave(const AudioBuffer& input, float* output) {
+        interleave(input, 0, input.frames(), output);
+    }
+
+    void interleave(const AudioBuffer& input, long long offset, long long frames, float* output) {
+        if (input.empty() || !output || offset < 0 || frames <= 0 || offset + frames > input.frames())
+            return;
+
+        switch (input.channels()) {
+            case 1:
+                std::memcpy(output, input.channel(0) + offset, static_cast<size_t>(frames) * sizeof(float));
+                return;
+            case 2:
+                interleaveFixed<2>(input, offset, frames, output);
+                return;
+            case 4:
+                interleaveFixed<4>(input, offset, frames, output);
+                return;
+            case 6:
+                interleaveFixed<6>(input, offset, frames, output);
+                return;
+            case 8:
+                interleaveFixed<8>(input, offset, frames, output);
+                return;
+            default:
+                break;
+        }
+
+        for (int c = 0; c < input.channels(); c++) {
+            const float* source = input.channel(c) + offset;
+            for (long long i = 0; i < frames; i++) {
+                output[i * input.channels() + c] = source[i];
+            }
+        }
+    }
+
+    void deinterleave(const float* input, AudioBuffer& output) {
+        if (output.empty() || !input)
+            return;
+
+        switch (output.channels()) {
+            case 1:
+                std::memcpy(output.channel(0), input, static_cast<size_t>(output.frames()) * sizeof(float));
+                return;
+            case 2:
+                deinterleaveFixed<2>(input, output);
+                return;
+            case 4:
+                deinterleaveFixed<4>(input, output);
+                return;
+            case 6:
+                deinterleaveFixed<6>(input, output);
+                return;
+            case 8:
+                deinterleaveFixed<8>(input, output);
+                return;
+            default:
+                break;
+        }
+
+        for (int c = 0; c < output.channels(); c++) {
+            float* destination = output.channel(c);
+            for (long long i = 0; i < output.frames(); i++) {
+                destination[i] = input[i * output.channels() + c];
+            }
+        }
+    }
+}
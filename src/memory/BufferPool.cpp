@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include "BufferPool.hpp"
+#include "Instrument.hpp"
+
+namespace Resonix {
+    // Sits in the cache line right before every block
+    struct BufferPool::Header {
+        size_t bytes;        // Size of the whole allocation, header included
+        int size_class;      // Free list index, -1 when too large to cache
+        int usage;           // Index of the tag the block is charged to
+        BufferPool* pool;
+        Allocator allocator;
+        size_t requested;    // Size the caller asked for
+    };
+
+    struct BufferPool::Usage {
+        const char* name;
+        unsigned long long allocations;
+        size_t bytes;
+        size_t live_bytes;
+        size_t peak_bytes;
+    };
+
+    namespace {
+        constexpr size_t HEADER_BYTES = BUFFER_ALIGNMENT;
+
+        // Class 0 holds allocations up to 2^MIN_CLASS_SHIFT bytes, then four classes per power of two
+        constexpr int MIN_CLASS_SHIFT = 12;
+        constexpr int MAX_CLASS_SHIFT = 40;
+        constexpr int CLASS_COUNT = 1 + 4 * (MAX_CLASS_SHIFT - MIN_CLASS_SHIFT);
+
+        void* alignedNew(size_t bytes, void*) {
+            return ::operator new(bytes, std::align_val_t(BUFFER_ALIGNMENT), std::nothrow);
+        }
+
+        void alignedDelete(void* memory, size_t, void*) {
+            ::operator delete(memory, std::align_val_t(BUFFER_ALIGNMENT));
+        }
+
+        const Allocator DEFAULT_ALLOCATOR = {alignedNew, alignedDelete, nullptr};
+
+        const char* const UNTAGGED = "other";
+
+        thread_local const char* current_tag = nullptr;
+
+        // Rounds bytes up to its size class; returns the class index, or -1 beyond the largest class
+        int sizeClass(size_t& bytes) {
+            size_t base, quarter, steps;
+            int shift;
+
+            if (bytes <= (size_t(1) << MIN_CLASS_SHIFT)) {
+                bytes = size_t(1) << MIN_CLASS_SHIFT;
+                return 0;
+            }
+
+            for (shift = MIN_CLASS_SHIFT; shift < MAX_CLASS_SHIFT && (size_t(1) << (shift + 1)) < bytes; shift++) {}
+            if (shift == MAX_CLASS_SHIFT) {
+                bytes = (bytes + BUFFER_ALIGNMENT - 1) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT;
+                return -1;
+            }
+
+            base = size_t(1) << shift;
+            quarter = base / 4;
+            steps = (bytes - base + quarter - 1) / quarter;
+            bytes = base + steps * quarter;
+
+            return 1 + 4 * (shift - MIN_CLASS_SHIFT) + static_cast<int>(steps) - 1;
+        }
+    }
+
+    BufferPool::BufferPool()
+        : free_lists_(CLASS_COUNT),
+          allocator_(DEFAULT_ALLOCATOR),
+          cached_bytes_(0),
+          cache_limit_(DEFAULT_CACHE_LIMIT),
+          reserved_bytes_(0),
+          peak_reserved_bytes_(0),
+          usage_(1, Usage{nullptr, 0, 0, 0, 0}) {
+        static_assert(sizeof(Header) <= HEADER_BYTES, "header must fit in front of the aligned block");
+    }
+
+    BufferPool::~BufferPool() {
+        trim();
+    }
+
+    void* BufferPool::allocate(size_t bytes) {
+        Header* header = nullptr;
+        Allocator allocator;
+        size_t total;
+        int size_class;
+
+        if (bytes == 0 || bytes > static_cast<size_t>(-1) - 2 * HEADER_BYTES)
+            return nullptr;
+
+        total = bytes + HEADER_BYTES;
+        size_class = sizeClass(total);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            allocator = allocator_;
+
+            if (size_class >= 0 && !free_lists_[static_cast<size_t>(size_class)].empty()) {
+                header = free_lists_[static_cast<size_t>(size_class)].back();
+                free_lists_[static_cast<size_t>(size_class)].pop_back();
+                cached_bytes_ -= header->bytes;
+                header->requested = bytes;
+                recordAllocation(header);
+            }
+        }
+
+        if (!header) {
+            void* memory = allocator.allocate(total, allocator.user);
+            if (!memory)
+                return nullptr;
+
+            header = static_cast<Header*>(memory);
+            header->bytes = total;
+            header->size_class = size_class;
+            header->pool = this;
+            header->allocator = allocator;
+            header->requested = bytes;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            reserved_bytes_ += total;
+            peak_reserved_bytes_ = std::max(peak_reserved_bytes_, reserved_bytes_);
+            recordAllocation(header);
+        }
+
+        RESONIX_PROFILE_BYTES(bytes);
+        return reinterpret_cast<unsigned char*>(header) + HEADER_BYTES;
+    }
+
+    // Called with mutex_ held
+    void BufferPool::recordAllocation(Header* header) {
+        const char* name = current_tag ? current_tag : UNTAGGED;
+        size_t index;
+
+        // Compared by text: the same literal may live at different addresses in different translation units
+        for (index = 1; index < usage_.size() && usage_[index].name != name && std::strcmp(usage_[index].name, name) != 0; index++) {}
+        if (index == usage_.size())
+            usage_.push_back(Usage{name, 0, 0, 0, 0});
+        header->usage = static_cast<int>(index);
+
+        for (size_t k : {size_t(0), index}) {
+            Usage& usage = usage_[k];
+            usage.allocations++;
+            usage.bytes += header->requested;
+            usage.live_bytes += header->requested;
+            usage.peak_bytes = std::max(usage.peak_bytes, usage.live_bytes);
+        }
+    }
+
+    void BufferPool::release(void* memory) {
+        Header* header;
+
+        if (!memory)
+            return;
+
+        header = reinterpret_cast<Header*>(static_cast<unsigned char*>(memory) - HEADER_BYTES);
+        header->pool->recycle(header);
+    }
+
+    void BufferPool::recycle(Header* header) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            usage_[0].live_bytes -= header->requested;
+            usage_[static_cast<size_t>(header->usage)].live_bytes -= header->requested;
+
+            // Blocks of a replaced allocator are never reused
+            if (header->size_class >= 0 && header->allocator.allocate == allocator_.allocate
+                && header->allocator.user == allocator_.user && cached_bytes_ + header->bytes <= cache_limit_) {
+                free_lists_[static_cast<size_t>(header->size_class)].push_back(header);
+                cached_bytes_ += header->bytes;
+                return;
+            }
+            reserved_bytes_ -= header->bytes;
+        }
+
+        freeBlock(header);
+    }
+
+    void BufferPool::freeBlock(Header* header) {
+        Allocator allocator = header->allocator;
+        allocator.deallocate(header, header->bytes, allocator.user);
+    }
+
+    void BufferPool::setAllocator(const Allocator* allocator) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            allocator_ = allocator && allocator->allocate && allocator->deallocate ? *allocator : DEFAULT_ALLOCATOR;
+        }
+        trim();
+    }
+
+    void BufferPool::setCacheLimit(size_t bytes) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cache_limit_ = bytes;
+            if (cached_bytes_ <= cache_limit_)
+                return;
+        }
+        trim();
+    }
+
+    void BufferPool::trim() {
+        std::vector<Header*> blocks;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (std::vector<Header*>& list : free_lists_) {
+                blocks.insert(blocks.end(), list.begin(), list.end());
+                list.clear();
+            }
+            reserved_bytes_ -= cached_bytes_;
+            cached_bytes_ = 0;
+        }
+
+        for (Header* header : blocks) {
+            freeBlock(header);
+        }
+    }
+
+    size_t BufferPool::cachedBytes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cached_bytes_;
+    }
+
+    MemoryStats BufferPool::memoryStats() const {
+        MemoryStats stats;
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        stats.live_bytes = usage_[0].live_bytes;
+        stats.peak_bytes = usage_[0].peak_bytes;
+        stats.reserved_bytes = reserved_bytes_;
+        stats.peak_reserved_bytes = peak_reserved_bytes_;
+        stats.cached_bytes = cached_bytes_;
+        stats.allocations = usage_[0].allocations;
+
+        for (size_t k = 1; k < usage_.size(); k++) {
+            const Usage& usage = usage_[k];
+            if (!usage.allocations && !usage.live_bytes)
+                continue;
+            stats.apis.push_back({usage.name, usage.allocations, usage.bytes, usage.live_bytes, usage.peak_bytes});
+        }
+
+        std::sort(stats.apis.begin(), stats.apis.end(), [](const MemoryUsage& a, const MemoryUsage& b) {
+            return a.peak_bytes > b.peak_bytes;
+        });
+        return stats;
+    }
+
+    void BufferPool::resetMemoryStats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (Usage& usage : usage_) {
+            usage.allocations = 0;
+            usage.bytes = 0;
+            usage.peak_bytes = usage.live_bytes;
+        }
+        peak_reserved_bytes_ = reserved_bytes_;
+    }
+
+    BufferPool& BufferPool::global() {
+        // Leaked on purpose: NumPy may release buffers during interpreter shutdown
+        static BufferPool* pool = new BufferPool();
+        return *pool;
+    }
+
+    SampleBuffer allocateSamples(size_t count) {
+        if (count == 0 || count > static_cast<size_t>(-1) / sizeof(float))
+            return nullptr;
+
+        return SampleBuffer(static_cast<float*>(BufferPool::global().allocate(count * sizeof(float))));
+    }
+
+    MemoryStats memoryStats() {
+        return BufferPool::global().memoryStats();
+    }
+
+    void resetMemoryStats() {
+        BufferPool::global().resetMemoryStats();
+    }
+
+    MemoryTag::MemoryTag(const char* name) : outermost_(current_tag == nullptr) {
+        if (outermost_)
+            current_tag = name;
+    }
+
+    MemoryTag::~MemoryTag() {
+        if (outermost_)
+            current_tag = nullptr;
+    }
+}
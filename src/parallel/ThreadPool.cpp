@@ -0,0 +1,131 @@
+#include "ThreadPool.hpp"
+
+namespace Resonix {
+    namespace {
+        thread_local ThreadPool* current_pool = nullptr;
+        thread_local int current_worker = -1;
+    }
+
+    ThreadPool::ThreadPool(unsigned thread_count) : queued_(0), next_(0), stopping_(false) {
+        if (thread_count == 0)
+            thread_count = std::thread::hardware_concurrency();
+        if (thread_count == 0)
+            thread_count = 1;
+
+        for (unsigned i = 0; i < thread_count; i++) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+
+        for (unsigned i = 0; i < thread_count; i++) {
+            threads_.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        sleep_cv_.notify_all();
+
+        for (std::thread& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    ThreadPool& ThreadPool::global() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::submit(Task task) {
+        unsigned target;
+
+        if (current_pool == this && current_worker >= 0)
+            target = static_cast<unsigned>(current_worker);
+        else
+            target = next_.fetch_add(1, std::memory_order_relaxed) % size();
+
+        {
+            std::lock_guard<std::mutex> lock(workers_[target]->mutex);
+            workers_[target]->tasks.push_back(std::move(task));
+        }
+
+        // Publishing under the sleep mutex prevents a lost wake-up
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            queued_.fetch_add(1, std::memory_order_release);
+        }
+        sleep_cv_.notify_one();
+    }
+
+    bool ThreadPool::popTask(int self, Task& task) {
+        unsigned count = size();
+
+        if (self >= 0) {
+            Worker& own = *workers_[static_cast<unsigned>(self)];
+            std::lock_guard<std::mutex> lock(own.mutex);
+
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (unsigned k = 1; k <= count; k++) {
+            unsigned victim = (static_cast<unsigned>(self + 1) + k - 1) % count;
+
+            if (static_cast<int>(victim) == self)
+                continue;
+
+            Worker& other = *workers_[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+
+            if (!other.tasks.empty()) {
+                task = std::move(other.tasks.front());
+                other.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool ThreadPool::runPending() {
+        Task task;
+        int self = current_pool == this ? current_worker : -1;
+
+        if (queued_.load(std::memory_order_acquire) <= 0 || !popTask(self, task))
+            return false;
+
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        task();
+        return true;
+    }
+
+    void ThreadPool::wait(const std::atomic<int>& remaining) {
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!runPending())
+                std::this_thread::yield();
+        }
+    }
+
+    void ThreadPool::workerLoop(unsigned index) {
+        current_pool = this;
+        current_worker = static_cast<int>(index);
+
+        while (true) {
+            if (runPending())
+                continue;
+
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleep_cv_.wait(lock, [this] {
+                return stopping_ || queued_.load(std::memory_order_acquire) > 0;
+            });
+
+            if (stopping_ && queued_.load(std::memory_order_acquire) <= 0)
+                return;
+        }
+    }
+}
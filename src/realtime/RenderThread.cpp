@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <chrono>
+#include "Instrument.hpp"
+#include "Realtime.hpp"
+
+namespace Resonix {
+    namespace {
+        using SteadyClock = std::chrono::steady_clock;
+
+        // Smallest block the render thread asks the source for
+        constexpr int MIN_BLOCK_SIZE = 16;
+
+        size_t ringFrames(int block_size, int buffer_frames) {
+            return static_cast<size_t>(std::max(buffer_frames, 2 * block_size));
+        }
+
+        // Counters have a single writer, so a relaxed load-compare-store suffices
+        void storeMax(std::atomic<long long>& counter, long long value) {
+            if (value > counter.load(std::memory_order_relaxed))
+                counter.store(value, std::memory_order_relaxed);
+        }
+
+        void storeMin(std::atomic<long long>& counter, long long value) {
+            if (value < counter.load(std::memory_order_relaxed))
+                counter.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    RenderThread::RenderThread(Source source, int block_size, int buffer_frames)
+        : source_(std::move(source)), block_size_(std::max(block_size, MIN_BLOCK_SIZE)),
+          ring_(ringFrames(block_size_, buffer_frames)), running_(false), frames_rendered_(0),
+          render_ns_max_(0), frames_read_(0), underruns_(0), underrun_frames_(0), min_buffered_(0) {
+        MemoryTag tag("RenderThread");
+        block_ = allocateSamples(static_cast<size_t>(block_size_));
+    }
+
+    RenderThread::~RenderThread() {
+        stop();
+    }
+
+    bool RenderThread::start() {
+        if (running() || !source_ || !block_)
+            return false;
+
+        // Whatever is left from an earlier run would play out of order. The
+        // ring's consumer side may only be reset while no read() is inside it,
+        // so reads are turned away first and any one in progress waited for.
+        // Both sides store their flag before loading the other's, sequentially
+        // consistent, so at least one of them sees the other.
+        restarting_.store(true);
+        while (reading_.load()) {
+            std::this_thread::yield();
+        }
+        ring_.reset();
+        restarting_.store(false);
+
+        while (ring_.writeAvailable() >= static_cast<size_t>(block_size_)) {
+            renderBlock();
+        }
+        min_buffered_.store(static_cast<long long>(ring_.size()), std::memory_order_relaxed);
+
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread(&RenderThread::renderLoop, this);
+        return true;
+    }
+
+    void RenderThread::stop() {
+        running_.store(false, std::memory_order_release);
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    void RenderThread::renderBlock() {
+        RESONIX_PROFILE("RenderThread::block", block_size_);
+        const SteadyClock::time_point start = SteadyClock::now();
+
+        source_(block_.get(), block_size_);
+        ring_.write(block_.get(), static_cast<size_t>(block_size_));
+
+        const long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - start).count();
+        storeMax(render_ns_max_, elapsed);
+        frames_rendered_.store(frames_rendered_.load(std::memory_order_relaxed) + block_size_, std::memory_order_relaxed);
+    }
+
+    void RenderThread::renderLoop() {
+        // A quarter block of playback: short enough to refill well before the ring drains
+        const std::chrono::microseconds idle(std::max<long long>(1, 250000LL * block_size_ / SAMPLE_RATE));
+
+        while (running_.load(std::memory_order_acquire)) {
+            if (ring_.writeAvailable() >= static_cast<size_t>(block_size_))
+                renderBlock();
+            else
+                std::this_thread::sleep_for(idle);
+        }
+    }
+
+    int RenderThread::read(float* output, int frames) {
+        if (!output || frames <= 0)
+            return 0;
+
+        int count = 0;
+
+        // The ring has one consumer: a read() that overlaps another one gets
+        // silence and leaves the ring and the counters to the first
+        if (reading_.exchange(true)) {
+            std::fill(output, output + frames, 0.0f);
+            return 0;
+        }
+
+        // While start() resets the ring the frames are silence
+        if (!restarting_.load()) {
+            storeMin(min_buffered_, static_cast<long long>(ring_.readAvailable()));
+            count = static_cast<int>(ring_.read(output, static_cast<size_t>(frames)));
+        }
+
+        frames_read_.store(frames_read_.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        if (count < frames) {
+            underruns_.store(underruns_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            underrun_frames_.store(underrun_frames_.load(std::memory_order_relaxed) + (frames - count), std::memory_order_relaxed);
+        }
+        reading_.store(false, std::memory_order_release);
+
+        if (count < frames)
+            std::fill(output + count, output + frames, 0.0f);
+        return count;
+    }
+
+    RealtimeStats RenderThread::stats() const {
+        RealtimeStats result;
+
+        result.frames_rendered = frames_rendered_.load(std::memory_order_relaxed);
+        result.frames_read = frames_read_.load(std::memory_order_relaxed);
+        result.underruns = underruns_.load(std::memory_order_relaxed);
+        result.underrun_frames = underrun_frames_.load(std::memory_order_relaxed);
+        result.buffered_frames = static_cast<long long>(ring_.size());
+        result.min_buffered_frames = min_buffered_.load(std::memory_order_relaxed);
+        result.max_render_ms = static_cast<double>(render_ns_max_.load(std::memory_order_relaxed)) * 1e-6;
+        return result;
+    }
+
+    void RenderThread::resetStats() {
+        frames_rendered_.store(0, std::memory_order_relaxed);
+        render_ns_max_.store(0, std::memory_order_relaxed);
+        frames_read_.store(0, std::memory_order_relaxed);
+        underruns_.store(0, std::memory_order_relaxed);
+        underrun_frames_.store(0, std::memory_order_relaxed);
+        min_buffered_.store(static_cast<long long>(ring_.size()), std::memory_order_relaxed);
+    }
+
+    SinkThread::SinkThread(RenderThread& source, Sink sink, int period, bool realtime)
+        : source_(source), sink_(std::move(sink)), period_(std::max(period, 1)), realtime_(realtime),
+          running_(false), delivered_(0) {
+        MemoryTag tag("SinkThread");
+        buffer_ = allocateSamples(static_cast<size_t>(period_));
+    }
+
+    SinkThread::~SinkThread() {
+        stop();
+    }
+
+    bool SinkThread::start(long long frames) {
+        if (running() || !sink_ || !buffer_)
+            return false;
+
+        // A previous run that ended by itself still needs joining
+        if (thread_.joinable())
+            thread_.join();
+
+        delivered_.store(0, std::memory_order_release);
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread(&SinkThread::pullLoop, this, frames);
+        return true;
+    }
+
+    void SinkThread::stop() {
+        running_.store(false, std::memory_order_release);
+        wait();
+    }
+
+    void SinkThread::wait() {
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    void SinkThread::pullLoop(long long frames) {
+        // Periods are scheduled from the start time, so late wake-ups do not accumulate into drift
+        const SteadyClock::time_point start = SteadyClock::now();
+        long long delivered = 0;
+
+        while (running_.load(std::memory_order_acquire) && (frames < 0 || delivered < frames)) {
+            const int count = frames < 0 ? period_ : static_cast<int>(std::min<long long>(period_, frames - delivered));
+
+            if (realtime_)
+                std::this_thread::sleep_until(start + std::chrono::seconds(delivered / SAMPLE_RATE)
+                                              + std::chrono::nanoseconds(delivered % SAMPLE_RATE * 1000000000LL / SAMPLE_RATE));
+
+            source_.read(buffer_.get(), count);
+            if (!sink_(buffer_.get(), count))
+                break;
+
+            delivered += count;
+            delivered_.store(delivered, std::memory_order_release);
+        }
+        running_.store(false, std::memory_order_release);
+    }
+
+    SinkThread::Sink nullSink() {
+        return [](const float*, int) { return true; };
+    }
+
+    SinkThread::Sink fileSink(AudioFileWriter& writer) {
+        return [&writer](const float* samples, int frames) { return writer.write(samples, frames); };
+    }
+}
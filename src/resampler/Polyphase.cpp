@@ -0,0 +1,236 @@
+#include "Resampler.hpp"
+#include "Instrument.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <tuple>
+
+namespace Resampler {
+    namespace {
+        struct QualityPreset {
+            int taps;
+            double beta;
+            double rolloff;
+        };
+
+        constexpr QualityPreset presets[] = {
+            {8, 5.0, 0.80},    // FAST
+            {16, 7.5, 0.88},   // MEDIUM
+            {32, 10.0, 0.93},  // HIGH
+            {64, 12.0, 0.96}   // BEST
+        };
+
+        // Banks larger than this (e.g. 44100 -> 44101) are refused rather than
+        // silently allocating hundreds of megabytes.
+        constexpr long long MAX_BANK_COEFFICIENTS = 1LL << 24;
+
+        double bessel_i0(double x) {
+            double sum = 1.0, term = 1.0, half = x * 0.5;
+
+            for (int k = 1; k < 64; k++) {
+                term *= (half / k) * (half / k);
+                sum += term;
+                if (term < sum * 1e-12)
+                    break;
+            }
+
+            return sum;
+        }
+
+        std::shared_ptr<const FilterBank> design(int up, int down, Quality quality) {
+            const QualityPreset& preset = presets[quality];
+            auto bank = std::make_shared<FilterBank>();
+            int taps, length, center, p, j;
+            double cutoff, inv_i0_beta, x, r, h;
+            std::vector<double> prototype;
+
+            bank->up = up;
+            bank->down = down;
+
+            if (up == 1 && down == 1) {
+                bank->taps = 1;
+                bank->coefficients.assign(1, 1.0f);
+                return bank;
+            }
+
+            taps = preset.taps;
+            length = taps * up;
+            center = length / 2;
+            cutoff = preset.rolloff * 0.5 / static_cast<double>(up > down ? up : down);
+            inv_i0_beta = 1.0 / bessel_i0(preset.beta);
+
+            prototype.resize(static_cast<size_t>(length));
+            for (int i = 0; i < length; i++) {
+                x = static_cast<double>(i - center);
+                r = x / center;
+                h = (x == 0.0) ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+                prototype[static_cast<size_t>(i)] = h * bessel_i0(preset.beta * std::sqrt(1.0 - r * r)) * inv_i0_beta * up;
+            }
+
+            bank->taps = taps;
+            bank->coefficients.resize(static_cast<size_t>(length));
+            for (p = 0; p < up; p++) {
+                for (j = 0; j < taps; j++) {
+                    bank->coefficients[static_cast<size_t>(p * taps + j)] =
+                        static_cast<float>(prototype[static_cast<size_t>(p + (taps - 1 - j) * up)]);
+                }
+            }
+
+            return bank;
+        }
+
+        inline float dot(const float* coefficients, const float* window, int taps) {
+            float acc = 0.0f;
+
+            // Plain reduction; vectorized under -O3 -ffast-math
+            for (int j = 0; j < taps; j++) {
+                acc += coefficients[j] * window[j];
+            }
+
+            return acc;
+        }
+    }
+
+    std::shared_ptr<const FilterBank> getFilterBank(int up, int down, Quality quality) {
+        static std::mutex cache_mutex;
+        static std::map<std::tuple<int, int, int>, std::shared_ptr<const FilterBank>> cache;
+
+        if (up <= 0 || down <= 0 || quality < FAST || quality > BEST)
+            return nullptr;
+
+        if (static_cast<long long>(up) * presets[quality].taps > MAX_BANK_COEFFICIENTS)
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto key = std::make_tuple(up, down, static_cast<int>(quality));
+        auto it = cache.find(key);
+
+        if (it != cache.end())
+            return it->second;
+
+        auto bank = design(up, down, quality);
+        cache.emplace(key, bank);
+        return bank;
+    }
+
+    PolyphaseResampler::PolyphaseResampler(int input_rate, int output_rate, Quality quality)
+        : history_(0), base_(0), phase_(0), first_(0), consumed_(0), input_total_(0), produced_(0) {
+        if (input_rate > 0 && output_rate > 0) {
+            int divisor = std::gcd(input_rate, output_rate);
+            bank_ = getFilterBank(output_rate / divisor, input_rate / divisor, quality);
+        }
+
+        reset();
+    }
+
+    void PolyphaseResampler::reset() {
+        long long delay;
+
+        if (!bank_)
+            return;
+
+        history_ = bank_->taps - 1;
+        buffer_.assign(static_cast<size_t>(history_), 0.0f);
+
+        // Start at the filter's centre tap so output sample n lines up with input time n * M / L
+        delay = static_cast<long long>(bank_->taps) * bank_->up / 2;
+        base_ = delay / bank_->up;
+        phase_ = static_cast<int>(delay % bank_->up);
+        first_ = -history_;
+        consumed_ = 0;
+        input_total_ = 0;
+        produced_ = 0;
+    }
+
+    int PolyphaseResampler::maxOutputLength(int input_length) const {
+        long long available;
+
+        if (!bank_ || input_length <= 0)
+            return 0;
+
+        // Input a previous call had no room to turn into output is still buffered
+        available = input_length + std::max(consumed_ - base_, 0LL);
+        return static_cast<int>(available * bank_->up / bank_->down + 1);
+    }
+
+    int PolyphaseResampler::pendingOutputLength() const {
+        long long expected;
+
+        if (!bank_)
+            return 0;
+
+        expected = (input_total_ * bank_->up + bank_->down - 1) / bank_->down;
+        return static_cast<int>(expected - produced_);
+    }
+
+    int PolyphaseResampler::latency() const {
+        return bank_ ? static_cast<int>(std::max(base_ - consumed_ + 1, 0LL)) : 0;
+    }
+
+    int PolyphaseResampler::process(const float* input, int input_length, float* output, int output_capacity) {
+        RESONIX_PROFILE("PolyphaseResampler::process", input_length);
+
+        if (!bank_ || !input || !output || input_length <= 0)
+            return 0;
+
+        input_total_ += input_length;
+        return run(input, input_length, output, output_capacity);
+    }
+
+    int PolyphaseResampler::run(const float* input, int input_length, float* output, int output_capacity) {
+        const int taps = bank_->taps;
+        const int up = bank_->up;
+        const int down = bank_->down;
+        const float* coefficients = bank_->coefficients.data();
+        const long long end = consumed_ + input_length;
+        const float* work;
+        int written = 0;
+
+        buffer_.insert(buffer_.end(), input, input + input_length);
+        work = buffer_.data();
+
+        // work[0] holds absolute input index first_; the window of base_ starts history_ samples before it
+        while (base_ < end && written < output_capacity) {
+            output[written++] = dot(coefficients + static_cast<size_t>(phase_) * taps,
+                                    work + (base_ - history_ - first_), taps);
+            phase_ += down;
+            base_ += phase_ / up;
+            phase_ %= up;
+        }
+
+        // Keep the window of the next output; when output_capacity cut the run short that includes
+        // the input it has not reached yet
+        const long long keep = std::min(base_, end) - history_;
+        buffer_.erase(buffer_.begin(), buffer_.begin() + (keep - first_));
+        first_ = keep;
+        consumed_ = end;
+        produced_ += written;
+
+        return written;
+    }
+
+    int PolyphaseResampler::flush(float* output, int output_capacity) {
+        int pending, padding;
+        std::vector<float> zeros;
+
+        if (!bank_ || !output)
+            return 0;
+
+        pending = pendingOutputLength();
+        if (pending <= 0)
+            return 0;
+
+        if (pending > output_capacity)
+            pending = output_capacity;
+
+        // Last pending output needs input up to its window end; pad with silence
+        padding = static_cast<int>(std::max(base_ - consumed_
+                + static_cast<long long>(pending) * bank_->down / bank_->up + 2, 0LL));
+        zeros.assign(static_cast<size_t>(padding), 0.0f);
+
+        return run(zeros.data(), padding, output, pending);
+    }
+}
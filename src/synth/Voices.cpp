@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <cmath>
+#include "Voices.hpp"
+#include "Dispatch.hpp"
+#include "Generator.hpp"
+#include "Instrument.hpp"
+#include "../generator/Tones.hpp"
+
+namespace Resonix {
+    namespace {
+        // Longest stretch rendered in one go; bounds the scratch block and keeps the float phase exact
+        constexpr int SEGMENT_FRAMES = 1024;
+
+        template <Shape S>
+        inline void mixLoop(float* output, int count, float cycle, float step, float gain, float delta) {
+            for (int i = 0; i < count; i++) {
+                output[i] += (gain + static_cast<float>(i) * delta) * Generator::Tone::at<S>(cycle + static_cast<float>(i) * step);
+            }
+        }
+
+        // Adds count samples of one voice, with a linear gain ramp, onto output
+        RESONIX_CLONES
+        void mixTone(Shape shape, float* output, int count, float cycle, float step, float gain, float delta) {
+            switch (shape) {
+                case SINE:
+                    mixLoop<SINE>(output, count, cycle, step, gain, delta);
+                    break;
+                case COSINE:
+                    mixLoop<COSINE>(output, count, cycle, step, gain, delta);
+                    break;
+                case SQUARE:
+                    mixLoop<SQUARE>(output, count, cycle, step, gain, delta);
+                    break;
+                case TRIANGLE:
+                    mixLoop<TRIANGLE>(output, count, cycle, step, gain, delta);
+                    break;
+                default:
+                    mixLoop<SAWTOOTH>(output, count, cycle, step, gain, delta);
+                    break;
+            }
+        }
+
+        // Heap order: the event that applies last compares greatest
+        bool appliesLater(const NoteEvent& a, long long a_order, const NoteEvent& b, long long b_order) {
+            if (a.time != b.time)
+                return a.time > b.time;
+            if ((a.type == NOTE_ON) != (b.type == NOTE_ON))
+                return a.type == NOTE_ON;
+            return a_order > b_order;
+        }
+    }
+
+    VoiceAllocator::VoiceAllocator(int voice_count)
+        : voices_(static_cast<size_t>(std::min(std::max(voice_count, 1), MAX_VOICE_COUNT))),
+          filtered_(false), regroup_(false), position_(0), scheduled_(0), started_(0), next_note_(-1) {
+        MemoryTag tag("VoiceAllocator");
+        const float declick = static_cast<float>(DECLICK_FRAMES) / SAMPLE_RATE;
+
+        sounding_.reserve(voices_.size());
+        scratch_ = allocateSamples(SEGMENT_FRAMES);
+        setEnvelope(Envelope(declick, 0.0f, 1.0f, declick));
+    }
+
+    bool VoiceAllocator::schedule(const NoteEvent& event) {
+        if (event.time < position_)
+            return false;
+        if (event.type == NOTE_ON && (!Generator::Tone::supports(event.shape) || !(event.frequency > 0.0f) || !std::isfinite(event.frequency)
+                                      || !(event.velocity >= 0.0f)))
+            return false;
+
+        events_.push_back({event, scheduled_++});
+        std::push_heap(events_.begin(), events_.end(), [](const Queued& a, const Queued& b) {
+            return appliesLater(a.event, a.order, b.event, b.order);
+        });
+        return true;
+    }
+
+    bool VoiceAllocator::addNote(long long start, long long duration, Shape shape, float frequency, float velocity) {
+        NoteEvent event;
+
+        if (duration <= 0)
+            return false;
+
+        event.time = start;
+        event.type = NOTE_ON;
+        event.note = next_note_;
+        event.shape = shape;
+        event.frequency = frequency;
+        event.velocity = velocity;
+        if (!schedule(event))
+            return false;
+
+        event.time = start + duration;
+        event.type = NOTE_OFF;
+        schedule(event);
+        next_note_ = next_note_ > -0x7FFFFFFF ? next_note_ - 1 : -1;
+        return true;
+    }
+
+    void VoiceAllocator::setFilter(const Filter::FilterChain& chain) {
+        filtered_ = chain.size() > 0 && scratch_;
+
+        for (Voice& voice : voices_) {
+            voice.filter = chain;
+        }
+    }
+
+    void VoiceAllocator::setEnvelope(const Envelope& envelope) {
+        // Sounding voices keep theirs; each NOTE_ON starts from a fresh copy
+        envelope_ = envelope;
+        envelope_.reset();
+    }
+
+    void VoiceAllocator::reset() {
+        for (Voice& voice : voices_) {
+            voice.active = false;
+            voice.filter.reset();
+        }
+        sounding_.clear();
+        events_.clear();
+        position_ = 0;
+        scheduled_ = 0;
+        started_ = 0;
+        next_note_ = -1;
+        stats_ = VoiceStats();
+    }
+
+    VoiceAllocator::Voice& VoiceAllocator::allocate() {
+        Voice* oldest = nullptr;
+
+        for (Voice& voice : voices_) {
+            if (!voice.active)
+                return voice;
+        }
+
+        // Releasing voices are nearly silent already, so they go first
+        for (Voice& voice : voices_) {
+            if (!oldest || voice.releasing > oldest->releasing
+                || (voice.releasing == oldest->releasing && voice.started < oldest->started))
+                oldest = &voice;
+        }
+
+        stats_.steals++;
+        return *oldest;
+    }
+
+    void VoiceAllocator::release(Voice& voice) {
+        voice.releasing = true;
+        voice.envelope.noteOff();
+    }
+
+    void VoiceAllocator::apply(const NoteEvent& event) {
+        if (event.type == NOTE_ON) {
+            Voice& voice = allocate();
+
+            if (!voice.active) {
+                sounding_.push_back(static_cast<int>(&voice - voices_.data()));
+                regroup_ = true;
+            } else if (voice.shape != event.shape) {
+                regroup_ = true;
+            }
+
+            voice.active = true;
+            voice.releasing = false;
+            voice.note = event.note;
+            voice.shape = event.shape;
+            voice.frequency = event.frequency;
+            voice.age = 0;
+            voice.started = started_++;
+            voice.velocity = event.velocity;
+            voice.envelope = envelope_;
+            voice.envelope.noteOn();
+            if (filtered_)
+                voice.filter.reset();
+
+            stats_.notes++;
+            stats_.peak_active = std::max(stats_.peak_active, static_cast<int>(sounding_.size()));
+            return;
+        }
+
+        for (int index : sounding_) {
+            Voice& voice = voices_[static_cast<size_t>(index)];
+
+            if (!voice.releasing && (event.type == ALL_NOTES_OFF || voice.note == event.note))
+                release(voice);
+        }
+    }
+
+    void VoiceAllocator::renderVoice(Voice& voice, float* output, int frames) {
+        const float step = voice.frequency / SAMPLE_RATE;
+        Ramp ramp;
+
+        // One mix pass per envelope ramp; a finished release leaves the rest silent
+        for (int done = 0; done < frames && voice.envelope.active(); done += ramp.frames) {
+            ramp = voice.envelope.next(frames - done);
+            mixTone(voice.shape, output + done, ramp.frames, Generator::cycleAt(voice.age + done, voice.frequency) + step, step,
+                    voice.velocity * ramp.start, voice.velocity * ramp.delta);
+        }
+
+        voice.age += frames;
+        if (!voice.envelope.active())
+            voice.active = false;
+    }
+
+    void VoiceAllocator::renderSegment(float* output, int frames) {
+        float* scratch = scratch_.get();
+
+        if (regroup_) {
+            std::sort(sounding_.begin(), sounding_.end(), [this](int a, int b) {
+                const Shape shape_a = voices_[static_cast<size_t>(a)].shape, shape_b = voices_[static_cast<size_t>(b)].shape;
+                return shape_a != shape_b ? shape_a < shape_b : a < b;
+            });
+            regroup_ = false;
+        }
+
+        for (int index : sounding_) {
+            Voice& voice = voices_[static_cast<size_t>(index)];
+
+            if (!filtered_) {
+                renderVoice(voice, output, frames);
+                continue;
+            }
+
+            std::fill(scratch, scratch + frames, 0.0f);
+            renderVoice(voice, scratch, frames);
+            voice.filter.process(scratch, scratch, frames);
+            for (int i = 0; i < frames; i++) {
+                output[i] += scratch[i];
+            }
+        }
+
+        sounding_.erase(std::remove_if(sounding_.begin(), sounding_.end(), [this](int index) {
+            return !voices_[static_cast<size_t>(index)].active;
+        }), sounding_.end());
+        stats_.active = static_cast<int>(sounding_.size());
+    }
+
+    void VoiceAllocator::render(float* output, int frames) {
+        RESONIX_PROFILE("VoiceAllocator::render", frames);
+        const auto later = [](const Queued& a, const Queued& b) {
+            return appliesLater(a.event, a.order, b.event, b.order);
+        };
+        int done = 0, count;
+
+        if (!output || frames <= 0)
+            return;
+
+        std::fill(output, output + frames, 0.0f);
+
+        while (done < frames) {
+            while (!events_.empty() && events_.front().event.time <= position_) {
+                apply(events_.front().event);
+                std::pop_heap(events_.begin(), events_.end(), later);
+                events_.pop_back();
+            }
+
+            count = std::min(frames - done, SEGMENT_FRAMES);
+            if (!events_.empty())
+                count = static_cast<int>(std::min<long long>(count, events_.front().event.time - position_));
+
+            renderSegment(output + done, count);
+            position_ += count;
+            done += count;
+        }
+    }
+}
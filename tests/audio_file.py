@@ -0,0 +1,82 @@
+import resonix
+import numpy as np
+import os
+import struct
+
+os.makedirs('output', exist_ok=True)
+
+frames = resonix.SAMPLE_RATE // 3
+t = np.arange(frames) / resonix.SAMPLE_RATE
+stereo = np.stack([0.5 * np.sin(2 * np.pi * 440.0 * t), 0.25 * np.sin(2 * np.pi * 660.0 * t)], axis=1).astype(np.float32)
+
+# Round trip through the writer for every stored encoding
+for sample_format, tolerance in [(resonix.SampleFormat.FLOAT32, 0.0),
+                                 (resonix.SampleFormat.INT16, 2.0 / 32768),
+                                 (resonix.SampleFormat.INT24, 2.0 / 8388608),
+                                 (resonix.SampleFormat.FLOAT16, 1e-3)]:
+    path = 'output/roundtrip_%s.wav' % sample_format.name.lower()
+    with resonix.AudioFileWriter(path, channels=2, sample_format=sample_format, dither=False) as writer:
+        writer.write(stereo[:1000])
+        writer.write(stereo[1000:])
+
+    with resonix.AudioFileReader(path) as reader:
+        assert reader.channels == 2 and len(reader) == frames and reader.format == sample_format
+        decoded = reader.read()
+        assert decoded.shape == stereo.shape
+        assert np.max(np.abs(decoded - stereo)) <= tolerance
+        if sample_format == resonix.SampleFormat.FLOAT32:
+            assert np.array_equal(reader.samples(), stereo)
+        assert np.array_equal(reader.read(frames - 10), decoded[frames - 10:])
+
+# An odd INT24 data chunk is followed by a pad byte, so the RIFF size stays even
+with resonix.AudioFileWriter('output/odd_int24.wav', sample_format=resonix.SampleFormat.INT24) as writer:
+    writer.write(stereo[:1001, 0].copy())
+with open('output/odd_int24.wav', 'rb') as source:
+    odd = source.read()
+assert len(odd) % 2 == 0 and struct.unpack('<I', odd[4:8])[0] == len(odd) - 8
+with resonix.AudioFileReader('output/odd_int24.wav') as reader:
+    assert len(reader) == 1001
+
+# Every encoding call draws its own dither noise
+quiet = (stereo[:, 0] * 1e-3).copy()
+first = resonix.lowpass_filter(quiet, 8000.0, sample_format=resonix.SampleFormat.INT16)
+second = resonix.lowpass_filter(quiet, 8000.0, sample_format=resonix.SampleFormat.INT16)
+undithered = resonix.lowpass_filter(quiet, 8000.0, sample_format=resonix.SampleFormat.INT16, dither=False)
+assert not np.array_equal(first, second)
+assert np.max(np.abs(first.astype(np.int32) - undithered)) <= 2
+
+# A recording cut off mid-write opens with the whole frames that reached the disk
+with open('output/roundtrip_int16.wav', 'rb') as source:
+    complete = source.read()
+with open('output/truncated.wav', 'wb') as target:
+    target.write(complete[:len(complete) - 1001])
+with resonix.AudioFileReader('output/truncated.wav') as reader:
+    assert len(reader) == frames - 251
+
+# A lazy signal streamed block by block into a file matches the same signal evaluated in memory
+vowel = resonix.Signal.tone(resonix.Shape.SAWTOOTH, 110.0).formant(peak=0.5, mix=1.0, spread=0.0)
+with resonix.AudioFileWriter('output/vowel_stream.wav') as writer:
+    vowel.write(writer, frames, block_size=1000)
+    assert writer.frames_written == frames
+with resonix.AudioFileReader('output/vowel_stream.wav') as reader:
+    assert np.array_equal(reader.read(), vowel.evaluate(frames))
+
+
+def refuses(data):
+    with open('output/broken.wav', 'wb') as target:
+        target.write(data)
+    try:
+        resonix.AudioFileReader('output/broken.wav')
+    except RuntimeError:
+        return True
+    return False
+
+
+# Headers cut short are refused rather than read past the end of the mapping
+for length in [0, 11, 12, 30, 60, 100]:
+    assert refuses(complete[:length])
+
+# RF64 whose ds64 chunk runs past the end of the file
+assert refuses(b'RF64' + struct.pack('<I', 0xFFFFFFFF) + b'WAVE' + b'ds64' + struct.pack('<I', 28) + b'\0' * 8)
+
+print('Test finished')
@@ -0,0 +1,37 @@
+import resonix
+import numpy as np
+
+HOUR = 3600 * 44100
+FRAMES = 1 << 18
+
+
+def render(shape, frequency, length, start, cached):
+    resonix.set_cycle_cache_limit(16 << 20 if cached else 0)
+    osc = resonix.Oscillator(shape, frequency, length)
+    osc.seek(start)
+    return np.concatenate([osc.render(1000) for _ in range(FRAMES // 1000)])
+
+
+# Tiled tones match the direct render however long they run and whatever length they were made for.
+# Single samples may still flip across a wrap of the waveform, so the mean error is what must stay tiny.
+for frequency in [437.3, 1234.567, 440.0, 110.0, 32.210026]:
+    for shape in [resonix.Shape.SINE, resonix.Shape.SAWTOOTH]:
+        direct = render(shape, frequency, 44100, HOUR, cached=False)
+        for length in [44100, 600 * 44100, HOUR + FRAMES]:
+            tiled = render(shape, frequency, length, HOUR, cached=True)
+            error = np.abs(tiled - direct)
+            assert np.mean(error) < 1e-3, (frequency, shape, length, np.mean(error))
+            if shape == resonix.Shape.SINE:
+                assert np.max(error) < 0.1, (frequency, length, np.max(error))
+
+for frequency in [437.3, 440.0, 1000.0]:
+    resonix.set_cycle_cache_limit(16 << 20)
+    tiled = resonix.generate_samples(resonix.Shape.SINE, 60, frequency)
+    resonix.set_cycle_cache_limit(0)
+    direct = resonix.generate_samples(resonix.Shape.SINE, 60, frequency)
+    assert np.mean(np.abs(tiled - direct)) < 1e-4
+    assert np.max(np.abs(tiled[-44100:] - direct[-44100:])) < 0.1
+
+resonix.set_cycle_cache_limit(16 << 20)
+
+print('Test finished')
@@ -0,0 +1,47 @@
+import resonix
+import numpy as np
+
+sample_rate = resonix.SAMPLE_RATE
+cutoff, resonance = 30.0, 0.707
+
+
+def reference_lowpass(x):
+    # Cookbook lowpass evaluated in double precision
+    omega = 2.0 * np.pi * cutoff / sample_rate
+    alpha = np.sin(omega) / (2.0 * np.float32(resonance))
+    cos_omega = np.cos(omega)
+    a0 = 1.0 + alpha
+    b0, b1, b2 = (1.0 - cos_omega) / 2.0 / a0, (1.0 - cos_omega) / a0, (1.0 - cos_omega) / 2.0 / a0
+    a1, a2 = -2.0 * cos_omega / a0, (1.0 - alpha) / a0
+    y = np.empty_like(x)
+    x1 = x2 = y1 = y2 = 0.0
+    for i, value in enumerate(x):
+        out = b0 * value + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2
+        x2, x1, y2, y1 = x1, value, y1, out
+        y[i] = out
+    return y
+
+
+t = np.arange(3 * sample_rate) / sample_rate
+signal64 = np.sin(2 * np.pi * 55.0 * t) + 0.3 * np.sin(2 * np.pi * 6300.0 * t)
+signal32 = signal64.astype(np.float32)
+
+filtered64 = resonix.lowpass_filter(signal64, cutoff, resonance)
+filtered32 = resonix.lowpass_filter(signal32, cutoff, resonance)
+assert filtered64.dtype == np.float64 and filtered32.dtype == np.float32
+
+# float64 runs a double-precision filter; float32 stays close to it
+expected = reference_lowpass(signal64)
+assert np.max(np.abs(filtered64 - expected)) < 1e-10
+assert np.max(np.abs(filtered64 - filtered32)) < 1e-2
+
+# Statistics are collected block by block, which must not change the samples
+with_stats, stats = resonix.lowpass_filter(signal64, cutoff, resonance, return_stats=True)
+assert np.array_equal(with_stats, filtered64)
+assert abs(stats.peak - np.max(np.abs(filtered64))) < 1e-6
+
+stereo = np.stack([signal64, -signal64])
+both, channel_stats = resonix.lowpass_filter(stereo, cutoff, resonance, return_stats=True)
+assert np.array_equal(both[0], filtered64) and np.array_equal(both[1], -filtered64)
+
+print('Test finished')
@@ -5,6 +5,19 @@ import matplotlib.pyplot as plt
 
 os.makedirs('output', exist_ok=True)
 
+MB = 1024 * 1024
+
+
+def peak_mb(call):
+    # High-water mark of the call's own allocations, temporaries included
+    resonix.reset_memory_stats()
+    baseline = resonix.memory_stats()['live_bytes']
+    result = call()
+    peak = resonix.memory_stats()['peak_bytes'] - baseline
+    del result
+    return peak / MB
+
+
 iterations = 100
 memory_samples = []
 allocation_sizes = []
@@ -25,10 +38,7 @@ shape_memory = {shape: [] for shape in shapes}
 
 for i in range(iterations):
     for shape in shapes:
-        samples = resonix.generate_samples(shape, 1, 440.0)
-        memory_mb = samples.nbytes / (1024 * 1024)
-        shape_memory[shape].append(memory_mb)
-        del samples
+        shape_memory[shape].append(peak_mb(lambda: resonix.generate_samples(shape, 1, 440.0)))
 
 filter_memory = []
 filter_types = ['lowpass', 'highpass', 'bandpass', 'formant']
@@ -37,21 +47,10 @@ filter_data = {ftype: [] for ftype in filter_types}
 for i in range(iterations):
     base_samples = resonix.generate_samples(resonix.Shape.SINE, 1, 440.0)
 
-    lowpass = resonix.lowpass_filter(base_samples, 1000.0, 0.707)
-    filter_data['lowpass'].append(lowpass.nbytes / (1024 * 1024))
-    del lowpass
-
-    highpass = resonix.highpass_filter(base_samples, 1000.0, 0.707)
-    filter_data['highpass'].append(highpass.nbytes / (1024 * 1024))
-    del highpass
-
-    bandpass = resonix.bandpass_filter(base_samples, 1000.0, 500.0, 0.707)
-    filter_data['bandpass'].append(bandpass.nbytes / (1024 * 1024))
-    del bandpass
-
-    formant = resonix.formant_filter(base_samples, 0.5, 0.8, 0.2)
-    filter_data['formant'].append(formant.nbytes / (1024 * 1024))
-    del formant
+    filter_data['lowpass'].append(peak_mb(lambda: resonix.lowpass_filter(base_samples, 1000.0, 0.707)))
+    filter_data['highpass'].append(peak_mb(lambda: resonix.highpass_filter(base_samples, 1000.0, 0.707)))
+    filter_data['bandpass'].append(peak_mb(lambda: resonix.bandpass_filter(base_samples, 1000.0, 500.0, 0.707)))
+    filter_data['formant'].append(peak_mb(lambda: resonix.formant_filter(base_samples, 0.5, 0.8, 0.2)))
 
     del base_samples
 
@@ -59,9 +58,7 @@ duration_tests = [1, 2, 5, 10, 20]
 duration_memory = []
 
 for duration in duration_tests:
-    samples = resonix.generate_samples(resonix.Shape.SINE, duration, 440.0)
-    duration_memory.append(samples.nbytes / (1024 * 1024))
-    del samples
+    duration_memory.append(peak_mb(lambda: resonix.generate_samples(resonix.Shape.SINE, duration, 440.0)))
 
 fig, axs = plt.subplots(2, 2, figsize=(16, 12))
 
@@ -123,10 +120,11 @@ fig2, axs2 = plt.subplots(1, 2, figsize=(16, 6))
 leak_test_iterations = 500
 leak_memory = []
 
+# Memory still live after each result is freed; anything but a flat line is a leak
 for i in range(leak_test_iterations):
     samples = resonix.generate_samples(resonix.Shape.SINE, 1, 440.0)
-    leak_memory.append(samples.nbytes / (1024 * 1024))
     del samples
+    leak_memory.append(resonix.memory_stats()['live_bytes'] / MB)
 
 axs2[0].plot(range(leak_test_iterations), leak_memory, color='darkred', linewidth=1, alpha=0.8)
 axs2[0].set_title('Memory Leak Detection (500 Iterations)', fontweight='bold', fontsize=12)
@@ -147,9 +145,9 @@ all_filter_memory = []
 for i in range(leak_test_iterations):
     base_samples = resonix.generate_samples(resonix.Shape.SINE, 1, 440.0)
     filtered = resonix.lowpass_filter(base_samples, 1000.0, 0.707)
-    all_filter_memory.append(filtered.nbytes / (1024 * 1024))
     del filtered
     del base_samples
+    all_filter_memory.append(resonix.memory_stats()['live_bytes'] / MB)
 
 axs2[1].plot(range(leak_test_iterations), all_filter_memory, color='darkblue', linewidth=1, alpha=0.8)
 axs2[1].set_title('Filter Memory Leak Detection (500 Iterations)', fontweight='bold', fontsize=12)
@@ -169,4 +167,13 @@ axs2[1].legend(loc='upper right')
 plt.tight_layout()
 plt.savefig('output/memory_report.png', dpi=150, bbox_inches='tight')
 
+# Every call measured above is charged to its own API rather than to 'other'
+apis = resonix.memory_stats()['apis']
+for api in ['Resonix::generateSamples', 'Resonix::lowpass_filter', 'Resonix::highpass_filter',
+            'Resonix::bandpass_filter', 'Resonix::formant_filter']:
+    assert api in apis, api
+
+for api, usage in apis.items():
+    print(f"{api:32s} {usage['allocations']:8d} allocations, peak {usage['peak_bytes'] / MB:8.2f} MB")
+
 print("Test finished")
\ No newline at end of file
@@ -0,0 +1,57 @@
+import resonix
+import numpy as np
+import os
+
+os.makedirs('output', exist_ok=True)
+
+osc = resonix.Oscillator(resonix.Shape.SAWTOOTH, 220.0)
+expected = resonix.Oscillator(resonix.Shape.SAWTOOTH, 220.0).render(4096)
+
+# Headless run into a file: the ring is full when start() returns, so the first buffer_frames frames are the stream
+renderer = resonix.RenderThread(osc, block_size=256, buffer_frames=4096)
+renderer.start()
+with resonix.AudioFileWriter('output/render_thread.wav', channels=1, sample_format=resonix.SampleFormat.FLOAT32) as writer:
+    sink = resonix.SinkThread(renderer, writer, period=256, realtime=False)
+    sink.start(resonix.SAMPLE_RATE)
+    sink.wait()
+    assert sink.frames_delivered == resonix.SAMPLE_RATE
+renderer.stop()
+
+with resonix.AudioFileReader('output/render_thread.wav') as reader:
+    recorded = reader.read()
+assert len(recorded) == resonix.SAMPLE_RATE
+assert np.array_equal(recorded[:4096], expected)
+
+stats = renderer.stats()
+assert stats['frames_read'] + stats['underrun_frames'] == resonix.SAMPLE_RATE
+
+# Restarting while a device keeps pulling; start() once reset the ring under a running read()
+renderer = resonix.RenderThread(osc, block_size=64, buffer_frames=1024)
+renderer.start()
+sink = resonix.SinkThread(renderer, period=64, realtime=False)
+sink.start()
+for _ in range(200):
+    renderer.stop()
+    renderer.start()
+sink.stop()
+renderer.stop()
+assert not sink.running and sink.frames_delivered > 0
+
+block = renderer.read(512)
+assert np.all(np.isfinite(block)) and np.max(np.abs(block)) <= 1.0
+
+# Reading from Python while a sink pulls, then closing the sink's writer under it
+renderer = resonix.RenderThread(osc, block_size=64, buffer_frames=1024)
+renderer.start()
+writer = resonix.AudioFileWriter('output/render_thread_closed.wav')
+sink = resonix.SinkThread(renderer, writer, period=64, realtime=False)
+sink.start()
+for _ in range(200):
+    block = renderer.read(64)
+    assert np.all(np.isfinite(block)) and np.max(np.abs(block)) <= 1.0
+writer.close()
+sink.wait()
+renderer.stop()
+assert not sink.running and sink.frames_delivered > 0
+
+print('Test finished')
@@ -0,0 +1,32 @@
+import resonix
+import numpy as np
+
+signal = resonix.generate_samples(resonix.Shape.SINE, 1, 440.0)
+
+for input_rate, output_rate in [(44100, 48000), (48000, 44100), (44100, 88200), (88200, 44100)]:
+    whole = resonix.Resampler(input_rate, output_rate, resonix.ResampleQuality.HIGH)
+    expected = np.concatenate([whole.process(signal), whole.flush()])
+
+    # Blocks of any size give the output of a single call
+    blocks = resonix.Resampler(input_rate, output_rate, resonix.ResampleQuality.HIGH)
+    edges = [0, 1, 7, 300, 301, 4096, 20000, len(signal)]
+    parts = [blocks.process(signal[a:b]) for a, b in zip(edges[:-1], edges[1:])]
+    streamed = np.concatenate(parts + [blocks.flush()])
+
+    assert len(streamed) == len(expected) == -(-len(signal) * output_rate // input_rate)
+    assert np.array_equal(streamed, expected)
+
+    # Regression: process() after flush() without reset() once read before the history buffer
+    after = blocks.process(signal[:2048])
+    assert np.all(np.isfinite(after))
+    assert np.max(np.abs(after)) < 1.5
+
+    blocks.reset()
+    again = np.concatenate([blocks.process(signal), blocks.flush()])
+    assert np.array_equal(again, expected)
+
+# One-shot resample() copies strided and float64 input into a contiguous float32 array first
+for view in [signal[::2], signal[::2].astype(np.float64)]:
+    assert np.array_equal(resonix.resample(view, 48000), resonix.resample(np.ascontiguousarray(signal[::2]), 48000))
+
+print('Test finished')
@@ -0,0 +1,427 @@
+/*
+ * resonix_bench: native micro-benchmarks of the generators, filters, Math
+ * kernels and sample encoders.
+ *
+ * Every benchmark runs over a sweep of buffer sizes. One sample of a
+ * measurement is a batch of back-to-back calls lasting at least --min-time,
+ * taken after a warm-up batch of the same length, and is repeated
+ * --repetitions times. Results go to stdout as JSON, a readable table to
+ * stderr.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BufferPool.hpp"
+#include "Dispatch.hpp"
+#include "Filter.hpp"
+#include "Math.hpp"
+#include "Oscillator.hpp"
+#include "Pcm.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using Body = std::function<void()>;
+
+    const std::vector<long long> DEFAULT_SIZES = {64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304, 10000000};
+    const std::vector<long long> QUICK_SIZES = {64, 4096, 262144, 10000000};
+
+    struct Options {
+        std::vector<long long> sizes = DEFAULT_SIZES;
+        std::string filter;
+        std::string output;
+        int repetitions = 10;
+        double min_time_ms = 5.0;
+        bool quiet = false;
+        bool list = false;
+    };
+
+    /*
+     * A benchmark prepares its state for one buffer size and returns the body
+     * that is timed; bytes_per_sample counts memory read plus written.
+     */
+    struct Benchmark {
+        std::string group;
+        std::string name;
+        int bytes_per_sample;
+        std::function<Body(long long frames)> prepare;
+    };
+
+    struct Measurement {
+        const Benchmark* benchmark;
+        long long frames;
+        long long iterations;
+        std::vector<double> ns_per_sample;
+    };
+
+    // Shared input and output, sized for the largest frame count
+    Resonix::SampleBuffer input_samples;
+    Resonix::SampleBuffer output_samples;
+    std::unique_ptr<unsigned char[]> encoded;
+
+    // Keeps results observable so the compiler cannot drop the calls under LTO
+    volatile float sink;
+
+    void usage(std::FILE* out) {
+        std::fprintf(out,
+                     "usage: resonix_bench [options]\n"
+                     "\n"
+                     "Measures ns/sample and GB/s of every shape, filter, Math kernel and encoder,\n"
+                     "and prints the results as JSON.\n"
+                     "\n"
+                     "options:\n"
+                     "  -f, --filter TEXT      only benchmarks whose group/name contains TEXT\n"
+                     "  -s, --sizes N,N,...    frame counts to sweep (default: 64 ... 10000000)\n"
+                     "  -r, --repetitions N    timed samples per measurement (default: 10)\n"
+                     "  -t, --min-time MS      minimum duration of one sample (default: 5)\n"
+                     "      --quick            sizes 64,4096,262144,10000000 and 5 repetitions\n"
+                     "  -o, --output FILE      write the JSON to FILE instead of stdout\n"
+                     "  -l, --list             list the benchmarks and exit\n"
+                     "  -q, --quiet            no table on stderr\n"
+                     "  -h, --help             show this message\n");
+    }
+
+    bool parseSizes(const std::string& text, std::vector<long long>& sizes) {
+        const char* p = text.c_str();
+        char* end;
+
+        sizes.clear();
+        while (*p) {
+            long long size = std::strtoll(p, &end, 10);
+            if (end == p || size <= 0)
+                return false;
+            sizes.push_back(size);
+            p = *end == ',' ? end + 1 : end;
+            if (*end && *end != ',')
+                return false;
+        }
+        return !sizes.empty();
+    }
+
+    bool parseArguments(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            const bool has_value = i + 1 < argc;
+
+            if (arg == "-h" || arg == "--help") {
+                usage(stdout);
+                std::exit(0);
+            } else if ((arg == "-f" || arg == "--filter") && has_value) {
+                options.filter = argv[++i];
+            } else if ((arg == "-s" || arg == "--sizes") && has_value) {
+                if (!parseSizes(argv[++i], options.sizes))
+                    return false;
+            } else if ((arg == "-r" || arg == "--repetitions") && has_value) {
+                options.repetitions = std::atoi(argv[++i]);
+                if (options.repetitions <= 0)
+                    return false;
+            } else if ((arg == "-t" || arg == "--min-time") && has_value) {
+                options.min_time_ms = std::atof(argv[++i]);
+                if (!(options.min_time_ms > 0.0))
+                    return false;
+            } else if (arg == "--quick") {
+                options.sizes = QUICK_SIZES;
+                options.repetitions = 5;
+            } else if ((arg == "-o" || arg == "--output") && has_value) {
+                options.output = argv[++i];
+            } else if (arg == "-l" || arg == "--list") {
+                options.list = true;
+            } else if (arg == "-q" || arg == "--quiet") {
+                options.quiet = true;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Benchmark shapeBenchmark(const char* name, Resonix::Shape shape) {
+        return {"generator", name, 4, [shape](long long frames) -> Body {
+            auto oscillator = std::make_shared<Resonix::Oscillator>(shape, 440.0f, frames, 1);
+            const int count = static_cast<int>(frames);
+            return [oscillator, count] {
+                oscillator->seek(0);
+                oscillator->render(output_samples.get(), count);
+                sink = output_samples[0];
+            };
+        }};
+    }
+
+    Benchmark biquadBenchmark(const char* name, Filter::BiquadFilter filter) {
+        return {"filter", name, 8, [filter](long long frames) -> Body {
+            auto state = std::make_shared<Filter::BiquadFilter>(filter);
+            const int count = static_cast<int>(frames);
+            return [state, count] {
+                state->process(input_samples.get(), output_samples.get(), count);
+                sink = output_samples[0];
+            };
+        }};
+    }
+
+    // Applies a scalar Math kernel across the buffer, the way the generators call it
+    template <typename Kernel>
+    Benchmark mathBenchmark(const char* name, Kernel kernel) {
+        return {"math", name, 8, [kernel](long long frames) -> Body {
+            return [kernel, frames] {
+                const float* in = input_samples.get();
+                float* out = output_samples.get();
+                for (long long i = 0; i < frames; i++) {
+                    out[i] = kernel(in[i], static_cast<float>(i));
+                }
+                sink = out[0];
+            };
+        }};
+    }
+
+    Benchmark encodeBenchmark(const char* name, Resonix::SampleFormat format, bool dithered) {
+        return {"pcm", name, 4 + Resonix::bytesPerSample(format), [format, dithered](long long frames) -> Body {
+            auto dither = std::make_shared<Resonix::Dither>();
+            return [format, dithered, dither, frames] {
+                Resonix::encodeSamples(input_samples.get(), frames, format, encoded.get(), dithered ? dither.get() : nullptr);
+                sink = static_cast<float>(encoded[0]);
+            };
+        }};
+    }
+
+    Benchmark decodeBenchmark(const char* name, Resonix::SampleFormat format) {
+        return {"pcm", name, 4 + Resonix::bytesPerSample(format), [format](long long frames) -> Body {
+            Resonix::encodeSamples(input_samples.get(), frames, format, encoded.get());
+            return [format, frames] {
+                Resonix::decodeSamples(encoded.get(), frames, 1, format, output_samples.get());
+                sink = output_samples[0];
+            };
+        }};
+    }
+
+    std::vector<Benchmark> benchmarks() {
+        std::vector<Benchmark> list = {
+            shapeBenchmark("SINE", Resonix::SINE),
+            shapeBenchmark("SQUARE", Resonix::SQUARE),
+            shapeBenchmark("TRIANGLE", Resonix::TRIANGLE),
+            shapeBenchmark("SAWTOOTH", Resonix::SAWTOOTH),
+            shapeBenchmark("COSINE", Resonix::COSINE),
+            shapeBenchmark("TANGENT", Resonix::TANGENT),
+            shapeBenchmark("COTANGENT", Resonix::COTANGENT),
+            shapeBenchmark("HANN", Resonix::HANN),
+            shapeBenchmark("PHASED_HANN", Resonix::PHASED_HANN),
+            shapeBenchmark("NOISE_WHITE", Resonix::NOISE_WHITE),
+            shapeBenchmark("NOISE_PINK", Resonix::NOISE_PINK),
+            shapeBenchmark("NOISE_BROWN", Resonix::NOISE_BROWN),
+
+            biquadBenchmark("lowpass", Filter::make_lowpass_filter(1000.0f, 0.707f)),
+            biquadBenchmark("highpass", Filter::make_highpass_filter(1000.0f, 0.707f)),
+            biquadBenchmark("bandpass", Filter::make_bandpass_filter(1000.0f, 500.0f, 0.707f)),
+            {"filter", "formant", 8, [](long long frames) -> Body {
+                auto formant = std::make_shared<Filter::FormantFilter>();
+                const int count = static_cast<int>(frames);
+                formant->setup(0.5f, 0.8f, 0.2f);
+                return [formant, count] {
+                    formant->process(input_samples.get(), output_samples.get(), count);
+                    sink = output_samples[0];
+                };
+            }},
+            {"filter", "chain", 8, [](long long frames) -> Body {
+                auto chain = std::make_shared<Filter::FilterChain>();
+                Filter::FormantFilter formant;
+                const int count = static_cast<int>(frames);
+                formant.setup(0.5f, 0.8f, 0.2f);
+                chain->addBiquad(Filter::make_highpass_filter(80.0f, 0.707f));
+                chain->addBiquad(Filter::make_lowpass_filter(8000.0f, 0.707f));
+                chain->addFormant(formant);
+                return [chain, count] {
+                    chain->process(input_samples.get(), output_samples.get(), count);
+                    sink = output_samples[0];
+                };
+            }},
+
+            mathBenchmark("Sine", [](float x, float) { return Math::Sine(x * 360.0f); }),
+            mathBenchmark("Cosine", [](float x, float) { return Math::Cosine(x * 360.0f); }),
+            mathBenchmark("Tangent", [](float x, float) { return Math::Tangent(x * 80.0f); }),
+            mathBenchmark("Cotangent", [](float x, float) { return Math::Cotangent(x * 80.0f + 90.0f); }),
+            mathBenchmark("Hann", [](float, float n) { return Math::Hann(n, 4096.0f); }),
+            mathBenchmark("fmod", [](float x, float n) { return Math::fmod(n + x, 360.0f); }),
+            mathBenchmark("clamp", [](float x, float) { return Math::clamp(x, -0.5f, 0.5f); }),
+            mathBenchmark("min", [](float x, float) { return Math::min(x, 0.25f); }),
+            mathBenchmark("abs", [](float x, float) { return Math::abs(x); }),
+            mathBenchmark("isNaN", [](float x, float) { return Math::isNaN(x) ? 0.0f : x; }),
+
+            encodeBenchmark("encode_int16", Resonix::INT16, false),
+            encodeBenchmark("encode_int16_dither", Resonix::INT16, true),
+            encodeBenchmark("encode_int24_dither", Resonix::INT24, true),
+            encodeBenchmark("encode_float16", Resonix::FLOAT16, false),
+            decodeBenchmark("decode_int16", Resonix::INT16),
+            decodeBenchmark("decode_int24", Resonix::INT24),
+            decodeBenchmark("decode_float16", Resonix::FLOAT16),
+        };
+        return list;
+    }
+
+    double elapsedNs(const Body& body, long long iterations) {
+        const Clock::time_point start = Clock::now();
+        for (long long i = 0; i < iterations; i++)
+            body();
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    Measurement measure(const Benchmark& benchmark, long long frames, const Options& options) {
+        const double min_time_ns = options.min_time_ms * 1e6;
+        Body body = benchmark.prepare(frames);
+        Measurement result{&benchmark, frames, 1, {}};
+        double warm_up;
+
+        // The first call faults in the buffers; a warm-up batch then settles caches and clocks and sizes the timed batches
+        warm_up = elapsedNs(body, 1);
+        result.iterations = std::max(1LL, static_cast<long long>(std::ceil(min_time_ns / std::max(warm_up, 1.0))));
+        warm_up = elapsedNs(body, result.iterations) / static_cast<double>(result.iterations);
+        result.iterations = std::max(1LL, static_cast<long long>(std::ceil(min_time_ns / std::max(warm_up, 1.0))));
+
+        for (int r = 0; r < options.repetitions; r++) {
+            const double ns = elapsedNs(body, result.iterations);
+            result.ns_per_sample.push_back(ns / static_cast<double>(result.iterations * frames));
+        }
+        return result;
+    }
+
+    struct Summary {
+        double min, median, mean, stddev;
+    };
+
+    Summary summarize(std::vector<double> values) {
+        Summary summary{0.0, 0.0, 0.0, 0.0};
+        const size_t n = values.size();
+
+        std::sort(values.begin(), values.end());
+        summary.min = values.front();
+        summary.median = n % 2 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+        for (double value : values)
+            summary.mean += value;
+        summary.mean /= static_cast<double>(n);
+        for (double value : values)
+            summary.stddev += (value - summary.mean) * (value - summary.mean);
+        summary.stddev = n > 1 ? std::sqrt(summary.stddev / static_cast<double>(n - 1)) : 0.0;
+        return summary;
+    }
+
+    std::string cpuModel() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 10, "model name") == 0) {
+                size_t colon = line.find(':');
+                if (colon != std::string::npos)
+                    return line.substr(line.find_first_not_of(' ', colon + 1));
+            }
+        }
+        return "unknown";
+    }
+
+    std::string jsonString(const std::string& text) {
+        std::string out = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                out += c;
+        }
+        return out + "\"";
+    }
+
+    void writeJson(std::FILE* out, const std::vector<Measurement>& measurements, const Options& options) {
+        std::fprintf(out, "{\n");
+        std::fprintf(out, "  \"schema\": 1,\n");
+        std::fprintf(out, "  \"sample_rate\": %d,\n", Resonix::SAMPLE_RATE);
+        std::fprintf(out, "  \"cpu\": %s,\n", jsonString(cpuModel()).c_str());
+        std::fprintf(out, "  \"simd\": %s,\n", jsonString(Resonix::simdLevel()).c_str());
+#ifdef __VERSION__
+        std::fprintf(out, "  \"compiler\": %s,\n", jsonString(__VERSION__).c_str());
+#endif
+        std::fprintf(out, "  \"repetitions\": %d,\n", options.repetitions);
+        std::fprintf(out, "  \"min_time_ms\": %g,\n", options.min_time_ms);
+        std::fprintf(out, "  \"results\": [");
+
+        for (size_t i = 0; i < measurements.size(); i++) {
+            const Measurement& m = measurements[i];
+            const Summary s = summarize(m.ns_per_sample);
+
+            std::fprintf(out, "%s\n    {\"group\": %s, \"name\": %s, \"frames\": %lld, \"iterations\": %lld, "
+                              "\"ns_per_sample\": {\"min\": %.6g, \"median\": %.6g, \"mean\": %.6g, \"stddev\": %.6g}, "
+                              "\"samples_per_s\": %.6g, \"gb_per_s\": %.6g, \"bytes_per_sample\": %d}",
+                         i ? "," : "", jsonString(m.benchmark->group).c_str(), jsonString(m.benchmark->name).c_str(),
+                         m.frames, m.iterations, s.min, s.median, s.mean, s.stddev, 1e9 / s.median,
+                         m.benchmark->bytes_per_sample / s.median, m.benchmark->bytes_per_sample);
+        }
+        std::fprintf(out, "\n  ]\n}\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<Benchmark> list = benchmarks();
+    std::vector<Measurement> measurements;
+    long long largest;
+    std::FILE* out = stdout;
+
+    if (!parseArguments(argc, argv, options)) {
+        usage(stderr);
+        return 2;
+    }
+
+    list.erase(std::remove_if(list.begin(), list.end(), [&](const Benchmark& b) {
+        return (b.group + "/" + b.name).find(options.filter) == std::string::npos;
+    }), list.end());
+
+    if (options.list) {
+        for (const Benchmark& benchmark : list)
+            std::printf("%s/%s\n", benchmark.group.c_str(), benchmark.name.c_str());
+        return 0;
+    }
+
+    // Frame counts are passed to the kernels as int
+    largest = *std::max_element(options.sizes.begin(), options.sizes.end());
+    if (largest > 0x7FFFFFFF) {
+        std::fprintf(stderr, "resonix_bench: sizes must be below 2^31\n");
+        return 2;
+    }
+
+    input_samples = Resonix::generateNoise(Resonix::NOISE_WHITE, static_cast<int>(largest / Resonix::SAMPLE_RATE + 1), 7);
+    output_samples = Resonix::allocateSamples(static_cast<size_t>(largest));
+    encoded.reset(new (std::nothrow) unsigned char[static_cast<size_t>(largest) * 4]);
+    if (!input_samples || !output_samples || !encoded) {
+        std::fprintf(stderr, "resonix_bench: cannot allocate buffers for %lld frames\n", largest);
+        return 1;
+    }
+
+    if (!options.output.empty() && !(out = std::fopen(options.output.c_str(), "w"))) {
+        std::fprintf(stderr, "resonix_bench: cannot create %s\n", options.output.c_str());
+        return 1;
+    }
+
+    if (!options.quiet)
+        std::fprintf(stderr, "%-28s %10s %12s %12s %10s %7s\n", "benchmark", "frames", "ns/sample", "min", "GB/s", "cv %");
+
+    for (const Benchmark& benchmark : list) {
+        for (long long frames : options.sizes) {
+            measurements.push_back(measure(benchmark, frames, options));
+
+            if (!options.quiet) {
+                const Summary s = summarize(measurements.back().ns_per_sample);
+                std::fprintf(stderr, "%-28s %10lld %12.4f %12.4f %10.3f %7.2f\n", (benchmark.group + "/" + benchmark.name).c_str(),
+                             frames, s.median, s.min, benchmark.bytes_per_sample / s.median, 100.0 * s.stddev / s.mean);
+            }
+        }
+    }
+
+    writeJson(out, measurements, options);
+    if (out != stdout)
+        std::fclose(out);
+    return 0;
+}
@@ -0,0 +1,559 @@
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include "Manifest.hpp"
+
+namespace Render {
+    namespace {
+        /*
+         * Just enough JSON for manifests: the parser builds a small tree and
+         * reports the byte offset of the first syntax error. Numbers are doubles.
+         */
+        struct JsonValue {
+            enum Kind { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT } kind = NUL;
+            bool boolean = false;
+            double number = 0.0;
+            std::string string;
+            std::vector<JsonValue> array;
+            std::vector<std::pair<std::string, JsonValue>> object;
+
+            const JsonValue* member(const std::string& key) const {
+                for (const auto& [name, value] : object) {
+                    if (name == key)
+                        return &value;
+                }
+                return nullptr;
+            }
+        };
+
+        class JsonParser {
+        public:
+            explicit JsonParser(const std::string& text) : text_(text), pos_(0) {}
+
+            bool parse(JsonValue& value, std::string& error) {
+                if (!parseValue(value, 0) || (skipSpace(), pos_ != text_.size())) {
+                    error = "invalid JSON near byte " + std::to_string(pos_);
+                    return false;
+                }
+                return true;
+            }
+
+        private:
+            static constexpr int MAX_DEPTH = 64;
+
+            const std::string& text_;
+            size_t pos_;
+
+            void skipSpace() {
+                while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_])))
+                    pos_++;
+            }
+
+            bool consume(char c) {
+                skipSpace();
+                if (pos_ < text_.size() && text_[pos_] == c) {
+                    pos_++;
+                    return true;
+                }
+                return false;
+            }
+
+            bool literal(const char* word) {
+                size_t length = std::char_traits<char>::length(word);
+                if (text_.compare(pos_, length, word) != 0)
+                    return false;
+                pos_ += length;
+                return true;
+            }
+
+            bool parseString(std::string& out) {
+                if (!consume('"'))
+                    return false;
+
+                while (pos_ < text_.size()) {
+                    char c = text_[pos_++];
+                    if (c == '"')
+                        return true;
+                    if (c != '\\') {
+                        out += c;
+                        continue;
+                    }
+                    if (pos_ >= text_.size())
+                        return false;
+                    switch (c = text_[pos_++]) {
+                        case 'n': out += '\n'; break;
+                        case 't': out += '\t'; break;
+                        case 'r': out += '\r'; break;
+                        case 'b': out += '\b'; break;
+                        case 'f': out += '\f'; break;
+                        case 'u': {
+                            // Paths are the only strings that could need this; encode the code unit as UTF-8
+                            unsigned code;
+                            if (pos_ + 4 > text_.size())
+                                return false;
+                            code = static_cast<unsigned>(std::strtoul(text_.substr(pos_, 4).c_str(), nullptr, 16));
+                            pos_ += 4;
+                            if (code < 0x80) {
+                                out += static_cast<char>(code);
+                            } else if (code < 0x800) {
+                                out += static_cast<char>(0xC0 | code >> 6);
+                                out += static_cast<char>(0x80 | (code & 0x3F));
+                            } else {
+                                out += static_cast<char>(0xE0 | code >> 12);
+                                out += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+                                out += static_cast<char>(0x80 | (code & 0x3F));
+                            }
+                            break;
+                        }
+                        default: out += c; break;
+                    }
+                }
+                return false;
+            }
+
+            bool parseValue(JsonValue& value, int depth) {
+                skipSpace();
+                if (pos_ >= text_.size() || depth > MAX_DEPTH)
+                    return false;
+
+                switch (text_[pos_]) {
+                    case '{':
+                        pos_++;
+                        value.kind = JsonValue::OBJECT;
+                        if (consume('}'))
+                            return true;
+                        do {
+                            std::pair<std::string, JsonValue> entry;
+                            if (!parseString(entry.first) || !consume(':') || !parseValue(entry.second, depth + 1))
+                                return false;
+                            value.object.push_back(std::move(entry));
+                        } while (consume(','));
+                        return consume('}');
+                    case '[':
+                        pos_++;
+                        value.kind = JsonValue::ARRAY;
+                        if (consume(']'))
+                            return true;
+                        do {
+                            value.array.emplace_back();
+                            if (!parseValue(value.array.back(), depth + 1))
+                                return false;
+                        } while (consume(','));
+                        return consume(']');
+                    case '"':
+                        value.kind = JsonValue::STRING;
+                        return parseString(value.string);
+                    case 't':
+                        value.kind = JsonValue::BOOLEAN;
+                        value.boolean = true;
+                        return literal("true");
+                    case 'f':
+                        value.kind = JsonValue::BOOLEAN;
+                        return literal("false");
+                    case 'n':
+                        return literal("null");
+                    default: {
+                        const char* start = text_.c_str() + pos_;
+                        char* end;
+                        value.kind = JsonValue::NUMBER;
+                        value.number = std::strtod(start, &end);
+                        if (end == start)
+                            return false;
+                        pos_ += static_cast<size_t>(end - start);
+                        return true;
+                    }
+                }
+            }
+        };
+
+        std::string lower(std::string text) {
+            for (char& c : text)
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            return text;
+        }
+
+        std::string trim(const std::string& text) {
+            size_t first = text.find_first_not_of(" \t\r\n");
+            size_t last = text.find_last_not_of(" \t\r\n");
+            return first == std::string::npos ? std::string() : text.substr(first, last - first + 1);
+        }
+
+        bool toNumber(const std::string& text, double& value) {
+            std::string s = trim(text);
+            char* end;
+            if (s.empty())
+                return false;
+            value = std::strtod(s.c_str(), &end);
+            return *end == '\0';
+        }
+
+        bool parseShape(const std::string& name, Resonix::Shape& shape) {
+            static const std::map<std::string, Resonix::Shape> SHAPES = {
+                {"sine", Resonix::SINE},
+                {"square", Resonix::SQUARE},
+                {"triangle", Resonix::TRIANGLE},
+                {"sawtooth", Resonix::SAWTOOTH},
+                {"cosine", Resonix::COSINE},
+                {"tangent", Resonix::TANGENT},
+                {"cotangent", Resonix::COTANGENT},
+                {"hann", Resonix::HANN},
+                {"phased_hann", Resonix::PHASED_HANN},
+                {"noise_white", Resonix::NOISE_WHITE},
+                {"noise_pink", Resonix::NOISE_PINK},
+                {"noise_brown", Resonix::NOISE_BROWN},
+            };
+            auto it = SHAPES.find(lower(trim(name)));
+
+            if (it == SHAPES.end())
+                return false;
+            shape = it->second;
+            return true;
+        }
+
+        bool parseSampleFormat(const std::string& name, Resonix::SampleFormat& format) {
+            std::string key = lower(trim(name));
+
+            if (key.empty() || key == "float32")
+                format = Resonix::FLOAT32;
+            else if (key == "int16")
+                format = Resonix::INT16;
+            else if (key == "int24")
+                format = Resonix::INT24;
+            else if (key == "float16")
+                format = Resonix::FLOAT16;
+            else
+                return false;
+            return true;
+        }
+
+        bool parseStageType(const std::string& name, FilterStage::Type& type) {
+            std::string key = lower(trim(name));
+
+            if (key == "lowpass")
+                type = FilterStage::LOWPASS;
+            else if (key == "highpass")
+                type = FilterStage::HIGHPASS;
+            else if (key == "bandpass")
+                type = FilterStage::BANDPASS;
+            else if (key == "formant")
+                type = FilterStage::FORMANT;
+            else
+                return false;
+            return true;
+        }
+
+        // Same ranges the Python bindings enforce
+        bool checkStage(const FilterStage& stage, std::string& error) {
+            switch (stage.type) {
+                case FilterStage::LOWPASS:
+                case FilterStage::HIGHPASS:
+                case FilterStage::BANDPASS:
+                    if (stage.frequency_hz <= 0.0f)
+                        error = stage.type == FilterStage::BANDPASS ? "center must be positive" : "cutoff must be positive";
+                    else if (stage.type == FilterStage::BANDPASS && stage.bandwidth_hz <= 0.0f)
+                        error = "bandwidth must be positive";
+                    else if (stage.resonance < 0.5f || stage.resonance > 10.0f)
+                        error = "resonance must be between 0.5 and 10.0";
+                    break;
+                case FilterStage::FORMANT:
+                    if (stage.peak < 0.0f || stage.peak > 1.0f)
+                        error = "peak must be between 0.0 and 1.0";
+                    else if (stage.mix < 0.0f || stage.mix > 1.0f)
+                        error = "mix must be between 0.0 and 1.0";
+                    else if (stage.spread < 0.0f || stage.spread > 1.0f)
+                        error = "spread must be between 0.0 and 1.0";
+                    break;
+            }
+            return error.empty();
+        }
+
+        bool checkJob(const Job& job, std::string& error) {
+            if (!Resonix::isNoise(job.shape) && job.frequency <= 0.0f)
+                error = "frequency must be positive";
+            else if (!(job.duration > 0.0))
+                error = "duration must be positive";
+            else if (job.output.empty())
+                error = "output is missing";
+            return error.empty();
+        }
+
+        bool jsonNumber(const JsonValue& object, const char* key, double& value) {
+            const JsonValue* member = object.member(key);
+            if (!member)
+                return true;
+            if (member->kind != JsonValue::NUMBER)
+                return false;
+            value = member->number;
+            return true;
+        }
+
+        bool jsonStage(const JsonValue& node, FilterStage& stage, std::string& error) {
+            const JsonValue* type = node.member("type");
+            double frequency = 0.0, bandwidth = 0.0, resonance = stage.resonance;
+            double peak = stage.peak, mix = stage.mix, spread = stage.spread;
+
+            if (node.kind != JsonValue::OBJECT || !type || type->kind != JsonValue::STRING) {
+                error = "filter stages need a \"type\"";
+                return false;
+            }
+            if (!parseStageType(type->string, stage.type)) {
+                error = "unknown filter type \"" + type->string + "\"";
+                return false;
+            }
+
+            if (!jsonNumber(node, stage.type == FilterStage::BANDPASS ? "center" : "cutoff", frequency)
+                || !jsonNumber(node, "bandwidth", bandwidth) || !jsonNumber(node, "resonance", resonance)
+                || !jsonNumber(node, "peak", peak) || !jsonNumber(node, "mix", mix) || !jsonNumber(node, "spread", spread)) {
+                error = "filter parameters must be numbers";
+                return false;
+            }
+
+            stage.frequency_hz = static_cast<float>(frequency);
+            stage.bandwidth_hz = static_cast<float>(bandwidth);
+            stage.resonance = static_cast<float>(resonance);
+            stage.peak = static_cast<float>(peak);
+            stage.mix = static_cast<float>(mix);
+            stage.spread = static_cast<float>(spread);
+            return checkStage(stage, error);
+        }
+
+        bool jsonJob(const JsonValue& node, Job& job, std::string& error) {
+            const JsonValue* shape = node.member("shape");
+            const JsonValue* format = node.member("format");
+            const JsonValue* output = node.member("output");
+            const JsonValue* filters = node.member("filters");
+            double frequency = 0.0, seed = 0.0;
+
+            if (node.kind != JsonValue::OBJECT) {
+                error = "jobs must be objects";
+                return false;
+            }
+            if (!shape || shape->kind != JsonValue::STRING || !parseShape(shape->string, job.shape)) {
+                error = "missing or unknown \"shape\"";
+                return false;
+            }
+            if (format && (format->kind != JsonValue::STRING || !parseSampleFormat(format->string, job.sample_format))) {
+                error = "\"format\" must be float32, int16, int24 or float16";
+                return false;
+            }
+            if (!jsonNumber(node, "frequency", frequency) || !jsonNumber(node, "duration", job.duration) || !jsonNumber(node, "seed", seed)) {
+                error = "frequency, duration and seed must be numbers";
+                return false;
+            }
+            if (output && output->kind == JsonValue::STRING)
+                job.output = output->string;
+
+            job.frequency = static_cast<float>(frequency);
+            job.seed = seed > 0.0 ? static_cast<unsigned long long>(seed) : 0;
+
+            if (filters && filters->kind == JsonValue::STRING) {
+                if (!parseFilterChain(filters->string, job.filters, error))
+                    return false;
+            } else if (filters && filters->kind == JsonValue::ARRAY) {
+                for (const JsonValue& entry : filters->array) {
+                    FilterStage stage;
+                    if (!jsonStage(entry, stage, error))
+                        return false;
+                    job.filters.push_back(stage);
+                }
+            } else if (filters && filters->kind != JsonValue::NUL) {
+                error = "\"filters\" must be an array or a chain string";
+                return false;
+            }
+
+            return checkJob(job, error);
+        }
+
+        // Splits one CSV record, honouring double-quoted fields with "" escapes
+        std::vector<std::string> csvFields(const std::string& line) {
+            std::vector<std::string> fields(1);
+            bool quoted = false;
+
+            for (size_t i = 0; i < line.size(); i++) {
+                char c = line[i];
+                if (quoted && c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                    fields.back() += '"';
+                    i++;
+                } else if (c == '"') {
+                    quoted = !quoted;
+                } else if (c == ',' && !quoted) {
+                    fields.emplace_back();
+                } else {
+                    fields.back() += c;
+                }
+            }
+            return fields;
+        }
+    }
+
+    bool parseFilterChain(const std::string& spec, std::vector<FilterStage>& stages, std::string& error) {
+        std::stringstream chain(spec);
+        std::string item;
+
+        while (std::getline(chain, item, '|')) {
+            std::stringstream fields(item);
+            std::string field;
+            std::vector<double> values;
+            FilterStage stage;
+
+            if (trim(item).empty())
+                continue;
+
+            std::getline(fields, field, ':');
+            if (!parseStageType(field, stage.type)) {
+                error = "unknown filter type \"" + trim(field) + "\"";
+                return false;
+            }
+            while (std::getline(fields, field, ':')) {
+                double value;
+                if (!toNumber(field, value)) {
+                    error = "bad filter parameter \"" + trim(field) + "\"";
+                    return false;
+                }
+                values.push_back(value);
+            }
+
+            const size_t required = stage.type == FilterStage::BANDPASS ? 2 : 1;
+            const size_t allowed = stage.type == FilterStage::FORMANT || stage.type == FilterStage::BANDPASS ? 3 : 2;
+            if (values.size() < required || values.size() > allowed) {
+                error = "wrong number of parameters in \"" + trim(item) + "\"";
+                return false;
+            }
+
+            if (stage.type == FilterStage::FORMANT) {
+                stage.peak = static_cast<float>(values[0]);
+                if (values.size() > 1)
+                    stage.mix = static_cast<float>(values[1]);
+                if (values.size() > 2)
+                    stage.spread = static_cast<float>(values[2]);
+            } else {
+                stage.frequency_hz = static_cast<float>(values[0]);
+                if (stage.type == FilterStage::BANDPASS)
+                    stage.bandwidth_hz = static_cast<float>(values[1]);
+                if (values.size() == allowed)
+                    stage.resonance = static_cast<float>(values.back());
+            }
+
+            if (!checkStage(stage, error))
+                return false;
+            stages.push_back(stage);
+        }
+        return true;
+    }
+
+    bool parseJsonManifest(const std::string& text, std::vector<Job>& jobs, std::string& error) {
+        JsonValue root;
+        const JsonValue* list = &root;
+
+        if (!JsonParser(text).parse(root, error))
+            return false;
+
+        if (root.kind == JsonValue::OBJECT)
+            list = root.member("jobs");
+        if (!list || list->kind != JsonValue::ARRAY) {
+            error = "manifest must be an array of jobs or an object with a \"jobs\" array";
+            return false;
+        }
+
+        for (size_t i = 0; i < list->array.size(); i++) {
+            Job job;
+            job.source_line = static_cast<int>(i);
+            if (!jsonJob(list->array[i], job, error)) {
+                error = "job " + std::to_string(i) + ": " + error;
+                return false;
+            }
+            jobs.push_back(std::move(job));
+        }
+        return true;
+    }
+
+    bool parseCsvManifest(const std::string& text, std::vector<Job>& jobs, std::string& error) {
+        std::stringstream input(text);
+        std::string line;
+        std::vector<std::string> header;
+        int line_number = 0;
+
+        while (std::getline(input, line)) {
+            std::vector<std::string> fields;
+            Job job;
+            line_number++;
+
+            if (trim(line).empty() || trim(line)[0] == '#')
+                continue;
+
+            fields = csvFields(line);
+            if (header.empty()) {
+                for (const std::string& name : fields)
+                    header.push_back(lower(trim(name)));
+                continue;
+            }
+
+            job.source_line = line_number;
+            for (size_t i = 0; i < fields.size() && i < header.size() && error.empty(); i++) {
+                const std::string& column = header[i];
+                const std::string value = trim(fields[i]);
+                double number = 0.0;
+
+                if (column == "shape") {
+                    if (!parseShape(value, job.shape))
+                        error = "unknown shape \"" + value + "\"";
+                } else if (column == "frequency" || column == "duration" || column == "seed") {
+                    if (value.empty())
+                        continue;
+                    if (!toNumber(value, number))
+                        error = column + " must be a number";
+                    else if (column == "frequency")
+                        job.frequency = static_cast<float>(number);
+                    else if (column == "duration")
+                        job.duration = number;
+                    else
+                        job.seed = number > 0.0 ? static_cast<unsigned long long>(number) : 0;
+                } else if (column == "format") {
+                    if (!parseSampleFormat(value, job.sample_format))
+                        error = "format must be float32, int16, int24 or float16";
+                } else if (column == "filters") {
+                    parseFilterChain(value, job.filters, error);
+                } else if (column == "output") {
+                    job.output = value;
+                }
+            }
+
+            if (error.empty())
+                checkJob(job, error);
+            if (!error.empty()) {
+                error = "line " + std::to_string(line_number) + ": " + error;
+                return false;
+            }
+            jobs.push_back(std::move(job));
+        }
+
+        if (header.empty()) {
+            error = "manifest is empty";
+            return false;
+        }
+        return true;
+    }
+
+    bool loadManifest(const std::string& path, std::vector<Job>& jobs, std::string& error) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        std::string text;
+        size_t first;
+
+        if (!file) {
+            error = "cannot open " + path;
+            return false;
+        }
+        contents << file.rdbuf();
+        text = contents.str();
+
+        first = text.find_first_not_of(" \t\r\n");
+        if (path.size() >= 4 && lower(path.substr(path.size() - 4)) == ".csv")
+            return parseCsvManifest(text, jobs, error);
+        if (first != std::string::npos && (text[first] == '[' || text[first] == '{'))
+            return parseJsonManifest(text, jobs, error);
+        return parseCsvManifest(text, jobs, error);
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Resonix.hpp"
+
+/**
+ * @namespace Render
+ * @brief Job manifests of the resonix_render batch renderer
+ */
+namespace Render {
+    /**
+     * @struct FilterStage
+     * @brief One stage of a job's filter chain
+     */
+    struct FilterStage {
+        enum Type {
+            LOWPASS,  ///< frequency_hz is the cutoff
+            HIGHPASS, ///< frequency_hz is the cutoff
+            BANDPASS, ///< frequency_hz is the center, bandwidth_hz the width
+            FORMANT   ///< peak, mix and spread as in formant_filter()
+        };
+
+        Type type = LOWPASS;
+        float frequency_hz = 0.0f;
+        float bandwidth_hz = 0.0f;
+        float resonance = 0.707f;
+        float peak = 0.0f;
+        float mix = 0.5f;
+        float spread = 0.0f;
+    };
+
+    /**
+     * @struct Job
+     * @brief One file to render: a waveform through a filter chain
+     */
+    struct Job {
+        Resonix::Shape shape = Resonix::SINE;
+        float frequency = 0.0f;                                ///< Hz; ignored by the NOISE_* shapes
+        double duration = 0.0;                                 ///< Seconds
+        unsigned long long seed = 0;                           ///< Noise stream
+        Resonix::SampleFormat sample_format = Resonix::FLOAT32;
+        std::vector<FilterStage> filters;
+        std::string output;                                    ///< WAV file to write
+        int source_line = 0;                                   ///< Manifest line (CSV) or array index (JSON), for messages
+    };
+
+    /**
+     * @brief Reads a JSON or CSV manifest
+     *
+     * JSON is an array of job objects, or an object whose "jobs" member is
+     * one. CSV has a header row naming the columns; shape, duration and
+     * output are required, frequency, filters, seed and format are optional.
+     * Files ending in .csv are read as CSV, anything else is detected from
+     * its first character.
+     *
+     * @param path Manifest file
+     * @param jobs Receives the parsed jobs
+     * @param error Receives a message naming the offending line or job on failure
+     * @return bool false if the file cannot be read or a job is invalid
+     */
+    bool loadManifest(const std::string& path, std::vector<Job>& jobs, std::string& error);
+
+    /** @brief Parses JSON manifest text, see loadManifest() */
+    bool parseJsonManifest(const std::string& text, std::vector<Job>& jobs, std::string& error);
+
+    /** @brief Parses CSV manifest text, see loadManifest() */
+    bool parseCsvManifest(const std::string& text, std::vector<Job>& jobs, std::string& error);
+
+    /**
+     * @brief Parses a compact filter chain such as "highpass:80|lowpass:8000:0.9|formant:0.5:1"
+     *
+     * Stages are separated by '|' and their parameters by ':', in the order
+     * of the library functions: lowpass/highpass cutoff[:resonance],
+     * bandpass center:bandwidth[:resonance], formant peak[:mix[:spread]].
+     *
+     * @return bool false on an unknown stage or an out-of-range parameter
+     */
+    bool parseFilterChain(const std::string& spec, std::vector<FilterStage>& stages, std::string& error);
+}
@@ -0,0 +1,245 @@
+/*
+ * resonix_render: renders a manifest of tone and noise jobs to WAV files.
+ *
+ * Every job streams an Oscillator through its filter chain into an
+ * AudioFileWriter one block at a time, so memory use does not grow with the
+ * duration, and the jobs run side by side on a thread pool.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AudioFile.hpp"
+#include "BufferPool.hpp"
+#include "Filter.hpp"
+#include "Generator.hpp"
+#include "Manifest.hpp"
+#include "Oscillator.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string manifest;
+        std::string output_dir;
+        unsigned threads = 0;
+        int block_size = Generator::BLOCK_LENGTH;
+        bool quiet = false;
+    };
+
+    struct Result {
+        bool ok = false;
+        long long frames = 0;
+        double seconds = 0.0;
+        std::string path;
+        std::string error;
+    };
+
+    void usage(std::FILE* out) {
+        std::fprintf(out,
+                     "usage: resonix_render [options] MANIFEST\n"
+                     "\n"
+                     "Renders every job of a JSON or CSV manifest to a WAV file.\n"
+                     "\n"
+                     "options:\n"
+                     "  -j, --threads N      worker threads (default: hardware concurrency)\n"
+                     "  -o, --output-dir DIR prefix for relative output paths\n"
+                     "  -b, --block-size N   samples rendered per block (default: %d)\n"
+                     "  -q, --quiet          print only the summary\n"
+                     "  -h, --help           show this message\n",
+                     Generator::BLOCK_LENGTH);
+    }
+
+    bool parseArguments(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            const bool has_value = i + 1 < argc;
+
+            if (arg == "-h" || arg == "--help") {
+                usage(stdout);
+                std::exit(0);
+            } else if ((arg == "-j" || arg == "--threads") && has_value) {
+                int threads = std::atoi(argv[++i]);
+                if (threads <= 0)
+                    return false;
+                options.threads = static_cast<unsigned>(threads);
+            } else if ((arg == "-o" || arg == "--output-dir") && has_value) {
+                options.output_dir = argv[++i];
+            } else if ((arg == "-b" || arg == "--block-size") && has_value) {
+                options.block_size = std::atoi(argv[++i]);
+                if (options.block_size <= 0)
+                    return false;
+            } else if (arg == "-q" || arg == "--quiet") {
+                options.quiet = true;
+            } else if (!arg.empty() && arg[0] != '-' && options.manifest.empty()) {
+                options.manifest = arg;
+            } else {
+                return false;
+            }
+        }
+        return !options.manifest.empty();
+    }
+
+    Filter::FilterChain buildChain(const std::vector<Render::FilterStage>& stages) {
+        Filter::FilterChain chain;
+
+        for (const Render::FilterStage& stage : stages) {
+            switch (stage.type) {
+                case Render::FilterStage::LOWPASS:
+                    chain.addBiquad(Filter::make_lowpass_filter(stage.frequency_hz, stage.resonance));
+                    break;
+                case Render::FilterStage::HIGHPASS:
+                    chain.addBiquad(Filter::make_highpass_filter(stage.frequency_hz, stage.resonance));
+                    break;
+                case Render::FilterStage::BANDPASS:
+                    chain.addBiquad(Filter::make_bandpass_filter(stage.frequency_hz, stage.bandwidth_hz, stage.resonance));
+                    break;
+                case Render::FilterStage::FORMANT: {
+                    Filter::FormantFilter formant;
+                    formant.setup(stage.peak, stage.mix, stage.spread);
+                    chain.addFormant(formant);
+                    break;
+                }
+            }
+        }
+        return chain;
+    }
+
+    Result renderJob(const Render::Job& job, const Options& options) {
+        const Clock::time_point start = Clock::now();
+        const long long frames = std::llround(job.duration * Resonix::SAMPLE_RATE);
+        std::filesystem::path path(job.output);
+        Resonix::Oscillator oscillator(job.shape, job.frequency, frames, job.seed);
+        Filter::FilterChain chain = buildChain(job.filters);
+        Resonix::AudioFileWriter writer;
+        Resonix::SampleBuffer block;
+        std::error_code ignored;
+        Result result;
+
+        if (!options.output_dir.empty() && path.is_relative())
+            path = std::filesystem::path(options.output_dir) / path;
+        result.path = path.string();
+
+        if (path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path(), ignored);
+
+        block = Resonix::allocateSamples(static_cast<size_t>(options.block_size));
+        if (!block) {
+            result.error = "out of memory";
+            return result;
+        }
+        if (!writer.open(result.path, 1, Resonix::SAMPLE_RATE, Resonix::WAV, job.sample_format)) {
+            result.error = "cannot create file";
+            return result;
+        }
+
+        for (long long done = 0; done < frames;) {
+            const int count = static_cast<int>(std::min<long long>(options.block_size, frames - done));
+
+            oscillator.render(block.get(), count);
+            if (chain.size() > 0)
+                chain.process(block.get(), block.get(), count);
+            if (!writer.write(block.get(), count))
+                break;
+            done += count;
+        }
+
+        result.ok = writer.close() && writer.framesWritten() == frames;
+        if (!result.ok)
+            result.error = "write failed";
+        result.frames = frames;
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return result;
+    }
+
+    double percentile(std::vector<double> values, double fraction) {
+        size_t index;
+
+        if (values.empty())
+            return 0.0;
+        index = static_cast<size_t>(std::ceil(fraction * static_cast<double>(values.size()))) - 1;
+        index = std::min(index, values.size() - 1);
+        std::nth_element(values.begin(), values.begin() + static_cast<long>(index), values.end());
+        return values[index];
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<Render::Job> jobs;
+    std::vector<Result> results;
+    std::vector<double> job_ms;
+    std::string error;
+    std::atomic<int> remaining{0};
+    Clock::time_point start;
+    double wall, audio_seconds = 0.0, mean_ms = 0.0;
+    int failures = 0;
+
+    if (!parseArguments(argc, argv, options)) {
+        usage(stderr);
+        return 2;
+    }
+    if (!Render::loadManifest(options.manifest, jobs, error)) {
+        std::fprintf(stderr, "resonix_render: %s: %s\n", options.manifest.c_str(), error.c_str());
+        return 2;
+    }
+
+    // The global pool unless -j asks for a specific size
+    std::unique_ptr<Resonix::ThreadPool> own_pool;
+    if (options.threads)
+        own_pool = std::make_unique<Resonix::ThreadPool>(options.threads);
+    Resonix::ThreadPool& pool = own_pool ? *own_pool : Resonix::ThreadPool::global();
+
+    results.resize(jobs.size());
+    remaining = static_cast<int>(jobs.size());
+    start = Clock::now();
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        pool.submit([&, i] {
+            results[i] = renderJob(jobs[i], options);
+            remaining--;
+        });
+    }
+    pool.wait(remaining);
+    wall = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const Result& result = results[i];
+        const double seconds = static_cast<double>(result.frames) / Resonix::SAMPLE_RATE;
+
+        if (result.ok) {
+            audio_seconds += seconds;
+            job_ms.push_back(result.seconds * 1000.0);
+            mean_ms += result.seconds * 1000.0;
+        } else {
+            failures++;
+        }
+
+        if (!result.ok)
+            std::fprintf(stderr, "%5zu  FAILED  %s: %s\n", i, result.path.c_str(), result.error.c_str());
+        else if (!options.quiet)
+            std::printf("%5zu  %9.3f s  %9.2f ms  %8.1fx  %s\n", i, seconds, result.seconds * 1000.0,
+                        result.seconds > 0.0 ? seconds / result.seconds : 0.0, result.path.c_str());
+    }
+
+    if (!job_ms.empty())
+        mean_ms /= static_cast<double>(job_ms.size());
+
+    std::printf("rendered %zu/%zu jobs, %.1f s of audio in %.3f s on %u threads (%.1fx realtime)\n",
+                jobs.size() - static_cast<size_t>(failures), jobs.size(), audio_seconds, wall, pool.size(),
+                wall > 0.0 ? audio_seconds / wall : 0.0);
+    if (!job_ms.empty())
+        std::printf("job time: mean %.2f ms, p50 %.2f ms, p95 %.2f ms, max %.2f ms\n", mean_ms,
+                    percentile(job_ms, 0.5), percentile(job_ms, 0.95), *std::max_element(job_ms.begin(), job_ms.end()));
+
+    return failures ? 1 : 0;
+}